@@ -2359,9 +2359,12 @@ void PropertyColorList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
+    std::vector<uint32_t> packed;
+    packed.reserve(_lValueList.size());
     for (std::vector<App::Color>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->getPackedValue();
+        packed.push_back(it->getPackedValue());
     }
+    str.write(packed.data(), packed.size());
 }
 
 void PropertyColorList::RestoreDocFile(Base::Reader &reader)
@@ -2369,11 +2372,11 @@ void PropertyColorList::RestoreDocFile(Base::Reader &reader)
     Base::InputStream str(reader);
     uint32_t uCt=0;
     str >> uCt;
+    std::vector<uint32_t> packed(uCt); // must be 32 bit long
+    str.read(packed.data(), packed.size());
     std::vector<Color> values(uCt);
-    uint32_t value; // must be 32 bit long
-    for (std::vector<App::Color>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> value;
-        it->setPackedValue(value);
+    for (std::size_t i = 0; i < packed.size(); i++) {
+        values[i].setPackedValue(packed[i]);
     }
     setValues(values);
 }
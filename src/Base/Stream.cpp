@@ -27,6 +27,7 @@
 # include <QBuffer>
 # include <QByteArray>
 # include <QIODevice>
+# include <algorithm>
 # include <cstring>
 #ifdef __GNUC__
 # include <cstdint>
@@ -40,6 +41,41 @@
 
 using namespace Base;
 
+namespace {
+template <typename T>
+void writeBlock(std::ostream& out, const T* data, std::size_t count, bool swap)
+{
+    if (!swap) {
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+        return;
+    }
+
+    // swap a copy of the values as the input must not be modified
+    const std::size_t chunkSize = 4096;
+    std::vector<T> chunk(std::min(count, chunkSize));
+    while (count > 0) {
+        std::size_t num = std::min(count, chunkSize);
+        for (std::size_t i = 0; i < num; i++) {
+            chunk[i] = data[i];
+            SwapEndian<T>(chunk[i]);
+        }
+        out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(num * sizeof(T)));
+        data += num;
+        count -= num;
+    }
+}
+
+template <typename T>
+void readBlock(std::istream& in, T* data, std::size_t count, bool swap)
+{
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+    if (swap) {
+        for (std::size_t i = 0; i < count; i++)
+            SwapEndian<T>(data[i]);
+    }
+}
+}
+
 Stream::Stream() : _swap(false)
 {
 }
@@ -136,6 +172,30 @@ OutputStream& OutputStream::operator << (double d)
     return *this;
 }
 
+OutputStream& OutputStream::write(const int32_t* data, std::size_t count)
+{
+    writeBlock(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const uint32_t* data, std::size_t count)
+{
+    writeBlock(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const float* data, std::size_t count)
+{
+    writeBlock(_out, data, count, _swap);
+    return *this;
+}
+
+OutputStream& OutputStream::write(const double* data, std::size_t count)
+{
+    writeBlock(_out, data, count, _swap);
+    return *this;
+}
+
 InputStream::InputStream(std::istream &rin) : _in(rin)
 {
 }
@@ -216,6 +276,30 @@ InputStream& InputStream::operator >> (double& d)
     return *this;
 }
 
+InputStream& InputStream::read(int32_t* data, std::size_t count)
+{
+    readBlock(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(uint32_t* data, std::size_t count)
+{
+    readBlock(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(float* data, std::size_t count)
+{
+    readBlock(_in, data, count, _swap);
+    return *this;
+}
+
+InputStream& InputStream::read(double* data, std::size_t count)
+{
+    readBlock(_in, data, count, _swap);
+    return *this;
+}
+
 // ----------------------------------------------------------------------
 
 ByteArrayOStreambuf::ByteArrayOStreambuf(QByteArray& ba) : _buffer(new QBuffer(&ba))
@@ -81,6 +81,17 @@ public:
     OutputStream& operator << (float f);
     OutputStream& operator << (double d);
 
+    /** @name Block writing
+     * Writes \a count values as one contiguous block. If the byte order
+     * must be swapped this is done chunk-wise instead of value by value.
+     */
+    //@{
+    OutputStream& write(const int32_t* data, std::size_t count);
+    OutputStream& write(const uint32_t* data, std::size_t count);
+    OutputStream& write(const float* data, std::size_t count);
+    OutputStream& write(const double* data, std::size_t count);
+    //@}
+
 private:
     OutputStream (const OutputStream&);
     void operator = (const OutputStream&);
@@ -111,6 +122,16 @@ public:
     InputStream& operator >> (float& f);
     InputStream& operator >> (double& d);
 
+    /** @name Block reading
+     * Reads \a count values as one contiguous block directly into \a data.
+     */
+    //@{
+    InputStream& read(int32_t* data, std::size_t count);
+    InputStream& read(uint32_t* data, std::size_t count);
+    InputStream& read(float* data, std::size_t count);
+    InputStream& read(double* data, std::size_t count);
+    //@}
+
     operator bool() const
     {
         // test if _Ipfx succeeded
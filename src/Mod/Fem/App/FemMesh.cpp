@@ -24,15 +24,22 @@
 
 #ifndef _PreComp_
 # include <Python.h>
+# include <algorithm>
+# include <cmath>
 # include <cstdlib>
 # include <memory>
+# include <numeric>
 
 # include <Bnd_Box.hxx>
 # include <BRep_Tool.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
 # include <BRepExtrema_DistShapeShape.hxx>
+# include <BRepMesh_IncrementalMesh.hxx>
 # include <gp_Pnt.hxx>
+# include <Poly_Triangulation.hxx>
+# include <Precision.hxx>
 # include <ShapeAnalysis_ShapeTolerance.hxx>
 # include <SMDS_MeshGroup.hxx>
 # include <SMESH_Gen.hxx>
@@ -51,6 +58,8 @@
 # include <StdMeshers_StartEndLength.hxx>
 # include <StdMeshers_QuadranglePreference.hxx>
 # include <StdMeshers_Quadrangle_2D.hxx>
+# include <TopLoc_Location.hxx>
+# include <TopoDS.hxx>
 # include <TopoDS_Face.hxx>
 # include <TopoDS_Shape.hxx>
 # include <TopoDS_Solid.hxx>
@@ -71,6 +80,7 @@
 #include <Mod/Mesh/App/Core/Iterator.h>
 
 #include "FemMesh.h"
+#include "FemTextWriter.h"
 #include <FemMeshPy.h>
 
 #ifdef FC_USE_VTK
@@ -142,6 +152,7 @@ FemMesh &FemMesh::operator=(const FemMesh& mesh)
 void FemMesh::copyMeshData(const FemMesh& mesh)
 {
     _Mtrx = mesh._Mtrx;
+    nodeIndex.reset();
 
     // See file SMESH_I/SMESH_Gen_i.cxx in the git repo of smesh at
     // https://git.salome-platform.org
@@ -599,6 +610,7 @@ void FemMesh::setStandardHypotheses()
 
 void FemMesh::compute()
 {
+    nodeIndex.reset();
     getGenerator()->Compute(*myMesh, myMesh->GetShapeToMesh());
 }
 
@@ -619,7 +631,7 @@ std::set<long> FemMesh::getSurfaceNodes(long /*ElemId*/, short /*FaceId*/, float
 std::list<std::pair<int, int> > FemMesh::getVolumesByFace(const TopoDS_Face &face) const
 {
     std::list<std::pair<int, int> > result;
-    std::set<int> nodes_on_face = getNodesByFace(face);
+    std::vector<int> nodes_on_face = getNodesByFace(face);
 
 #if SMESH_VERSION_MAJOR >= 7
     // SMDS_MeshVolume::facesIterator() is broken with SMESH7 as it is impossible
@@ -718,7 +730,7 @@ std::list<int> FemMesh::getFacesByFace(const TopoDS_Face &face) const
 {
     //TODO: This function is broken with SMESH7 as it is impossible to iterate volume faces
     std::list<int> result;
-    std::set<int> nodes_on_face = getNodesByFace(face);
+    std::vector<int> nodes_on_face = getNodesByFace(face);
 
     SMDS_FaceIteratorPtr face_iter = myMesh->GetMeshDS()->facesIterator();
     while (face_iter->more()) {
@@ -750,7 +762,7 @@ std::list<int> FemMesh::getFacesByFace(const TopoDS_Face &face) const
 std::list<int> FemMesh::getEdgesByEdge(const TopoDS_Edge &edge) const
 {
     std::list<int> result;
-    std::set<int> nodes_on_edge = getNodesByEdge(edge);
+    std::vector<int> nodes_on_edge = getNodesByEdge(edge);
 
     SMDS_EdgeIteratorPtr edge_iter = myMesh->GetMeshDS()->edgesIterator();
     while (edge_iter->more()) {
@@ -785,7 +797,7 @@ std::list<int> FemMesh::getEdgesByEdge(const TopoDS_Edge &edge) const
 std::map<int, int> FemMesh::getccxVolumesByFace(const TopoDS_Face &face) const
 {
     std::map<int, int> result;
-    std::set<int> nodes_on_face = getNodesByFace(face);
+    std::vector<int> nodes_on_face = getNodesByFace(face);
 
     static std::map<int, std::vector<int> > elem_order;
     if (elem_order.empty()) {
@@ -865,196 +877,442 @@ std::map<int, int> FemMesh::getccxVolumesByFace(const TopoDS_Face &face) const
     return result;
 }
 
-std::set<int> FemMesh::getNodesBySolid(const TopoDS_Solid &solid) const
+//! A uniform grid of the nodes of a mesh, in the coordinates of the mesh, to find the nodes
+//! inside a box without visiting all nodes.
+class FemMesh::NodeIndex
 {
-    std::set<int> result;
+public:
+    explicit NodeIndex(const SMESHDS_Mesh* meshDS)
+        : mesh(meshDS)
+        , numNodes(meshDS->NbNodes())
+        , minId(meshDS->MinNodeID())
+        , maxId(meshDS->MaxNodeID())
+    {
+        std::vector<int> nodeIds;
+        std::vector<Base::Vector3d> nodePoints;
+        nodeIds.reserve(numNodes);
+        nodePoints.reserve(numNodes);
+        SMDS_NodeIteratorPtr aNodeIter = meshDS->nodesIterator();
+        while (aNodeIter->more()) {
+            const SMDS_MeshNode* aNode = aNodeIter->next();
+            nodeIds.push_back(aNode->GetID());
+            nodePoints.emplace_back(aNode->X(), aNode->Y(), aNode->Z());
+            bounds.Add(nodePoints.back());
+        }
 
-    Bnd_Box box;
-    BRepBndLib::Add(solid, box);
+        // about four nodes per cell, over the dimensions the mesh extends in
+        double lengths[3] = {0.0, 0.0, 0.0};
+        if (bounds.IsValid()) {
+            lengths[0] = bounds.LengthX();
+            lengths[1] = bounds.LengthY();
+            lengths[2] = bounds.LengthZ();
+        }
+        double size = std::max({lengths[0], lengths[1], lengths[2]});
+        double volume = 1.0;
+        int dimensions = 0;
+        for (double length : lengths) {
+            if (length > size * 1e-6) {
+                volume *= length;
+                dimensions++;
+            }
+        }
+        double cellSize = size;
+        if (dimensions > 0) {
+            double cells = std::max(1.0, nodePoints.size() / 4.0);
+            cellSize = std::pow(volume / cells, 1.0 / dimensions);
+        }
+        for (int k = 0; k < 3; k++) {
+            counts[k] = 1;
+            if (cellSize > 0.0) {
+                counts[k] = std::min(1024, std::max(1, int(std::ceil(lengths[k] / cellSize))));
+            }
+            invCellSizes[k] = lengths[k] > 0.0 ? counts[k] / lengths[k] : 0.0;
+        }
 
-    // limit where the mesh node belongs to the solid
-    TopAbs_ShapeEnum shapetype = TopAbs_SHAPE;
-    ShapeAnalysis_ShapeTolerance analysis;
-    double limit = analysis.Tolerance(solid, 1, shapetype);
-    Base::Console().Log(
-        "The limit if a node is in or out: %.12lf in scientific: %.4e \n", limit, limit);
+        // sort the nodes by cell
+        std::vector<size_t> cellOfNode(nodePoints.size());
+        cellStart.assign(size_t(counts[0]) * counts[1] * counts[2] + 1, 0);
+        for (size_t i = 0; i < nodePoints.size(); i++) {
+            int cell[3];
+            cellOf(nodePoints[i], cell);
+            cellOfNode[i] = (size_t(cell[2]) * counts[1] + cell[1]) * counts[0] + cell[0];
+            cellStart[cellOfNode[i] + 1]++;
+        }
+        std::partial_sum(cellStart.begin(), cellStart.end(), cellStart.begin());
+        std::vector<size_t> next(cellStart.begin(), cellStart.end() - 1);
+        ids.resize(nodeIds.size());
+        points.resize(nodePoints.size());
+        for (size_t i = 0; i < nodePoints.size(); i++) {
+            size_t pos = next[cellOfNode[i]]++;
+            ids[pos] = nodeIds[i];
+            points[pos] = nodePoints[i];
+        }
+    }
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
+    /// false if nodes have been added or removed since the index was made
+    bool isValidFor(const SMESHDS_Mesh* meshDS) const
+    {
+        return meshDS == mesh && meshDS->NbNodes() == numNodes
+            && meshDS->MinNodeID() == minId && meshDS->MaxNodeID() == maxId;
+    }
 
-    std::vector<const SMDS_MeshNode*> nodes;
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        nodes.push_back(aNode);
+    /// the positions in the index of the nodes inside the box
+    std::vector<size_t> nodesInBox(const Base::BoundBox3d& box) const
+    {
+        std::vector<size_t> result;
+        if (!bounds.IsValid() || !box.IsValid() || !bounds.Intersect(box)) {
+            return result;
+        }
+        int low[3], high[3];
+        cellOf(Base::Vector3d(box.MinX, box.MinY, box.MinZ), low);
+        cellOf(Base::Vector3d(box.MaxX, box.MaxY, box.MaxZ), high);
+        for (int z = low[2]; z <= high[2]; z++) {
+            for (int y = low[1]; y <= high[1]; y++) {
+                size_t row = (size_t(z) * counts[1] + y) * counts[0];
+                for (size_t i = cellStart[row + low[0]]; i < cellStart[row + high[0] + 1]; i++) {
+                    if (box.IsInBox(points[i])) {
+                        result.push_back(i);
+                    }
+                }
+            }
+        }
+        return result;
     }
 
-#pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        const SMDS_MeshNode* aNode = nodes[i];
-        double xyz[3];
-        aNode->GetXYZ(xyz);
-        Base::Vector3d vec(xyz[0], xyz[1], xyz[2]);
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
+    int getId(size_t i) const
+    {
+        return ids[i];
+    }
+    const Base::Vector3d& getPoint(size_t i) const
+    {
+        return points[i];
+    }
 
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
-            // create a vertex
-            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x, vec.y, vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
-            // measure distance
-            BRepExtrema_DistShapeShape measure(solid, s);
-            measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
-                continue;
+private:
+    void cellOf(const Base::Vector3d& point, int cell[3]) const
+    {
+        const double coords[3] = {point.x - bounds.MinX, point.y - bounds.MinY,
+                                  point.z - bounds.MinZ};
+        for (int k = 0; k < 3; k++) {
+            cell[k] = std::min(counts[k] - 1, std::max(0, int(coords[k] * invCellSizes[k])));
+        }
+    }
 
-            if (measure.Value() < limit)
-#pragma omp critical
-            {
-                result.insert(aNode->GetID());
-            }
+    const SMESHDS_Mesh* mesh;
+    int numNodes;
+    int minId;
+    int maxId;
+    Base::BoundBox3d bounds;
+    int counts[3];
+    double invCellSizes[3];
+    std::vector<size_t> cellStart;
+    std::vector<int> ids;
+    std::vector<Base::Vector3d> points;
+};
+
+const FemMesh::NodeIndex& FemMesh::getNodeIndex() const
+{
+    const SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    if (!nodeIndex || !nodeIndex->isValidFor(meshDS)) {
+        nodeIndex = std::make_shared<NodeIndex>(meshDS);
+    }
+    return *nodeIndex;
+}
+
+std::vector<std::pair<int, Base::Vector3d>> FemMesh::getNodesInBox(const Bnd_Box& box) const
+{
+    std::vector<std::pair<int, Base::Vector3d>> result;
+    if (box.IsVoid()) {
+        return result;
+    }
+
+    // the box in the coordinates of the mesh
+    const Base::Matrix4D Mtrx(getTransform());
+    Base::Matrix4D inverse(Mtrx);
+    inverse.inverseGauss();
+    double xMin, yMin, zMin, xMax, yMax, zMax;
+    box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    Base::BoundBox3d localBox =
+        Base::BoundBox3d(xMin, yMin, zMin, xMax, yMax, zMax).Transformed(inverse);
+
+    const NodeIndex& index = getNodeIndex();
+    for (size_t i : index.nodesInBox(localBox)) {
+        // Apply the matrix to hold the node in absolute space.
+        Base::Vector3d vec = Mtrx * index.getPoint(i);
+        if (!box.IsOut(gp_Pnt(vec.x, vec.y, vec.z))) {
+            result.emplace_back(index.getId(i), vec);
         }
     }
     return result;
 }
 
-std::set<int> FemMesh::getNodesByFace(const TopoDS_Face &face) const
+namespace {
+
+/*! Rejects points that are far from a face by their distance to a triangulation of
+ * the face. A point is only rejected if it is farther than the limit plus a multiple
+ * of the deflection of the triangulation from every triangle.
+ */
+class FaceTriangulationFilter
 {
-    std::set<int> result;
+public:
+    FaceTriangulationFilter(const TopoDS_Face& face, const Bnd_Box& faceBox, double limit)
+    {
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        faceBox.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        double diagonal = gp_Pnt(xMin, yMin, zMin).Distance(gp_Pnt(xMax, yMax, zMax));
+        double deflection = std::max(diagonal * 1e-3, Precision::Confusion());
+        radius = limit + 2.0 * deflection;
+
+        // mesh a copy to leave the triangulation of the face alone
+        BRepBuilderAPI_Copy copier(face, Standard_True, Standard_False);
+        TopoDS_Face copy = TopoDS::Face(copier.Shape());
+        BRepMesh_IncrementalMesh(copy, deflection, Standard_False, 0.5);
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(copy, loc);
+        if (mesh.IsNull() || mesh->NbTriangles() < 1) {
+            return;
+        }
 
-    Bnd_Box box;
-    BRepBndLib::Add(
-        face,
-        box,
-        Standard_False);// https://forum.freecadweb.org/viewtopic.php?f=18&t=21571&start=70#p221591
-    // limit where the mesh node belongs to the face:
-    double limit = BRep_Tool::Tolerance(face);
-    box.Enlarge(limit);
+        gp_Trsf trsf = loc.Transformation();
+        for (int i = 1; i <= mesh->NbTriangles(); i++) {
+            int n[3];
+            mesh->Triangle(i).Get(n[0], n[1], n[2]);
+            for (int k = 0; k < 3; k++) {
+                gp_Pnt p = mesh->Node(n[k]).Transformed(trsf);
+                corners.emplace_back(p.X(), p.Y(), p.Z());
+                bounds.Add(corners.back());
+            }
+        }
+        bounds.Enlarge(radius);
+
+        // bucket the triangles, grown by the radius, in a grid of about one cell each
+        size_t numTriangles = corners.size() / 3;
+        double volume = 1.0;
+        int dimensions = 0;
+        double lengths[3] = {bounds.LengthX(), bounds.LengthY(), bounds.LengthZ()};
+        for (double length : lengths) {
+            if (length > radius * 4.0) {
+                volume *= length;
+                dimensions++;
+            }
+        }
+        double cellSize = dimensions > 0 ? std::pow(volume / numTriangles, 1.0 / dimensions)
+                                         : lengths[0];
+        cellSize = std::max(cellSize, radius);
+        for (int k = 0; k < 3; k++) {
+            counts[k] = std::min(256, std::max(1, int(std::ceil(lengths[k] / cellSize))));
+            invCellSizes[k] = counts[k] / lengths[k];
+        }
+        cells.resize(size_t(counts[0]) * counts[1] * counts[2]);
+        for (size_t t = 0; t < numTriangles; t++) {
+            Base::BoundBox3d box;
+            box.Add(corners[3 * t]);
+            box.Add(corners[3 * t + 1]);
+            box.Add(corners[3 * t + 2]);
+            box.Enlarge(radius);
+            int low[3], high[3];
+            cellOf(Base::Vector3d(box.MinX, box.MinY, box.MinZ), low);
+            cellOf(Base::Vector3d(box.MaxX, box.MaxY, box.MaxZ), high);
+            for (int z = low[2]; z <= high[2]; z++) {
+                for (int y = low[1]; y <= high[1]; y++) {
+                    for (int x = low[0]; x <= high[0]; x++) {
+                        cells[(size_t(z) * counts[1] + y) * counts[0] + x].push_back(t);
+                    }
+                }
+            }
+        }
+    }
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
+    /// false if the point is certainly farther from the face than the limit
+    bool mayBeNear(const Base::Vector3d& point) const
+    {
+        if (cells.empty()) {
+            return true;
+        }
+        if (!bounds.IsInBox(point)) {
+            return false;
+        }
+        int cell[3];
+        cellOf(point, cell);
+        double radius2 = radius * radius;
+        for (size_t t : cells[(size_t(cell[2]) * counts[1] + cell[1]) * counts[0] + cell[0]]) {
+            if (distanceToTriangle2(point, corners[3 * t], corners[3 * t + 1],
+                                    corners[3 * t + 2]) <= radius2) {
+                return true;
+            }
+        }
+        return false;
+    }
 
-    std::vector<const SMDS_MeshNode*> nodes;
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        nodes.push_back(aNode);
+private:
+    void cellOf(const Base::Vector3d& point, int cell[3]) const
+    {
+        const double coords[3] = {point.x - bounds.MinX, point.y - bounds.MinY,
+                                  point.z - bounds.MinZ};
+        for (int k = 0; k < 3; k++) {
+            cell[k] = std::min(counts[k] - 1, std::max(0, int(coords[k] * invCellSizes[k])));
+        }
     }
 
-#pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        const SMDS_MeshNode* aNode = nodes[i];
-        double xyz[3];
-        aNode->GetXYZ(xyz);
-        Base::Vector3d vec(xyz[0], xyz[1], xyz[2]);
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
+    // squared distance of a point to a triangle, see Ericson, Real-Time Collision Detection
+    static double distanceToTriangle2(const Base::Vector3d& p, const Base::Vector3d& a,
+                                      const Base::Vector3d& b, const Base::Vector3d& c)
+    {
+        Base::Vector3d ab = b - a, ac = c - a, ap = p - a;
+        double d1 = ab * ap, d2 = ac * ap;
+        if (d1 <= 0.0 && d2 <= 0.0) {
+            return Base::DistanceP2(p, a);
+        }
+        Base::Vector3d bp = p - b;
+        double d3 = ab * bp, d4 = ac * bp;
+        if (d3 >= 0.0 && d4 <= d3) {
+            return Base::DistanceP2(p, b);
+        }
+        double vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+            double v = d1 / (d1 - d3);
+            return Base::DistanceP2(p, a + ab * v);
+        }
+        Base::Vector3d cp = p - c;
+        double d5 = ab * cp, d6 = ac * cp;
+        if (d6 >= 0.0 && d5 <= d6) {
+            return Base::DistanceP2(p, c);
+        }
+        double vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+            double w = d2 / (d2 - d6);
+            return Base::DistanceP2(p, a + ac * w);
+        }
+        double va = d3 * d6 - d5 * d4;
+        if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+            double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            return Base::DistanceP2(p, b + (c - b) * w);
+        }
+        double denom = 1.0 / (va + vb + vc);
+        double v = vb * denom, w = vc * denom;
+        return Base::DistanceP2(p, a + ab * v + ac * w);
+    }
+
+    double radius = 0.0;
+    std::vector<Base::Vector3d> corners;
+    Base::BoundBox3d bounds;
+    int counts[3] = {1, 1, 1};
+    double invCellSizes[3] = {0.0, 0.0, 0.0};
+    std::vector<std::vector<size_t>> cells;
+};
 
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
+/*! Returns the sorted IDs of the nodes closer to the shape than the limit. Each thread
+ * measures with its own BRepExtrema_DistShapeShape, which keeps the data of the shape
+ * between the nodes, and collects its IDs in its own buffer.
+ */
+template<typename Prefilter>
+std::vector<int> getNodesNearShape(const TopoDS_Shape& shape, double limit,
+                                   const std::vector<std::pair<int, Base::Vector3d>>& nodes,
+                                   Prefilter mayBeNear)
+{
+    std::vector<int> result;
+
+#pragma omp parallel
+    {
+        BRepExtrema_DistShapeShape measure;
+        measure.LoadS1(shape);
+        std::vector<int> found;
+
+#pragma omp for schedule(dynamic, 64) nowait
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const Base::Vector3d& vec = nodes[i].second;
+            if (!mayBeNear(vec)) {
+                continue;
+            }
             // create a vertex
             BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x, vec.y, vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
             // measure distance
-            BRepExtrema_DistShapeShape measure(face, s);
+            measure.LoadS2(aBuilder.Vertex());
             measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
+            if (!measure.IsDone() || measure.NbSolution() < 1) {
                 continue;
-
-            if (measure.Value() < limit)
-#pragma omp critical
-            {
-                result.insert(aNode->GetID());
+            }
+            if (measure.Value() < limit) {
+                found.push_back(nodes[i].first);
             }
         }
+
+#pragma omp critical
+        result.insert(result.end(), found.begin(), found.end());
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
-std::set<int> FemMesh::getNodesByEdge(const TopoDS_Edge &edge) const
-{
-    std::set<int> result;
+}
 
+std::vector<int> FemMesh::getNodesBySolid(const TopoDS_Solid &solid) const
+{
     Bnd_Box box;
-    BRepBndLib::Add(edge, box);
-    // limit where the mesh node belongs to the edge:
-    double limit = BRep_Tool::Tolerance(edge);
-    box.Enlarge(limit);
+    BRepBndLib::Add(solid, box);
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
+    // limit where the mesh node belongs to the solid
+    TopAbs_ShapeEnum shapetype = TopAbs_SHAPE;
+    ShapeAnalysis_ShapeTolerance analysis;
+    double limit = analysis.Tolerance(solid, 1, shapetype);
+    Base::Console().Log(
+        "The limit if a node is in or out: %.12lf in scientific: %.4e \n", limit, limit);
 
-    std::vector<const SMDS_MeshNode*> nodes;
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        nodes.push_back(aNode);
-    }
+    std::vector<std::pair<int, Base::Vector3d>> nodes = getNodesInBox(box);
+    return getNodesNearShape(solid, limit, nodes, [](const Base::Vector3d&) { return true; });
+}
 
-#pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        const SMDS_MeshNode* aNode = nodes[i];
-        double xyz[3];
-        aNode->GetXYZ(xyz);
-        Base::Vector3d vec(xyz[0], xyz[1], xyz[2]);
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
+std::vector<int> FemMesh::getNodesByFace(const TopoDS_Face &face) const
+{
+    Bnd_Box box;
+    BRepBndLib::Add(
+        face,
+        box,
+        Standard_False);// https://forum.freecadweb.org/viewtopic.php?f=18&t=21571&start=70#p221591
+    // limit where the mesh node belongs to the face:
+    double limit = BRep_Tool::Tolerance(face);
+    box.Enlarge(limit);
 
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
-            // create a vertex
-            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x, vec.y, vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
-            // measure distance
-            BRepExtrema_DistShapeShape measure(edge, s);
-            measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
-                continue;
+    std::vector<std::pair<int, Base::Vector3d>> nodes = getNodesInBox(box);
+    FaceTriangulationFilter filter(face, box, limit);
+    return getNodesNearShape(face, limit, nodes, [&filter](const Base::Vector3d& vec) {
+        return filter.mayBeNear(vec);
+    });
+}
 
-            if (measure.Value() < limit)
-#pragma omp critical
-            {
-                result.insert(aNode->GetID());
-            }
-        }
-    }
+std::vector<int> FemMesh::getNodesByEdge(const TopoDS_Edge &edge) const
+{
+    Bnd_Box box;
+    BRepBndLib::Add(edge, box);
+    // limit where the mesh node belongs to the edge:
+    double limit = BRep_Tool::Tolerance(edge);
+    box.Enlarge(limit);
 
-    return result;
+    std::vector<std::pair<int, Base::Vector3d>> nodes = getNodesInBox(box);
+    return getNodesNearShape(edge, limit, nodes, [](const Base::Vector3d&) { return true; });
 }
 
-std::set<int> FemMesh::getNodesByVertex(const TopoDS_Vertex &vertex) const
+std::vector<int> FemMesh::getNodesByVertex(const TopoDS_Vertex &vertex) const
 {
-    std::set<int> result;
+    std::vector<int> result;
 
     double limit = BRep_Tool::Tolerance(vertex);
-    limit *= limit; // use square to improve speed
     gp_Pnt pnt = BRep_Tool::Pnt(vertex);
     Base::Vector3d node(pnt.X(), pnt.Y(), pnt.Z());
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
-
-    std::vector<const SMDS_MeshNode*> nodes;
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        nodes.push_back(aNode);
-    }
-
-#pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        const SMDS_MeshNode* aNode = nodes[i];
-        double xyz[3];
-        aNode->GetXYZ(xyz);
-        Base::Vector3d vec(xyz[0], xyz[1], xyz[2]);
-        vec = Mtrx * vec;
+    Bnd_Box box;
+    box.Add(pnt);
+    box.Enlarge(limit);
 
-        if (Base::DistanceP2(node, vec) <= limit)
-#pragma omp critical
-        {
-            result.insert(aNode->GetID());
+    limit *= limit; // use square to improve speed
+    for (const auto& it : getNodesInBox(box)) {
+        if (Base::DistanceP2(node, it.second) <= limit) {
+            result.push_back(it.first);
         }
     }
 
+    std::sort(result.begin(), result.end());
     return result;
 }
 
@@ -1574,6 +1832,7 @@ void FemMesh::readNastran(const std::string &Filename)
     Base::Console().Log("Start: FemMesh::readNastran() =================================\n");
 
     _Mtrx = Base::Matrix4D();
+    nodeIndex.reset();
 
     Base::FileInfo fi(Filename);
     Base::ifstream inputfile;
@@ -1666,6 +1925,7 @@ void FemMesh::readNastran95(const std::string &Filename)
     Base::Console().Log("Start: FemMesh::readNastran95() =================================\n");
 
     _Mtrx = Base::Matrix4D();
+    nodeIndex.reset();
 
     Base::FileInfo fi(Filename);
     Base::ifstream inputfile;
@@ -1802,6 +2062,7 @@ void FemMesh::readAbaqus(const std::string &FileName)
 {
     Base::TimeInfo Start;
     Base::Console().Log("Start: FemMesh::readAbaqus() =================================\n");
+    nodeIndex.reset();
 
     /*
     Python command to read Abaqus inp mesh file from test suite:
@@ -1838,6 +2099,7 @@ void FemMesh::readZ88(const std::string &FileName)
 {
     Base::TimeInfo Start;
     Base::Console().Log("Start: FemMesh::readZ88() =================================\n");
+    nodeIndex.reset();
 
     /*
     Python command to read Z88 mesh file from test suite:
@@ -1874,6 +2136,7 @@ void FemMesh::read(const char *FileName)
 {
     Base::FileInfo File(FileName);
     _Mtrx = Base::Matrix4D();
+    nodeIndex.reset();
 
     // checking on the file
     if (!File.isReadable())
@@ -2051,36 +2314,51 @@ void FemMesh::writeABAQUS(const std::string &Filename, int elemParam, bool group
     }
 
     // get all data --> Extract Nodes and Elements of the current SMESH datastructure
-    using VertexMap = std::map<int, Base::Vector3d>;
-    using NodesMap = std::map<int, std::vector<int> >;
-    using ElementsMap = std::map<std::string, NodesMap>;
+    // The nodes and the elements of each type are sorted by their IDs.
+    // See http://forum.freecadweb.org/viewtopic.php?f=18&t=12646&start=40#p103004
+    using VertexList = std::vector<std::pair<int, Base::Vector3d> >;
+    using NodesList = std::vector<std::pair<int, std::vector<int> > >;
+    using ElementsMap = std::map<std::string, NodesList>;
+
+    auto byId = [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    };
+    auto addElement = [&](ElementsMap& elementsMap, const SMDS_MeshElement* elem,
+                          const std::map<int, std::string>& typeMap) {
+        std::map<int, std::string>::const_iterator it = typeMap.find(elem->NbNodes());
+        if (it != typeMap.end()) {
+            const std::vector<int>& order = elemOrderMap[it->second];
+            std::vector<int> nodes;
+            nodes.reserve(order.size());
+            for (int index : order)
+                nodes.push_back(elem->GetNode(index)->GetID());
+            elementsMap[it->second].emplace_back(elem->GetID(), std::move(nodes));
+        }
+    };
+    auto sortElements = [&](ElementsMap& elementsMap) {
+        for (auto& it : elementsMap)
+            std::sort(it.second.begin(), it.second.end(), byId);
+    };
 
     // get nodes
-    VertexMap vertexMap;  // empty nodes map
+    VertexList vertexList;
+    vertexList.reserve(myMesh->GetMeshDS()->NbNodes());
     SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    Base::Vector3d current_node;
     while (aNodeIter->more()) {
         const SMDS_MeshNode* aNode = aNodeIter->next();
-        current_node.Set(aNode->X(),aNode->Y(),aNode->Z());
-        current_node = _Mtrx * current_node;
-        vertexMap[aNode->GetID()] = current_node;
+        vertexList.emplace_back(aNode->GetID(), Base::Vector3d(aNode->X(), aNode->Y(), aNode->Z()));
+    }
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < static_cast<long>(vertexList.size()); ++i) {
+        vertexList[i].second = _Mtrx * vertexList[i].second;
     }
+    std::sort(vertexList.begin(), vertexList.end(), byId);
 
     // get volumes
     ElementsMap elementsMapVol;  // empty volumes map
     SMDS_VolumeIteratorPtr aVolIter = myMesh->GetMeshDS()->volumesIterator();
     while (aVolIter->more()) {
-        const SMDS_MeshVolume* aVol = aVolIter->next();
-        std::pair<int, std::vector<int> > apair;
-        apair.first = aVol->GetID();
-        int numNodes = aVol->NbNodes();
-        std::map<int, std::string>::iterator it = volTypeMap.find(numNodes);
-        if (it != volTypeMap.end()) {
-            const std::vector<int>& order = elemOrderMap[it->second];
-            for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt)
-                apair.second.push_back(aVol->GetNode(*jt)->GetID());
-            elementsMapVol[it->second].insert(apair);
-        }
+        addElement(elementsMapVol, aVolIter->next(), volTypeMap);
     }
 
     //get faces
@@ -2091,34 +2369,14 @@ void FemMesh::writeABAQUS(const std::string &Filename, int elemParam, bool group
         // we're going to fill the elementsMapFac with all faces
         SMDS_FaceIteratorPtr aFaceIter = myMesh->GetMeshDS()->facesIterator();
         while (aFaceIter->more()) {
-            const SMDS_MeshFace* aFace = aFaceIter->next();
-            std::pair<int, std::vector<int> > apair;
-            apair.first = aFace->GetID();
-            int numNodes = aFace->NbNodes();
-            std::map<int, std::string>::iterator it = faceTypeMap.find(numNodes);
-            if (it != faceTypeMap.end()) {
-                const std::vector<int>& order = elemOrderMap[it->second];
-                for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt)
-                    apair.second.push_back(aFace->GetNode(*jt)->GetID());
-                elementsMapFac[it->second].insert(apair);
-            }
+            addElement(elementsMapFac, aFaceIter->next(), faceTypeMap);
         }
     }
     if (elemParam == 2) {
         // we're going to fill the elementsMapFac with the facesOnly
         std::set<int> facesOnly = getFacesOnly();
-        for (std::set<int>::iterator itfa = facesOnly.begin(); itfa != facesOnly.end(); ++itfa) {
-            std::pair<int, std::vector<int> > apair;
-            apair.first = *itfa;
-            const SMDS_MeshElement* aFace = myMesh->GetMeshDS()->FindElement(*itfa);
-            int numNodes = aFace->NbNodes();
-            std::map<int, std::string>::iterator it = faceTypeMap.find(numNodes);
-            if (it != faceTypeMap.end()) {
-                const std::vector<int>& order = elemOrderMap[it->second];
-                for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt)
-                    apair.second.push_back(aFace->GetNode(*jt)->GetID());
-                elementsMapFac[it->second].insert(apair);
-            }
+        for (int id : facesOnly) {
+            addElement(elementsMapFac, myMesh->GetMeshDS()->FindElement(id), faceTypeMap);
         }
     }
 
@@ -2130,167 +2388,127 @@ void FemMesh::writeABAQUS(const std::string &Filename, int elemParam, bool group
         // and elmentsMapFac are empty we're going to fill the elementsMapEdg with all edges
         SMDS_EdgeIteratorPtr aEdgeIter = myMesh->GetMeshDS()->edgesIterator();
         while (aEdgeIter->more()) {
-            const SMDS_MeshEdge* aEdge = aEdgeIter->next();
-            std::pair<int, std::vector<int> > apair;
-            apair.first = aEdge->GetID();
-            int numNodes = aEdge->NbNodes();
-            std::map<int, std::string>::iterator it = edgeTypeMap.find(numNodes);
-            if (it != edgeTypeMap.end()) {
-                const std::vector<int>& order = elemOrderMap[it->second];
-                for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt)
-                    apair.second.push_back(aEdge->GetNode(*jt)->GetID());
-                elementsMapEdg[it->second].insert(apair);
-            }
+            addElement(elementsMapEdg, aEdgeIter->next(), edgeTypeMap);
         }
     }
     if (elemParam == 2) {
         // we're going to fill the elementsMapEdg with the edgesOnly
         std::set<int> edgesOnly = getEdgesOnly();
-        for (std::set<int>::iterator ited = edgesOnly.begin(); ited != edgesOnly.end(); ++ited) {
-            std::pair<int, std::vector<int> > apair;
-            apair.first = *ited;
-            const SMDS_MeshElement* aEdge = myMesh->GetMeshDS()->FindElement(*ited);
-            int numNodes = aEdge->NbNodes();
-            std::map<int, std::string>::iterator it = edgeTypeMap.find(numNodes);
-            if (it != edgeTypeMap.end()) {
-                const std::vector<int>& order = elemOrderMap[it->second];
-                for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt)
-                    apair.second.push_back(aEdge->GetNode(*jt)->GetID());
-                elementsMapEdg[it->second].insert(apair);
-            }
+        for (int id : edgesOnly) {
+            addElement(elementsMapEdg, myMesh->GetMeshDS()->FindElement(id), edgeTypeMap);
         }
     }
 
+    sortElements(elementsMapVol);
+    sortElements(elementsMapFac);
+    sortElements(elementsMapEdg);
+
     // write all data to file
     // take also care of special characters in path
     // https://forum.freecadweb.org/viewtopic.php?f=10&t=37436
-    Base::FileInfo fi(Filename);
-    Base::ofstream anABAQUS_Output(fi);
+    // precision of the coordinates
     // https://forum.freecadweb.org/viewtopic.php?f=18&t=22759#p176669
-    anABAQUS_Output.precision(13);
+    TextBlockWriter anABAQUS_Output(Base::FileInfo(Filename), 13);
+    TextBuffer& header = anABAQUS_Output.buffer();
 
     // add some text and make sure one of the known elemParam values is used
-    anABAQUS_Output << "** written by FreeCAD inp file writer for CalculiX,Abaqus meshes"
-        << std::endl;
+    header << "** written by FreeCAD inp file writer for CalculiX,Abaqus meshes\n";
     switch(elemParam){
         case 0:
-            anABAQUS_Output << "** all mesh elements." << std::endl << std::endl;
+            header << "** all mesh elements.\n\n";
             break;
         case 1:
-            anABAQUS_Output << "** highest dimension mesh elements only." << std::endl << std::endl;
+            header << "** highest dimension mesh elements only.\n\n";
             break;
         case 2:
-            anABAQUS_Output << "** FEM mesh elements only (edges if they do not belong to faces "
-                               "and faces if they do not belong to volumes)."
-                            << std::endl
-                            << std::endl;
+            header << "** FEM mesh elements only (edges if they do not belong to faces "
+                      "and faces if they do not belong to volumes).\n\n";
             break;
         default:
-            anABAQUS_Output << "** Problem on writing" << std::endl;
+            header << "** Problem on writing\n";
             anABAQUS_Output.close();
             throw std::runtime_error(
                 "Unknown ABAQUS element choice parameter, [0|1|2] are allowed.");
     }
 
     // write nodes
-    anABAQUS_Output << "** Nodes" << std::endl;
-    anABAQUS_Output << "*Node, NSET=Nall" << std::endl;
-    // This way we get sorted output.
-    // See http://forum.freecadweb.org/viewtopic.php?f=18&t=12646&start=40#p103004
-    for (VertexMap::iterator it = vertexMap.begin(); it != vertexMap.end(); ++it) {
-        anABAQUS_Output << it->first << ", "
-            << it->second.x << ", "
-            << it->second.y << ", "
-            << it->second.z << std::endl;
-    }
-    anABAQUS_Output << std::endl << std::endl;;
-
+    header << "** Nodes\n";
+    header << "*Node, NSET=Nall\n";
+    anABAQUS_Output.writeRows(vertexList.size(), [&vertexList](std::size_t i, TextBuffer& line) {
+        const Base::Vector3d& node = vertexList[i].second;
+        line << vertexList[i].first << ", " << node.x << ", " << node.y << ", " << node.z << '\n';
+    });
+    header << "\n\n";
+
+    auto writeElements = [&anABAQUS_Output](const NodesList& elements) {
+        anABAQUS_Output.writeRows(elements.size(), [&elements](std::size_t i, TextBuffer& line) {
+            line << elements[i].first;
+            // Calculix allows max 16 entries in one line, a hexa20 has more !
+            const std::vector<int>& nodes = elements[i].second;
+            for (std::size_t ct = 0; ct < nodes.size(); ++ct) {
+                if (ct < 15) {
+                    line << ", " << nodes[ct];
+                }
+                else {
+                    if (ct == 15) {
+                        line << ",\n";
+                    }
+                    line << nodes[ct] << ", ";
+                }
+            }
+            line << '\n';
+        });
+    };
 
     // write volumes to file
     std::string elsetname;
     if (!elementsMapVol.empty()) {
         for (ElementsMap::iterator it = elementsMapVol.begin(); it != elementsMapVol.end(); ++it) {
-            anABAQUS_Output << "** Volume elements" << std::endl;
-            anABAQUS_Output << "*Element, TYPE=" << it->first << ", ELSET=Evolumes" << std::endl;
-            for (NodesMap::iterator jt = it->second.begin(); jt != it->second.end(); ++jt) {
-                anABAQUS_Output << jt->first;
-                // Calculix allows max 16 entries in one line, a hexa20 has more !
-                int ct = 0;  // counter
-                bool first_line = true;
-                for (std::vector<int>::iterator kt = jt->second.begin(); kt != jt->second.end();
-                     ++kt, ++ct) {
-                    if (ct < 15) {
-                        anABAQUS_Output  << ", " << *kt;
-                    }
-                    else {
-                        if (first_line) {
-                            anABAQUS_Output << "," << std::endl;
-                            first_line = false;
-                        }
-                        anABAQUS_Output << *kt << ", ";
-                    }
-                }
-                anABAQUS_Output << std::endl;
-            }
+            header << "** Volume elements\n";
+            header << "*Element, TYPE=" << it->first << ", ELSET=Evolumes\n";
+            writeElements(it->second);
         }
         elsetname += "Evolumes";
-        anABAQUS_Output << std::endl;
+        header << '\n';
     }
 
     // write faces to file
     if (!elementsMapFac.empty()) {
         for (ElementsMap::iterator it = elementsMapFac.begin(); it != elementsMapFac.end(); ++it) {
-            anABAQUS_Output << "** Face elements" << std::endl;
-            anABAQUS_Output << "*Element, TYPE=" << it->first << ", ELSET=Efaces" << std::endl;
-            for (NodesMap::iterator jt = it->second.begin(); jt != it->second.end(); ++jt) {
-                anABAQUS_Output << jt->first;
-                for (std::vector<int>::iterator kt = jt->second.begin(); kt != jt->second.end();
-                     ++kt) {
-                    anABAQUS_Output << ", " << *kt;
-                }
-                anABAQUS_Output << std::endl;
-            }
+            header << "** Face elements\n";
+            header << "*Element, TYPE=" << it->first << ", ELSET=Efaces\n";
+            writeElements(it->second);
         }
         if (elsetname.empty())
             elsetname += "Efaces";
         else
             elsetname += ", Efaces";
-        anABAQUS_Output << std::endl;
+        header << '\n';
     }
 
     // write edges to file
     if (!elementsMapEdg.empty()) {
         for (ElementsMap::iterator it = elementsMapEdg.begin(); it != elementsMapEdg.end(); ++it) {
-            anABAQUS_Output << "** Edge elements" << std::endl;
-            anABAQUS_Output << "*Element, TYPE=" << it->first << ", ELSET=Eedges" << std::endl;
-            for (NodesMap::iterator jt = it->second.begin(); jt != it->second.end(); ++jt) {
-                anABAQUS_Output << jt->first;
-                for (std::vector<int>::iterator kt = jt->second.begin(); kt != jt->second.end();
-                     ++kt) {
-                    anABAQUS_Output << ", " << *kt;
-                }
-                anABAQUS_Output << std::endl;
-            }
+            header << "** Edge elements\n";
+            header << "*Element, TYPE=" << it->first << ", ELSET=Eedges\n";
+            writeElements(it->second);
         }
         if (elsetname.empty())
             elsetname += "Eedges";
         else
             elsetname += ", Eedges";
-        anABAQUS_Output << std::endl;
+        header << '\n';
     }
 
     // write elset Eall
-    anABAQUS_Output << "** Define element set Eall" << std::endl;
-    anABAQUS_Output << "*ELSET, ELSET=Eall" << std::endl;
-    anABAQUS_Output << elsetname << std::endl;
+    header << "** Define element set Eall\n";
+    header << "*ELSET, ELSET=Eall\n";
+    header << elsetname << '\n';
 
     // groups
-    if (!groupParam) {
-        anABAQUS_Output.close();
-    }
-    else {
+    if (groupParam) {
         // get and write group data
-        anABAQUS_Output  << std::endl << "** Group data" << std::endl;
+        header << "\n** Group data\n";
 
         std::list<int> groupIDs = myMesh->GetGroupIds();
         for (std::list<int>::iterator it = groupIDs.begin(); it != groupIDs.end(); ++it) {
@@ -2311,32 +2529,34 @@ void FemMesh::writeABAQUS(const std::string &Filename, int elemParam, bool group
                 default                     : groupElementType = "Unknown"; break;
             }
             const char* groupName = myMesh->GetGroup(*it)->GetName();
-            anABAQUS_Output << "** GroupID: " << (*it) << " --> GroupName: " << groupName
-                            << " --> GroupElementType: " << groupElementType << std::endl;
+            header << "** GroupID: " << (*it) << " --> GroupName: " << groupName
+                   << " --> GroupElementType: " << groupElementType << '\n';
 
             if (aElementType == SMDSAbs_Node) {
-                anABAQUS_Output << "*NSET, NSET=" << groupName << std::endl;
+                header << "*NSET, NSET=" << groupName << '\n';
             }
             else {
-                anABAQUS_Output << "*ELSET, ELSET=" << groupName << std::endl;
+                header << "*ELSET, ELSET=" << groupName << '\n';
             }
 
             // get and write group elements
-            std::set<int> ids;
+            std::vector<int> ids;
             SMDS_ElemIteratorPtr aElemIter = myMesh->GetGroup(*it)->GetGroupDS()->GetElements();
             while (aElemIter->more()) {
                 const SMDS_MeshElement* aElement = aElemIter->next();
-                ids.insert(aElement->GetID());
-            }
-            for (std::set<int>::iterator it = ids.begin(); it != ids.end(); ++it) {
-                anABAQUS_Output << *it << std::endl;
+                ids.push_back(aElement->GetID());
             }
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            anABAQUS_Output.writeRows(ids.size(), [&ids](std::size_t i, TextBuffer& line) {
+                line << ids[i] << '\n';
+            });
 
             // write newline after each group
-            anABAQUS_Output << std::endl;
+            header << '\n';
         }
-        anABAQUS_Output.close();
     }
+    anABAQUS_Output.close();
 }
 
 
@@ -2429,12 +2649,49 @@ unsigned int FemMesh::getMemSize () const
     return 0;
 }
 
+//! Writes the mesh in the UNV format next to the binary file, see FemMesh::Save()
+class FemMesh::UNVFile : public Base::Persistence
+{
+public:
+    explicit UNVFile(const FemMesh* mesh)
+        : mesh(mesh)
+    {}
+    unsigned int getMemSize () const override
+    {
+        return 0;
+    }
+    void Save (Base::Writer &/*writer*/) const override
+    {}
+    void Restore(Base::XMLReader &/*reader*/) override
+    {}
+    void SaveDocFile (Base::Writer &writer) const override
+    {
+        mesh->saveUNV(writer);
+    }
+
+private:
+    const FemMesh* mesh;
+};
+
+/*! Versions before the binary format expect the UNV file named by the attribute
+ * 'file' and load an empty mesh from FemMesh.bin. If the preference SaveUNVFallback
+ * is set, the mesh is also written as FemMesh.unv, 'file' names this copy and the
+ * attribute 'binary' the binary file, which older versions ignore.
+ */
 void FemMesh::Save (Base::Writer &writer) const
 {
     if (!writer.isForceXML()) {
         //See SaveDocFile(), RestoreDocFile()
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Mod/Fem/General");
         writer.Stream() << writer.ind() << "<FemMesh file=\"";
-        writer.Stream() << writer.addFile("FemMesh.unv", this) << "\"";
+        if (hGrp->GetBool("SaveUNVFallback", false)) {
+            if (!unvFile) {
+                unvFile = std::make_shared<UNVFile>(this);
+            }
+            writer.Stream() << writer.addFile("FemMesh.unv", unvFile.get()) << "\" binary=\"";
+        }
+        writer.Stream() << writer.addFile("FemMesh.bin", this) << "\"";
         writer.Stream() << " a11=\"" << _Mtrx[0][0] << "\" a12=\"" << _Mtrx[0][1] << "\" a13=\""
                         << _Mtrx[0][2] << "\" a14=\"" << _Mtrx[0][3] << "\"";
         writer.Stream() << " a21=\"" << _Mtrx[1][0] << "\" a22=\"" << _Mtrx[1][1] << "\" a23=\""
@@ -2463,6 +2720,10 @@ void FemMesh::Restore(Base::XMLReader &reader)
 {
     reader.readElement("FemMesh");
     std::string file (reader.getAttribute("file") );
+    // the binary file of a document with a UNV fallback, see Save()
+    if (reader.hasAttribute("binary")) {
+        file = reader.getAttribute("binary");
+    }
 
     if (!file.empty()) {
         // initiate a file read
@@ -2491,7 +2752,345 @@ void FemMesh::Restore(Base::XMLReader &reader)
     }
 }
 
+namespace {
+
+// header of the binary mesh format
+const uint32_t BinaryMeshMagic = 0x464D4553;
+const uint32_t BinaryMeshVersion = 1;
+
+void writeString(Base::OutputStream& str, std::ostream& out, const std::string& text)
+{
+    str << static_cast<uint32_t>(text.size());
+    out.write(text.data(), text.size());
+}
+
+std::string readString(Base::InputStream& str, std::istream& in)
+{
+    uint32_t size = 0;
+    str >> size;
+    std::string text(size, '\0');
+    in.read(&text[0], size);
+    return text;
+}
+
+// Element kinds of the binary mesh format. The values are part of the format and must
+// not change. The raw values of SMDSAbs_EntityType can't be stored because they differ
+// between SMESH versions.
+enum ElementKind : int32_t
+{
+    KindNode = 0,
+    Kind0D = 1,
+    KindEdge = 2,
+    KindFace = 3,
+    KindPolygon = 4,
+    KindQuadPolygon = 5,
+    KindVolume = 6,
+    KindPolyhedron = 7,
+    KindBall = 8,
+    KindAll = 9
+};
+
+int32_t kindOfType(SMDSAbs_ElementType type)
+{
+    switch (type) {
+    case SMDSAbs_Node:
+        return KindNode;
+    case SMDSAbs_0DElement:
+        return Kind0D;
+    case SMDSAbs_Edge:
+        return KindEdge;
+    case SMDSAbs_Face:
+        return KindFace;
+    case SMDSAbs_Volume:
+        return KindVolume;
+    case SMDSAbs_Ball:
+        return KindBall;
+    default:
+        return KindAll;
+    }
+}
+
+int32_t kindOfElement(const SMDS_MeshElement* elem)
+{
+    switch (elem->GetEntityType()) {
+    case SMDSEntity_Polygon:
+        return KindPolygon;
+    case SMDSEntity_Quad_Polygon:
+        return KindQuadPolygon;
+    case SMDSEntity_Polyhedra:
+        return KindPolyhedron;
+    default:
+        return kindOfType(elem->GetType());
+    }
+}
+
+SMDSAbs_ElementType typeOfKind(int32_t kind)
+{
+    switch (kind) {
+    case KindNode:
+        return SMDSAbs_Node;
+    case Kind0D:
+        return SMDSAbs_0DElement;
+    case KindEdge:
+        return SMDSAbs_Edge;
+    case KindFace:
+    case KindPolygon:
+    case KindQuadPolygon:
+        return SMDSAbs_Face;
+    case KindVolume:
+    case KindPolyhedron:
+        return SMDSAbs_Volume;
+    case KindBall:
+        return SMDSAbs_Ball;
+    case KindAll:
+        return SMDSAbs_All;
+    default:
+        throw Base::BadFormatError("FemMesh::RestoreDocFile: unknown element kind");
+    }
+}
+
+}
+
+/*! The mesh is written in a binary format of arrays:
+ * the node IDs and coordinates, then the IDs, kinds, node counts and node IDs of the
+ * elements followed by the face counts and face node counts of the polyhedra and the
+ * diameters of the balls, and finally the groups with their names, kinds and element IDs.
+ * The element kinds are the fixed codes of ElementKind.
+ *
+ * Versions before the binary format can't read it, unless the UNV fallback is
+ * enabled, see Save().
+ */
 void FemMesh::SaveDocFile (Base::Writer &writer) const
+{
+    const SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    std::ostream& out = writer.Stream();
+    Base::OutputStream str(out);
+    str << BinaryMeshMagic << BinaryMeshVersion;
+
+    std::vector<int32_t> nodeIds;
+    std::vector<double> coords;
+    nodeIds.reserve(meshDS->NbNodes());
+    coords.reserve(3 * meshDS->NbNodes());
+    SMDS_NodeIteratorPtr aNodeIter = meshDS->nodesIterator();
+    while (aNodeIter->more()) {
+        const SMDS_MeshNode* aNode = aNodeIter->next();
+        nodeIds.push_back(aNode->GetID());
+        coords.push_back(aNode->X());
+        coords.push_back(aNode->Y());
+        coords.push_back(aNode->Z());
+    }
+    str << static_cast<uint32_t>(nodeIds.size());
+    str.write(nodeIds.data(), nodeIds.size());
+    str.write(coords.data(), coords.size());
+
+    std::vector<int32_t> elemIds, kinds, nodeCounts, connectivity;
+    std::vector<int32_t> faceCounts, faceNodeCounts;
+    std::vector<double> diameters;
+    SMDS_ElemIteratorPtr aElemIter = meshDS->elementsIterator();
+    while (aElemIter->more()) {
+        const SMDS_MeshElement* elem = aElemIter->next();
+        if (elem->GetType() == SMDSAbs_Node) {
+            continue;
+        }
+        elemIds.push_back(elem->GetID());
+        kinds.push_back(kindOfElement(elem));
+        nodeCounts.push_back(elem->NbNodes());
+        SMDS_ElemIteratorPtr nIt = elem->nodesIterator();
+        while (nIt->more()) {
+            connectivity.push_back(nIt->next()->GetID());
+        }
+
+        if (elem->GetEntityType() == SMDSEntity_Polyhedra) {
+#if SMESH_VERSION_MAJOR >= 9
+            std::vector<int> quantities = static_cast<const SMDS_MeshVolume*>(elem)->GetQuantities();
+#else
+            std::vector<int> quantities = static_cast<const SMDS_VtkVolume*>(elem)->GetQuantities();
+#endif
+            faceCounts.push_back(quantities.size());
+            faceNodeCounts.insert(faceNodeCounts.end(), quantities.begin(), quantities.end());
+        }
+        else if (elem->GetEntityType() == SMDSEntity_Ball) {
+            diameters.push_back(static_cast<const SMDS_BallElement*>(elem)->GetDiameter());
+        }
+    }
+    str << static_cast<uint32_t>(elemIds.size());
+    str.write(elemIds.data(), elemIds.size());
+    str.write(kinds.data(), kinds.size());
+    str.write(nodeCounts.data(), nodeCounts.size());
+    str << static_cast<uint32_t>(connectivity.size());
+    str.write(connectivity.data(), connectivity.size());
+    str << static_cast<uint32_t>(faceCounts.size()) << static_cast<uint32_t>(faceNodeCounts.size());
+    str.write(faceCounts.data(), faceCounts.size());
+    str.write(faceNodeCounts.data(), faceNodeCounts.size());
+    str << static_cast<uint32_t>(diameters.size());
+    str.write(diameters.data(), diameters.size());
+
+    std::vector<SMESH_Group*> groups;
+    SMESH_Mesh::GroupIteratorPtr gIt = myMesh->GetGroups();
+    while (gIt->more()) {
+        groups.push_back(gIt->next());
+    }
+    str << static_cast<uint32_t>(groups.size());
+    for (SMESH_Group* group : groups) {
+        const SMESHDS_GroupBase* groupDS = group->GetGroupDS();
+        std::vector<int32_t> ids;
+        SMDS_ElemIteratorPtr eIt = groupDS->GetElements();
+        while (eIt->more()) {
+            ids.push_back(eIt->next()->GetID());
+        }
+        writeString(str, out, group->GetName());
+        str << kindOfType(groupDS->GetType()) << static_cast<uint32_t>(ids.size());
+        str.write(ids.data(), ids.size());
+    }
+}
+
+void FemMesh::RestoreDocFile(Base::Reader &reader)
+{
+    // documents of older versions contain the mesh in the UNV format
+    if (Base::FileInfo(reader.getFileName()).hasExtension("unv")) {
+        restoreUNV(reader);
+        return;
+    }
+
+    SMESHDS_Mesh* meshDS = myMesh->GetMeshDS();
+    Base::InputStream str(reader);
+    uint32_t magic = 0, version = 0;
+    str >> magic >> version;
+    if (magic != BinaryMeshMagic || version > BinaryMeshVersion) {
+        throw Base::BadFormatError("FemMesh::RestoreDocFile: unknown mesh format");
+    }
+
+    uint32_t count = 0;
+    str >> count;
+    std::vector<int32_t> nodeIds(count);
+    std::vector<double> coords(3 * size_t(count));
+    str.read(nodeIds.data(), nodeIds.size());
+    str.read(coords.data(), coords.size());
+    for (size_t i = 0; i < nodeIds.size(); i++) {
+        meshDS->AddNodeWithID(coords[3 * i], coords[3 * i + 1], coords[3 * i + 2], nodeIds[i]);
+    }
+
+    str >> count;
+    std::vector<int32_t> elemIds(count), kinds(count), nodeCounts(count);
+    str.read(elemIds.data(), elemIds.size());
+    str.read(kinds.data(), kinds.size());
+    str.read(nodeCounts.data(), nodeCounts.size());
+    str >> count;
+    std::vector<int32_t> connectivity(count);
+    str.read(connectivity.data(), connectivity.size());
+    uint32_t faceCount = 0, faceNodeCount = 0;
+    str >> faceCount >> faceNodeCount;
+    std::vector<int32_t> faceCounts(faceCount), faceNodeCounts(faceNodeCount);
+    str.read(faceCounts.data(), faceCounts.size());
+    str.read(faceNodeCounts.data(), faceNodeCounts.size());
+    str >> count;
+    std::vector<double> diameters(count);
+    str.read(diameters.data(), diameters.size());
+    if (!reader) {
+        throw Base::BadFormatError("FemMesh::RestoreDocFile: truncated mesh data");
+    }
+
+    size_t total = 0;
+    for (int32_t nodeCount : nodeCounts) {
+        total += nodeCount;
+    }
+    if (total != connectivity.size()) {
+        throw Base::BadFormatError("FemMesh::RestoreDocFile: inconsistent element data");
+    }
+
+    // look up the nodes of all elements concurrently, adding the elements to the mesh
+    // can only be done one by one
+    std::vector<const SMDS_MeshNode*> elemNodes(connectivity.size());
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < static_cast<long>(connectivity.size()); ++i) {
+        elemNodes[i] = meshDS->FindNode(connectivity[i]);
+    }
+
+    SMESH_MeshEditor editor(myMesh);
+    std::vector<const SMDS_MeshNode*> nodes;
+    size_t offset = 0, polyhedron = 0, faceOffset = 0, ball = 0;
+    for (size_t i = 0; i < elemIds.size(); i++) {
+        nodes.assign(elemNodes.begin() + offset, elemNodes.begin() + offset + nodeCounts[i]);
+        offset += nodeCounts[i];
+        bool missingNode = std::find(nodes.begin(), nodes.end(), nullptr) != nodes.end();
+
+        switch (kinds[i]) {
+        case KindPolyhedron:
+        {
+            if (polyhedron >= faceCounts.size()
+                || faceOffset + faceCounts[polyhedron] > faceNodeCounts.size()) {
+                throw Base::BadFormatError("FemMesh::RestoreDocFile: inconsistent polyhedra");
+            }
+            std::vector<int> quantities(faceNodeCounts.begin() + faceOffset,
+                faceNodeCounts.begin() + faceOffset + faceCounts[polyhedron]);
+            faceOffset += faceCounts[polyhedron++];
+            if (!missingNode) {
+                meshDS->AddPolyhedralVolumeWithID(nodes, quantities, elemIds[i]);
+            }
+            break;
+        }
+        case KindBall:
+        {
+            if (ball >= diameters.size()) {
+                throw Base::BadFormatError("FemMesh::RestoreDocFile: inconsistent balls");
+            }
+            double diameter = diameters[ball++];
+            if (!missingNode) {
+                SMESH_MeshEditor::ElemFeatures elemFeat;
+                elemFeat.Init(diameter);
+                elemFeat.SetID(elemIds[i]);
+                editor.AddElement(nodes, elemFeat);
+            }
+            break;
+        }
+        default:
+            if (!missingNode) {
+                bool isPoly = kinds[i] == KindPolygon || kinds[i] == KindQuadPolygon;
+                SMESH_MeshEditor::ElemFeatures elemFeat(typeOfKind(kinds[i]), isPoly,
+                                                        kinds[i] == KindQuadPolygon);
+                elemFeat.SetID(elemIds[i]);
+                editor.AddElement(nodes, elemFeat);
+            }
+            break;
+        }
+        if (missingNode) {
+            Base::Console().Warning("FemMesh::RestoreDocFile: element %d refers to a missing node\n",
+                                    elemIds[i]);
+        }
+    }
+
+    str >> count;
+    for (uint32_t g = 0; g < count && reader; g++) {
+        std::string name = readString(str, reader);
+        int32_t kind = 0;
+        uint32_t size = 0;
+        str >> kind >> size;
+        std::vector<int32_t> ids(size);
+        str.read(ids.data(), ids.size());
+
+        int aId = -1;
+        SMDSAbs_ElementType groupType = typeOfKind(kind);
+        SMESH_Group* group = myMesh->AddGroup(groupType, name.c_str(), aId);
+        SMESHDS_Group* groupDS = dynamic_cast<SMESHDS_Group*>(group->GetGroupDS());
+        if (!groupDS) {
+            continue;
+        }
+        SMDS_MeshGroup& smdsGroup = groupDS->SMDSGroup();
+        for (int32_t id : ids) {
+            const SMDS_MeshElement* elem = groupType == SMDSAbs_Node
+                ? static_cast<const SMDS_MeshElement*>(meshDS->FindNode(id))
+                : meshDS->FindElement(id);
+            if (elem) {
+                smdsGroup.Add(elem);
+            }
+        }
+    }
+
+    meshDS->Modified();
+    nodeIndex.reset();
+}
+
+void FemMesh::saveUNV(Base::Writer &writer) const
 {
     // create a temporary file and copy the content to the zip stream
     Base::FileInfo fi(App::Application::getTempFileName().c_str());
@@ -2509,7 +3108,7 @@ void FemMesh::SaveDocFile (Base::Writer &writer) const
     fi.deleteFile();
 }
 
-void FemMesh::RestoreDocFile(Base::Reader &reader)
+void FemMesh::restoreUNV(Base::Reader &reader)
 {
     // create a temporary file and copy the content from the zip stream
     Base::FileInfo fi(App::Application::getTempFileName().c_str());
@@ -2522,6 +3121,7 @@ void FemMesh::RestoreDocFile(Base::Reader &reader)
 
     // read the shape from the temp file
     myMesh->UNVToMesh(fi.filePath().c_str());
+    nodeIndex.reset();
 
     // delete the temp file
     fi.deleteFile();
@@ -2539,6 +3139,7 @@ void FemMesh::transformGeometry(const Base::Matrix4D& rclTrf)
         current_node = clMatrix * current_node;
         myMesh->GetMeshDS()->MoveNode(aNode,current_node.x,current_node.y,current_node.z);
     }
+    nodeIndex.reset();
 }
 
 void FemMesh::setTransform(const Base::Matrix4D& rclTrf)
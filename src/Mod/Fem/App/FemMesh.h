@@ -38,6 +38,7 @@
 class SMESH_Gen;
 class SMESH_Mesh;
 class SMESH_Hypothesis;
+class Bnd_Box;
 class TopoDS_Shape;
 class TopoDS_Face;
 class TopoDS_Edge;
@@ -95,14 +96,14 @@ public:
     //@{
     /// retrieving by region growing
     std::set<long> getSurfaceNodes(long ElemId, short FaceId, float Angle=360)const;
-    /// retrieving by solid
-    std::set<int> getNodesBySolid(const TopoDS_Solid &solid) const;
-    /// retrieving by face
-    std::set<int> getNodesByFace(const TopoDS_Face &face) const;
-    /// retrieving by edge
-    std::set<int> getNodesByEdge(const TopoDS_Edge &edge) const;
-    /// retrieving by vertex
-    std::set<int> getNodesByVertex(const TopoDS_Vertex &vertex) const;
+    /// retrieving by solid, the node IDs are sorted
+    std::vector<int> getNodesBySolid(const TopoDS_Solid &solid) const;
+    /// retrieving by face, the node IDs are sorted
+    std::vector<int> getNodesByFace(const TopoDS_Face &face) const;
+    /// retrieving by edge, the node IDs are sorted
+    std::vector<int> getNodesByEdge(const TopoDS_Edge &edge) const;
+    /// retrieving by vertex, the node IDs are sorted
+    std::vector<int> getNodesByVertex(const TopoDS_Vertex &vertex) const;
     /// retrieving node IDs by element ID
     std::list<int> getElementNodes(int id) const;
     /// retrieving elements IDs by node ID
@@ -179,6 +180,14 @@ private:
     void readNastran95(const std::string &Filename);
     void readZ88(const std::string &Filename);
     void readAbaqus(const std::string &Filename);
+    void restoreUNV(Base::Reader &reader);
+    void saveUNV(Base::Writer &writer) const;
+
+    class NodeIndex;
+    const NodeIndex& getNodeIndex() const;
+    class UNVFile;
+    /// the IDs and absolute positions of the nodes inside the box
+    std::vector<std::pair<int, Base::Vector3d>> getNodesInBox(const Bnd_Box& box) const;
 
 private:
     /// positioning matrix
@@ -187,6 +196,10 @@ private:
 
     std::list<SMESH_HypothesisPtr> hypoth;
     static SMESH_Gen *_mesh_gen;
+    /// spatial index of the nodes, built on demand
+    mutable std::shared_ptr<NodeIndex> nodeIndex;
+    /// writes the UNV copy of the mesh for older versions, see Save()
+    mutable std::shared_ptr<UNVFile> unvFile;
 };
 
 } //namespace Part
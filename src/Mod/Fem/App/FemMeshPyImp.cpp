@@ -810,9 +810,9 @@ PyObject* FemMeshPy::getNodesBySolid(PyObject *args)
             return nullptr;
         }
         Py::List ret;
-        std::set<int> resultSet = getFemMeshPtr()->getNodesBySolid(fc);
-        for (std::set<int>::const_iterator it = resultSet.begin();it!=resultSet.end();++it)
-            ret.append(Py::Long(*it));
+        std::vector<int> resultSet = getFemMeshPtr()->getNodesBySolid(fc);
+        for (int id : resultSet)
+            ret.append(Py::Long(id));
 
         return Py::new_reference_to(ret);
 
@@ -837,9 +837,9 @@ PyObject* FemMeshPy::getNodesByFace(PyObject *args)
             return nullptr;
         }
         Py::List ret;
-        std::set<int> resultSet = getFemMeshPtr()->getNodesByFace(fc);
-        for (std::set<int>::const_iterator it = resultSet.begin();it!=resultSet.end();++it)
-            ret.append(Py::Long(*it));
+        std::vector<int> resultSet = getFemMeshPtr()->getNodesByFace(fc);
+        for (int id : resultSet)
+            ret.append(Py::Long(id));
 
         return Py::new_reference_to(ret);
 
@@ -864,9 +864,9 @@ PyObject* FemMeshPy::getNodesByEdge(PyObject *args)
             return nullptr;
         }
         Py::List ret;
-        std::set<int> resultSet = getFemMeshPtr()->getNodesByEdge(fc);
-        for (std::set<int>::const_iterator it = resultSet.begin();it!=resultSet.end();++it)
-            ret.append(Py::Long(*it));
+        std::vector<int> resultSet = getFemMeshPtr()->getNodesByEdge(fc);
+        for (int id : resultSet)
+            ret.append(Py::Long(id));
 
         return Py::new_reference_to(ret);
 
@@ -891,9 +891,9 @@ PyObject* FemMeshPy::getNodesByVertex(PyObject *args)
             return nullptr;
         }
         Py::List ret;
-        std::set<int> resultSet = getFemMeshPtr()->getNodesByVertex(fc);
-        for (std::set<int>::const_iterator it = resultSet.begin();it!=resultSet.end();++it)
-            ret.append(Py::Long(*it));
+        std::vector<int> resultSet = getFemMeshPtr()->getNodesByVertex(fc);
+        for (int id : resultSet)
+            ret.append(Py::Long(id));
 
         return Py::new_reference_to(ret);
 
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <charconv>
+# include <cstdio>
+# include <thread>
+#endif
+
+#include <Base/Exception.h>
+
+#include "FemTextWriter.h"
+
+
+using namespace Fem;
+
+TextBuffer::TextBuffer(int precision)
+  : precision(precision)
+{
+}
+
+TextBuffer& TextBuffer::operator<<(const char* text)
+{
+    buffer += text;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(const std::string& text)
+{
+    buffer += text;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(char c)
+{
+    buffer += c;
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(int value)
+{
+    char text[16];
+    auto res = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, res.ptr);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(unsigned long value)
+{
+    char text[24];
+    auto res = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, res.ptr);
+    return *this;
+}
+
+TextBuffer& TextBuffer::operator<<(double value)
+{
+    // the same as writing to an iostream with the precision set
+    char text[32];
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(text, text + sizeof(text), value,
+                             std::chars_format::general, precision);
+    buffer.append(text, res.ptr);
+#else
+    int len = std::snprintf(text, sizeof(text), "%.*g", precision, value);
+    buffer.append(text, len);
+#endif
+    return *this;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::size_t TextBlockWriter::RowsPerChunk = 8192;
+
+TextBlockWriter::TextBlockWriter(const Base::FileInfo& fi, int precision)
+  : file(fi)
+  , header(precision)
+{
+    if (!file) {
+        throw Base::FileException("Cannot open file for writing", fi);
+    }
+
+    // a few chunks per thread so that the threads stay busy while the chunks
+    // of one round take different times to format
+    std::size_t count = 4 * std::max(1U, std::thread::hardware_concurrency());
+    chunks.resize(count, TextBuffer(precision));
+}
+
+TextBlockWriter::~TextBlockWriter() = default;
+
+void TextBlockWriter::write()
+{
+    if (header.size() > 0) {
+        file.write(header.str().data(), header.size());
+        header.clear();
+    }
+}
+
+void TextBlockWriter::writeChunks(std::size_t count)
+{
+    for (std::size_t c = 0; c < count; ++c) {
+        file.write(chunks[c].str().data(), chunks[c].size());
+    }
+    if (!file) {
+        throw Base::FileException("Failed to write mesh file");
+    }
+}
+
+void TextBlockWriter::close()
+{
+    write();
+    file.close();
+}
@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                        *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef FEM_TEXTWRITER_H
+#define FEM_TEXTWRITER_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+#include <Mod/Fem/FemGlobal.h>
+
+
+namespace Fem
+{
+
+/*!
+ A text buffer to format the lines of mesh files. Numbers are formatted without
+ iostreams, floating point numbers like an iostream with the given precision.
+ */
+class FemExport TextBuffer
+{
+public:
+    explicit TextBuffer(int precision = 13);
+
+    TextBuffer& operator<<(const char* text);
+    TextBuffer& operator<<(const std::string& text);
+    TextBuffer& operator<<(char c);
+    TextBuffer& operator<<(int value);
+    TextBuffer& operator<<(unsigned long value);
+    TextBuffer& operator<<(double value);
+
+    const std::string& str() const
+    {
+        return buffer;
+    }
+    void clear()
+    {
+        buffer.clear();
+    }
+    std::size_t size() const
+    {
+        return buffer.size();
+    }
+
+private:
+    std::string buffer;
+    int precision;
+};
+
+/*!
+ Writes mesh files of text formats like the Abaqus inp format. Large blocks of lines,
+ e.g. nodes or elements, are formatted in chunks in parallel and written to the file
+ in their order, a chunk at a time.
+ */
+class FemExport TextBlockWriter
+{
+public:
+    explicit TextBlockWriter(const Base::FileInfo& fi, int precision = 13);
+    ~TextBlockWriter();
+
+    /// the buffer of the lines written with write()
+    TextBuffer& buffer()
+    {
+        return header;
+    }
+    /// writes the content of buffer() to the file
+    void write();
+    /*!
+     Writes the lines of a block of \a count rows. For each row \a format is called
+     with the row index and the buffer to append the row to. \a format is called
+     concurrently for different rows.
+     */
+    template<typename Func>
+    void writeRows(std::size_t count, Func format);
+    void close();
+
+private:
+    void writeChunks(std::size_t count);
+
+private:
+    Base::ofstream file;
+    TextBuffer header;
+    std::vector<TextBuffer> chunks;
+    static const std::size_t RowsPerChunk;
+};
+
+template<typename Func>
+void TextBlockWriter::writeRows(std::size_t count, Func format)
+{
+    write();
+    std::size_t chunkCount = chunks.size();
+    std::size_t roundSize = chunkCount * RowsPerChunk;
+    for (std::size_t start = 0; start < count; start += roundSize) {
+        std::size_t end = std::min(count, start + roundSize);
+        long used = static_cast<long>((end - start + RowsPerChunk - 1) / RowsPerChunk);
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long c = 0; c < used; ++c) {
+            TextBuffer& chunk = chunks[c];
+            chunk.clear();
+            std::size_t first = start + c * RowsPerChunk;
+            std::size_t last = std::min(end, first + RowsPerChunk);
+            for (std::size_t row = first; row < last; ++row) {
+                format(row, chunk);
+            }
+        }
+
+        writeChunks(used);
+    }
+}
+
+} //namespace Fem
+
+
+#endif // FEM_TEXTWRITER_H
@@ -78,6 +78,7 @@ DlgSettingsFemGeneralImp::~DlgSettingsFemGeneralImp()
 void DlgSettingsFemGeneralImp::saveSettings()
 {
     ui->cb_analysis_group_meshing->onSave();
+    ui->cb_save_unv_fallback->onSave();
 
     ui->cb_restore_result_dialog->onSave();
     ui->cb_keep_results_on_rerun->onSave();
@@ -94,6 +95,7 @@ void DlgSettingsFemGeneralImp::saveSettings()
 void DlgSettingsFemGeneralImp::loadSettings()
 {
     ui->cb_analysis_group_meshing->onRestore();
+    ui->cb_save_unv_fallback->onRestore();
 
     ui->cb_restore_result_dialog->onRestore();
     ui->cb_keep_results_on_rerun->onRestore();
@@ -220,6 +220,55 @@ class TestMeshCommon(unittest.TestCase):
             )
         )
 
+    # ********************************************************************************************
+    def test_nodes_by_shape(
+        self
+    ):
+        import Part
+        # a grid of nodes with a spacing of 1 mm, partly inside of a 4 mm box
+        grid = Fem.FemMesh()
+        node_id = 1
+        points = {}
+        for x in range(-2, 7):
+            for y in range(-2, 7):
+                for z in range(-2, 7):
+                    grid.addNode(x, y, z, node_id)
+                    points[node_id] = FreeCAD.Vector(x, y, z)
+                    node_id += 1
+        box = Part.makeBox(4, 4, 4)
+
+        def expected(condition):
+            return sorted(i for i, p in points.items() if condition(p))
+
+        self.assertEqual(
+            grid.getNodesByFace(box.Faces[0]),  # the face at x = 0
+            expected(lambda p: p.x == 0 and 0 <= p.y <= 4 and 0 <= p.z <= 4),
+            "Nodes of the face are unexpected"
+        )
+        self.assertEqual(
+            grid.getNodesByEdge(box.Edges[0]),  # the edge at x = 0, y = 0
+            expected(lambda p: p.x == 0 and p.y == 0 and 0 <= p.z <= 4),
+            "Nodes of the edge are unexpected"
+        )
+        self.assertEqual(
+            grid.getNodesByVertex(box.Vertexes[0]),
+            expected(lambda p: p.x == 0 and p.y == 0 and p.z == 0),
+            "Nodes of the vertex are unexpected"
+        )
+        self.assertEqual(
+            grid.getNodesBySolid(box.Solids[0]),
+            expected(lambda p: 0 <= p.x <= 4 and 0 <= p.y <= 4 and 0 <= p.z <= 4),
+            "Nodes of the solid are unexpected"
+        )
+
+        # the node positions follow the placement of the mesh
+        grid.Placement = FreeCAD.Placement(FreeCAD.Vector(1, 0, 0), FreeCAD.Rotation())
+        self.assertEqual(
+            grid.getNodesByFace(box.Faces[0]),
+            expected(lambda p: p.x == -1 and 0 <= p.y <= 4 and 0 <= p.z <= 4),
+            "Nodes of the face of the moved mesh are unexpected"
+        )
+
 
 # ************************************************************************************************
 # ************************************************************************************************
@@ -703,3 +752,123 @@ class TestMeshGroups(unittest.TestCase):
                 format(elements_to_be_added, elements_returned)
             )
         )
+
+    def test_document_save_restore(self):
+        """
+        Save a document with a mesh with groups and check that the
+        restored mesh has the same nodes, elements and groups.
+        """
+        from femexamples.meshes.mesh_canticcx_tetra10 import create_elements
+        from femexamples.meshes.mesh_canticcx_tetra10 import create_nodes
+
+        fm = Fem.FemMesh()
+        create_nodes(fm)
+        create_elements(fm)
+        node_group = fm.addGroup("MyNodeGroup", "Node")
+        fm.addGroupElements(node_group, [1, 2, 3, 4])
+        volume_group = fm.addGroup("MyVolumeGroup", "Volume")
+        fm.addGroupElements(volume_group, list(fm.Volumes[:5]))
+
+        mesh_obj = self.document.addObject("Fem::FemMeshObject", "Mesh")
+        mesh_obj.FemMesh = fm
+
+        file_path = join(
+            testtools.get_fem_test_tmp_dir("mesh_groups_save_restore"),
+            "mesh_save_restore.FCStd"
+        )
+        self.document.saveAs(file_path)
+        FreeCAD.closeDocument(self.document.Name)
+        self.document = FreeCAD.open(file_path)
+        restored = self.document.Mesh.FemMesh
+
+        self.assertEqual(fm.NodeCount, restored.NodeCount)
+        self.assertEqual(fm.Nodes, restored.Nodes)
+        self.assertEqual(fm.Volumes, restored.Volumes)
+        self.assertEqual(fm.Faces, restored.Faces)
+        self.assertEqual(fm.Edges, restored.Edges)
+        for elem in fm.Volumes:
+            self.assertEqual(fm.getElementNodes(elem), restored.getElementNodes(elem))
+        self.assertEqual(
+            [(fm.getGroupName(g), fm.getGroupElementType(g), fm.getGroupElements(g))
+             for g in fm.Groups],
+            [(restored.getGroupName(g), restored.getGroupElementType(g),
+              restored.getGroupElements(g)) for g in restored.Groups]
+        )
+
+    def test_document_save_restore_element_types(self):
+        """
+        Save a document with a mesh of edges, faces and volumes and check
+        that the restored elements keep their types and nodes.
+        """
+        fm = Fem.FemMesh()
+        fm.addNode(0.0, 0.0, 0.0, 1)
+        fm.addNode(1.0, 0.0, 0.0, 2)
+        fm.addNode(1.0, 1.0, 0.0, 3)
+        fm.addNode(0.0, 1.0, 0.0, 4)
+        fm.addNode(0.0, 0.0, 1.0, 5)
+        fm.addEdge([1, 2], 1)
+        fm.addFace([1, 2, 3], 2)
+        fm.addFace([1, 2, 3, 4], 3)
+        fm.addVolume([1, 2, 4, 5], 4)
+        face_group = fm.addGroup("MyFaceGroup", "Face")
+        fm.addGroupElements(face_group, [2, 3])
+
+        mesh_obj = self.document.addObject("Fem::FemMeshObject", "Mesh")
+        mesh_obj.FemMesh = fm
+
+        file_path = join(
+            testtools.get_fem_test_tmp_dir("mesh_element_types_save_restore"),
+            "mesh_element_types.FCStd"
+        )
+        self.document.saveAs(file_path)
+        FreeCAD.closeDocument(self.document.Name)
+        self.document = FreeCAD.open(file_path)
+        restored = self.document.Mesh.FemMesh
+
+        for elem in range(1, 5):
+            self.assertEqual(fm.getElementType(elem), restored.getElementType(elem))
+            self.assertEqual(fm.getElementNodes(elem), restored.getElementNodes(elem))
+        self.assertEqual(
+            [restored.getGroupElementType(g) for g in restored.Groups],
+            ["Face"]
+        )
+
+    def test_document_save_unv_fallback(self):
+        """
+        Save a document with the UNV fallback enabled and check that it
+        contains both mesh files and restores the mesh from the binary one.
+        """
+        import zipfile
+
+        fm = Fem.FemMesh()
+        fm.addNode(0.0, 0.0, 0.0, 1)
+        fm.addNode(1.0, 0.0, 0.0, 2)
+        fm.addNode(0.0, 1.0, 0.0, 3)
+        fm.addNode(0.0, 0.0, 1.0, 4)
+        fm.addVolume([1, 2, 3, 4], 1)
+
+        mesh_obj = self.document.addObject("Fem::FemMeshObject", "Mesh")
+        mesh_obj.FemMesh = fm
+
+        file_path = join(
+            testtools.get_fem_test_tmp_dir("mesh_unv_fallback"),
+            "mesh_unv_fallback.FCStd"
+        )
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Fem/General")
+        fallback = param.GetBool("SaveUNVFallback", False)
+        param.SetBool("SaveUNVFallback", True)
+        try:
+            self.document.saveAs(file_path)
+        finally:
+            param.SetBool("SaveUNVFallback", fallback)
+
+        with zipfile.ZipFile(file_path) as archive:
+            names = archive.namelist()
+        self.assertIn("FemMesh.unv", names)
+        self.assertIn("FemMesh.bin", names)
+
+        FreeCAD.closeDocument(self.document.Name)
+        self.document = FreeCAD.open(file_path)
+        restored = self.document.Mesh.FemMesh
+        self.assertEqual(fm.Nodes, restored.Nodes)
+        self.assertEqual(fm.getElementNodes(1), restored.getElementNodes(1))
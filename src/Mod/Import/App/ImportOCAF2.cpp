@@ -44,6 +44,8 @@
 # include <XCAFDoc_ShapeTool.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <XCAFDoc_ShapeMapTool.hxx>
 
 #include <boost/format.hpp>
@@ -57,9 +59,11 @@
 #include <Base/Console.h>
 #include <Base/FileInfo.h>
 #include <Base/Parameter.h>
+#include <Base/TimeInfo.h>
 #include <Mod/Part/App/FeatureCompound.h>
 #include <Mod/Part/App/Interface.h>
 #include <Mod/Part/App/OCAF/ImportExportSettings.h>
+#include <Mod/Part/App/Tools.h>
 
 #include "ImportOCAF2.h"
 
@@ -373,70 +377,84 @@ App::DocumentObject *ImportOCAF2::expandShape(
     return info.obj;
 }
 
-bool ImportOCAF2::createObject(App::Document *doc, TDF_Label label,
-        const TopoDS_Shape &shape, Info &info, bool newDoc)
+void ImportOCAF2::readShapeData(TDF_Label label, const TopoDS_Shape &shape, ShapeData &data)
 {
-    if(shape.IsNull() || !TopExp_Explorer(shape,TopAbs_VERTEX).More()) {
-        FC_WARN(labelName(label) << " has empty shape");
-        return false;
-    }
+    data.label = label;
+    data.shape = shape;
+    data.prepared = false;
+    if(shape.IsNull())
+        return;
 
-    getColor(shape,info);
-    bool hasFaceColors = false;
-    bool hasEdgeColors = false;
-
-    Part::TopoShape tshape(shape);
-    std::vector<App::Color> faceColors;
-    std::vector<App::Color> edgeColors;
+    getColor(shape,data.info);
 
     TDF_LabelSequence seq;
-    if(!label.IsNull() && aShapeTool->GetSubShapes(label,seq)) {
+    if(label.IsNull() || !aShapeTool->GetSubShapes(label,seq))
+        return;
+    data.hasSubShapes = true;
+    for(int i=1;i<=seq.Length();++i) {
+        TDF_Label l = seq.Value(i);
+        SubShapeColor sub;
+        sub.shape = aShapeTool->GetShape(l);
+        if(sub.shape.IsNull())
+            continue;
+        Quantity_ColorRGBA aColor;
+        if(aColorTool->GetColor(l, XCAFDoc_ColorSurf, aColor) ||
+           aColorTool->GetColor(l, XCAFDoc_ColorGen, aColor))
+        {
+            sub.faceColor = convertColor(aColor);
+            sub.hasFaceColor = true;
+        }
+        if(aColorTool->GetColor(l, XCAFDoc_ColorCurv, aColor)) {
+            sub.edgeColor = convertColor(aColor);
+            sub.hasEdgeColor = true;
+        }
+        data.subColors.push_back(sub);
+    }
+}
 
+void ImportOCAF2::prepareShapeData(ShapeData &data) const
+{
+    const TopoDS_Shape &shape = data.shape;
+    data.valid = !shape.IsNull() && TopExp_Explorer(shape,TopAbs_VERTEX).More();
+    if(!data.valid) {
+        data.prepared = true;
+        return;
+    }
+
+    Info &info = data.info;
+    Part::TopoShape tshape(shape);
+    if(data.hasSubShapes) {
         TopTools_IndexedMapOfShape faceMap,edgeMap;
-        TopExp::MapShapes(tshape.getShape(), TopAbs_FACE, faceMap);
-        TopExp::MapShapes(tshape.getShape(), TopAbs_EDGE, edgeMap);
+        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
+        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
 
-        faceColors.assign(faceMap.Extent(),info.faceColor);
-        edgeColors.assign(edgeMap.Extent(),info.edgeColor);
+        data.faceColors.assign(faceMap.Extent(),info.faceColor);
+        data.edgeColors.assign(edgeMap.Extent(),info.edgeColor);
         // Two passes to get sub shape colors. First pass, look for solid, and
         // second pass look for face and edges. This allows lower level
         // subshape to override color of higher level ones.
         for(int j=0;j<2;++j) {
-            for(int i=1;i<=seq.Length();++i) {
-                TDF_Label l = seq.Value(i);
-                TopoDS_Shape subShape = aShapeTool->GetShape(l);
-                if(subShape.IsNull())
-                    continue;
+            for(auto &sub : data.subColors) {
+                const TopoDS_Shape &subShape = sub.shape;
                 if(subShape.ShapeType()==TopAbs_FACE || subShape.ShapeType()==TopAbs_EDGE) {
                     if(j==0)
                         continue;
                 }else if(j!=0)
                     continue;
 
-                bool foundFaceColor=false,foundEdgeColor=false;
-                App::Color faceColor,edgeColor;
-                Quantity_ColorRGBA aColor;
-                if(aColorTool->GetColor(l, XCAFDoc_ColorSurf, aColor) ||
-                   aColorTool->GetColor(l, XCAFDoc_ColorGen, aColor))
-                {
-                    faceColor = convertColor(aColor);
-                    foundFaceColor = true;
-                }
-                if(aColorTool->GetColor(l, XCAFDoc_ColorCurv, aColor)) {
-                    edgeColor = convertColor(aColor);
-                    foundEdgeColor = true;
-                    if(j==0 && foundFaceColor && !faceColors.empty() && edgeColor==faceColor) {
-                        // Do not set edge the same color as face
-                        foundEdgeColor = false;
-                    }
+                bool foundEdgeColor = sub.hasEdgeColor;
+                if(j==0 && foundEdgeColor && sub.hasFaceColor && !data.faceColors.empty()
+                        && sub.edgeColor==sub.faceColor) {
+                    // Do not set edge the same color as face
+                    foundEdgeColor = false;
                 }
 
-                if(foundFaceColor) {
+                if(sub.hasFaceColor) {
                     for(TopExp_Explorer exp(subShape,TopAbs_FACE);exp.More();exp.Next()) {
                         int idx = faceMap.FindIndex(exp.Current())-1;
-                        if(idx>=0 && idx<(int)faceColors.size()) {
-                            faceColors[idx] = faceColor;
-                            hasFaceColors = true;
+                        if(idx>=0 && idx<(int)data.faceColors.size()) {
+                            data.faceColors[idx] = sub.faceColor;
+                            data.hasFaceColors = true;
                             info.hasFaceColor = true;
                         }else
                             assert(0);
@@ -445,9 +463,9 @@ bool ImportOCAF2::createObject(App::Document *doc, TDF_Label label,
                 if(foundEdgeColor) {
                     for(TopExp_Explorer exp(subShape,TopAbs_EDGE);exp.More();exp.Next()) {
                         int idx = edgeMap.FindIndex(exp.Current())-1;
-                        if(idx>=0 && idx<(int)edgeColors.size()) {
-                            edgeColors[idx] = edgeColor;
-                            hasEdgeColors = true;
+                        if(idx>=0 && idx<(int)data.edgeColors.size()) {
+                            data.edgeColors[idx] = sub.edgeColor;
+                            data.hasEdgeColors = true;
                             info.hasEdgeColor = true;
                         }
                     }
@@ -456,29 +474,58 @@ bool ImportOCAF2::createObject(App::Document *doc, TDF_Label label,
         }
     }
 
+    data.expand = options.expandCompound &&
+        (tshape.countSubShapes(TopAbs_SOLID)>1 ||
+         (!tshape.countSubShapes(TopAbs_SOLID) && tshape.countSubShapes(TopAbs_SHELL)>1));
+    data.prepared = true;
+}
+
+bool ImportOCAF2::createObject(App::Document *doc, TDF_Label label,
+        const TopoDS_Shape &shape, Info &info, bool newDoc)
+{
+    // use the data prepared by loadShapes() if there is any for this label
+    ShapeData localData;
+    const ShapeData *data = &localData;
+    auto it = myShapeData.find(shape);
+    if(it != myShapeData.end() && it->second.label == label && it->second.prepared) {
+        data = &it->second;
+    }
+    else {
+        readShapeData(label,shape,localData);
+        prepareShapeData(localData);
+    }
+
+    if(!data->valid) {
+        FC_WARN(labelName(label) << " has empty shape");
+        return false;
+    }
+
+    info.faceColor = data->info.faceColor;
+    info.edgeColor = data->info.edgeColor;
+    info.hasFaceColor = data->info.hasFaceColor;
+    info.hasEdgeColor = data->info.hasEdgeColor;
+
     Part::Feature *feature;
 
     if(newDoc && (options.mode == ObjectPerDoc ||
                   options.mode == ObjectPerDir))
         doc = getDocument(doc,label);
 
-    if(options.expandCompound &&
-       (tshape.countSubShapes(TopAbs_SOLID)>1 ||
-        (!tshape.countSubShapes(TopAbs_SOLID) && tshape.countSubShapes(TopAbs_SHELL)>1)))
-    {
+    if(data->expand) {
         feature = dynamic_cast<Part::Feature*>(expandShape(doc,label,shape));
         assert(feature);
     } else {
-        feature = static_cast<Part::Feature*>(doc->addObject("Part::Feature",tshape.shapeName().c_str()));
+        feature = static_cast<Part::Feature*>(doc->addObject("Part::Feature",
+                    Part::TopoShape(shape).shapeName().c_str()));
         feature->Shape.setValue(shape);
         // feature->Visibility.setValue(false);
     }
     applyFaceColors(feature,{info.faceColor});
     applyEdgeColors(feature,{info.edgeColor});
-    if(hasFaceColors)
-        applyFaceColors(feature,faceColors);
-    if(hasEdgeColors)
-        applyEdgeColors(feature,edgeColors);
+    if(data->hasFaceColors)
+        applyFaceColors(feature,data->faceColors);
+    if(data->hasEdgeColors)
+        applyEdgeColors(feature,data->edgeColors);
 
     info.propPlacement = &feature->Placement;
     info.obj = feature;
@@ -594,17 +641,47 @@ App::DocumentObject* ImportOCAF2::loadShapes()
     myShapes.clear();
     myNames.clear();
     myCollapsedObjects.clear();
+    myShapeData.clear();
+    mySHUOColors.clear();
 
     std::vector<App::DocumentObject*> objs;
     aShapeTool->GetFreeShapes (labels);
     boost::dynamic_bitset<> vis;
     int count = 0;
+    Base::TimeInfo startTime;
+
+    // First phase: collect the unique shapes with their colors and process
+    // them concurrently
+    std::unordered_set<TopoDS_Shape, ShapeHasher> visited;
     for (Standard_Integer i=1; i <= labels.Length(); i++ ) {
         auto label = labels.Value(i);
         if(!options.importHidden && !aColorTool->IsVisible(label))
             continue;
         ++count;
+        collectShapes(aShapeTool->GetShape(label), visited);
     }
+    Base::TimeInfo readTime;
+
+    std::vector<ShapeData*> shapeData;
+    shapeData.reserve(myShapeData.size());
+    for(auto &v : myShapeData)
+        shapeData.push_back(&v.second);
+    QtConcurrent::blockingMap(shapeData, [this](ShapeData *data) {
+        try {
+            prepareShapeData(*data);
+        }
+        catch (Standard_Failure &) {
+            // processed again when creating the object to report the error
+            data->prepared = false;
+        }
+    });
+    Base::TimeInfo prepareTime;
+    Base::Console().Log("Import: %d unique shapes, read in %f s, processed in %f s\n",
+            (int)myShapeData.size(),
+            Base::TimeInfo::diffTimeF(startTime,readTime),
+            Base::TimeInfo::diffTimeF(readTime,prepareTime));
+
+    // Second phase: create the document objects
     for (Standard_Integer i=1; i <= labels.Length(); i++ ) {
         auto label = labels.Value(i);
         if(!options.importHidden && !aColorTool->IsVisible(label))
@@ -644,17 +721,51 @@ App::DocumentObject* ImportOCAF2::loadShapes()
         ret = feature;
         ret->recomputeFeature(true);
     }
+    Base::Console().Log("Import: objects created in %f s\n",
+            Base::TimeInfo::diffTimeF(prepareTime,Base::TimeInfo()));
+    myShapeData.clear();
+    mySHUOColors.clear();
     sequencer = nullptr;
     return ret;
 }
 
-void ImportOCAF2::getSHUOColors(TDF_Label label,
-        std::map<std::string,App::Color> &colors, bool appendFirst)
+void ImportOCAF2::collectShapes(const TopoDS_Shape &shape,
+        std::unordered_set<TopoDS_Shape, ShapeHasher> &visited)
 {
+    if(shape.IsNull())
+        return;
+
+    // the same traversal as loadShape() and createAssembly()
+    auto baseShape = shape.Located(TopLoc_Location());
+    if(!visited.insert(baseShape).second)
+        return;
+    auto baseLabel = aShapeTool->FindShape(baseShape);
+    if(baseLabel.IsNull() || !aShapeTool->IsAssembly(baseLabel)) {
+        readShapeData(baseLabel,baseShape,myShapeData[baseShape]);
+        return;
+    }
+
+    for(TopoDS_Iterator it(baseShape,0,0);it.More();it.Next()) {
+        TopoDS_Shape childShape = it.Value();
+        if(childShape.IsNull())
+            continue;
+        TDF_Label childLabel;
+        aShapeTool->Search(childShape,childLabel,Standard_True,Standard_True,Standard_False);
+        if(!childLabel.IsNull()) {
+            if(!options.importHidden && !aColorTool->IsVisible(childLabel))
+                continue;
+            mySHUOColors.emplace(childLabel,readSHUOColors(childLabel));
+        }
+        collectShapes(childShape,visited);
+    }
+}
+
+std::vector<ImportOCAF2::SHUOColor> ImportOCAF2::readSHUOColors(TDF_Label label)
+{
+    std::vector<SHUOColor> colors;
     TDF_AttributeSequence seq;
     if(label.IsNull() || !aShapeTool->GetAllComponentSHUO(label,seq))
-        return;
-    std::ostringstream ss;
+        return colors;
     for(int i=1;i<=seq.Length();++i) {
         Handle(XCAFDoc_GraphNode) shuo = Handle(XCAFDoc_GraphNode)::DownCast(seq.Value(i));
         if(shuo.IsNull())
@@ -668,41 +779,62 @@ void ImportOCAF2::getSHUOColors(TDF_Label label,
         if(uppers.Length())
             continue;
 
-        // appendFirst tells us whether we shall append the object name of the first label
-        bool skipFirst = !appendFirst;
-        ss.str("");
+        SHUOColor color;
         while(1) {
-            if(skipFirst)
-                skipFirst = false;
-            else {
-                TDF_Label l = shuo->Label().Father();
-                auto it = myNames.find(l);
-                if(it == myNames.end()) {
-                    FC_WARN("Failed to find object of label " << labelName(l));
-                    ss.str("");
-                    break;
-                }
-                if(!it->second.empty())
-                    ss << it->second << '.';
-            }
+            color.labels.push_back(shuo->Label().Father());
             if(!shuo->NbChildren())
                 break;
             shuo = shuo->GetChild(1);
         }
-        std::string subname = ss.str();
-        if(subname.empty())
-            continue;
         if(!aColorTool->IsVisible(slabel)) {
-            subname += App::DocumentObject::hiddenMarker();
-            colors.emplace(subname,App::Color());
+            color.visible = false;
         } else {
             Quantity_ColorRGBA aColor;
             if(aColorTool->GetColor(slabel, XCAFDoc_ColorSurf, aColor) ||
                aColorTool->GetColor(slabel, XCAFDoc_ColorGen, aColor))
             {
-                colors.emplace(subname, convertColor(aColor));
+                color.color = convertColor(aColor);
+                color.hasColor = true;
             }
         }
+        colors.push_back(color);
+    }
+    return colors;
+}
+
+void ImportOCAF2::getSHUOColors(TDF_Label label,
+        std::map<std::string,App::Color> &colors, bool appendFirst)
+{
+    if(label.IsNull())
+        return;
+    auto it = mySHUOColors.find(label);
+    if(it == mySHUOColors.end())
+        it = mySHUOColors.emplace(label,readSHUOColors(label)).first;
+
+    std::ostringstream ss;
+    for(auto &shuo : it->second) {
+        // appendFirst tells us whether we shall append the object name of the first label
+        ss.str("");
+        for(std::size_t i = appendFirst ? 0 : 1; i < shuo.labels.size(); ++i) {
+            TDF_Label l = shuo.labels[i];
+            auto jt = myNames.find(l);
+            if(jt == myNames.end()) {
+                FC_WARN("Failed to find object of label " << labelName(l));
+                ss.str("");
+                break;
+            }
+            if(!jt->second.empty())
+                ss << jt->second << '.';
+        }
+        std::string subname = ss.str();
+        if(subname.empty())
+            continue;
+        if(!shuo.visible) {
+            subname += App::DocumentObject::hiddenMarker();
+            colors.emplace(subname,App::Color());
+        } else if(shuo.hasColor) {
+            colors.emplace(subname, shuo.color);
+        }
     }
 }
 
@@ -983,6 +1115,13 @@ static Standard_Boolean FindSHUO (const TDF_LabelSequence& theLabels,
     return ( !theSHUOAttr.IsNull() );
 }
 
+static const std::array<const char *,3> &colorKeys()
+{
+    static std::string marker(App::DocumentObject::hiddenMarker()+"*");
+    static std::array<const char *,3> keys = {"Face*","Edge*",marker.c_str()};
+    return keys;
+}
+
 TDF_Label ExportOCAF2::findComponent(const char *subname, TDF_Label label, TDF_LabelSequence &labels) {
     const char *dot = strchr(subname,'.');
     if(!dot) {
@@ -1051,14 +1190,12 @@ void ExportOCAF2::setupObject(TDF_Label label, App::DocumentObject *obj,
         return;
 
     std::map<std::string, std::map<std::string,App::Color> > colors;
-    static std::string marker(App::DocumentObject::hiddenMarker()+"*");
-    static std::array<const char *,3> keys = {"Face*","Edge*",marker.c_str()};
     std::string childName;
     if(name) {
         childName = name;
         childName += '.';
     }
-    for(auto key : keys) {
+    for(auto key : colorKeys()) {
         for(auto &v : getShapeColors(obj,key)) {
             const char *subname = v.first.c_str();
             if(name) {
@@ -1150,12 +1287,95 @@ void ExportOCAF2::setupObject(TDF_Label label, App::DocumentObject *obj,
     }
 }
 
+void ExportOCAF2::collectShapes(App::DocumentObject *obj,
+        std::unordered_set<App::DocumentObject*> &objs,
+        std::unordered_set<TopoDS_Shape, ShapeHasher> &shapes)
+{
+    if(!obj || !objs.insert(obj).second)
+        return;
+    auto subs = obj->getSubObjects();
+    if(subs.empty()) {
+        auto shape = Part::Feature::getTopoShape(obj->getLinkedObject(true)).getShape();
+        if(!shape.IsNull())
+            shapes.insert(shape.Located(TopLoc_Location()));
+        return;
+    }
+    for(auto &sub : subs)
+        collectShapes(obj->resolve(sub.c_str()),objs,shapes);
+}
+
+const std::string &ExportOCAF2::getShapeKey(const TopoDS_Shape &shape) {
+    auto it = myShapeKeys.find(shape);
+    if(it == myShapeKeys.end())
+        it = myShapeKeys.emplace(shape,Part::Tools::contentKey(shape)).first;
+    return it->second;
+}
+
+std::map<std::string,App::Color> ExportOCAF2::getColors(App::DocumentObject *obj) {
+    std::map<std::string,App::Color> colors;
+    if(!getShapeColors)
+        return colors;
+    for(auto key : colorKeys()) {
+        for(auto &v : getShapeColors(obj,key))
+            colors.insert(v);
+    }
+    return colors;
+}
+
+TDF_Label ExportOCAF2::findPrototype(const std::string &key, const TopoDS_Shape &shape,
+        const std::map<std::string,App::Color> &colors)
+{
+    auto it = myPrototypes.find(key);
+    if(it != myPrototypes.end()) {
+        for(auto &prototype : it->second) {
+            if(prototype.colors != colors)
+                continue;
+            // Different shapes may have the same key, so confirm the match by
+            // the content. The content of a prototype is only kept once it's
+            // needed.
+            if(!prototype.content)
+                prototype.content = std::make_unique<std::string>(
+                        Part::Tools::content(prototype.shape));
+            if(Part::Tools::hasContent(shape,*prototype.content))
+                return prototype.label;
+        }
+    }
+    return TDF_Label();
+}
+
 void ExportOCAF2::exportObjects(std::vector<App::DocumentObject*> &objs, const char *name) {
     if(objs.empty())
         return;
     myObjects.clear();
     myNames.clear();
     mySetups.clear();
+    myShapeKeys.clear();
+    myPrototypes.clear();
+
+    // Identify the geometry of all parts up front, so that geometrically
+    // identical parts share the same shape label in the exported assembly
+    Base::TimeInfo startTime;
+    std::unordered_set<App::DocumentObject*> visited;
+    std::unordered_set<TopoDS_Shape, ShapeHasher> shapes;
+    for(auto obj : objs)
+        collectShapes(obj,visited,shapes);
+    std::vector<std::pair<TopoDS_Shape, std::string> > keys;
+    keys.reserve(shapes.size());
+    for(auto &shape : shapes)
+        keys.emplace_back(shape,std::string());
+    QtConcurrent::blockingMap(keys, [](std::pair<TopoDS_Shape, std::string> &v) {
+        try {
+            v.second = Part::Tools::contentKey(v.first);
+        }
+        catch (Standard_Failure &) {
+            // computed again on demand
+        }
+    });
+    for(auto &v : keys) {
+        if(!v.second.empty())
+            myShapeKeys.emplace(v.first,v.second);
+    }
+    Base::TimeInfo keyTime;
     if(objs.size()==1)
         exportObject(objs.front(),nullptr,TDF_Label());
     else {
@@ -1181,6 +1401,15 @@ void ExportOCAF2::exportObjects(std::vector<App::DocumentObject*> &objs, const c
 
     // Update is not performed automatically anymore: https://tracker.dev.opencascade.org/view.php?id=28055
     aShapeTool->UpdateAssemblies();
+
+    std::size_t count = 0;
+    for(auto &v : myPrototypes)
+        count += v.second.size();
+    Base::Console().Log("Export: %d shapes identified in %f s, %d unique parts, exported in %f s\n",
+            (int)keys.size(), Base::TimeInfo::diffTimeF(startTime,keyTime),
+            (int)count, Base::TimeInfo::diffTimeF(keyTime,Base::TimeInfo()));
+    myShapeKeys.clear();
+    myPrototypes.clear();
 }
 
 TDF_Label ExportOCAF2::exportObject(App::DocumentObject* parentObj,
@@ -1265,9 +1494,20 @@ TDF_Label ExportOCAF2::exportObject(App::DocumentObject* parentObj,
                 auto baseShape = linkedShape;
                 auto linked = links.empty()?obj:links.back();
                 baseShape.setShape(baseShape.getShape().Located(TopLoc_Location()));
-                label = aShapeTool->NewShape();
-                aShapeTool->SetShape(label,baseShape.getShape());
-                setupObject(label,linked,baseShape,prefix);
+
+                // Check for a geometrically identical shape with the same
+                // colors exported before, and refer to its shape if found
+                const std::string &key = getShapeKey(baseShape.getShape());
+                auto colors = getColors(linked);
+                label = findPrototype(key,baseShape.getShape(),colors);
+                if(!label.IsNull()) {
+                    shape.setShape(aShapeTool->GetShape(label).Located(shape.getShape().Location()));
+                } else {
+                    label = aShapeTool->NewShape();
+                    aShapeTool->SetShape(label,baseShape.getShape());
+                    setupObject(label,linked,baseShape,prefix);
+                    myPrototypes[key].push_back({label,std::move(colors),baseShape.getShape(),nullptr});
+                }
             }
 
             label = aShapeTool->AddComponent(parent,shape.getShape(),Standard_False);
@@ -25,9 +25,11 @@
 
 #include <climits>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <TDF_LabelMapHasher.hxx>
@@ -137,6 +139,41 @@ private:
         int free = true;
     };
 
+    // Colors of a sub-shape label, read from the document in the first phase of
+    // loadShapes() and applied to the faces and edges of the shape later on
+    struct SubShapeColor {
+        TopoDS_Shape shape;
+        App::Color faceColor;
+        App::Color edgeColor;
+        bool hasFaceColor = false;
+        bool hasEdgeColor = false;
+    };
+
+    // Everything needed to create the object of a unique shape. The colors are
+    // read from the document sequentially, the rest is computed concurrently.
+    struct ShapeData {
+        TDF_Label label;
+        TopoDS_Shape shape;
+        Info info;
+        bool hasSubShapes = false;
+        std::vector<SubShapeColor> subColors;
+
+        bool prepared = false;
+        bool valid = false;
+        bool expand = false;
+        std::vector<App::Color> faceColors;
+        std::vector<App::Color> edgeColors;
+        bool hasFaceColors = false;
+        bool hasEdgeColors = false;
+    };
+
+    struct SHUOColor {
+        std::vector<TDF_Label> labels;
+        App::Color color;
+        bool visible = true;
+        bool hasColor = false;
+    };
+
     App::DocumentObject *loadShape(App::Document *doc, TDF_Label label,
             const TopoDS_Shape &shape, bool baseOnly=false, bool newDoc=true);
     App::Document *getDocument(App::Document *doc, TDF_Label label);
@@ -152,6 +189,11 @@ private:
     void setObjectName(Info &info, TDF_Label label);
     std::string getLabelName(TDF_Label label);
     App::DocumentObject *expandShape(App::Document *doc, TDF_Label label, const TopoDS_Shape &shape);
+    void collectShapes(const TopoDS_Shape &shape,
+            std::unordered_set<TopoDS_Shape, ShapeHasher> &visited);
+    void readShapeData(TDF_Label label, const TopoDS_Shape &shape, ShapeData &data);
+    void prepareShapeData(ShapeData &data) const;
+    std::vector<SHUOColor> readSHUOColors(TDF_Label label);
 
     virtual void applyEdgeColors(Part::Feature*, const std::vector<App::Color>&) {}
     virtual void applyFaceColors(Part::Feature*, const std::vector<App::Color>&) {}
@@ -185,6 +227,8 @@ private:
 
     std::unordered_map<TopoDS_Shape, Info, ShapeHasher> myShapes;
     std::unordered_map<TDF_Label, std::string, LabelHasher> myNames;
+    std::unordered_map<TopoDS_Shape, ShapeData, ShapeHasher> myShapeData;
+    std::unordered_map<TDF_Label, std::vector<SHUOColor>, LabelHasher> mySHUOColors;
     std::unordered_map<App::DocumentObject*, App::PropertyPlacement*> myCollapsedObjects;
 
     Base::SequencerLauncher *sequencer;
@@ -225,8 +269,24 @@ private:
             const char *name=nullptr, bool force=false);
     void setName(TDF_Label label, App::DocumentObject *obj, const char *name=nullptr);
     TDF_Label findComponent(const char *subname, TDF_Label label, TDF_LabelSequence &labels);
+    void collectShapes(App::DocumentObject *obj, std::unordered_set<App::DocumentObject*> &objs,
+            std::unordered_set<TopoDS_Shape, ShapeHasher> &shapes);
+    const std::string &getShapeKey(const TopoDS_Shape &shape);
+    std::map<std::string,App::Color> getColors(App::DocumentObject *obj);
+    TDF_Label findPrototype(const std::string &key, const TopoDS_Shape &shape,
+            const std::map<std::string,App::Color> &colors);
 
 private:
+    // A shape label that is shared by all objects with geometrically identical
+    // shapes and the same colors
+    struct Prototype {
+        TDF_Label label;
+        std::map<std::string,App::Color> colors;
+        TopoDS_Shape shape;
+        // the BRep text of the shape to confirm a matching key
+        std::unique_ptr<std::string> content;
+    };
+
     Handle(TDocStd_Document) pDoc;
     Handle(XCAFDoc_ShapeTool) aShapeTool;
     Handle(XCAFDoc_ColorTool) aColorTool;
@@ -237,6 +297,9 @@ private:
 
     std::set<std::pair<App::DocumentObject*,std::string> > mySetups;
 
+    std::unordered_map<TopoDS_Shape, std::string, ShapeHasher> myShapeKeys;
+    std::unordered_map<std::string, std::vector<Prototype> > myPrototypes;
+
     std::vector<App::DocumentObject*> groupLinks;
 
     GetShapeColorsFunc getShapeColors;
@@ -52,6 +52,8 @@
 # include <TopoDS_Vertex.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 #include <App/Annotation.h>
 #include <App/Application.h>
 #include <App/Document.h>
@@ -59,6 +61,7 @@
 #include <Base/Interpreter.h>
 #include <Base/Matrix.h>
 #include <Base/Parameter.h>
+#include <Base/TimeInfo.h>
 #include <Base/Vector3D.h>
 #include <Mod/Part/App/PartFeature.h>
 
@@ -81,6 +84,14 @@ ImpExpDxfRead::ImpExpDxfRead(std::string filepath, App::Document *pcDoc) : CDxfR
     setOptions();
 }
 
+ImpExpDxfRead::~ImpExpDxfRead()
+{
+    for (const auto& it : layers) {
+        for (Part::TopoShape* shape : it.second)
+            delete shape;
+    }
+}
+
 void ImpExpDxfRead::setOptions()
 {
     ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(getOptionSource().c_str());
@@ -301,9 +312,10 @@ void ImpExpDxfRead::OnReadText(const double *point, const double /*height*/, con
     if (optionImportAnnotations) {
         Base::Vector3d pt(point[0] * optionScaling, point[1] * optionScaling, point[2] * optionScaling);
         if(LayerName().substr(0, 6) != "BLOCKS") {
-            App::Annotation *pcFeature = static_cast<App::Annotation *>(document->addObject("App::Annotation", "Text"));
-            pcFeature->LabelText.setValue(Deformat(text));
-            pcFeature->Position.setValue(pt);
+            PendingFeature feature;
+            feature.text = Deformat(text);
+            feature.position = pt;
+            features.push_back(feature);
         }
         //else std::cout << "skipped text in block: " << LayerName() << std::endl;
     }
@@ -360,15 +372,13 @@ void ImpExpDxfRead::OnReadDimension(const double* s, const double* e, const doub
 void ImpExpDxfRead::AddObject(Part::TopoShape *shape)
 {
     //std::cout << "layer:" << LayerName() << std::endl;
-    std::vector <Part::TopoShape*> vec;
-    if (layers.count(LayerName()))
-        vec = layers[LayerName()];
-    vec.push_back(shape);
-    layers[LayerName()] = vec;
+    std::string layerName = LayerName();
+    layers[layerName].push_back(shape);
     if (!optionGroupLayers) {
-        if(LayerName().substr(0, 6) != "BLOCKS") {
-            Part::Feature *pcFeature = static_cast<Part::Feature *>(document->addObject("Part::Feature", "Shape"));
-            pcFeature->Shape.setValue(shape->getShape());
+        if(layerName.substr(0, 6) != "BLOCKS") {
+            PendingFeature feature;
+            feature.shape = shape;
+            features.push_back(feature);
         }
     }
 }
@@ -415,28 +425,70 @@ std::string ImpExpDxfRead::Deformat(const char* text)
 
 void ImpExpDxfRead::AddGraphics() const
 {
+    Base::TimeInfo startTime;
+
+    // build the compounds of the layers in parallel
+    struct LayerCompound {
+        std::string name;
+        const std::vector<Part::TopoShape*>* shapes;
+        TopoDS_Compound comp;
+    };
+    std::vector<LayerCompound> compounds;
     if (optionGroupLayers) {
-        for(std::map<std::string,std::vector<Part::TopoShape*> > ::const_iterator i = layers.begin(); i != layers.end(); ++i) {
+        for (const auto& it : layers) {
+            if (it.first.substr(0, 6) == "BLOCKS")
+                continue;
+            LayerCompound layer;
+            layer.name = it.first;
+            if (layer.name == "0") // FreeCAD doesn't like an object name being '0'...
+                layer.name = "LAYER_0";
+            layer.shapes = &it.second;
+            compounds.push_back(layer);
+        }
+        QtConcurrent::blockingMap(compounds, [](LayerCompound& layer) {
             BRep_Builder builder;
-            TopoDS_Compound comp;
-            builder.MakeCompound(comp);
-            std::string k = i->first;
-            if (k == "0") // FreeCAD doesn't like an object name being '0'...
-                k = "LAYER_0";
-            std::vector<Part::TopoShape*> v = i->second;
-            if(k.substr(0, 6) != "BLOCKS") {
-                for(std::vector<Part::TopoShape*>::const_iterator j = v.begin(); j != v.end(); ++j) {
-                    const TopoDS_Shape& sh = (*j)->getShape();
-                    if (!sh.IsNull())
-                        builder.Add(comp, sh);
-                }
-                if (!comp.IsNull()) {
-                    Part::Feature *pcFeature = static_cast<Part::Feature *>(document->addObject("Part::Feature", k.c_str()));
-                    pcFeature->Shape.setValue(comp);
-                }
+            builder.MakeCompound(layer.comp);
+            for (const Part::TopoShape* shape : *layer.shapes) {
+                const TopoDS_Shape& sh = shape->getShape();
+                if (!sh.IsNull())
+                    builder.Add(layer.comp, sh);
             }
+        });
+    }
+    Base::TimeInfo buildTime;
+
+    // add the features in one transaction, unless the import is part of another one
+    bool transaction = !document->hasPendingTransaction();
+    if (transaction)
+        document->openTransaction("Import DXF");
+    try {
+        for (const PendingFeature& feature : features) {
+            if (feature.shape) {
+                Part::Feature *pcFeature = static_cast<Part::Feature *>(document->addObject("Part::Feature", "Shape"));
+                pcFeature->Shape.setValue(feature.shape->getShape());
+            }
+            else {
+                App::Annotation *pcFeature = static_cast<App::Annotation *>(document->addObject("App::Annotation", "Text"));
+                pcFeature->LabelText.setValue(feature.text);
+                pcFeature->Position.setValue(feature.position);
+            }
+        }
+        for (const LayerCompound& layer : compounds) {
+            Part::Feature *pcFeature = static_cast<Part::Feature *>(document->addObject("Part::Feature", layer.name.c_str()));
+            pcFeature->Shape.setValue(layer.comp);
         }
     }
+    catch (...) {
+        if (transaction)
+            document->commitTransaction();
+        throw;
+    }
+    if (transaction)
+        document->commitTransaction();
+
+    Base::Console().Log("DXF import: compounds %f s, features %f s\n",
+            Base::TimeInfo::diffTimeF(startTime,buildTime),
+            Base::TimeInfo::diffTimeF(buildTime,Base::TimeInfo()));
 }
 
 //******************************************************************************
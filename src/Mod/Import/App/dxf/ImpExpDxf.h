@@ -39,6 +39,7 @@ namespace Import
     {
     public:
         ImpExpDxfRead(std::string filepath, App::Document *pcDoc);
+        ~ImpExpDxfRead() override;
 
         // CDxfRead's virtual functions
         void OnReadLine(const double* s, const double* e, bool hidden) override;
@@ -63,6 +64,15 @@ namespace Import
     private:
         gp_Pnt makePoint(const double* p);
 
+        // A feature that is created in AddGraphics(): a shape if the layers are not
+        // grouped, or a text annotation
+        struct PendingFeature {
+            const Part::TopoShape* shape = nullptr;
+            std::string text;
+            Base::Vector3d position;
+        };
+        std::vector<PendingFeature> features;
+
     protected:
         App::Document *document;
         bool optionGroupLayers;
@@ -7,11 +7,17 @@
 
 //required by windows for M_PI definition
 #define _USE_MATH_DEFINES
+#include <charconv>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
+
+#include <QByteArray>
+#include <QFile>
 
 #include <App/Application.h>
 #include <Base/Console.h>
@@ -1744,6 +1750,67 @@ void CDxfWrite::writeObjectsSection(void)
     (*m_ofs) << getPlateFile(fileSpec);
 }
 
+// The DXF file mapped into memory, or read at once if it can't be mapped.
+// The lines are tokenized in place by get_line().
+class CDxfRead::CDxfFile
+{
+public:
+    explicit CDxfFile(const char* filepath)
+        : file(QString::fromUtf8(filepath))
+    {
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        open = true;
+        qint64 size = file.size();
+        if (size > 0) {
+            data = reinterpret_cast<const char*>(file.map(0, size));
+        }
+        if (data) {
+            length = static_cast<std::size_t>(size);
+        }
+        else {
+            buffer = file.readAll();
+            data = buffer.constData();
+            length = static_cast<std::size_t>(buffer.size());
+        }
+    }
+
+    bool isOpen() const { return open; }
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+
+private:
+    QFile file;         // the mapping is released when the file is closed
+    QByteArray buffer;
+    const char* data = nullptr;
+    std::size_t length = 0;
+    bool open = false;
+};
+
+// Group codes and values are written in the "C" locale. Integer values are parsed like
+// sscanf("%d") did, i.e. trailing text like a fractional part is ignored.
+template<typename T>
+bool CDxfRead::ParseNumber(const char* str, T& value)
+{
+    // from_chars doesn't accept a leading plus sign
+    if (*str == '+')
+        ++str;
+    const char* end = str + strlen(str);
+#if !defined(__cpp_lib_to_chars)
+    if constexpr (std::is_floating_point_v<T>) {
+        std::istringstream ss(std::string(str, end));
+        ss.imbue(std::locale::classic());
+        ss >> value;
+        return !ss.fail();
+    }
+    else
+#endif
+    {
+        std::from_chars_result res = std::from_chars(str, end, value);
+        return res.ec == std::errc();
+    }
+}
+
 CDxfRead::CDxfRead(const char* filepath)
 {
     // start the file
@@ -1758,19 +1825,22 @@ CDxfRead::CDxfRead(const char* filepath)
     memset( m_block_name, '\0', sizeof(m_block_name) );
     m_ignore_errors = true;
 
-    m_ifs = new ifstream(filepath);
-    if(!(*m_ifs)){
+    m_file = new CDxfFile(filepath);
+    m_pos = m_file->begin();
+    m_end = m_file->end();
+    m_eof = false;
+    if(!m_file->isOpen()){
         m_fail = true;
+        m_eof = true;
         printf("DXF file didn't load\n");
         return;
     }
-    m_ifs->imbue(std::locale("C"));
 
 }
 
 CDxfRead::~CDxfRead()
 {
-    delete m_ifs;
+    delete m_file;
 }
 
 double CDxfRead::mm( double value ) const
@@ -1820,19 +1890,17 @@ bool CDxfRead::ReadLine()
     double e[3] = {0, 0, 0};
     bool hidden = false;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadLine() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with line
@@ -1854,37 +1922,37 @@ bool CDxfRead::ReadLine()
             case 10:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[0])) return false; s[0] = mm(s[0]);
                 break;
             case 20:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[1])) return false; s[1] = mm(s[1]);
                 break;
             case 30:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[2])) return false; s[2] = mm(s[2]);
                 break;
             case 11:
                 // end x
                 get_line();
-                ss.str(m_str); ss >> e[0]; e[0] = mm(e[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[0])) return false; e[0] = mm(e[0]);
                 break;
             case 21:
                 // end y
                 get_line();
-                ss.str(m_str); ss >> e[1]; e[1] = mm(e[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[1])) return false; e[1] = mm(e[1]);
                 break;
             case 31:
                 // end z
                 get_line();
-                ss.str(m_str); ss >> e[2]; e[2] = mm(e[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[2])) return false; e[2] = mm(e[2]);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
 
             case 100:
@@ -1918,19 +1986,17 @@ bool CDxfRead::ReadPoint()
 {
     double s[3] = {0, 0, 0};
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadPoint() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with line
@@ -1946,23 +2012,23 @@ bool CDxfRead::ReadPoint()
             case 10:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[0])) return false; s[0] = mm(s[0]);
                 break;
             case 20:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[1])) return false; s[1] = mm(s[1]);
                 break;
             case 30:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[2])) return false; s[2] = mm(s[2]);
                 break;
 
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
 
             case 100:
@@ -2002,18 +2068,16 @@ bool CDxfRead::ReadArc()
     double z_extrusion_dir = 1.0;
     bool hidden = false;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadArc() Failed to read integer from '%s'\n", m_str);
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with arc
@@ -2035,37 +2099,37 @@ bool CDxfRead::ReadArc()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[0])) return false; c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[1])) return false; c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[2])) return false; c[2] = mm(c[2]);
                 break;
             case 40:
                 // radius
                 get_line();
-                ss.str(m_str); ss >> radius; radius = mm(radius); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, radius)) return false; radius = mm(radius);
                 break;
             case 50:
                 // start angle
                 get_line();
-                ss.str(m_str); ss >> start_angle; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, start_angle)) return false;
                 break;
             case 51:
                 // end angle
                 get_line();
-                ss.str(m_str); ss >> end_angle; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, end_angle)) return false;
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
 
 
@@ -2080,7 +2144,7 @@ bool CDxfRead::ReadArc()
             case 230:
                 //Z extrusion direction for arc
                 get_line();
-                ss.str(m_str); ss >> z_extrusion_dir; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, z_extrusion_dir)) return false;
                 break;
 
             default:
@@ -2108,17 +2172,15 @@ bool CDxfRead::ReadSpline()
 
     double temp_double;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadSpline() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Spline
@@ -2132,130 +2194,130 @@ bool CDxfRead::ReadSpline()
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             case 210:
                 // normal x
                 get_line();
-                ss.str(m_str); ss >> sd.norm[0]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.norm[0])) return false;
                 break;
             case 220:
                 // normal y
                 get_line();
-                ss.str(m_str); ss >> sd.norm[1]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.norm[1])) return false;
                 break;
             case 230:
                 // normal z
                 get_line();
-                ss.str(m_str); ss >> sd.norm[2]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.norm[2])) return false;
                 break;
             case 70:
                 // flag
                 get_line();
-                ss.str(m_str); ss >> sd.flag; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.flag)) return false;
                 break;
             case 71:
                 // degree
                 get_line();
-                ss.str(m_str); ss >> sd.degree; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.degree)) return false;
                 break;
             case 72:
                 // knots
                 get_line();
-                ss.str(m_str); ss >> sd.knots; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.knots)) return false;
                 break;
             case 73:
                 // control points
                 get_line();
-                ss.str(m_str); ss >> sd.control_points; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.control_points)) return false;
                 break;
             case 74:
                 // fit points
                 get_line();
-                ss.str(m_str); ss >> sd.fit_points; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, sd.fit_points)) return false;
                 break;
             case 12:
                 // starttan x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.starttanx.push_back(temp_double);
                 break;
             case 22:
                 // starttan y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.starttany.push_back(temp_double);
                 break;
             case 32:
                 // starttan z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.starttanz.push_back(temp_double);
                 break;
             case 13:
                 // endtan x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.endtanx.push_back(temp_double);
                 break;
             case 23:
                 // endtan y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.endtany.push_back(temp_double);
                 break;
             case 33:
                 // endtan z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.endtanz.push_back(temp_double);
                 break;
             case 40:
                 // knot
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.knot.push_back(temp_double);
                 break;
             case 41:
                 // weight
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.weight.push_back(temp_double);
                 break;
             case 10:
                 // control x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.controlx.push_back(temp_double);
                 break;
             case 20:
                 // control y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.controly.push_back(temp_double);
                 break;
             case 30:
                 // control z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.controlz.push_back(temp_double);
                 break;
             case 11:
                 // fit x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.fitx.push_back(temp_double);
                 break;
             case 21:
                 // fit y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.fity.push_back(temp_double);
                 break;
             case 31:
                 // fit z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, temp_double)) return false; temp_double = mm(temp_double);
                 sd.fitz.push_back(temp_double);
                 break;
             case 42:
@@ -2282,17 +2344,15 @@ bool CDxfRead::ReadCircle()
     double c[3] = {0,0,0}; // centre
     bool hidden = false;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadCircle() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Circle
@@ -2314,27 +2374,27 @@ bool CDxfRead::ReadCircle()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[0])) return false; c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[1])) return false; c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[2])) return false; c[2] = mm(c[2]);
                 break;
             case 40:
                 // radius
                 get_line();
-                ss.str(m_str); ss >> radius; radius = mm(radius); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, radius)) return false; radius = mm(radius);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
 
             case 100:
@@ -2365,17 +2425,15 @@ bool CDxfRead::ReadText()
 
     memset( c, 0, sizeof(c) );
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadText() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 return false;
@@ -2387,22 +2445,22 @@ bool CDxfRead::ReadText()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[0])) return false; c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[1])) return false; c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[2])) return false; c[2] = mm(c[2]);
                 break;
             case 40:
                 // text height
                 get_line();
-                ss.str(m_str); ss >> height; height = mm(height); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, height)) return false; height = mm(height);
                 break;
             case 3:
                 // Additional text that goes before the type 1 text
@@ -2425,7 +2483,7 @@ bool CDxfRead::ReadText()
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
 
             case 100:
@@ -2455,17 +2513,15 @@ bool CDxfRead::ReadEllipse()
     double start=0; //start of arc
     double end=0;  // end of arc
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadEllipse() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Ellipse
@@ -2480,52 +2536,52 @@ bool CDxfRead::ReadEllipse()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[0])) return false; c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[1])) return false; c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[2])) return false; c[2] = mm(c[2]);
                 break;
             case 11:
                 // major x
                 get_line();
-                ss.str(m_str); ss >> m[0]; m[0] = mm(m[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m[0])) return false; m[0] = mm(m[0]);
                 break;
             case 21:
                 // major y
                 get_line();
-                ss.str(m_str); ss >> m[1]; m[1] = mm(m[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m[1])) return false; m[1] = mm(m[1]);
                 break;
             case 31:
                 // major z
                 get_line();
-                ss.str(m_str); ss >> m[2]; m[2] = mm(m[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m[2])) return false; m[2] = mm(m[2]);
                 break;
             case 40:
                 // ratio
                 get_line();
-                ss.str(m_str); ss >> ratio; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, ratio)) return false;
                 break;
             case 41:
                 // start
                 get_line();
-                ss.str(m_str); ss >> start; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, start)) return false;
                 break;
             case 42:
                 // end
                 get_line();
-                ss.str(m_str); ss >> end; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, end)) return false;
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             case 100:
             case 210:
@@ -2625,17 +2681,15 @@ bool CDxfRead::ReadLwPolyLine()
     int flags;
     bool next_item_found = false;
 
-    while(!((*m_ifs).eof()) && !next_item_found)
+    while(!m_eof && !next_item_found)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadLwPolyLine() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -2664,37 +2718,37 @@ bool CDxfRead::ReadLwPolyLine()
                     x_found = false;
                     y_found = false;
                 }
-                ss.str(m_str); ss >> x; x = mm(x); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, x)) return false; x = mm(x);
                 x_found = true;
                 break;
             case 20:
                 // y
                 get_line();
-                ss.str(m_str); ss >> y; y = mm(y); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, y)) return false; y = mm(y);
                 y_found = true;
                 break;
             case 38:
                 // elevation
                 get_line();
-                ss.str(m_str); ss >> z; z = mm(z); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, z)) return false; z = mm(z);
                 break;
             case 42:
                 // bulge
                 get_line();
-                ss.str(m_str); ss >> bulge; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, bulge)) return false;
                 bulge_found = true;
                 break;
             case 70:
                 // flags
                 get_line();
-                if(sscanf(m_str, "%d", &flags) != 1)
+                if(!ParseNumber(m_str, flags))
                     return false;
                 closed = ((flags & 1) != 0);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             default:
                 // skip the next line
@@ -2733,15 +2787,13 @@ bool CDxfRead::ReadVertex(double *pVertex, bool *bulge_found, double *bulge)
     pVertex[1] = 0.0;
     pVertex[2] = 0.0;
 
-    while(!(*m_ifs).eof()) {
+    while(!m_eof) {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1) {
+        if(!ParseNumber(m_str, n)) {
             printf("CDxfRead::ReadVertex() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
         case 0:
         DerefACI();
@@ -2757,30 +2809,30 @@ bool CDxfRead::ReadVertex(double *pVertex, bool *bulge_found, double *bulge)
         case 10:
             // x
             get_line();
-            ss.str(m_str); ss >> x; pVertex[0] = mm(x); if(ss.fail()) return false;
+            if(!ParseNumber(m_str, x)) return false; pVertex[0] = mm(x);
             x_found = true;
             break;
         case 20:
             // y
             get_line();
-            ss.str(m_str); ss >> y; pVertex[1] = mm(y); if(ss.fail()) return false;
+            if(!ParseNumber(m_str, y)) return false; pVertex[1] = mm(y);
             y_found = true;
             break;
         case 30:
             // z
             get_line();
-            ss.str(m_str); ss >> z; pVertex[2] = mm(z); if(ss.fail()) return false;
+            if(!ParseNumber(m_str, z)) return false; pVertex[2] = mm(z);
             break;
 
         case 42:
             get_line();
             *bulge_found = true;
-            ss.str(m_str); ss >> *bulge; if(ss.fail()) return false;
+            if(!ParseNumber(m_str, *bulge)) return false;
             break;
     case 62:
         // color index
         get_line();
-        ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+        if(!ParseNumber(m_str, m_aci)) return false;
         break;
 
         default:
@@ -2806,17 +2858,15 @@ bool CDxfRead::ReadPolyLine()
     bool bulge_found;
     double bulge;
 
-    while(!(*m_ifs).eof())
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadPolyLine() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -2848,14 +2898,14 @@ bool CDxfRead::ReadPolyLine()
             case 70:
                 // flags
                 get_line();
-                if(sscanf(m_str, "%d", &flags) != 1)
+                if(!ParseNumber(m_str, flags))
                     return false;
                 closed = ((flags & 1) != 0);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             default:
                 // skip the next line
@@ -2929,17 +2979,15 @@ bool CDxfRead::ReadInsert()
     double rot = 0.0; // rotation
     char name[1024] = {0};
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadInsert() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -2954,37 +3002,37 @@ bool CDxfRead::ReadInsert()
             case 10:
                 // coord x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[0])) return false; c[0] = mm(c[0]);
                 break;
             case 20:
                 // coord y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[1])) return false; c[1] = mm(c[1]);
                 break;
             case 30:
                 // coord z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, c[2])) return false; c[2] = mm(c[2]);
                 break;
             case 41:
                 // scale x
                 get_line();
-                ss.str(m_str); ss >> s[0]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[0])) return false;
                 break;
             case 42:
                 // scale y
                 get_line();
-                ss.str(m_str); ss >> s[1]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[1])) return false;
                 break;
             case 43:
                 // scale z
                 get_line();
-                ss.str(m_str); ss >> s[2]; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[2])) return false;
                 break;
             case 50:
                 // rotation
                 get_line();
-                ss.str(m_str); ss >> rot; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, rot)) return false;
                 break;
             case 2:
                 // block name
@@ -2994,7 +3042,7 @@ bool CDxfRead::ReadInsert()
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             case 100:
             case 39:
@@ -3021,17 +3069,15 @@ bool CDxfRead::ReadDimension()
     double p[3] = {0,0,0}; // dimpoint
     double rot = -1.0; // rotation
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadInsert() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -3046,57 +3092,57 @@ bool CDxfRead::ReadDimension()
             case 13:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[0])) return false; s[0] = mm(s[0]);
                 break;
             case 23:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[1])) return false; s[1] = mm(s[1]);
                 break;
             case 33:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, s[2])) return false; s[2] = mm(s[2]);
                 break;
             case 14:
                 // end x
                 get_line();
-                ss.str(m_str); ss >> e[0]; e[0] = mm(e[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[0])) return false; e[0] = mm(e[0]);
                 break;
             case 24:
                 // end y
                 get_line();
-                ss.str(m_str); ss >> e[1]; e[1] = mm(e[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[1])) return false; e[1] = mm(e[1]);
                 break;
             case 34:
                 // end z
                 get_line();
-                ss.str(m_str); ss >> e[2]; e[2] = mm(e[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, e[2])) return false; e[2] = mm(e[2]);
                 break;
             case 10:
                 // dimline x
                 get_line();
-                ss.str(m_str); ss >> p[0]; p[0] = mm(p[0]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, p[0])) return false; p[0] = mm(p[0]);
                 break;
             case 20:
                 // dimline y
                 get_line();
-                ss.str(m_str); ss >> p[1]; p[1] = mm(p[1]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, p[1])) return false; p[1] = mm(p[1]);
                 break;
             case 30:
                 // dimline z
                 get_line();
-                ss.str(m_str); ss >> p[2]; p[2] = mm(p[2]); if(ss.fail()) return false;
+                if(!ParseNumber(m_str, p[2])) return false; p[2] = mm(p[2]);
                 break;
             case 50:
                 // rotation
                 get_line();
-                ss.str(m_str); ss >> rot; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, rot)) return false;
                 break;
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!ParseNumber(m_str, m_aci)) return false;
                 break;
             case 100:
             case 39:
@@ -3118,17 +3164,15 @@ bool CDxfRead::ReadDimension()
 
 bool CDxfRead::ReadBlockInfo()
 {
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadBlockInfo() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 2:
                 // block name
@@ -3159,23 +3203,31 @@ void CDxfRead::get_line()
         return;
     }
 
-    m_ifs->getline(m_str, 1024);
+    // like getline() the end of the file is reached when the last line has no line
+    // end, or when reading past the last line
+    const char* eol = m_end;
+    if (m_pos != m_end)
+        eol = static_cast<const char*>(memchr(m_pos, '\n', m_end - m_pos));
+    if (!eol || eol == m_end) {
+        eol = m_end;
+        m_eof = true;
+    }
 
-    char str[1024];
-    size_t len = strlen(m_str);
-    int j = 0;
+    // copy the line without the leading white space and carriage returns,
+    // truncating overlong lines
+    size_t j = 0;
     bool non_white_found = false;
-    for(size_t i = 0; i<len; i++){
-        if(non_white_found || (m_str[i] != ' ' && m_str[i] != '\t')){
-            if(m_str[i] != '\r')
+    for(const char* c = m_pos; c != eol && j < sizeof(m_str) - 1; c++){
+        if(non_white_found || (*c != ' ' && *c != '\t')){
+            if(*c != '\r')
             {
-                str[j] = m_str[i]; j++;
+                m_str[j] = *c; j++;
             }
             non_white_found = true;
         }
     }
-    str[j] = 0;
-    strcpy(m_str, str);
+    m_str[j] = 0;
+    m_pos = (eol == m_end) ? m_end : eol + 1;
 }
 
 void dxf_strncpy(char* dst, const char* src, size_t size)
@@ -3200,7 +3252,7 @@ bool CDxfRead::ReadUnits()
     get_line(); // Skip to next line.
     get_line(); // Skip to next line.
     int n = 0;
-    if(sscanf(m_str, "%d", &n) == 1)
+    if(ParseNumber(m_str, n))
     {
         m_eUnits = eDxfUnits_t( n );
         return(true);
@@ -3218,19 +3270,17 @@ bool CDxfRead::ReadLayer()
     std::string layername;
     int aci = -1;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!ParseNumber(m_str, n))
         {
             printf("CDxfRead::ReadLayer() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0: // next item found, so finish with line
                     if (layername.empty())
@@ -3249,7 +3299,7 @@ bool CDxfRead::ReadLayer()
             case 62:
                 // layer color ; if negative, layer is off
                 get_line();
-                if(sscanf(m_str, "%d", &aci) != 1)
+                if(!ParseNumber(m_str, aci))
                     return false;
                 break;
 
@@ -3279,11 +3329,11 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
 
     get_line();
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         if (!strcmp( m_str, "$INSUNITS" )){
             if (!ReadUnits())
-                return;
+                break;
             continue;
         } // End if - then
 
@@ -3291,7 +3341,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
             get_line();
             get_line();
             int n = 1;
-            if(sscanf(m_str, "%d", &n) == 1)
+            if(ParseNumber(m_str, n))
             {
                 if(n == 0)m_measurement_inch = true;
             }
@@ -3330,7 +3380,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
             if(!ReadBlockInfo())
             {
                 printf("CDxfRead::DoRead() Failed to read block info\n");
-                return;
+                break;
             }
             continue;
         } // End if - then
@@ -3343,7 +3393,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadLine())
                 {
                     printf("CDxfRead::DoRead() Failed to read line\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3351,7 +3401,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadArc())
                 {
                     printf("CDxfRead::DoRead() Failed to read arc\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3359,7 +3409,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadCircle())
                 {
                     printf("CDxfRead::DoRead() Failed to read circle\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3367,7 +3417,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadText())
                 {
                     printf("CDxfRead::DoRead() Failed to read text\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3375,7 +3425,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadText())
                 {
                     printf("CDxfRead::DoRead() Failed to read text\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3383,7 +3433,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadEllipse())
                 {
                     printf("CDxfRead::DoRead() Failed to read ellipse\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3391,7 +3441,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadSpline())
                 {
                     printf("CDxfRead::DoRead() Failed to read spline\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3399,7 +3449,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadLwPolyLine())
                 {
                     printf("CDxfRead::DoRead() Failed to read LW Polyline\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3407,7 +3457,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadPolyLine())
                 {
                     printf("CDxfRead::DoRead() Failed to read Polyline\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3415,7 +3465,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadPoint())
                 {
                     printf("CDxfRead::DoRead() Failed to read Point\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3423,7 +3473,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadInsert())
                 {
                     printf("CDxfRead::DoRead() Failed to read Insert\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3431,7 +3481,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
                 if(!ReadDimension())
                 {
                     printf("CDxfRead::DoRead() Failed to read Dimension\n");
-                    return;
+                    break;
                 }
                 continue;
             }
@@ -3439,6 +3489,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
 
         get_line();
     }
+    // also add the entities read before an error
     AddGraphics();
 }
 
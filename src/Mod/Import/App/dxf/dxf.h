@@ -243,7 +243,11 @@ public:
 // derive a class from this and implement it's virtual functions
 class CDxfRead{
 private:
-    std::ifstream* m_ifs;
+    class CDxfFile;
+    CDxfFile* m_file;   // the memory mapped file
+    const char* m_pos;  // the start of the next line in the file
+    const char* m_end;
+    bool m_eof;
 
     bool m_fail;
     char m_str[1024];
@@ -280,6 +284,8 @@ private:
 
     void get_line();
     void put_line(const char *value);
+    template<typename T>
+    static bool ParseNumber(const char* str, T& value);
     void DerefACI();
 
 protected:
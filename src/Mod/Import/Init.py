@@ -34,3 +34,5 @@ FreeCAD.addImportType("PLMXML files (*.plmxml)","PlmXmlParser")
 FreeCAD.addImportType("STEPZ Zip File Type (*.stpZ *.stpz)","stepZ")
 FreeCAD.addExportType("STEPZ zip File Type (*.stpZ *.stpz)","stepZ")
 FreeCAD.addExportType("glTF (*.gltf *.glb)","ImportGui")
+
+FreeCAD.__unit_test__ += ["TestImportApp"]
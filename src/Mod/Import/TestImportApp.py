@@ -0,0 +1,61 @@
+#**************************************************************************
+#   Copyright (c) 2023 FreeCAD Project Association                        *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import os
+import tempfile
+import unittest
+
+import FreeCAD
+import Import
+
+
+class ExportStepTestCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("ExportStepTest")
+        self.fileName = os.path.join(tempfile.gettempdir(), "ExportStepTest.step")
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.doc.Name)
+        if os.path.exists(self.fileName):
+            os.remove(self.fileName)
+
+    def addBox(self, part, name, length, x):
+        box = self.doc.addObject("Part::Box", name)
+        box.Length = length
+        box.Placement.Base = FreeCAD.Vector(x, 0, 0)
+        part.addObject(box)
+        return box
+
+    def countSolids(self):
+        with open(self.fileName) as step:
+            return step.read().count("MANIFOLD_SOLID_BREP")
+
+    def testSharedShapes(self):
+        """Copies of a part share their shape, different parts don't"""
+        part = self.doc.addObject("App::Part", "Part")
+        self.addBox(part, "Box1", 10, 0)
+        self.addBox(part, "Box2", 10, 20)
+        self.addBox(part, "Box3", 15, 40)
+        self.doc.recompute()
+
+        Import.export([part], self.fileName, legacy=False)
+        self.assertEqual(self.countSolids(), 2, "expected one solid for Box1 and Box2 and one for Box3")
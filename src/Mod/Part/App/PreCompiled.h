@@ -42,12 +42,14 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 // STL
 #include <array>
 #include <fcntl.h>
 #include <fstream>
+#include <functional>
 #include <list>
 #include <iostream>
 #include <map>
@@ -55,6 +57,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Qt
@@ -23,6 +23,11 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <cassert>
+# include <cstdint>
+# include <cstring>
+# include <functional>
+# include <sstream>
+# include <string_view>
 # include <BRep_Tool.hxx>
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
@@ -30,6 +35,7 @@
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepLProp_SLProps.hxx>
 # include <BRepMesh_IncrementalMesh.hxx>
+# include <BRepTools.hxx>
 # include <CSLib.hxx>
 # include <Geom_BSplineSurface.hxx>
 # include <Geom_Line.hxx>
@@ -742,3 +748,139 @@ TopLoc_Location Part::Tools::fromPlacement(const Base::Placement& plm)
     trf.SetRotation(gp_Quaternion(q1, q2, q3, q4));
     return {trf};
 }
+
+namespace {
+
+// Hashes the text written to it in blocks of a fixed size, so the result only
+// depends on the text and not on how it's written. Two hashes of 64 bits are
+// combined: FNV-1a over the bytes and the standard hash over the blocks.
+class HashBuffer : public std::streambuf
+{
+public:
+    HashBuffer() : block(1 << 16)
+    {
+        setp(block.data(), block.data() + block.size());
+    }
+
+    std::string key()
+    {
+        hashBlock();
+        std::ostringstream str;
+        str << std::hex << fnv << ":" << blocks << ":" << std::dec << length;
+        return str.str();
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        hashBlock();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+private:
+    void hashBlock()
+    {
+        std::size_t size = pptr() - pbase();
+        if (size == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            fnv = (fnv ^ static_cast<unsigned char>(block[i])) * 0x100000001b3ULL;
+        }
+        std::size_t hash = std::hash<std::string_view>()(std::string_view(block.data(), size));
+        blocks ^= hash + 0x9e3779b97f4a7c15ULL + (blocks << 6) + (blocks >> 2);
+        length += size;
+        setp(block.data(), block.data() + block.size());
+    }
+
+private:
+    std::vector<char> block;
+    uint64_t fnv = 0xcbf29ce484222325ULL;
+    uint64_t blocks = 0;
+    uint64_t length = 0;
+};
+
+// Compares the text written to it with a reference text. On the first
+// difference it fails, which stops the stream writing to it.
+class CompareBuffer : public std::streambuf
+{
+public:
+    explicit CompareBuffer(const std::string& reference) : reference(reference)
+    {
+    }
+
+    bool matches() const
+    {
+        return equal && offset == reference.size();
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return traits_type::not_eof(c);
+        }
+        char ch = traits_type::to_char_type(c);
+        return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        std::size_t size = static_cast<std::size_t>(n);
+        if (!equal || size > reference.size() - offset
+            || std::memcmp(reference.data() + offset, s, size) != 0) {
+            equal = false;
+            return 0;
+        }
+        offset += size;
+        return n;
+    }
+
+private:
+    const std::string& reference;
+    std::size_t offset = 0;
+    bool equal = true;
+};
+
+}
+
+std::string Part::Tools::contentKey(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull()) {
+        return {};
+    }
+    HashBuffer buffer;
+    std::ostream stream(&buffer);
+    BRepTools::Write(shape, stream);
+    return buffer.key();
+}
+
+std::string Part::Tools::content(const TopoDS_Shape& shape)
+{
+    if (shape.IsNull()) {
+        return {};
+    }
+    std::ostringstream stream;
+    BRepTools::Write(shape, stream);
+    return stream.str();
+}
+
+bool Part::Tools::hasContent(const TopoDS_Shape& shape, const std::string& content)
+{
+    if (shape.IsNull()) {
+        return content.empty();
+    }
+    CompareBuffer buffer(content);
+    std::ostream stream(&buffer);
+    try {
+        BRepTools::Write(shape, stream);
+    }
+    catch (const Standard_Failure&) {
+        // writing may be aborted when the stream fails on a difference
+    }
+    return buffer.matches();
+}
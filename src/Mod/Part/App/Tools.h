@@ -40,6 +40,8 @@
 #include <TopLoc_Location.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Shape.hxx>
+#include <string>
 #include <vector>
 
 
@@ -225,6 +227,28 @@ public:
      * \return TopLoc_Location
      */
     static TopLoc_Location fromPlacement(const Base::Placement&);
+    /*!
+     * \brief contentKey
+     * Returns a key for the content of a shape made from its BRep text. The text
+     * contains the topology, the geometry and the order of the sub-shapes but not the
+     * identity of the TShapes, so copies of a shape get the same key. The text is
+     * hashed while it is written and is not kept in memory.
+     * \note Different shapes get the same key with a tiny probability only, use
+     * hasContent() to confirm a match.
+     * \return a 128 bit hash and the length of the text, empty for a null shape
+     */
+    static std::string contentKey(const TopoDS_Shape& shape);
+    /*!
+     * \brief content
+     * Returns the BRep text of a shape to confirm a match of contentKey() later.
+     */
+    static std::string content(const TopoDS_Shape& shape);
+    /*!
+     * \brief hasContent
+     * Checks whether the BRep text of a shape is \a content. The text is compared
+     * while it is written and is not kept in memory.
+     */
+    static bool hasContent(const TopoDS_Shape& shape, const std::string& content);
 };
 
 } //namespace Part
@@ -47,6 +47,7 @@
 #include "Area.h"
 #include "PathPy.h"
 #include "FeaturePath.h"
+#include "VoronoiPy.h"
 
 
 #define PATH_CATCH catch (Standard_Failure &e)                      \
@@ -89,9 +90,36 @@ namespace PathApp {
   public:
       VoronoiModule() : Py::ExtensionModule<VoronoiModule>("Voronoi")
       {
+          add_varargs_method("construct",&VoronoiModule::construct,
+              "construct(diagrams): Constructs the given independent voronoi diagrams concurrently"
+          );
           initialize("Working with Voronoi diagrams and data structures");
       }
       ~VoronoiModule() override {}
+
+  private:
+      Py::Object construct(const Py::Tuple& args)
+      {
+          PyObject *pDiagrams;
+          if (!PyArg_ParseTuple(args.ptr(), "O", &pDiagrams))
+              throw Py::Exception();
+
+          std::vector<Path::Voronoi*> diagrams;
+          Py::Sequence diagramSeq(pDiagrams);
+          for (Py::Sequence::iterator it = diagramSeq.begin(); it != diagramSeq.end(); ++it) {
+              PyObject* item = (*it).ptr();
+              if (!PyObject_TypeCheck(item, &(Path::VoronoiPy::Type)))
+                  throw Py::TypeError("the given list must only contain voronoi diagrams");
+              Path::Voronoi* vo = static_cast<Path::VoronoiPy*>(item)->getVoronoiPtr();
+              // a diagram listed twice must not be constructed twice at the same time
+              if (std::find(diagrams.begin(), diagrams.end(), vo) == diagrams.end())
+                  diagrams.push_back(vo);
+          }
+          try {
+              Path::Voronoi::construct(diagrams);
+              return Py::None();
+          } PATH_CATCH
+      }
   };
 
   class Module : public Py::ExtensionModule<Module>
@@ -26,7 +26,10 @@
 #define BOOST_GEOMETRY_DISABLE_DEPRECATED_03_WARNING
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <cfloat>
+# include <exception>
+# include <QtConcurrentMap>
 
 # include <boost_geometry.hpp>
 # include <boost/geometry/geometries/register/point.hpp>
@@ -39,6 +42,7 @@
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeEdge.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
@@ -52,6 +56,7 @@
 # include <GCPnts_UniformAbscissa.hxx>
 # include <GCPnts_UniformDeflection.hxx>
 # include <GeomAPI_ProjectPointOnCurve.hxx>
+# include <gp.hxx>
 # include <gp_Circ.hxx>
 # include <HLRAlgo_Projector.hxx>
 # include <HLRBRep_Algo.hxx>
@@ -95,15 +100,28 @@ using RParameters = bgi::linear<16>;
 BOOST_GEOMETRY_REGISTER_POINT_3D_GET_SET(
     gp_Pnt, double, bg::cs::cartesian, X, Y, Z, SetX, SetY, SetZ)
 
+// Warnings and errors may be printed by the worker threads of
+// runConcurrently(), which collects them in t_messages
+#define AREA_PRINT(_l, _style, _msg) do {\
+    if (FC_LOG_INSTANCE.isEnabled(_l)) {\
+        std::stringstream _str;\
+        FC_LOG_INSTANCE.prefix(_str, __FILE__, __LINE__) << _msg << std::endl;\
+        if (t_messages)\
+            t_messages->emplace_back(_style, _str.str());\
+        else\
+            Base::Console().Notify<_style>("", _str.str());\
+    }\
+} while(0)
+
 #define AREA_LOG FC_LOG
-#define AREA_WARN FC_WARN
-#define AREA_ERR FC_ERR
+#define AREA_WARN(_msg) AREA_PRINT(FC_LOGLEVEL_WARN, Base::LogStyle::Warning, _msg)
+#define AREA_ERR(_msg) AREA_PRINT(FC_LOGLEVEL_ERR, Base::LogStyle::Error, _msg)
 #define AREA_TRACE FC_TRACE
 #define AREA_XYZ FC_XYZ
 #define AREA_XY AREA_XY
 
 #ifdef FC_DEBUG
-#   define AREA_DBG FC_WARN
+#   define AREA_DBG AREA_WARN
 #else
 #   define AREA_DBG(...) do{}while(0)
 #endif
@@ -112,6 +130,67 @@ FC_LOG_LEVEL_INIT("Path.Area", true, true)
 
 using namespace Path;
 
+using AreaMessages = std::vector<std::pair<Base::LogStyle, std::string> >;
+static thread_local AreaMessages* t_messages;
+
+/** Calls func(i) for every i in [0, count) on the global thread pool
+ *
+ * The console is not thread safe, so the warnings and errors of the calls are
+ * printed in order by the calling thread afterwards, and the exception of the
+ * first failed call is rethrown. With a log level of Path.Area of at least
+ * FC_LOGLEVEL_LOG the calls are made one after another by the calling thread,
+ * because logging and Area::showShape() are not thread safe.
+ */
+template<class Func>
+static void runConcurrently(std::size_t count, Func func)
+{
+    if (count < 2 || FC_LOG_INSTANCE.isEnabled(FC_LOGLEVEL_LOG)) {
+        for (std::size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    struct Task {
+        std::size_t index;
+        AreaMessages messages;
+        std::exception_ptr error;
+    };
+    std::vector<Task> tasks(count);
+    for (std::size_t i = 0; i < count; ++i)
+        tasks[i].index = i;
+
+    QtConcurrent::blockingMap(tasks, [&func](Task& task) {
+        t_messages = &task.messages;
+        try {
+            func(task.index);
+        }
+        catch (...) {
+            task.error = std::current_exception();
+        }
+        t_messages = nullptr;
+    });
+
+    for (const Task& task : tasks) {
+        for (const auto& message : task.messages) {
+            if (t_messages) {
+                // called by a worker thread of an outer runConcurrently()
+                t_messages->push_back(message);
+                continue;
+            }
+            switch (message.first) {
+            case Base::LogStyle::Warning:
+                Base::Console().Notify<Base::LogStyle::Warning>("", message.second);
+                break;
+            default:
+                Base::Console().Notify<Base::LogStyle::Error>("", message.second);
+                break;
+            }
+        }
+        if (task.error)
+            std::rethrow_exception(task.error);
+    }
+}
+
 CAreaParams::CAreaParams()
     :PARAM_INIT(PARAM_FNAME, AREA_PARAMS_CAREA)
 {}
@@ -972,7 +1051,7 @@ struct WireJoiner {
                 // TechDraw even uses 0.1 as tolerance. Really? Why?
                 TopoDS_Wire wire = makeCleanWire(wireData, 0.01);
                 if (!BRep_Tool::IsClosed(wire)) {
-                    FC_WARN("failed to close some projection wire");
+                    AREA_WARN("failed to close some projection wire");
                     Area::showShape(wire, "failed");
                     ++skips;
                 }
@@ -1307,6 +1386,71 @@ int Area::project(TopoDS_Shape& shape_out,
     return skips;
 }
 
+/** Adds the Z ranges of a shape in which its cross sections change
+ *
+ * These are the ranges of all its faces and edges, except for the faces of
+ * vertical planes, cylinders and extrusions, and the vertical line edges.
+ * Between two ranges the shape is a prism along Z.
+ */
+static void getSectionChanges(const TopoDS_Shape& shape, std::vector<std::pair<double, double> >& ranges)
+{
+    auto addRange = [&ranges](const TopoDS_Shape& s) {
+        Bnd_Box box;
+        BRepBndLib::Add(s, box, Standard_False);
+        if (box.IsVoid())
+            return;
+        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+        box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        ranges.emplace_back(zMin - Precision::Confusion(), zMax + Precision::Confusion());
+    };
+
+    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+        BRepAdaptor_Surface surface(TopoDS::Face(xp.Current()));
+        bool vertical = false;
+        switch (surface.GetType()) {
+        case GeomAbs_Plane:
+            vertical = surface.Plane().Axis().Direction().IsNormal(gp::DZ(), Precision::Angular());
+            break;
+        case GeomAbs_Cylinder:
+            vertical = surface.Cylinder().Axis().Direction().IsParallel(gp::DZ(), Precision::Angular());
+            break;
+        case GeomAbs_SurfaceOfExtrusion:
+            vertical = surface.Direction().IsParallel(gp::DZ(), Precision::Angular());
+            break;
+        default:
+            break;
+        }
+        if (!vertical)
+            addRange(xp.Current());
+    }
+    for (TopExp_Explorer xp(shape, TopAbs_EDGE); xp.More(); xp.Next()) {
+        const TopoDS_Edge& edge = TopoDS::Edge(xp.Current());
+        if (BRep_Tool::Degenerated(edge))
+            continue;
+        BRepAdaptor_Curve curve(edge);
+        if (curve.GetType() == GeomAbs_Line
+                && curve.Line().Direction().IsParallel(gp::DZ(), Precision::Angular()))
+            continue;
+        addRange(edge);
+    }
+}
+
+/** Sorts the ranges and joins the overlapping ones */
+static void mergeRanges(std::vector<std::pair<double, double> >& ranges)
+{
+    if (ranges.empty())
+        return;
+    std::sort(ranges.begin(), ranges.end());
+    auto last = ranges.begin();
+    for (auto it = ranges.begin() + 1; it != ranges.end(); ++it) {
+        if (it->first <= last->second)
+            last->second = std::max(last->second, it->second);
+        else
+            *++last = *it;
+    }
+    ranges.erase(last + 1, ranges.end());
+}
+
 std::vector<shared_ptr<Area> > Area::makeSections(
     PARAM_ARGS(PARAM_FARG, AREA_PARAMS_SECTION_EXTRA),
     const std::vector<double>& _heights,
@@ -1445,43 +1589,55 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     std::vector<shared_ptr<Area> > sections;
     sections.reserve(heights.size());
 
-    std::list<Shape> projectedShapes;
+    TopLoc_Location locInverse(loc.Inverted());
+    auto makeArea = [&](double z) {
+        gp_Pln pln(gp_Pnt(0, 0, z), gp_Dir(0, 0, 1));
+        BRepLib_MakeFace mkFace(pln, xMin, xMax, yMin, yMax);
+        const TopoDS_Shape& face = mkFace.Face();
+
+        shared_ptr<Area> area(std::make_shared<Area>(&myParams));
+        area->myParams.Outline = false;
+        area->setPlane(face.Moved(locInverse));
+        return area;
+    };
+
     if (project) {
-        projectedShapes = getProjectedShapes(trsf, false);
+        std::list<Shape> projectedShapes = getProjectedShapes(trsf, false);
         if (projectedShapes.empty()) {
             AREA_ERR("empty projection");
             return sections;
         }
+        for (double z : heights) {
+            shared_ptr<Area> area = makeArea(z);
+            gp_Trsf t;
+            t.SetTranslation(gp_Vec(0, 0, z));
+            TopLoc_Location wloc(t);
+            for (const auto& s : projectedShapes)
+                area->add(s.shape.Moved(wloc).Moved(locInverse), s.op);
+            sections.push_back(area);
+        }
+        runConcurrently(sections.size(), [&](std::size_t i) { sections[i]->getShape(); });
+        FC_TIME_LOG(t, "makeSection count: " << sections.size() << ", total");
+        return sections;
     }
 
     tolerance *= 2.0;
     bool can_retry = fabs(tolerance) > Precision::Confusion();
-    TopLoc_Location locInverse(loc.Inverted());
 
-    for (size_t i = 0; i < heights.size(); ++i) {
+    struct Section {
+        shared_ptr<Area> area;
+        double z = 0.0;     // the sectioned height, differs from the requested one after a retry
+    };
+    std::vector<Section> results(heights.size());
+
+    auto makeSection = [&](std::size_t i) {
         double z = heights[i];
         bool retried = !can_retry;
         while (true) {
             gp_Pln pln(gp_Pnt(0, 0, z), gp_Dir(0, 0, 1));
             Standard_Real a, b, c, d;
             pln.Coefficients(a, b, c, d);
-            BRepLib_MakeFace mkFace(pln, xMin, xMax, yMin, yMax);
-            const TopoDS_Shape& face = mkFace.Face();
-
-            shared_ptr<Area> area(std::make_shared<Area>(&myParams));
-            area->myParams.Outline = false;
-            area->setPlane(face.Moved(locInverse));
-
-            if (project) {
-                for (const auto& s : projectedShapes) {
-                    gp_Trsf t;
-                    t.SetTranslation(gp_Vec(0, 0, -d));
-                    TopLoc_Location wloc(t);
-                    area->add(s.shape.Moved(wloc).Moved(locInverse), s.op);
-                }
-                sections.push_back(area);
-                break;
-            }
+            shared_ptr<Area> area = makeArea(z);
 
             for (auto it = myShapes.begin(); it != myShapes.end(); ++it) {
                 const auto& s = *it;
@@ -1491,8 +1647,12 @@ std::vector<shared_ptr<Area> > Area::makeSections(
 
                 for (TopExp_Explorer xp(s.shape.Moved(loc), TopAbs_SOLID); xp.More(); xp.Next()) {
                     showShape(xp.Current(), nullptr, "section_%u_shape", i);
+                    // The boolean operation of the section may update the
+                    // tolerances of its arguments, so every height slices
+                    // its own copy of the solid
+                    BRepBuilderAPI_Copy copy(xp.Current(), Standard_False);
                     std::list<TopoDS_Wire> wires;
-                    Part::CrossSection section(a, b, c, xp.Current());
+                    Part::CrossSection section(a, b, c, copy.Shape());
                     wires = section.slice(-d);
                     showShapes(wires, nullptr, "section_%u_wire", i);
                     if (wires.empty()) {
@@ -1550,9 +1710,12 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 }
             }
             if (!area->myShapes.empty()) {
-                sections.push_back(area);
+                // build the section on this thread, too
+                const TopoDS_Shape& shape = area->getShape();
+                results[i].area = area;
+                results[i].z = z;
                 FC_TIME_LOG(t1, "makeSection " << z);
-                showShape(area->getShape(), nullptr, "section_%u_final", i);
+                showShape(shape, nullptr, "section_%u_final", i);
                 break;
             }
             if (retried) {
@@ -1565,6 +1728,59 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 retried = true;
             }
         }
+    };
+
+    // Between two changes of the cross sections the solids are prisms along
+    // Z, so only the first height in between is sectioned and the others get
+    // a translated copy of it.
+    std::vector<std::pair<double, double> > changes;
+    for (const Shape& s : myShapes)
+        getSectionChanges(s.shape.Moved(loc), changes);
+    mergeRanges(changes);
+
+    std::vector<std::size_t> sources(heights.size());
+    std::map<std::size_t, std::size_t> firstInGap;
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < heights.size(); ++i) {
+        sources[i] = i;
+        double z = heights[i];
+        auto it = std::lower_bound(changes.begin(), changes.end(), z,
+            [](const std::pair<double, double>& range, double z) { return range.second < z; });
+        if (it == changes.end() || it->first > z)
+            sources[i] = firstInGap.emplace(it - changes.begin(), i).first->second;
+        if (sources[i] == i)
+            pending.push_back(i);
+    }
+
+    runConcurrently(pending.size(), [&](std::size_t k) { makeSection(pending[k]); });
+
+    pending.clear();
+    for (std::size_t i = 0; i < heights.size(); ++i) {
+        if (sources[i] != i)
+            pending.push_back(i);
+    }
+    runConcurrently(pending.size(), [&](std::size_t k) {
+        std::size_t i = pending[k];
+        const Section& source = results[sources[i]];
+        // a section that was discarded or retried is not reused
+        if (!source.area || source.z != heights[sources[i]]) {
+            makeSection(i);
+            return;
+        }
+        gp_Trsf t;
+        t.SetTranslation(gp_Vec(0, 0, heights[i] - source.z));
+        TopLoc_Location zloc(t);
+        shared_ptr<Area> area = makeArea(heights[i]);
+        for (const Shape& s : source.area->myShapes)
+            area->add(s.shape.Moved(loc).Moved(zloc).Moved(locInverse), s.op);
+        area->getShape();
+        results[i].area = area;
+        results[i].z = heights[i];
+    });
+
+    for (const Section& section : results) {
+        if (section.area)
+            sections.push_back(section.area);
     }
     FC_TIME_LOG(t, "makeSection count: " << sections.size() << ", total");
     return sections;
@@ -1752,17 +1968,20 @@ TopoDS_Shape Area::toShape(CArea& area, short fill, int reorient) {
     return toShape(area, bFill, &trsf, reorient);
 }
 
-
+// the sections are processed concurrently when all of them are requested
 #define AREA_SECTION(_op,_index,...) do {\
     if(mySections.size()) {\
         if(_index>=(int)mySections.size())\
             return TopoDS_Shape();\
         if(_index<0) {\
+            std::vector<TopoDS_Shape> shapes(mySections.size());\
+            runConcurrently(mySections.size(), [&](std::size_t i) {\
+                shapes[i] = mySections[i]->_op(_index, ## __VA_ARGS__);\
+            });\
             BRep_Builder builder;\
             TopoDS_Compound compound;\
             builder.MakeCompound(compound);\
-            for(shared_ptr<Area> area : mySections){\
-                const TopoDS_Shape &s = area->_op(_index, ## __VA_ARGS__);\
+            for(const TopoDS_Shape &s : shapes){\
                 if(s.IsNull()) continue;\
                 builder.Add(compound,s);\
             }\
@@ -3197,7 +3416,7 @@ static inline void addParameter(bool verbose, Command& cmd, const char* name,
         cmd.Parameters[name] = relative ? d : next;
 }
 
-static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+static inline Command makeGCode(bool verbose, const gp_Pnt& last,
     const gp_Pnt& next, const char* name)
 {
     Command cmd;
@@ -3205,19 +3424,25 @@ static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
     addParameter(verbose, cmd, "X", last.X(), next.X());
     addParameter(verbose, cmd, "Y", last.Y(), next.Y());
     addParameter(verbose, cmd, "Z", last.Z(), next.Z());
-    path.addCommand(cmd);
+    return cmd;
+}
+
+static inline void addGCode(bool verbose, Toolpath& path, const gp_Pnt& last,
+    const gp_Pnt& next, const char* name)
+{
+    path.addCommand(makeGCode(verbose, last, next, name));
     return;
 }
 
 static inline void addG1(bool verbose, Toolpath& path, const gp_Pnt& last,
     const gp_Pnt& next, double f, double& last_f)
 {
-    addGCode(verbose, path, last, next, "G1");
+    Command cmd = makeGCode(verbose, last, next, "G1");
     if (f > Precision::Confusion()) {
-        Command* cmd = path.getCommands().back();
-        addParameter(verbose, *cmd, "F", last_f, f);
+        addParameter(verbose, cmd, "F", last_f, f);
         last_f = f;
     }
+    path.addCommand(cmd);
     return;
 }
 
@@ -22,6 +22,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 # include <cinttypes>
 # include <iomanip>
 # include <boost/algorithm/string.hpp>
@@ -99,40 +100,61 @@ bool Command::has(const std::string& attr) const
 
 std::string Command::toGCode (int precision, bool padzero) const
 {
-    std::stringstream str;
-    str.fill('0');
-    str << Name;
-    if(precision<0)
-        precision = 0;
-    double scale = std::pow(10.0,precision+1);
-    std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
+    std::string str(Name);
+    char buf[48];
     for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         if(i->first == "N") continue;
 
-        str << " " << i->first;
+        str += ' ';
+        str += i->first;
+        str.append(buf, writeValue(buf, i->second, precision, padzero));
+    }
+    return str;
+}
 
-        std::int64_t v = static_cast<std::int64_t>(i->second*scale);
-        if(v<0) {
-            v = -v;
-            str << '-'; //shall we allow -0 ?
-        }
-        v+=5;
-        v /= 10;
-        str << (v/iscale);
-        if(!precision) continue;
+char *Command::writeValue(char *buf, double value, int precision, bool padzero)
+{
+    // the value is written as a fixed point number with an integer arithmetic,
+    // the scale must fit into an int64
+    static const double scales[] = {1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+    precision = std::max(0, std::min(precision, 17));
+    double scale = scales[precision];
+    std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
 
-        int width = precision;
-        std::int64_t digits = v%iscale;
-        if(!padzero) {
-            if(!digits) continue;
-            while(digits%10 == 0) {
-                digits/=10;
-                --width;
-            }
+    std::int64_t v = static_cast<std::int64_t>(value*scale);
+    if(v<0) {
+        v = -v;
+        *buf++ = '-'; //shall we allow -0 ?
+    }
+    v+=5;
+    v /= 10;
+
+    char digits[20];
+    char *it = digits + sizeof(digits);
+    std::int64_t whole = v/iscale;
+    do {
+        *--it = static_cast<char>('0' + whole%10);
+        whole /= 10;
+    } while (whole);
+    buf = std::copy(it, digits + sizeof(digits), buf);
+    if(!precision) return buf;
+
+    int width = precision;
+    std::int64_t fraction = v%iscale;
+    if(!padzero) {
+        if(!fraction) return buf;
+        while(fraction%10 == 0) {
+            fraction/=10;
+            --width;
         }
-        str << '.' << std::setw(width) << std::right << digits;
     }
-    return str.str();
+    *buf++ = '.';
+    for (int i = width - 1; i >= 0; --i) {
+        buf[i] = static_cast<char>('0' + fraction%10);
+        fraction /= 10;
+    }
+    return buf + width;
 }
 
 void Command::setFromGCode (const std::string& str)
@@ -59,6 +59,7 @@ namespace Path
         Command transform(const Base::Placement&); // returns a transformed copy of this command
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
+        static char *writeValue(char *buf, double value, int precision=6, bool padzero=true); // writes a parameter value as toGCode() does to buf, which must hold 48 characters, and returns its end
 
         // this assumes the name is upper case
         inline double getParam(const std::string &name, double fallback = 0.0) const {
@@ -21,6 +21,14 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cstdlib>
+# include <cstring>
+# include <iterator>
+# include <limits>
+# include <QtConcurrentMap>
+#endif
 
 #include <App/Application.h>
 #include <Base/Console.h>
@@ -38,20 +46,18 @@ using namespace Base;
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence)
 
 Toolpath::Toolpath()
+    : offsets(1, 0)
 {
 }
 
 Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
-    , center(otherPath.center)
+    : Base::Persistence()
 {
     *this = otherPath;
-    recalculate();
 }
 
 Toolpath::~Toolpath()
 {
-    clear();
 }
 
 Toolpath &Toolpath::operator=(const Toolpath& otherPath)
@@ -59,12 +65,15 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
     if (this == &otherPath)
         return *this;
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
-    }
+    opcodes = otherPath.opcodes;
+    nameIds = otherPath.nameIds;
+    masks = otherPath.masks;
+    offsets = otherPath.offsets;
+    values = otherPath.values;
+    names = otherPath.names;
+    nameCodes = otherPath.nameCodes;
+    nameIndex = otherPath.nameIndex;
+    extraParameters = otherPath.extraParameters;
     center = otherPath.center;
     recalculate();
     return *this;
@@ -72,16 +81,148 @@ Toolpath &Toolpath::operator=(const Toolpath& otherPath)
 
 void Toolpath::clear()
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    opcodes.clear();
+    nameIds.clear();
+    masks.clear();
+    offsets.assign(1, 0);
+    values.clear();
+    names.clear();
+    nameCodes.clear();
+    nameIndex.clear();
+    extraParameters.clear();
     recalculate();
 }
 
+Toolpath::Opcode Toolpath::opcodeOf(const std::string &name)
+{
+    static const std::unordered_map<std::string, Opcode> codes = {
+        {"G0", Opcode::Rapid}, {"G00", Opcode::Rapid},
+        {"G1", Opcode::Feed}, {"G01", Opcode::Feed},
+        {"G2", Opcode::ArcCW}, {"G02", Opcode::ArcCW},
+        {"G3", Opcode::ArcCCW}, {"G03", Opcode::ArcCCW},
+        {"G17", Opcode::PlaneXY}, {"G18", Opcode::PlaneXZ}, {"G19", Opcode::PlaneYZ},
+        {"G20", Opcode::Inches}, {"G21", Opcode::Metric},
+        {"G38.2", Opcode::Probe}, {"G38.3", Opcode::Probe},
+        {"G38.4", Opcode::Probe}, {"G38.5", Opcode::Probe},
+        {"G73", Opcode::Drill}, {"G81", Opcode::Drill}, {"G82", Opcode::Drill},
+        {"G83", Opcode::Drill}, {"G84", Opcode::Drill}, {"G85", Opcode::Drill},
+        {"G86", Opcode::Drill}, {"G89", Opcode::Drill},
+        {"G90", Opcode::Absolute}, {"G91", Opcode::Relative},
+        {"G90.1", Opcode::AbsoluteCenter}, {"G91.1", Opcode::RelativeCenter},
+    };
+    auto it = codes.find(name);
+    return it == codes.end() ? Opcode::Other : it->second;
+}
+
+std::uint32_t Toolpath::nameId(const std::string &name)
+{
+    // consecutive commands mostly share their name
+    if (!nameIds.empty() && names[nameIds.back()] == name)
+        return nameIds.back();
+
+    auto res = nameIndex.emplace(name, static_cast<std::uint32_t>(names.size()));
+    if (res.second) {
+        names.push_back(name);
+        nameCodes.push_back(opcodeOf(name));
+    }
+    return res.first->second;
+}
+
+// moves the extra parameters of the commands from pos on by the given offset
+static void shiftExtraParameters(std::map<unsigned int, std::map<std::string, double> > &extra,
+                                 unsigned int pos, int offset)
+{
+    std::map<unsigned int, std::map<std::string, double> > shifted;
+    for (auto it = extra.lower_bound(pos); it != extra.end();) {
+        auto node = extra.extract(it++);
+        node.key() += offset;
+        shifted.insert(std::move(node));
+    }
+    extra.merge(shifted);
+}
+
+void Toolpath::packCommand(const Command &cmd, unsigned int pos)
+{
+    std::uint32_t mask = 0;
+    double slots[26];
+    std::map<std::string, double> extra;
+    for (const auto &param : cmd.Parameters) {
+        std::uint32_t bit = param.first.size() == 1 ? slotBit(param.first[0]) : 0;
+        if (bit) {
+            mask |= bit;
+            slots[param.first[0] - 'A'] = param.second;
+        }
+        else {
+            extra.insert(param);
+        }
+    }
+    insertPacked(pos, cmd.Name, mask, slots, std::move(extra));
+}
+
+// inserts a command whose parameter values are given by slot
+void Toolpath::insertPacked(unsigned int pos, const std::string &name, std::uint32_t mask,
+                            const double *slots, std::map<std::string, double> &&extra)
+{
+    double packed[26];
+    int count = 0;
+    for (std::uint32_t bits = mask, slot = 0; bits; bits >>= 1, ++slot) {
+        if (bits & 1)
+            packed[count++] = slots[slot];
+    }
+
+    std::uint32_t id = nameId(name);
+    Opcode code = nameCodes[id];
+    std::uint32_t first = offsets[pos];
+    if (pos == opcodes.size()) {
+        opcodes.push_back(code);
+        nameIds.push_back(id);
+        masks.push_back(mask);
+        values.insert(values.end(), packed, packed + count);
+        offsets.push_back(first + count);
+    }
+    else {
+        opcodes.insert(opcodes.begin() + pos, code);
+        nameIds.insert(nameIds.begin() + pos, id);
+        masks.insert(masks.begin() + pos, mask);
+        values.insert(values.begin() + first, packed, packed + count);
+        offsets.insert(offsets.begin() + pos, first);
+        for (auto it = offsets.begin() + pos + 1; it != offsets.end(); ++it)
+            *it += count;
+        shiftExtraParameters(extraParameters, pos, 1);
+    }
+    if (!extra.empty())
+        extraParameters[pos] = std::move(extra);
+}
+
+Command Toolpath::getCommand(unsigned int pos) const
+{
+    Command cmd;
+    cmd.Name = getName(pos);
+    std::uint32_t index = offsets[pos];
+    char key[2] = {'A', 0};
+    for (std::uint32_t mask = masks[pos]; mask; mask >>= 1, ++key[0]) {
+        if (mask & 1)
+            cmd.Parameters.emplace_hint(cmd.Parameters.end(), key, values[index++]);
+    }
+    auto it = extraParameters.find(pos);
+    if (it != extraParameters.end())
+        cmd.Parameters.insert(it->second.begin(), it->second.end());
+    return cmd;
+}
+
+Vector3d Toolpath::getPosition(unsigned int pos, const Vector3d &last) const
+{
+    return Vector3d(getParam(pos, 'X', last.x), getParam(pos, 'Y', last.y), getParam(pos, 'Z', last.z));
+}
+
+Vector3d Toolpath::getArcCenter(unsigned int pos) const
+{
+    return Vector3d(getParam(pos, 'I'), getParam(pos, 'J'), getParam(pos, 'K'));
+}
+
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
+    packCommand(Cmd, getSize());
     recalculate();
 }
 
@@ -89,9 +230,8 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
     if (pos == -1) {
         addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
+    } else if (pos <= static_cast<int>(getSize())) {
+        packCommand(Cmd, pos);
     } else {
         throw Base::IndexError("Index not in range");
     }
@@ -101,33 +241,43 @@ void Toolpath::insertCommand(const Command &Cmd, int pos)
 void Toolpath::deleteCommand(int pos)
 {
     if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
-    } else {
+        pos = static_cast<int>(getSize()) - 1;
+        if (pos < 0)
+            return;
+    } else if (pos >= static_cast<int>(getSize())) {
         throw Base::IndexError("Index not in range");
     }
+
+    std::uint32_t first = offsets[pos];
+    std::uint32_t count = offsets[pos + 1] - first;
+    opcodes.erase(opcodes.begin() + pos);
+    nameIds.erase(nameIds.begin() + pos);
+    masks.erase(masks.begin() + pos);
+    values.erase(values.begin() + first, values.begin() + first + count);
+    offsets.erase(offsets.begin() + pos);
+    for (auto it = offsets.begin() + pos; it != offsets.end(); ++it)
+        *it -= count;
+    extraParameters.erase(pos);
+    shiftExtraParameters(extraParameters, pos + 1, -1);
     recalculate();
 }
 
-double Toolpath::getLength()
+double Toolpath::getLength() const
 {
-    if(vpcCommands.empty())
-        return 0;
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement(last).getPosition();
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+    for (unsigned int i = 0; i < getSize(); i++) {
+        Opcode code = opcodes[i];
+        if ( (code == Opcode::Rapid) || (code == Opcode::Feed) ) {
             // straight line
+            next = getPosition(i, last);
             l += (next - last).Length();
             last = next;
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if ( (code == Opcode::ArcCW) || (code == Opcode::ArcCCW) ) {
             // arc
-            Vector3d center = (*it)->getCenter();
+            next = getPosition(i, last);
+            Vector3d center = getArcCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -137,7 +287,7 @@ double Toolpath::getLength()
     return l;
 }
 
-double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid)
+double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid) const
 {
     // check the feedrates are set
     if ((hFeed == 0) || (vFeed == 0)) {
@@ -156,41 +306,29 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
         vRapid = vFeed;
     }
 
-    if (vpcCommands.empty()) {
-        return 0;
-    }
     double l = 0;
     double time = 0;
-    bool verticalMove = false;
+    double feedrate = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for (std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        float feedrate = (*it)->getParam("F");
+    for (unsigned int i = 0; i < getSize(); i++) {
+        Opcode code = opcodes[i];
 
         l = 0;
-        verticalMove = false;
-        feedrate = hFeed;
-        next = (*it)->getPlacement(last).getPosition();
+        next = getPosition(i, last);
+        bool verticalMove = (last.z != next.z);
+        feedrate = verticalMove ? vFeed : hFeed;
 
-        if (last.z != next.z){
-            verticalMove = true;
-            feedrate = vFeed;
-        }
-
-        if ((name == "G0") || (name == "G00")){
+        if (code == Opcode::Rapid) {
             // Rapid Move
             l += (next - last).Length();
-            feedrate = hRapid;
-            if(verticalMove){
-                feedrate = vRapid;
-            }
-        }else if ((name == "G1") || (name == "G01")) {
+            feedrate = verticalMove ? vRapid : hRapid;
+        } else if (code == Opcode::Feed) {
             // Feed Move
             l += (next - last).Length();
-        }else if ((name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if ( (code == Opcode::ArcCW) || (code == Opcode::ArcCCW) ) {
             // Arc Move
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = getArcCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -274,91 +412,433 @@ Base::BoundBox3d Toolpath::getBoundBox() const
     return visitor.bb;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+// size of the parts of a G-code text or of a toolpath that are processed in parallel
+static const std::size_t gcodePartSize = 1 << 20;
+static const unsigned int commandPartSize = 1 << 16;
+
+static inline bool isDigit(char c)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool isLetter(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static inline bool isCommandStart(char c)
+{
+    return c == 'G' || c == 'g' || c == 'M' || c == 'm' || c == '(';
+}
+
+static inline char toUpper(char c)
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// the parameters that are converted from inches
+static inline bool isLength(char c)
+{
+    switch (c) {
+    case 'X': case 'Y': case 'Z': case 'I': case 'J': case 'R': case 'Q': case 'F':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void scaleToMillimeters(std::uint32_t mask, double *slots, std::map<std::string, double> &extra)
+{
+    for (char c = 'A'; mask; mask >>= 1, ++c) {
+        if ((mask & 1) && isLength(c))
+            slots[c - 'A'] *= 25.4;
+    }
+    for (auto &param : extra) {
+        if (isLength(param.first[0]))
+            param.second *= 25.4;
+    }
+}
+
+/*
+ * Parses a G-code value the way atof() does. The value only consists of digits,
+ * '-' and '.', the number ends at the first character that doesn't fit. Values
+ * with up to 15 significant digits are converted exactly with a single division
+ * or multiplication by a power of ten, all others by strtod().
+ */
+static double parseValue(const std::string &value)
+{
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *it = value.c_str();
+    bool negative = (*it == '-');
+    if (negative)
+        ++it;
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool number = false;
+    for (; isDigit(*it); ++it, number = true) {
+        if (mantissa || *it != '0') {
+            mantissa = mantissa * 10 + (*it - '0');
+            ++digits;
+        }
+        if (digits > 15)
+            return std::strtod(value.c_str(), nullptr);
+    }
+    if (*it == '.') {
+        for (++it; isDigit(*it); ++it, number = true) {
+            if (mantissa || *it != '0') {
+                mantissa = mantissa * 10 + (*it - '0');
+                ++digits;
+            }
+            --exponent;
+            if (digits > 15 || exponent < -22)
+                return std::strtod(value.c_str(), nullptr);
+        }
+    }
+    if (!number)
+        return 0.0;
+
+    double result = exponent < 0 ? double(mantissa) / powers[-exponent] : double(mantissa);
+    return negative ? -result : result;
+}
+
+/*
+ * Splits the G-code text into parts that start with a command or a comment. Only
+ * the parentheses are tracked on the way, so that no part starts inside a comment.
+ */
+static std::vector<std::pair<const char*, const char*> > splitGCode(const char *begin, const char *end)
+{
+    std::vector<std::pair<const char*, const char*> > parts;
+    const char *start = begin;
+    const char *ptr = begin;
+    bool comment = false;
+    while (static_cast<std::size_t>(end - start) > gcodePartSize + gcodePartSize / 2) {
+        const char *target = std::max(start + gcodePartSize, ptr);
+        for (;;) {
+            const char *next = static_cast<const char*>(std::memchr(ptr, comment ? ')' : '(', end - ptr));
+            if (!next || next >= target)
+                break;
+            comment = !comment;
+            ptr = next + 1;
+        }
+        for (ptr = target; ptr != end; ++ptr) {
+            if (comment) {
+                if (*ptr == ')')
+                    comment = false;
+            }
+            else if (isCommandStart(*ptr)) {
+                break;
+            }
+        }
+        if (ptr == end)
+            break;
+        parts.emplace_back(start, ptr);
+        start = ptr;
+    }
+    parts.emplace_back(start, end);
+    return parts;
+}
+
+/*
+ * Appends the commands of the G-code text to the path in a single pass. The text
+ * is split into commands at each G or M and at each comment in parentheses, text
+ * before the first command and after a comment is skipped. The commands are read
+ * like Command::setFromGCode() does it. With inches given, G20 and G21 switch
+ * between inches and millimeters and aren't added, otherwise they are added as
+ * commands and the values are not converted.
+ */
+void Toolpath::parseGCode(const char *begin, const char *end, bool *inches)
+{
+    enum class Mode { None, Command, Argument };
+    std::string name;
+    std::string value;
+    double slots[26];
+    std::uint32_t mask = 0;
+    std::map<std::string, double> extra;
+
+    auto setParameter = [&](char key) {
+        double val = parseValue(value);
+        std::uint32_t bit = slotBit(toUpper(key));
+        if (bit) {
+            mask |= bit;
+            slots[toUpper(key) - 'A'] = val;
+        }
+        else {
+            extra[std::string(1, key)] = val;
+        }
+    };
+
+    const char *it = begin;
+    while (it != end) {
+        if (!isCommandStart(*it)) {
+            ++it;
+            continue;
+        }
+
+        if (*it == '(') {
+            // comment, the name is the text without nested opening parentheses
+            const char *close = static_cast<const char*>(std::memchr(it + 1, ')', end - it - 1));
+            if (!close)
+                break;
+            name.assign(1, '(');
+            for (const char *c = it + 1; c != close; ++c) {
+                if (*c != '(')
+                    name += *c;
+            }
+            name += ')';
+            std::map<std::string, double> none;
+            insertPacked(getSize(), name, 0, slots, std::move(none));
+            it = close + 1;
+            continue;
+        }
+
+        Mode mode = Mode::None;
+        char key = 0;
+        value.clear();
+        mask = 0;
+        extra.clear();
+        for (; it != end; ++it) {
+            char c = *it;
+            if (isDigit(c) || c == '-' || c == '.') {
+                value += c;
+            }
+            else if (isLetter(c)) {
+                if (mode != Mode::None && (c == 'G' || c == 'g' || c == 'M' || c == 'm'))
+                    break;
+                if (mode == Mode::Command) {
+                    if (!key || value.empty())
+                        throw Base::BadFormatError("Badly formatted GCode command");
+                    name.assign(1, toUpper(key));
+                    name += value;
+                    value.clear();
+                    mode = Mode::Argument;
+                }
+                else if (mode == Mode::None) {
+                    mode = Mode::Command;
+                }
+                else {
+                    if (!key || value.empty())
+                        throw Base::BadFormatError("Badly formatted GCode argument");
+                    setParameter(key);
+                    value.clear();
+                }
+                key = c;
+            }
+            else if (c == '(') {
+                break;
+            }
+            else if (c == ')') {
+                key = '(';
+                value += ')';
+            }
+        }
+
+        if (!key || value.empty())
+            throw Base::BadFormatError("Badly formatted GCode argument");
+        if (mode == Mode::Command) {
+            name.assign(1, toUpper(key));
+            name += value;
+        }
+        else {
+            setParameter(key);
+        }
+
         if (inches) {
-            cmd->scaleBy(25.4);
+            if (name == "G20") {
+                *inches = true;
+                continue;
+            }
+            if (name == "G21") {
+                *inches = false;
+                continue;
+            }
+            if (*inches)
+                scaleToMillimeters(mask, slots, extra);
         }
-        commands.push_back(cmd);
+        insertPacked(getSize(), name, mask, slots, std::move(extra));
+        extra.clear();
     }
 }
 
-void Toolpath::setFromGCode(const std::string instr)
+// appends a path read by parseGCode() without the inches handling
+void Toolpath::appendParsed(const Toolpath &part, bool &inches)
 {
-    clear();
+    std::vector<std::uint32_t> ids(part.names.size(), std::numeric_limits<std::uint32_t>::max());
+    for (unsigned int i = 0; i < part.getSize(); i++) {
+        Opcode code = part.opcodes[i];
+        if (code == Opcode::Inches) {
+            inches = true;
+            continue;
+        }
+        if (code == Opcode::Metric) {
+            inches = false;
+            continue;
+        }
 
-    // remove comments
-    //boost::regex e("\\(.*?\\)");
-    //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
+        std::uint32_t &id = ids[part.nameIds[i]];
+        if (id == std::numeric_limits<std::uint32_t>::max())
+            id = nameId(part.names[part.nameIds[i]]);
+        std::uint32_t mask = part.masks[i];
+        const double *first = part.values.data() + part.offsets[i];
+        const double *last = part.values.data() + part.offsets[i + 1];
 
-    // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
-    while (found != std::string::npos)
-    {
-        if (str[found] == '(') {
-            // start of comment
-            if ( (last > -1) && (mode == "command") ) {
-                // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+        unsigned int pos = getSize();
+        opcodes.push_back(code);
+        nameIds.push_back(id);
+        masks.push_back(mask);
+        values.insert(values.end(), first, last);
+        offsets.push_back(static_cast<std::uint32_t>(values.size()));
+
+        auto extra = part.extraParameters.find(i);
+        if (extra != part.extraParameters.end())
+            extraParameters[pos] = extra->second;
+
+        if (inches) {
+            auto value = values.end() - (last - first);
+            for (char c = 'A'; mask; mask >>= 1, ++c) {
+                if (mask & 1) {
+                    if (isLength(c))
+                        *value *= 25.4;
+                    ++value;
+                }
             }
-            mode = "comment";
-            last = found;
-            found = str.find_first_of(')', found+1);
-        } else if (str[found] == ')') {
-            // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
-            // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+            if (extra != part.extraParameters.end()) {
+                for (auto &param : extraParameters[pos]) {
+                    if (isLength(param.first[0]))
+                        param.second *= 25.4;
+                }
             }
-            last = found;
-            found = str.find_first_of("(gGmM", found+1);
         }
     }
-    // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
+}
+
+void Toolpath::setFromGCode(const std::string instr)
+{
+    clear();
+
+    const char *begin = instr.c_str();
+    const char *end = begin + instr.size();
+    std::vector<std::pair<const char*, const char*> > ranges = splitGCode(begin, end);
+    bool inches = false;
+    if (ranges.size() == 1) {
+        parseGCode(begin, end, &inches);
+        recalculate();
+        return;
+    }
+
+    // the parts are read in parallel, a G20 or G21 affects the following parts
+    // so the conversion from inches is done when they are joined
+    struct Part {
+        const char *begin;
+        const char *end;
+        Toolpath path;
+        std::string error;
+    };
+    std::vector<Part> parts;
+    parts.reserve(ranges.size());
+    for (const auto &range : ranges)
+        parts.push_back({range.first, range.second, Toolpath(), std::string()});
+
+    QtConcurrent::blockingMap(parts, [](Part &part) {
+        try {
+            part.path.parseGCode(part.begin, part.end, nullptr);
+        }
+        catch (const Base::Exception &e) {
+            part.error = e.what();
+        }
+    });
+
+    std::size_t numValues = 0;
+    for (const auto &part : parts)
+        numValues += part.path.values.size();
+    values.reserve(numValues);
+
+    for (const auto &part : parts) {
+        appendParsed(part.path, inches);
+        if (!part.error.empty()) {
+            recalculate();
+            throw Base::BadFormatError(part.error);
         }
     }
     recalculate();
 }
 
-std::string Toolpath::toGCode() const
+void Toolpath::writeCommand(std::string &str, unsigned int pos, int precision, bool padzero) const
+{
+    // same output as Command::toGCode(), the slots and the extra parameters are
+    // merged in the order of their names
+    static const std::map<std::string, double> noExtra;
+    auto found = extraParameters.find(pos);
+    const std::map<std::string, double> &extra = found == extraParameters.end() ? noExtra : found->second;
+    auto it = extra.begin();
+    char buf[48];
+
+    str += getName(pos);
+    std::uint32_t index = offsets[pos];
+    char key[2] = {'A', 0};
+    for (std::uint32_t mask = masks[pos]; mask; mask >>= 1, ++key[0]) {
+        if (!(mask & 1))
+            continue;
+        for (; it != extra.end() && it->first < key; ++it) {
+            str += ' ';
+            str += it->first;
+            str.append(buf, Command::writeValue(buf, it->second, precision, padzero));
+        }
+        double value = values[index++];
+        if (key[0] == 'N')
+            continue;
+        str += ' ';
+        str += key[0];
+        str.append(buf, Command::writeValue(buf, value, precision, padzero));
+    }
+    for (; it != extra.end(); ++it) {
+        str += ' ';
+        str += it->first;
+        str.append(buf, Command::writeValue(buf, it->second, precision, padzero));
+    }
+}
+
+std::string Toolpath::toGCode(unsigned int begin, unsigned int end) const
 {
-    std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
-        result += "\n";
+    if (end - begin <= commandPartSize) {
+        std::string str;
+        str.reserve((end - begin) * 40);
+        for (unsigned int i = begin; i < end; i++) {
+            writeCommand(str, i, 6, true);
+            str += '\n';
+        }
+        return str;
     }
-    return result;
+
+    std::vector<std::pair<unsigned int, unsigned int> > ranges;
+    for (unsigned int i = begin; i < end; i += commandPartSize)
+        ranges.emplace_back(i, std::min(i + commandPartSize, end));
+    std::vector<std::string> parts(ranges.size());
+    QtConcurrent::blockingMap(ranges, [&](const std::pair<unsigned int, unsigned int> &range) {
+        parts[(range.first - begin) / commandPartSize] = toGCode(range.first, range.second);
+    });
+
+    std::size_t size = 0;
+    for (const auto &part : parts)
+        size += part.size();
+    std::string str;
+    str.reserve(size);
+    for (const auto &part : parts)
+        str += part;
+    return str;
+}
+
+std::string Toolpath::toGCode() const
+{
+    return toGCode(0, getSize());
 }
 
 void Toolpath::recalculate() // recalculates the path cache
 {
 
-    if(vpcCommands.empty())
+    if(opcodes.empty())
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -422,7 +902,14 @@ void Toolpath::recalculate() // recalculates the path cache
 
 unsigned int Toolpath::getMemSize () const
 {
-    return toGCode().size();
+    std::size_t size = opcodes.capacity() * sizeof(Opcode)
+                     + (nameIds.capacity() + masks.capacity() + offsets.capacity()) * sizeof(std::uint32_t)
+                     + values.capacity() * sizeof(double);
+    for (const auto &name : names)
+        size += sizeof(std::string) + name.capacity();
+    for (const auto &extra : extraParameters)
+        size += extra.second.size() * (sizeof(std::string) + sizeof(double));
+    return static_cast<unsigned int>(size);
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -443,7 +930,7 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            getCommand(i).Save(writer);
         }
         writer.decInd();
     } else {
@@ -458,9 +945,12 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
-        return;
-    writer.Stream() << toGCode();
+    // written in batches to not hold the whole text of a large path
+    const unsigned int batchSize = 16 * commandPartSize;
+    for (unsigned int i = 0; i < getSize(); i += batchSize) {
+        std::string gcode = toGCode(i, std::min(i + batchSize, getSize()));
+        writer.Stream().write(gcode.c_str(), gcode.size());
+    }
 }
 
 void Toolpath::Restore(XMLReader &reader)
@@ -476,12 +966,7 @@ void Toolpath::Restore(XMLReader &reader)
 
 void Toolpath::RestoreDocFile(Base::Reader &reader)
 {
-    std::string gcode;
-    std::string line;
-    while (reader >> line) {
-        gcode += line;
-        gcode += " ";
-    }
+    std::string gcode((std::istreambuf_iterator<char>(reader)), std::istreambuf_iterator<char>());
     setFromGCode(gcode);
 
 }
@@ -23,6 +23,10 @@
 #ifndef PATH_Path_H
 #define PATH_Path_H
 
+#include <bitset>
+#include <cstdint>
+#include <unordered_map>
+
 #include <Base/BoundBox.h>
 #include <Base/Persistence.h>
 #include <Base/Vector3D.h>
@@ -33,13 +37,40 @@
 namespace Path
 {
 
-    /** The representation of a CNC Toolpath */
+    /** The representation of a CNC Toolpath
+     *
+     * The commands are not stored as Command objects but packed into contiguous
+     * arrays: an opcode and a name per command, and the values of the single letter
+     * parameters A to Z in slot order, flagged by a presence bitmask. Parameters with
+     * longer names are kept aside per command. getCommand() builds a Command from the
+     * packed data, the path algorithms read the packed data directly.
+     */
 
     class PathExport Toolpath : public Base::Persistence
     {
         TYPESYSTEM_HEADER();
 
         public:
+            /// the commands the path algorithms distinguish
+            enum class Opcode : unsigned char {
+                Other,          // any other command or a comment
+                Rapid,          // G0
+                Feed,           // G1
+                ArcCW,          // G2
+                ArcCCW,         // G3
+                PlaneXY,        // G17
+                PlaneXZ,        // G18
+                PlaneYZ,        // G19
+                Inches,         // G20
+                Metric,         // G21
+                Probe,          // G38.2 to G38.5
+                Drill,          // G73, G81 to G86 and G89
+                Absolute,       // G90
+                Relative,       // G91
+                AbsoluteCenter, // G90.1
+                RelativeCenter  // G91.1
+            };
+
             Toolpath();
             Toolpath(const Toolpath&);
             ~Toolpath();
@@ -58,17 +89,24 @@ namespace Path
             void addCommand(const Command &Cmd); // adds a command at the end
             void insertCommand(const Command &Cmd, int); // inserts a command
             void deleteCommand(int); // deletes a command
-            double getLength(void); // return the Length (mm) of the Path
-            double getCycleTime(double, double, double, double); // return the Cycle Time (s) of the Path
+            double getLength(void) const; // return the Length (mm) of the Path
+            double getCycleTime(double, double, double, double) const; // return the Cycle Time (s) of the Path
             void recalculate(void); // recalculates the points
             void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
             std::string toGCode(void) const; // gets a gcode string representation from the Path
             Base::BoundBox3d getBoundBox(void) const;
 
             // shortcut functions
-            unsigned int getSize(void) const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands(void) const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize(void) const { return opcodes.size(); }
+            Command getCommand(unsigned int pos) const; // returns a copy of the command at the given position
+
+            // access to the packed commands, slot is the upper case parameter letter
+            Opcode getOpcode(unsigned int pos) const { return opcodes[pos]; }
+            const std::string &getName(unsigned int pos) const { return names[nameIds[pos]]; }
+            bool hasParam(unsigned int pos, char slot) const { return (masks[pos] & slotBit(slot)) != 0; }
+            inline double getParam(unsigned int pos, char slot, double fallback = 0.0) const;
+            Base::Vector3d getPosition(unsigned int pos, const Base::Vector3d &last = Base::Vector3d()) const; // the x,y,z parameters, missing ones are taken from last
+            Base::Vector3d getArcCenter(unsigned int pos) const; // the i,j,k parameters
 
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
@@ -77,7 +115,28 @@ namespace Path
             static const int SchemaVersion = 2;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            static std::uint32_t slotBit(char slot) {
+                return (slot >= 'A' && slot <= 'Z') ? (std::uint32_t(1) << (slot - 'A')) : 0;
+            }
+            static Opcode opcodeOf(const std::string &name);
+            std::uint32_t nameId(const std::string &name);
+            void packCommand(const Command &cmd, unsigned int pos);
+            void insertPacked(unsigned int pos, const std::string &name, std::uint32_t mask,
+                              const double *slots, std::map<std::string, double> &&extra);
+            void parseGCode(const char *begin, const char *end, bool *inches);
+            void appendParsed(const Toolpath &part, bool &inches);
+            void writeCommand(std::string &str, unsigned int pos, int precision, bool padzero) const;
+            std::string toGCode(unsigned int begin, unsigned int end) const;
+
+            std::vector<Opcode> opcodes;         // per command
+            std::vector<std::uint32_t> nameIds;  // per command, index into names
+            std::vector<std::uint32_t> masks;    // per command, bit n is set if parameter 'A'+n is present
+            std::vector<std::uint32_t> offsets;  // per command and one past the last, first value of the command
+            std::vector<double> values;          // the values of the present slots of all commands
+            std::vector<std::string> names;      // the distinct command names
+            std::vector<Opcode> nameCodes;       // per name
+            std::unordered_map<std::string, std::uint32_t> nameIndex;
+            std::map<unsigned int, std::map<std::string, double> > extraParameters; // parameters that are not a single letter, by command
             Base::Vector3d center;
             //KDL::Path_Composite *pcPath;
 
@@ -98,6 +157,15 @@ namespace Path
         } */
     };
 
+    inline double Toolpath::getParam(unsigned int pos, char slot, double fallback) const
+    {
+        std::uint32_t bit = slotBit(slot);
+        std::uint32_t mask = masks[pos];
+        if (!(mask & bit))
+            return fallback;
+        return values[offsets[pos] + std::bitset<32>(mask & (bit - 1)).count()];
+    }
+
 } //namespace Path
 
 
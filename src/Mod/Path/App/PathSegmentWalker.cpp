@@ -142,27 +142,23 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
     for (unsigned int  i = 0; i < tp.getSize(); i++) {
         std::deque<Base::Vector3d> points;
 
-        const Path::Command &cmd = tp.getCommand(i);
-        const std::string &name = cmd.Name;
-        Base::Vector3d next = cmd.getPlacement().getPosition();
-        double a = A;
-        double b = B;
-        double c = C;
+        const Toolpath::Opcode code = tp.getOpcode(i);
+        Base::Vector3d next = tp.getPosition(i);
+        double a = tp.getParam(i, 'A', A);
+        double b = tp.getParam(i, 'B', B);
+        double c = tp.getParam(i, 'C', C);
 
         if (!absolute)
             next = last + next;
-        if (!cmd.has("X")) next.x = last.x;
-        if (!cmd.has("Y")) next.y = last.y;
-        if (!cmd.has("Z")) next.z = last.z;
-        if ( cmd.has("A")) a = cmd.getValue("A");
-        if ( cmd.has("B")) b = cmd.getValue("B");
-        if ( cmd.has("C")) c = cmd.getValue("C");
+        if (!tp.hasParam(i, 'X')) next.x = last.x;
+        if (!tp.hasParam(i, 'Y')) next.y = last.y;
+        if (!tp.hasParam(i, 'Z')) next.z = last.z;
 
         Base::Rotation nrot = yawPitchRoll(a, b, c);
 
         Base::Vector3d rnext = compensateRotation(next, nrot, rotCenter);
 
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+        if ( (code == Toolpath::Opcode::Rapid) || (code == Toolpath::Opcode::Feed) ) {
             // straight line
             if (nrot != lrot) {
                 double amax = std::max(fmod(fabs(a - A), 360), std::max(fmod(fabs(b - B), 360), fmod(fabs(c - C), 360)));
@@ -185,7 +181,7 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
                 }
             }
 
-            if ("G0" == name || "G00" == name) {
+            if (code == Toolpath::Opcode::Rapid) {
                 cb.g0(i, last, rnext, points);
             } else {
                 cb.g1(i, last, rnext, points);
@@ -197,20 +193,20 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             C = c;
             lrot = nrot;
 
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        } else if ( (code == Toolpath::Opcode::ArcCW) || (code == Toolpath::Opcode::ArcCCW) ) {
             // arc
             Base::Vector3d norm;
             Base::Vector3d center;
 
-            if ( (name == "G2") || (name == "G02") )
+            if (code == Toolpath::Opcode::ArcCW)
                 norm.*pz = -1.0;
             else
                 norm.*pz = 1.0;
 
             if (absolutecenter)
-                center = cmd.getCenter();
+                center = tp.getArcCenter(i);
             else
-                center = (last + cmd.getCenter());
+                center = (last + tp.getArcCenter(i));
             Base::Vector3d next0(next);
             next0.*pz = 0.0;
             Base::Vector3d last0(last);
@@ -222,10 +218,10 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             // GetAngle will always return the minor angle. Switch if needed
             Base::Vector3d anorm = (last0 - center0) % (next0 - center0);
             if (anorm.*pz < 0) {
-                if(name == "G3" || name == "G03")
+                if(code == Toolpath::Opcode::ArcCCW)
                     angle = M_PI * 2 - angle;
             } else if(anorm.*pz > 0) {
-                if(name == "G2" || name == "G02")
+                if(code == Toolpath::Opcode::ArcCW)
                     angle = M_PI * 2 - angle;
             } else if (angle == 0)
                 angle = M_PI * 2;
@@ -260,27 +256,25 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             C = c;
             lrot = nrot;
 
-        } else if (name == "G90") {
+        } else if (code == Toolpath::Opcode::Absolute) {
             // absolute mode
             absolute = true;
 
-        } else if (name == "G91") {
+        } else if (code == Toolpath::Opcode::Relative) {
             // relative mode
             absolute = false;
 
-        } else if (name == "G90.1") {
+        } else if (code == Toolpath::Opcode::AbsoluteCenter) {
             // absolute mode
             absolutecenter = true;
 
-        } else if (name == "G91.1") {
+        } else if (code == Toolpath::Opcode::RelativeCenter) {
             // relative mode
             absolutecenter = false;
 
-        } else if ((name=="G73")||(name=="G81")||(name=="G82")||(name=="G83")||(name=="G84")||(name=="G85")||(name=="G86")||(name=="G89")){
+        } else if (code == Toolpath::Opcode::Drill) {
             // drill,tap,bore
-            double r = 0;
-            if (cmd.has("R"))
-                r = cmd.getValue("R");
+            double r = tp.getParam(i, 'R');
 
             std::deque<Base::Vector3d> plist;
             std::deque<Base::Vector3d> qlist;
@@ -315,8 +309,8 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             Base::Vector3d p2r = compensateRotation(p2, nrot, rotCenter);
 
             double q;
-            if (cmd.has("Q")) {
-                q = cmd.getValue("Q");
+            if (tp.hasParam(i, 'Q')) {
+                q = tp.getParam(i, 'Q');
                 if (q>0) {
                     Base::Vector3d temp(next);
                     for(temp.*pz=r;temp.*pz>next.*pz;temp.*pz-=q) {
@@ -343,15 +337,15 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
             lrot = nrot;
 
 
-        } else if ((name=="G38.2")||(name=="G38.3")||(name=="G38.4")||(name=="G38.5")){
+        } else if (code == Toolpath::Opcode::Probe) {
             // Straight probe
             cb.g38(i, last, next);
             last = next;
-        } else if(name=="G17") {
+        } else if (code == Toolpath::Opcode::PlaneXY) {
             pz = &Base::Vector3d::z;
-        } else if(name=="G18") {
+        } else if (code == Toolpath::Opcode::PlaneXZ) {
             pz = &Base::Vector3d::y;
-        } else if(name=="G19") {
+        } else if (code == Toolpath::Opcode::PlaneYZ) {
             pz = &Base::Vector3d::x;
         }
     }
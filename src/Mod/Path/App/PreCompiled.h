@@ -43,13 +43,18 @@
 #ifdef _PreComp_
 
 // standard
+#include <algorithm>
 #include <cinttypes>
+#include <exception>
 #include <iomanip>
 #include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 
+// Qt
+#include <QtConcurrentMap>
+
 // Boost
 #include <boost/geometry.hpp>
 #include <boost/algorithm/string.hpp>
@@ -64,6 +69,7 @@
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepAdaptor_Surface.hxx>
 #include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
@@ -78,6 +84,7 @@
 #include <GCPnts_UniformAbscissa.hxx>
 #include <Geom_Ellipse.hxx>
 #include <GeomAPI_ProjectPointOnCurve.hxx>
+#include <gp.hxx>
 #include <gp_Circ.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
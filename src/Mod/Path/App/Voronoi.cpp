@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <Standard_math.hxx>
+# include <QtConcurrentMap>
 #endif
 
 #include <Base/Vector3D.h>
@@ -37,6 +38,15 @@ TYPESYSTEM_SOURCE(Path::Voronoi , Base::BaseClass)
 
 // Helpers
 
+// the elements of the diagram are stored in vectors, so their index is their offset
+template<typename T>
+static int indexOf(const std::vector<T> &elements, const T *element) {
+  if (elements.empty() || element < elements.data() || element >= elements.data() + elements.size()) {
+    return Voronoi::InvalidIndex;
+  }
+  return int(element - elements.data());
+}
+
 // Voronoi::diagram_type
 
 Voronoi::diagram_type::diagram_type()
@@ -66,45 +76,13 @@ Base::Vector3d Voronoi::diagram_type::scaledVector(const vertex_type &v, double
 
 
 int Voronoi::diagram_type::index(const Voronoi::diagram_type::cell_type   *cell)   const {
-  auto it = cell_index.find(intptr_t(cell));
-  if (it == cell_index.end()) {
-    return Voronoi::InvalidIndex;
-  }
-  return it->second;
+  return indexOf(cells(), cell);
 }
 int Voronoi::diagram_type::index(const Voronoi::diagram_type::edge_type   *edge)   const {
-  auto it = edge_index.find(intptr_t(edge));
-  if (it == edge_index.end()) {
-    return Voronoi::InvalidIndex;
-  }
-  return it->second;
+  return indexOf(edges(), edge);
 }
 int Voronoi::diagram_type::index(const Voronoi::diagram_type::vertex_type *vertex) const {
-  auto it = vertex_index.find(intptr_t(vertex));
-  if (it == vertex_index.end()) {
-    return Voronoi::InvalidIndex;
-  }
-  return it->second;
-}
-
-void Voronoi::diagram_type::reIndex() {
-  int idx = 0;
-  cell_index.clear();
-  edge_index.clear();
-  vertex_index.clear();
-
-  idx = 0;
-  for (auto it = cells().begin(); it != cells().end(); ++it, ++idx) {
-    cell_index[intptr_t(&(*it))] = idx;
-  }
-  idx = 0;
-  for (auto it = edges().begin(); it != edges().end(); ++it, ++idx) {
-    edge_index[intptr_t(&(*it))] = idx;
-  }
-  idx = 0;
-  for (auto it = vertices().begin(); it != vertices().end(); ++it, ++idx) {
-    vertex_index[intptr_t(&(*it))] = idx;
-  }
+  return indexOf(vertices(), vertex);
 }
 
 Voronoi::point_type Voronoi::diagram_type::retrievePoint(const Voronoi::diagram_type::cell_type *cell) const {
@@ -180,26 +158,50 @@ void Voronoi::construct()
 {
   vd->clear();
   construct_voronoi(vd->points.begin(), vd->points.end(), vd->segments.begin(), vd->segments.end(), static_cast<voronoi_diagram_type*>(vd));
-  vd->reIndex();
+}
+
+void Voronoi::construct(const std::vector<Voronoi*> &diagrams)
+{
+  QtConcurrent::blockingMap(diagrams, [](Voronoi *vo) {
+    vo->construct();
+  });
 }
 
 void Voronoi::colorExterior(const Voronoi::diagram_type::edge_type *edge, std::size_t colorValue) {
-  if (edge->color()) {
-    // end recursion
-    return;
-  }
-  edge->color(colorValue);
-  edge->twin()->color(colorValue);
-  auto v = edge->vertex1();
-  if (!v || !edge->is_primary()) {
-    return;
+  // Depth first walk with an explicit stack instead of recursion, large diagrams
+  // would overflow the stack otherwise. The edges are visited in the same order as
+  // by a recursion, which matters because coloring an edge also colors its twin.
+  struct Frame {
+    const diagram_type::vertex_type *vertex;
+    const diagram_type::edge_type   *next;
+  };
+  std::vector<Frame> stack;
+
+  auto visit = [&stack, colorValue](const diagram_type::edge_type *e) {
+    if (e->color()) {
+      return;
+    }
+    e->color(colorValue);
+    e->twin()->color(colorValue);
+    auto v = e->vertex1();
+    if (!v || !e->is_primary()) {
+      return;
+    }
+    v->color(colorValue);
+    stack.push_back({v, v->incident_edge()});
+  };
+
+  visit(edge);
+  while (!stack.empty()) {
+    Frame &frame = stack.back();
+    const diagram_type::edge_type *e = frame.next;
+    if (!e) {
+      stack.pop_back();
+      continue;
+    }
+    frame.next = e->rot_next() != frame.vertex->incident_edge() ? e->rot_next() : nullptr;
+    visit(e);
   }
-  v->color(colorValue);
-  auto e = v->incident_edge();
-  do {
-    colorExterior(e, colorValue);
-    e = e->rot_next();
-  } while (e != v->incident_edge());
 }
 
 void Voronoi::colorExterior(Voronoi::color_type color) {
@@ -248,6 +250,16 @@ static bool pointsMatch(const Voronoi::point_type &p0, const Voronoi::point_type
   return long(p0.x()) == long(p1.x()) && long(p0.y()) == long(p1.y());
 }
 
+static bool pointsCoincide(const Voronoi::point_type &p0, const Voronoi::point_type &p1, double scale) {
+  double dx = p0.x() - p1.x();
+  double dy = p0.y() - p1.y();
+  return 1e-6 > sqrt(dx * dx + dy * dy) / scale;
+}
+
+bool Voronoi::diagram_type::isPointOnSegment(const Voronoi::point_type &point, const Voronoi::segment_type &segment) const {
+  return pointsCoincide(point, low(segment), scale) || pointsCoincide(point, high(segment), scale);
+}
+
 bool Voronoi::diagram_type::segmentsAreConnected(int i, int j) const {
   return
        pointsMatch(low(segments[i]), low(segments[j]))
@@ -256,6 +268,17 @@ bool Voronoi::diagram_type::segmentsAreConnected(int i, int j) const {
     || pointsMatch(high(segments[i]), high(segments[j]));
 }
 
+bool Voronoi::diagram_type::isBorderline(const Voronoi::diagram_type::edge_type *edge) const {
+  // a curved edge between a point and a segment the point is an end point of
+  if (edge->is_linear()) {
+    return false;
+  }
+  bool pointCell = edge->cell()->contains_point();
+  Voronoi::point_type   point   = retrievePoint(pointCell ? edge->cell() : edge->twin()->cell());
+  Voronoi::segment_type segment = retrieveSegment(pointCell ? edge->twin()->cell() : edge->cell());
+  return isPointOnSegment(point, segment);
+}
+
 void Voronoi::colorColinear(Voronoi::color_type color, double degree) {
   double rad = degree * M_PI / 180;
 
@@ -285,6 +308,18 @@ void Voronoi::colorColinear(Voronoi::color_type color, double degree) {
   }
 }
 
+void Voronoi::colorEdges(Voronoi::color_type primary, Voronoi::color_type secondary, Voronoi::color_type borderline) {
+  for (diagram_type::const_edge_iterator it = vd->edges().begin(); it != vd->edges().end(); ++it) {
+    if (!it->is_primary()) {
+      it->color(secondary);
+    } else if (primary != borderline && vd->isBorderline(&(*it))) {
+      it->color(borderline);
+    } else {
+      it->color(primary);
+    }
+  }
+}
+
 void Voronoi::resetColor(Voronoi::color_type color) {
   for (auto it = vd->cells().begin(); it != vd->cells().end(); ++it) {
     if (color == 0 || it->color() == color) {
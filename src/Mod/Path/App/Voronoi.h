@@ -75,16 +75,10 @@ namespace Path
       Base::Vector3d scaledVector(const point_type &p, double z) const;
       Base::Vector3d scaledVector(const vertex_type &v, double z) const;
 
-      using cell_map_type = std::map<intptr_t, int>;
-      using edge_map_type = std::map<intptr_t, int>;
-      using vertex_map_type = std::map<intptr_t, int>;
-
       int index(const cell_type   *cell)   const;
       int index(const edge_type   *edge)   const;
       int index(const vertex_type *vertex) const;
 
-      void reIndex();
-
       std::vector<point_type>       points;
       std::vector<segment_type>     segments;
 
@@ -94,12 +88,12 @@ namespace Path
       using angle_map_t = std::map<int, double>;
       double angleOfSegment(int i, angle_map_t *angle = nullptr) const;
       bool segmentsAreConnected(int i, int j) const;
+      // true if the point coincides with one of the end points of the segment
+      bool isPointOnSegment(const point_type &point, const segment_type &segment) const;
+      bool isBorderline(const edge_type *edge) const;
 
     private:
       double          scale;
-      cell_map_type   cell_index;
-      edge_map_type   edge_index;
-      vertex_map_type vertex_index;
     };
 
     void addPoint(const point_type &p);
@@ -108,6 +102,8 @@ namespace Path
     long numSegments() const;
 
     void construct();
+    // constructs the given diagrams concurrently
+    static void construct(const std::vector<Voronoi*> &diagrams);
     long numCells() const;
     long numEdges() const;
     long numVertices() const;
@@ -116,6 +112,7 @@ namespace Path
     void colorExterior(color_type color);
     void colorTwins(color_type color);
     void colorColinear(color_type color, double degree);
+    void colorEdges(color_type primary, color_type secondary, color_type borderline);
 
     template<typename T>
     T* create(int index) {
@@ -265,6 +265,23 @@ PyObject* VoronoiPy::colorColinear(PyObject *args) {
   return Py_None;
 }
 
+PyObject* VoronoiPy::colorEdges(PyObject *args) {
+  Voronoi::color_type primary = 0;
+  Voronoi::color_type secondary = 0;
+  Voronoi::color_type borderline = 0;
+  int count = PyTuple_Size(args);
+  if (!PyArg_ParseTuple(args, "kk|k", &primary, &secondary, &borderline)) {
+    throw  Py::RuntimeError("colorEdges requires two integer (primary, secondary) and optionally an integer (borderline) argument");
+  }
+  if (count < 3) {
+    borderline = primary;
+  }
+  getVoronoiPtr()->colorEdges(primary, secondary, borderline);
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
 PyObject* VoronoiPy::resetColor(PyObject *args) {
   Voronoi::color_type color = 0;
   if (!PyArg_ParseTuple(args, "k", &color)) {
@@ -277,6 +294,60 @@ PyObject* VoronoiPy::resetColor(PyObject *args) {
   return Py_None;
 }
 
+PyObject* VoronoiPy::getVertexArray(PyObject *args) {
+  if (!PyArg_ParseTuple(args, "")) {
+    throw  Py::RuntimeError("no arguments accepted");
+  }
+  Voronoi *vo = getVoronoiPtr();
+  double scale = vo->getScale();
+  const auto &vertices = vo->vd->vertices();
+  PyObject *list = PyList_New(2 * vertices.size());
+  Py_ssize_t i = 0;
+  for (auto it = vertices.begin(); it != vertices.end(); ++it) {
+    PyList_SET_ITEM(list, i++, PyFloat_FromDouble(it->x() / scale));
+    PyList_SET_ITEM(list, i++, PyFloat_FromDouble(it->y() / scale));
+  }
+  return list;
+}
+
+PyObject* VoronoiPy::getEdgeArray(PyObject *args) {
+  if (!PyArg_ParseTuple(args, "")) {
+    throw  Py::RuntimeError("no arguments accepted");
+  }
+  Voronoi *vo = getVoronoiPtr();
+  const auto &edges = vo->vd->edges();
+  auto vertexIndex = [vo](const Voronoi::diagram_type::vertex_type *v) {
+    return v ? long(vo->vd->index(v)) : -1L;
+  };
+  PyObject *list = PyList_New(4 * edges.size());
+  Py_ssize_t i = 0;
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    PyList_SET_ITEM(list, i++, PyLong_FromLong(vertexIndex(it->vertex0())));
+    PyList_SET_ITEM(list, i++, PyLong_FromLong(vertexIndex(it->vertex1())));
+    PyList_SET_ITEM(list, i++, PyLong_FromLong(vo->vd->index(it->twin())));
+    PyList_SET_ITEM(list, i++, PyLong_FromSize_t(it->color() & Voronoi::ColorMask));
+  }
+  return list;
+}
+
+PyObject* VoronoiPy::getEdgesByIndex(PyObject *args) {
+  PyObject *obj = nullptr;
+  if (!PyArg_ParseTuple(args, "O", &obj)) {
+    throw  Py::RuntimeError("getEdgesByIndex requires a list of indices");
+  }
+  Voronoi *vo = getVoronoiPtr();
+  Py::Sequence indices(obj);
+  Py::List list;
+  for (Py::Sequence::iterator it = indices.begin(); it != indices.end(); ++it) {
+    long index = Py::Long(*it);
+    if (index < 0 || index >= vo->numEdges()) {
+      throw Py::IndexError("edge index out of range");
+    }
+    list.append(Py::asObject(new VoronoiEdgePy(vo->create<VoronoiEdge>(index))));
+  }
+  return Py::new_reference_to(list);
+}
+
 PyObject* VoronoiPy::getPoints(PyObject *args) {
   double z = 0;
   if (!PyArg_ParseTuple(args, "|d", &z)) {
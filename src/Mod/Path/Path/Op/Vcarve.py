@@ -54,11 +54,17 @@ _sorting = "global"
 
 
 def _collectVoronoiWires(vd):
-    edges = [e for e in vd.Edges if e.Color == PRIMARY]
+    # the wires are collected on the edge indices, only their edges are created
+    edgeArray = vd.getEdgeArray()
+    vertex0 = edgeArray[0::4]
+    vertex1 = edgeArray[1::4]
+    twin = edgeArray[2::4]
+    color = edgeArray[3::4]
+
+    edges = [e for e, c in enumerate(color) if c == PRIMARY]
     vertex = {}
     for e in edges:
-        for v in e.Vertices:
-            i = v.Index
+        for i in (vertex0[e], vertex1[e]):
             j = vertex.get(i, [])
             j.append(e)
             vertex[i] = j
@@ -73,16 +79,16 @@ def _collectVoronoiWires(vd):
                 break
 
     def consume(v, edge):
-        vertex[v] = [e for e in vertex[v] if e.Index != edge.Index]
+        vertex[v] = [e for e in vertex[v] if e != edge]
         return len(vertex[v]) == 0
 
     def traverse(vStart, edge, edges):
-        if vStart == edge.Vertices[0].Index:
-            vEnd = edge.Vertices[1].Index
+        if vStart == vertex0[edge]:
+            vEnd = vertex1[edge]
             edges.append(edge)
         else:
-            vEnd = edge.Vertices[0].Index
-            edges.append(edge.Twin)
+            vEnd = vertex0[edge]
+            edges.append(twin[edge])
 
         consume(vStart, edge)
         if consume(vEnd, edge):
@@ -109,7 +115,7 @@ def _collectVoronoiWires(vd):
             knots = [v for v in knots if v != vFirst]
         if len(vertex[vLast]) == 0:
             knots = [v for v in knots if v != vLast]
-    return wires
+    return [vd.getEdgesByIndex(we) for we in wires]
 
 
 def _sortVoronoiWires(wires, start=FreeCAD.Vector(0, 0, 0)):
@@ -287,21 +293,18 @@ class ObjectVcarve(PathEngraveBase.ObjectOp):
 
             return path
 
-        voronoiWires = []
+        diagrams = []
         for f in faces:
             vd = Path.Voronoi.Diagram()
             insert_many_wires(vd, f.Wires)
+            diagrams.append(vd)
 
-            vd.construct()
+        # the diagrams of the faces are independent of each other
+        Path.Voronoi.construct(diagrams)
 
-            for e in vd.Edges:
-                if e.isPrimary():
-                    if e.isBorderline():
-                        e.Color = BORDERLINE
-                    else:
-                        e.Color = PRIMARY
-                else:
-                    e.Color = SECONDARY
+        voronoiWires = []
+        for f, vd in zip(faces, diagrams):
+            vd.colorEdges(PRIMARY, SECONDARY, BORDERLINE)
             vd.colorExterior(EXTERIOR1)
             vd.colorExterior(
                 EXTERIOR2,
@@ -21,6 +21,10 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#ifndef _PreComp_
+# include <QThread>
+# include <QtConcurrentMap>
+#endif
 
 #include "PathSim.h"
 
@@ -86,8 +90,96 @@ Base::Placement * PathSim::ApplyCommand(Base::Placement * pos, Command * cmd)
 	return plc;
 }
 
+namespace {
+struct SimMove
+{
+	unsigned int index;
+	Toolpath::Opcode code;
+	Point3D from, to, cent;
+	cSimTile bounds;
+};
 
+struct SimBand
+{
+	cSimTile tile;
+	std::vector<std::pair<std::size_t, float> > removed; // move, volume
+};
+}
 
+void PathSim::ApplyToolpath(Base::Placement & pos, const Toolpath & path, std::vector<MoveStats> & stats)
+{
+	if (!m_stock)
+		throw Base::RuntimeError("Path Simulation: BeginSimulation was not called");
+	if (!m_tool)
+		throw Base::RuntimeError("Path Simulation: no tool shape set");
+
+	// resolve the positions sequentially, like ApplyCommand does
+	std::vector<SimMove> moves;
+	Vector3d last = pos.getPosition();
+	for (unsigned int i = 0; i < path.getSize(); i++)
+	{
+		Vector3d next = path.getPosition(i, last);
+		Toolpath::Opcode code = path.getOpcode(i);
+		if (code == Toolpath::Opcode::Rapid || code == Toolpath::Opcode::Feed
+				|| code == Toolpath::Opcode::ArcCW || code == Toolpath::Opcode::ArcCCW)
+		{
+			SimMove move;
+			move.index = i;
+			move.code = code;
+			move.from = Point3D(last);
+			move.to = Point3D(next);
+			if (code == Toolpath::Opcode::ArcCW || code == Toolpath::Opcode::ArcCCW)
+			{
+				Vector3d vcent = path.getArcCenter(i);
+				move.cent = Point3D(vcent);
+				move.bounds = m_stock->CircularToolBounds(move.from, move.to, move.cent, *m_tool);
+			}
+			else
+				move.bounds = m_stock->LinearToolBounds(move.from, move.to, *m_tool);
+			moves.push_back(move);
+		}
+		last = next;
+	}
+	pos.setPosition(last);
+
+	// every band applies all moves in order but only modifies its own cells, so the
+	// bands do not depend on each other and the stock is the same as applied serially
+	std::vector<cSimTile> tiles;
+	m_stock->GetTiles(moves.size() > 1 ? 4 * std::max(1, QThread::idealThreadCount()) : 1, tiles);
+	std::vector<SimBand> bands(tiles.size());
+	for (std::size_t i = 0; i < tiles.size(); i++)
+		bands[i].tile = tiles[i];
+
+	cStock *stock = m_stock;
+	cSimTool *tool = m_tool;
+	QtConcurrent::blockingMap(bands, [&moves, stock, tool](SimBand & band) {
+		for (std::size_t i = 0; i < moves.size(); i++)
+		{
+			SimMove move = moves[i];
+			if (!move.bounds.Intersects(band.tile))
+				continue;
+			float volume;
+			if (move.code == Toolpath::Opcode::ArcCW || move.code == Toolpath::Opcode::ArcCCW)
+				volume = stock->ApplyCircularTool(move.from, move.to, move.cent, *tool,
+						move.code == Toolpath::Opcode::ArcCCW, band.tile);
+			else
+				volume = stock->ApplyLinearTool(move.from, move.to, *tool, band.tile);
+			if (volume > 0)
+				band.removed.emplace_back(i, volume);
+		}
+	});
 
-
-
+	stats.resize(moves.size());
+	for (std::size_t i = 0; i < moves.size(); i++)
+	{
+		stats[i].index = moves[i].index;
+		stats[i].volume = 0;
+	}
+	for (const SimBand & band : bands)
+	{
+		for (const auto & removed : band.removed)
+			stats[removed.first].volume += removed.second;
+	}
+	for (std::size_t i = 0; i < moves.size(); i++)
+		stats[i].collision = moves[i].code == Toolpath::Opcode::Rapid && stats[i].volume > 0;
+}
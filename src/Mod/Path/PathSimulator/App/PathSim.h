@@ -23,9 +23,12 @@
 #ifndef PATHSIMULATOR_PathSim_H
 #define PATHSIMULATOR_PathSim_H
 
+#include <vector>
+
 #include <TopoDS_Shape.hxx>
 
 #include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
 #include <Mod/Part/App/TopoShape.h>
 
 #include "VolSim.h"
@@ -50,6 +53,19 @@ namespace PathSimulator
 			void SetToolShape(const TopoDS_Shape& toolShape, float resolution);
 			Base::Placement * ApplyCommand(Base::Placement * pos, Command * cmd);
 
+			/// removal statistics of a motion command
+			struct MoveStats
+			{
+				unsigned int index;     // position of the command in the toolpath
+				float volume;           // removed stock volume
+				bool collision;         // stock was removed by a rapid move
+			};
+			/** Applies all motion commands of a toolpath starting from pos, which is
+			 * updated to the end position. The stock is split into bands that are cut
+			 * concurrently, the result is the same as applying the commands one by one.
+			 */
+			void ApplyToolpath(Base::Placement & pos, const Toolpath & path, std::vector<MoveStats> & stats);
+
 		public:
 			cStock * m_stock;
 			cSimTool *m_tool;
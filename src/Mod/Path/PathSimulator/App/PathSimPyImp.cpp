@@ -26,6 +26,7 @@
 
 #include <Mod/Mesh/App/MeshPy.h>
 #include <Mod/Path/App/CommandPy.h>
+#include <Mod/Path/App/PathPy.h>
 #include <Mod/Part/App/TopoShapePy.h>
 
 #include "PathSim.h"
@@ -122,6 +123,33 @@ PyObject* PathSimPy::ApplyCommand(PyObject * args, PyObject * kwds)
 	return newposPy;
 }
 
+PyObject* PathSimPy::ApplyToolpath(PyObject * args, PyObject * kwds)
+{
+	static char *kwlist[] = { "position", "path", nullptr };
+	PyObject *pObjPlace;
+	PyObject *pObjPath;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!", kwlist, &(Base::PlacementPy::Type), &pObjPlace, &(Path::PathPy::Type), &pObjPath))
+		return nullptr;
+	PathSim *sim = getPathSimPtr();
+	Base::Placement pos = *static_cast<Base::PlacementPy*>(pObjPlace)->getPlacementPtr();
+	const Path::Toolpath *path = static_cast<Path::PathPy*>(pObjPath)->getToolpathPtr();
+	std::vector<PathSim::MoveStats> stats;
+	PY_TRY {
+		sim->ApplyToolpath(pos, *path, stats);
+	} PY_CATCH;
+
+	Py::List list(stats.size());
+	for (std::size_t i = 0; i < stats.size(); i++)
+	{
+		Py::Dict dict;
+		dict.setItem("Index", Py::Long(static_cast<long>(stats[i].index)));
+		dict.setItem("Volume", Py::Float(stats[i].volume));
+		dict.setItem("Collision", Py::Boolean(stats[i].collision));
+		list[i] = dict;
+	}
+	return Py::new_reference_to(Py::TupleN(Py::asObject(new Base::PlacementPy(new Base::Placement(pos))), list));
+}
+
 Py::Object PathSimPy::getTool() const
 {
     //return Py::Object();
@@ -63,6 +63,10 @@
 // Xerces
 #include <xercesc/util/XercesDefs.hpp>
 
+// Qt
+#include <QThread>
+#include <QtConcurrentMap>
+
 #endif //_PreComp_
 
 #endif
@@ -509,7 +509,42 @@ void cStock::CreatePocket(float cxf, float cyf, float radf, float height)
 	}
 }
 
-void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
+cSimTile cStock::LinearToolBounds(Point3D & p1, Point3D & p2, cSimTool & tool)
+{
+	Point3D pi1 = ToInner(p1);
+	Point3D pi2 = ToInner(p2);
+	float rad = tool.radius / m_res + 1;
+	return cSimTile((int)floor(std::min(pi1.x, pi2.x) - rad), (int)floor(std::min(pi1.y, pi2.y) - rad),
+		(int)ceil(std::max(pi1.x, pi2.x) + rad) + 1, (int)ceil(std::max(pi1.y, pi2.y) + rad) + 1);
+}
+
+cSimTile cStock::CircularToolBounds(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool)
+{
+	// the whole circle, cent is relative to the start point, and the end cup
+	Point3D pi1 = ToInner(p1);
+	Point3D pi2 = ToInner(p2);
+	float cx = pi1.x + cent.x / m_res;
+	float cy = pi1.y + cent.y / m_res;
+	float rad = tool.radius / m_res + 1;
+	float crad = sqrt(cent.x * cent.x + cent.y * cent.y) / m_res + rad;
+	return cSimTile((int)floor(std::min(cx - crad, pi2.x - rad)), (int)floor(std::min(cy - crad, pi2.y - rad)),
+		(int)ceil(std::max(cx + crad, pi2.x + rad)) + 1, (int)ceil(std::max(cy + crad, pi2.y + rad)) + 1);
+}
+
+void cStock::GetTiles(int count, std::vector<cSimTile> & tiles)
+{
+	tiles.clear();
+	count = std::max(1, std::min(count, m_x));
+	for (int i = 0; i < count; i++)
+		tiles.emplace_back(m_x * i / count, 0, m_x * (i + 1) / count, m_y);
+}
+
+float cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
+{
+	return ApplyLinearTool(p1, p2, tool, cSimTile(0, 0, m_x, m_y));
+}
+
+float cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool, const cSimTile & tile)
 {
 	// translate coordinates
 	Point3D pi1 = ToInner(p1);
@@ -517,6 +552,7 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 	float rad = tool.radius;
 	rad /= m_res;
 	float cupAngle = 180;
+	float removed = 0;
 
 	// strait motion
 	float perpDirX = 1;
@@ -540,13 +576,7 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 			Point3D p = start;
 			for (int i = 0; i < lenSteps; i++)
 			{
-				int x = (int)p.x;
-				int y = (int)p.y;
-				if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-				{
-					if (m_stock[x][y] > z)
-						m_stock[x][y] = z;
-				}
+				CutCell((int)p.x, (int)p.y, z, tile, removed);
 				p.Add(mainWay);
 				z += zstep;
 			}
@@ -566,19 +596,19 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
 		for (float a = 0; a < cupAngle; a += rotang)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutCell((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, tile, removed);
 			cupCirc.Rotate();
 		}
 	}
+	return removed * m_res * m_res;
+}
+
+float cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW)
+{
+	return ApplyCircularTool(p1, p2, cent, tool, isCCW, cSimTile(0, 0, m_x, m_y));
 }
 
-void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW)
+float cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW, const cSimTile & tile)
 {
 	// translate coordinates
 	Point3D pi1 = ToInner(p1);
@@ -588,6 +618,7 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 	rad /= m_res;
 	float cpx = centi.x;
 	float cpy = centi.y;
+	float removed = 0;
 
 	Point3D xynorm = unit(Point3D(-cpx, -cpy, 0));
 	float crad = sqrt(cpx * cpx + cpy * cpy);
@@ -627,13 +658,7 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 		float zstep = (pi2.z - pi1.z) / ndivs;
 		for (int i = 0; i< ndivs; i++)
 		{
-			int x = (int)(cpx + cupCirc.x);
-			int y = (int)(cpy + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutCell((int)(cpx + cupCirc.x), (int)(cpy + cupCirc.y), z, tile, removed);
 			z += zstep;
 			cupCirc.Rotate();
 		}
@@ -654,16 +679,11 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
 		for (int i = 0; i < ndivs; i++)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutCell((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, tile, removed);
 			cupCirc.Rotate();
 		}
 	}
+	return removed * m_res * m_res;
 }
 
 
@@ -787,6 +807,12 @@ float cSimTool::GetToolProfileAt(float pos)  // pos is -1..1 location along the
 		float radPos = std::abs(pos) * radius;
 		toolShapePoint test; test.radiusPos = radPos;
 		auto it = std::lower_bound(m_toolShape.begin(), m_toolShape.end(), test, toolShapePoint::less_than());
+		if (it == m_toolShape.end())
+		{
+			if (m_toolShape.empty())
+				return 0;
+			--it; // the profile ends a fraction of the resolution before the radius
+		}
 		return it->heightPos;
 	}catch(...){
 		return 0;
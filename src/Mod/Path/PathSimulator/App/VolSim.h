@@ -25,6 +25,7 @@
 #ifndef PATHSIMULATOR_VolSim_H
 #define PATHSIMULATOR_VolSim_H
 
+#include <algorithm>
 #include <vector>
 
 #include <Mod/Mesh/App/Mesh.h>
@@ -98,6 +99,16 @@ struct cLineSegment
 	float lenXY;
 };
 
+// rectangle of stock cells [xs, xe) x [ys, ye) that a tool application may modify
+struct cSimTile
+{
+	cSimTile() : xs(0), ys(0), xe(0), ye(0) {}
+	cSimTile(int xs, int ys, int xe, int ye) : xs(xs), ys(ys), xe(xe), ye(ye) {}
+	inline bool Contains(int x, int y) const { return x >= xs && y >= ys && x < xe && y < ye; }
+	inline bool Intersects(const cSimTile & t) const { return xs < t.xe && t.xs < xe && ys < t.ye && t.ys < ye; }
+	int xs, ys, xe, ye;
+};
+
 class cSimTool
 {
 public:
@@ -144,13 +155,34 @@ public:
 	~cStock();
 	void Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner);
     void CreatePocket(float x, float y, float rad, float height);
-    void ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool);
-    void ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW);
+	// the apply functions return the removed stock volume, only the cells inside tile are modified
+    float ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool);
+    float ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool, const cSimTile & tile);
+    float ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW);
+    float ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW, const cSimTile & tile);
+	// cells that may be modified by a tool application
+	cSimTile LinearToolBounds(Point3D & p1, Point3D & p2, cSimTool &tool);
+	cSimTile CircularToolBounds(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool);
+	// splits the stock into count bands of columns
+	void GetTiles(int count, std::vector<cSimTile> & tiles);
     inline Point3D ToInner(Point3D & p) {
 		return Point3D((p.x - m_px) / m_res, (p.y - m_py) / m_res, p.z);
 	}
 
 private:
+	inline void CutCell(int x, int y, float z, const cSimTile & tile, float & removed)
+	{
+		if (!tile.Contains(x, y))
+			return;
+		float & h = m_stock[x][y];
+		if (h > z)
+		{
+			if (h > m_pz)
+				removed += h - std::max(z, m_pz);
+			h = z;
+		}
+	}
+
 	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
 	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
 	void SetFacetPoints(MeshCore::MeshGeomFacet & facet, Point3D & p1, Point3D & p2, Point3D & p3);
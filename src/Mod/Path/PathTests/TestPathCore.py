@@ -21,6 +21,7 @@
 # ***************************************************************************
 
 import FreeCAD
+import Part
 import Path
 from PathTests.PathTestUtils import PathTestBase
 
@@ -138,3 +139,62 @@ G0 Z0.500000
         path = Path.Path(commands)
 
         self.assertEqual(path.Length, 2)
+
+    def test60(self):
+        """Test inserting, deleting and reading back Path commands"""
+        c1 = Path.Command("G0", {"X": 1, "Y": 2, "Z": 3})
+        c2 = Path.Command("G1", {"X": 4, "F": 100, "AB": 1.5})
+        c3 = Path.Command("(comment)")
+        p = Path.Path([c1, c3])
+
+        p.insertCommand(c2, 1)
+        self.assertEqual(p.Size, 3)
+        self.assertEqual(
+            p.toGCode(),
+            "G0 X1.000000 Y2.000000 Z3.000000\nG1 AB1.500000 F100.000000 X4.000000\n(comment)\n",
+        )
+        self.assertEqual(p.Commands[1].Parameters, {"X": 4.0, "F": 100.0, "AB": 1.5})
+        self.assertEqual(p.Commands[2].Name, "(comment)")
+
+        p.deleteCommand(0)
+        self.assertEqual(p.Size, 2)
+        self.assertEqual(p.Commands[0].Name, "G1")
+        self.assertEqual(p.Commands[0].Parameters, {"X": 4.0, "F": 100.0, "AB": 1.5})
+        self.assertEqual(p.Length, 4)
+
+        bb = p.BoundBox
+        self.assertRoughly(bb.XMin, 0)
+        self.assertRoughly(bb.XMax, 4)
+
+    def test70(self):
+        """Test reading G-code with unit changes, comments and continued lines"""
+        lines = "G20\nG1 X1 Y2 F10\n(set metric)\nG21\nG1 X1\nY2\n"
+        output = "G1 F254.000000 X25.400000 Y50.800000\n(set metric)\nG1 X1.000000 Y2.000000\n"
+
+        p = Path.Path()
+        p.setFromGCode(lines)
+        self.assertEqual(p.Size, 3)
+        self.assertEqual(p.toGCode(), output)
+
+        p2 = Path.Path()
+        p2.setFromGCode(p.toGCode())
+        self.assertEqual(p2.toGCode(), output)
+
+        with self.assertRaises(Exception):
+            p.setFromGCode("G1 X")
+
+    def test80(self):
+        """Test sectioning a stepped solid at many heights"""
+        solid = Part.makeBox(10, 10, 5).fuse(Part.makeBox(4, 4, 5, FreeCAD.Vector(0, 0, 5)))
+        area = Path.Area()
+        area.setPlane(Part.makePlane(1, 1))
+        area.add(solid.removeSplitter())
+
+        heights = [9.5, 8, 7, 6, 4, 3, 2, 0.5]
+        sections = area.makeSections(mode=0, project=False, heights=heights)
+        self.assertEqual(len(sections), len(heights))
+        for height, section in zip(heights, sections):
+            bb = section.getShape().BoundBox
+            self.assertRoughly(bb.ZMin, height)
+            self.assertRoughly(bb.ZMax, height)
+            self.assertRoughly(bb.XMax, 4 if height > 5 else 10)
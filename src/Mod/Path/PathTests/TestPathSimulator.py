@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+# ***************************************************************************
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import FreeCAD
+import Part
+import Path
+import PathSimulator
+
+from PathTests.PathTestUtils import PathTestBase
+
+GCODE = """G0 X20 Y50 Z15
+G1 X20 Y50 Z7
+G1 X80 Y50 Z7
+G2 X80 Y30 Z7 I0 J-10
+G1 X20 Y30 Z7
+G0 X20 Y30 Z15
+G0 X50 Y70 Z15
+G0 X50 Y70 Z8
+"""
+
+
+class TestPathSimulator(PathTestBase):
+    def simulator(self):
+        sim = PathSimulator.PathSim()
+        sim.BeginSimulation(Part.makeBox(100, 100, 10), 0.5)
+        sim.SetToolShape(Part.makeCylinder(3, 20), 0.1)
+        return sim
+
+    def start(self):
+        return FreeCAD.Placement(FreeCAD.Vector(0, 0, 20), FreeCAD.Rotation())
+
+    def test00(self):
+        """Check the removed volume and the collisions of every motion command."""
+        sim = self.simulator()
+        path = Path.Path(GCODE)
+        end, stats = sim.ApplyToolpath(self.start(), path)
+
+        self.assertCoincide(end.Base, FreeCAD.Vector(50, 70, 8))
+        self.assertEqual([s["Index"] for s in stats], list(range(len(path.Commands))))
+
+        volumes = [s["Volume"] for s in stats]
+        self.assertEqual(volumes[0], 0)
+        # plunge, then a slot of 60 mm, 6 mm wide and 3 mm deep ending in a half circle
+        self.assertRoughly(volumes[1], 3 * 3.14159 * 9, 15)
+        self.assertRoughly(volumes[2], 60 * 6 * 3 + 3 * 3.14159 * 9 / 2, 60)
+        self.assertGreater(volumes[3], 0)
+        self.assertEqual(volumes[5], 0)
+        self.assertEqual(volumes[6], 0)
+
+        self.assertEqual([s["Collision"] for s in stats], [False] * 7 + [True])
+
+    def test01(self):
+        """Check that the stock is the same as applying the commands one by one."""
+        sim = self.simulator()
+        sim.ApplyToolpath(self.start(), Path.Path(GCODE))
+        outer, inner = sim.GetResultMesh()
+
+        ref = self.simulator()
+        pos = self.start()
+        for cmd in Path.Path(GCODE).Commands:
+            pos = ref.ApplyCommand(pos, cmd)
+        refOuter, refInner = ref.GetResultMesh()
+
+        self.assertEqual(outer.CountFacets, refOuter.CountFacets)
+        self.assertEqual(inner.CountFacets, refInner.CountFacets)
+        self.assertTrue(inner.BoundBox.isValid())
+        self.assertRoughly(inner.BoundBox.ZMin, refInner.BoundBox.ZMin, 1e-6)
+        self.assertRoughly(inner.BoundBox.ZMin, 7, 1e-6)
@@ -28,30 +28,34 @@ import PathTests.PathTestUtils as PathTestUtils
 vd = None
 
 
+def newVD():
+    pts = [
+        (0, 0),
+        (3.5, 0),
+        (3.5, 1),
+        (1, 1),
+        (1, 2),
+        (2.5, 2),
+        (2.5, 3),
+        (1, 3),
+        (1, 4),
+        (3.5, 4),
+        (3.5, 5),
+        (0, 5),
+    ]
+    ptv = [FreeCAD.Vector(p[0], p[1]) for p in pts]
+    ptv.append(ptv[0])
+
+    diagram = Path.Voronoi.Diagram()
+    for i in range(len(pts)):
+        diagram.addSegment(ptv[i], ptv[i + 1])
+    return diagram
+
+
 def initVD():
     global vd
     if vd is None:
-        pts = [
-            (0, 0),
-            (3.5, 0),
-            (3.5, 1),
-            (1, 1),
-            (1, 2),
-            (2.5, 2),
-            (2.5, 3),
-            (1, 3),
-            (1, 4),
-            (3.5, 4),
-            (3.5, 5),
-            (0, 5),
-        ]
-        ptv = [FreeCAD.Vector(p[0], p[1]) for p in pts]
-        ptv.append(ptv[0])
-
-        vd = Path.Voronoi.Diagram()
-        for i in range(len(pts)):
-            vd.addSegment(ptv[i], ptv[i + 1])
-
+        vd = newVD()
         vd.construct()
 
         for e in vd.Edges:
@@ -206,3 +210,47 @@ class TestPathVoronoi(PathTestUtils.PathTestBase):
         )
         self.assertRoughly(e.valueAt(e.FirstParameter).z, 2.37)
         self.assertRoughly(e.valueAt(e.LastParameter).z, 5.14)
+
+    def test70(self):
+        """Check the batched edge coloring"""
+
+        diagram = newVD()
+        diagram.construct()
+        diagram.colorEdges(0, 1, 2)
+        for e in diagram.Edges:
+            if not e.isPrimary():
+                self.assertEqual(e.Color, 1)
+            elif e.isBorderline():
+                self.assertEqual(e.Color, 2)
+            else:
+                self.assertEqual(e.Color, 0)
+
+    def test71(self):
+        """Check the vertex and edge arrays"""
+
+        vertices = vd.getVertexArray()
+        self.assertEqual(len(vertices), 2 * vd.numVertices())
+        for v in vd.Vertices:
+            self.assertRoughly(vertices[2 * v.Index], v.X)
+            self.assertRoughly(vertices[2 * v.Index + 1], v.Y)
+
+        edges = vd.getEdgeArray()
+        self.assertEqual(len(edges), 4 * vd.numEdges())
+        for e in vd.Edges:
+            v0, v1, twin, color = edges[4 * e.Index : 4 * e.Index + 4]
+            self.assertEqual(v0, e.Vertices[0].Index if e.Vertices[0] else -1)
+            self.assertEqual(v1, e.Vertices[1].Index if e.Vertices[1] else -1)
+            self.assertEqual(twin, e.Twin.Index)
+            self.assertEqual(color, e.Color)
+
+        self.assertEqual(vd.getEdgesByIndex([3, 1]), [vd.Edges[3], vd.Edges[1]])
+
+    def test72(self):
+        """Check the concurrent construction of diagrams"""
+
+        diagrams = [newVD() for i in range(4)]
+        Path.Voronoi.construct(diagrams)
+        for diagram in diagrams:
+            self.assertEqual(diagram.numEdges(), vd.numEdges())
+            self.assertEqual(diagram.numVertices(), vd.numVertices())
+            self.assertEqual(diagram.numCells(), vd.numCells())
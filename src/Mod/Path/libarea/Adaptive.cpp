@@ -223,13 +223,13 @@ class BoundBox
 	}
 
 	// bounds check - intersection
-	inline bool CollidesWith(const BoundBox &bb2)
+	inline bool CollidesWith(const BoundBox &bb2) const
 	{
 		return minX <= bb2.maxX && maxX >= bb2.minX && minY <= bb2.maxY && maxY >= bb2.minY;
 	}
 
 	// bounds check -  contains
-	inline bool Contains(const BoundBox &bb2)
+	inline bool Contains(const BoundBox &bb2) const
 	{
 		return minX <= bb2.minX && maxX >= bb2.maxX && minY <= bb2.minY && maxY >= bb2.maxY;
 	}
@@ -909,6 +909,105 @@ PerfCounter Perf_AppendToolPath("AppendToolPath");
 PerfCounter Perf_IsAllowedToCutTrough("IsAllowedToCutTrough");
 PerfCounter Perf_IsClearPath("IsClearPath");
 
+//***********************************
+// Paths index for bounding to a box
+//***********************************
+// Keeps the bound boxes of runs of consecutive points of closed paths, in levels of runs of
+// RUN_LENGTH, RUN_LENGTH^2, ... points. A run that does not touch a box is replaced by its
+// first and last point: the edge between them stays on the same side of the box, so the
+// reduced paths cover the same region inside the box with only a fraction of the points.
+class PathsIndex
+{
+  public:
+	void Build(const Paths &p_paths)
+	{
+		paths = &p_paths;
+		index.resize(paths->size());
+		for (size_t i = 0; i < paths->size(); i++)
+		{
+			const Path &path = (*paths)[i];
+			vector<vector<BoundBox>> &levels = index[i];
+			levels.clear();
+			if (path.empty())
+				continue;
+			levels.emplace_back();
+			for (size_t j = 0; j < path.size(); j += RUN_LENGTH)
+			{
+				BoundBox bb(path[j]);
+				for (size_t k = j + 1; k < min(j + RUN_LENGTH, path.size()); k++)
+					bb.AddPoint(path[k]);
+				levels.back().push_back(bb);
+			}
+			while (levels.back().size() > 1)
+			{
+				vector<BoundBox> upper;
+				const vector<BoundBox> &lower = levels.back();
+				for (size_t j = 0; j < lower.size(); j += RUN_LENGTH)
+				{
+					BoundBox bb = lower[j];
+					for (size_t k = j + 1; k < min(j + RUN_LENGTH, lower.size()); k++)
+					{
+						bb.AddPoint(IntPoint(lower[k].minX, lower[k].minY));
+						bb.AddPoint(IntPoint(lower[k].maxX, lower[k].maxY));
+					}
+					upper.push_back(bb);
+				}
+				levels.push_back(std::move(upper));
+			}
+		}
+	}
+
+	// appends the reduced paths that have the same winding numbers as the indexed paths inside the box
+	void GetPathsInBox(const BoundBox &box, Paths &output) const
+	{
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			const vector<vector<BoundBox>> &levels = index[i];
+			if (levels.empty() || !levels.back().front().CollidesWith(box))
+				continue; // the path does not surround any point of the box
+			const Path &path = (*paths)[i];
+			if (box.Contains(levels.back().front()))
+			{
+				output.push_back(path);
+				continue;
+			}
+			output.emplace_back();
+			AddRun(path, levels, levels.size() - 1, 0, box, output.back());
+		}
+	}
+
+  private:
+	static const size_t RUN_LENGTH = 16;
+	const Paths *paths = nullptr;
+	vector<vector<vector<BoundBox>>> index; // per path the levels of the run bound boxes
+
+	void AddRun(const Path &path, const vector<vector<BoundBox>> &levels, size_t level, size_t run,
+				const BoundBox &box, Path &output) const
+	{
+		size_t length = RUN_LENGTH;
+		for (size_t l = 0; l < level; l++)
+			length *= RUN_LENGTH;
+		size_t first = run * length;
+		size_t last = min(first + length, path.size()) - 1;
+		if (!levels[level][run].CollidesWith(box))
+		{
+			output.push_back(path[first]);
+			if (last != first)
+				output.push_back(path[last]);
+		}
+		else if (level == 0)
+		{
+			output.insert(output.end(), path.begin() + first, path.begin() + last + 1);
+		}
+		else
+		{
+			size_t end = min((run + 1) * RUN_LENGTH, levels[level - 1].size());
+			for (size_t lower = run * RUN_LENGTH; lower < end; lower++)
+				AddRun(path, levels, level - 1, lower, box, output);
+		}
+	}
+};
+
 //***********************************
 // Cleared area bounding support
 //***********************************
@@ -925,6 +1024,7 @@ class ClearedArea
 		clearedPaths = paths;
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
+		indexInvalid = true;
 	}
 	void ExpandCleared(const Path toClearToolPath)
 	{
@@ -942,6 +1042,7 @@ class ClearedArea
 		CleanPolygons(clearedPaths);
 		bboxPathsInvalid = true;
 		bboxClippedInvalid = true;
+		indexInvalid = true;
 		Perf_ExpandCleared.Stop();
 	}
 
@@ -1014,14 +1115,27 @@ class ClearedArea
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y - delta2));
 		bbPath.push_back(IntPoint(toolPos.X + delta2, toolPos.Y + delta2));
 		bbPath.push_back(IntPoint(toolPos.X - delta2, toolPos.Y + delta2));
+		Paths clearedInBox;
+		GetClearedInBox(BoundBox(toolPos, delta2), clearedInBox);
 		clip.Clear();
 		clip.AddPath(bbPath, PolyType::ptSubject, true);
-		clip.AddPaths(clearedPaths, PolyType::ptClip, true);
+		clip.AddPaths(clearedInBox, PolyType::ptClip, true);
 		clip.Execute(ClipType::ctIntersection, clearedBoundedClipped);
 		bboxClippedInvalid = false;
 		return clearedBoundedClipped;
 	}
 
+	// get the cleared paths reduced to the points needed inside the box, see PathsIndex
+	void GetClearedInBox(const BoundBox &box, Paths &output)
+	{
+		if (indexInvalid)
+		{
+			clearedIndex.Build(clearedPaths);
+			indexInvalid = false;
+		}
+		clearedIndex.GetPathsInBox(box, output);
+	}
+
 	// get full cleared area
 	Paths &GetCleared()
 	{
@@ -1034,6 +1148,7 @@ class ClearedArea
 	Paths clearedPaths;
 	Paths clearedBoundedClipped;
 	Paths clearedBoundedPaths;
+	PathsIndex clearedIndex;
 
 	ClipperLib::cInt toolRadiusScaled;
 	BoundBox clearedBBClippedInFocus;
@@ -1041,6 +1156,7 @@ class ClearedArea
 
 	bool bboxClippedInvalid = false;
 	bool bboxPathsInvalid = false;
+	bool indexInvalid = true;
 	// size of the focus BB
 	const ClipperLib::cInt focusBBFactor1 = 8;
 	const ClipperLib::cInt focusBBFactor2 = 9;
@@ -2065,8 +2181,19 @@ bool Adaptive2d::IsClearPath(const Path &tp, ClearedArea &cleared, double safety
 	clipof.AddPath(tp, JoinType::jtRound, EndType::etOpenRound);
 	Paths toolShape;
 	clipof.Execute(toolShape, toolRadiusScaled + safetyClearance);
+	if (toolShape.empty() || toolShape.front().empty())
+	{
+		Perf_IsClearPath.Stop();
+		return true;
+	}
+	BoundBox toolShapeBB(toolShape.front().front());
+	for (const auto &pth : toolShape)
+		for (const auto &pt : pth)
+			toolShapeBB.AddPoint(pt);
+	Paths clearedInBox;
+	cleared.GetClearedInBox(toolShapeBB, clearedInBox);
 	clip.AddPaths(toolShape, PolyType::ptSubject, true);
-	clip.AddPaths(cleared.GetCleared(), PolyType::ptClip, true);
+	clip.AddPaths(clearedInBox, PolyType::ptClip, true);
 	Paths crossing;
 	clip.Execute(ClipType::ctDifference, crossing);
 	double collisionArea = 0;
@@ -4,6 +4,7 @@
 // This program is released under the BSD license. See the file COPYING for details.
 
 #include "Arc.h"
+#include "AreaSettings.h"
 #include "Curve.h"
 
 void CArc::SetDirWithPoint(const Point& p)
@@ -38,10 +39,10 @@ double CArc::IncludedAngle()const
 bool CArc::AlmostALine()const
 {
 	Point mid_point = MidParam(0.5);
-	if(Line(m_s, m_e - m_s).Dist(mid_point) <= Point::tolerance)
+	if(Line(m_s, m_e - m_s).Dist(mid_point) <= CAreaSettings::current().tolerance)
 		return true;
 
-	const double max_arc_radius = 1.0 / Point::tolerance;
+	const double max_arc_radius = 1.0 / CAreaSettings::current().tolerance;
 	double radius = m_c.dist(m_s);
 	if (radius > max_arc_radius)
 	{
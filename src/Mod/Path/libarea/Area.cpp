@@ -5,34 +5,18 @@
 
 #include "Area.h"
 #include "AreaOrderer.h"
+#include "AreaSettings.h"
 
 #include <map>
 
-double CArea::m_accuracy = 0.01;
-double CArea::m_units = 1.0;
-bool CArea::m_clipper_simple = false;
-double CArea::m_clipper_clean_distance = 0.0;
-bool CArea::m_fit_arcs = true;
-int CArea::m_min_arc_points = 4;
-int CArea::m_max_arc_points = 100;
-double CArea::m_single_area_processing_length = 0.0;
-double CArea::m_processing_done = 0.0;
 bool CArea::m_please_abort = false;
-double CArea::m_MakeOffsets_increment = 0.0;
-double CArea::m_split_processing_length = 0.0;
-bool CArea::m_set_processing_length_in_split = false;
-double CArea::m_after_MakeOffsets_length = 0.0;
 //static const double PI = 3.1415926535897932;
 
-#define _CAREA_PARAM_DEFINE(_class,_type,_name) \
-    _type CArea::get_##_name() {return _class::_name;}\
-    void CArea::set_##_name(_type _name) {_class::_name = _name;}
-
 #define CAREA_PARAM_DEFINE(_type,_name) \
-    _type CArea::get_##_name() {return m_##_name;}\
-    void CArea::set_##_name(_type _name) {m_##_name = _name;}
+    _type CArea::get_##_name() {return CAreaSettings::current()._name;}\
+    void CArea::set_##_name(_type _name) {CAreaSettings::current()._name = _name;}
 
-_CAREA_PARAM_DEFINE(Point,double,tolerance)
+CAREA_PARAM_DEFINE(double,tolerance)
 CAREA_PARAM_DEFINE(bool,fit_arcs)
 CAREA_PARAM_DEFINE(bool,clipper_simple)
 CAREA_PARAM_DEFINE(double,clipper_clean_distance)
@@ -94,8 +78,8 @@ void CArea::ChangeStartToNearest(const Point *point, double min_dist)
     std::list<CCurve> curves;
     Point p;
     if(point) p =*point;
-    if(min_dist < Point::tolerance) 
-        min_dist = Point::tolerance;
+    if(min_dist < CAreaSettings::current().tolerance) 
+        min_dist = CAreaSettings::current().tolerance;
 
     while(m_curves.size()) {
         std::list<CCurve>::iterator It=m_curves.begin();
@@ -107,7 +91,7 @@ void CArea::ChangeStartToNearest(const Point *point, double min_dist)
             const CCurve& curve = *It;
             Point near_point;
             double dist;
-            if(min_dist>Point::tolerance && !curve.IsClosed()) {
+            if(min_dist>CAreaSettings::current().tolerance && !curve.IsClosed()) {
                 double d1 = curve.m_vertices.front().m_p.dist(p);
                 double d2 = curve.m_vertices.back().m_p.dist(p);
                 if(d1<d2) {
@@ -133,7 +117,7 @@ void CArea::ChangeStartToNearest(const Point *point, double min_dist)
         }else{
             double dfront = ItBest->m_vertices.front().m_p.dist(best_point);
             double dback = ItBest->m_vertices.back().m_p.dist(best_point);
-            if(min_dist>Point::tolerance && dfront>min_dist && dback>min_dist) {
+            if(min_dist>CAreaSettings::current().tolerance && dfront>min_dist && dback>min_dist) {
                 ItBest->Break(best_point);
                 m_curves.push_back(*ItBest);
                 m_curves.back().ChangeEnd(best_point);
@@ -174,9 +158,9 @@ void CArea::Reorder()
         if(!It->IsClosed())
             continue;
 		ao.Insert(make_shared<CCurve>(curve));
-		if(m_set_processing_length_in_split)
+		if(CAreaSettings::current().set_processing_length_in_split)
 		{
-			CArea::m_processing_done += (m_split_processing_length / m_curves.size());
+			CAreaSettings::current().processing_done += (CAreaSettings::current().split_processing_length / m_curves.size());
 		}
         m_curves.erase(It);
 	}
@@ -501,11 +485,11 @@ static void zigzag(const CArea &input_a)
 {
 	if(input_a.m_curves.size() == 0)
 	{
-		CArea::m_processing_done += CArea::m_single_area_processing_length;
+		CAreaSettings::current().processing_done += CAreaSettings::current().single_area_processing_length;
 		return;
 	}
     
-    one_over_units = 1 / CArea::m_units;
+    one_over_units = 1 / CAreaSettings::current().units;
     
 	CArea a(input_a);
     rotate_area(a);
@@ -525,7 +509,7 @@ static void zigzag(const CArea &input_a)
 	if(CArea::m_please_abort)
 	    return;
 
-	double step_percent_increment = 0.8 * CArea::m_single_area_processing_length / num_steps;
+	double step_percent_increment = 0.8 * CAreaSettings::current().single_area_processing_length / num_steps;
 
 	for(int i = 0; i<num_steps; i++)
 	{
@@ -548,26 +532,26 @@ static void zigzag(const CArea &input_a)
 		rightward_for_zigs = !rightward_for_zigs;
 		if(CArea::m_please_abort)
 		    return;
-		CArea::m_processing_done += step_percent_increment;
+		CAreaSettings::current().processing_done += step_percent_increment;
 	}
 
 	reorder_zigs();
-	CArea::m_processing_done += 0.2 * CArea::m_single_area_processing_length;
+	CAreaSettings::current().processing_done += 0.2 * CAreaSettings::current().single_area_processing_length;
 }
 
 void CArea::SplitAndMakePocketToolpath(std::list<CCurve> &curve_list, const CAreaPocketParams &params)const
 {
-	CArea::m_processing_done = 0.0;
+	CAreaSettings::current().processing_done = 0.0;
 
-	double save_units = CArea::m_units;
-	CArea::m_units = 1.0;
+	double save_units = CAreaSettings::current().units;
+	CAreaSettings::current().units = 1.0;
 	std::list<CArea> areas;
-	m_split_processing_length = 50.0; // jump to 50 percent after split
-	m_set_processing_length_in_split = true;
+	CAreaSettings::current().split_processing_length = 50.0; // jump to 50 percent after split
+	CAreaSettings::current().set_processing_length_in_split = true;
 	Split(areas);
-	m_set_processing_length_in_split = false;
-	CArea::m_processing_done = m_split_processing_length;
-	CArea::m_units = save_units;
+	CAreaSettings::current().set_processing_length_in_split = false;
+	CAreaSettings::current().processing_done = CAreaSettings::current().split_processing_length;
+	CAreaSettings::current().units = save_units;
 
 	if(areas.size() == 0)
 	    return;
@@ -576,7 +560,7 @@ void CArea::SplitAndMakePocketToolpath(std::list<CCurve> &curve_list, const CAre
 
 	for(std::list<CArea>::iterator It = areas.begin(); It != areas.end(); It++)
 	{
-		CArea::m_single_area_processing_length = single_area_length;
+		CAreaSettings::current().single_area_processing_length = single_area_length;
 		CArea &ar = *It;
 		ar.MakePocketToolpath(curve_list, params);
 	}
@@ -609,11 +593,11 @@ void CArea::MakePocketToolpath(std::list<CCurve> &curve_list, const CAreaPocketP
 		    return;
 		if(m_areas.size() == 0)
 		{
-			CArea::m_processing_done += CArea::m_single_area_processing_length;
+			CAreaSettings::current().processing_done += CAreaSettings::current().single_area_processing_length;
 			return;
 		}
 
-		CArea::m_single_area_processing_length /= m_areas.size();
+		CAreaSettings::current().single_area_processing_length /= m_areas.size();
 
 		for(std::list<CArea>::iterator It = m_areas.begin(); It != m_areas.end(); It++)
 		{
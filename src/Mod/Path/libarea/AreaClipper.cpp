@@ -3,6 +3,7 @@
 // implements CArea methods using Angus Johnson's "Clipper"
 
 #include "Area.h"
+#include "AreaSettings.h"
 #include "clipper.hpp"
 using namespace ClipperLib;
 
@@ -12,7 +13,6 @@ using namespace ClipperLib;
 bool CArea::HolesLinked(){ return false; }
 
 //static const double PI = 3.1415926535897932;
-double CArea::m_clipper_scale = 10000.0;
 
 class DoubleAreaPoint
 {
@@ -20,8 +20,8 @@ public:
 	double X, Y;
 
 	DoubleAreaPoint(double x, double y){X = x; Y = y;}
-	DoubleAreaPoint(const IntPoint& p){X = (double)(p.X) / CArea::m_clipper_scale; Y = (double)(p.Y) / CArea::m_clipper_scale;}
-	IntPoint int_point(){return IntPoint((long64)(X * CArea::m_clipper_scale), (long64)(Y * CArea::m_clipper_scale));}
+	DoubleAreaPoint(const IntPoint& p){X = (double)(p.X) / CAreaSettings::current().clipper_scale; Y = (double)(p.Y) / CAreaSettings::current().clipper_scale;}
+	IntPoint int_point(){return IntPoint((long64)(X * CAreaSettings::current().clipper_scale), (long64)(Y * CAreaSettings::current().clipper_scale));}
 };
 
 static std::list<DoubleAreaPoint> pts_for_AddVertex;
@@ -35,7 +35,7 @@ static void AddVertex(const CVertex& vertex, const CVertex* prev_vertex)
 {
 	if(vertex.m_type == 0 || prev_vertex == NULL)
 	{
-		AddPoint(DoubleAreaPoint(vertex.m_p.x * CArea::m_units, vertex.m_p.y * CArea::m_units));
+		AddPoint(DoubleAreaPoint(vertex.m_p.x * CAreaSettings::current().units, vertex.m_p.y * CAreaSettings::current().units));
 	}
 	else
 	{
@@ -46,13 +46,13 @@ static void AddVertex(const CVertex& vertex, const CVertex* prev_vertex)
 		int i;
 		double ang1,ang2,phit;
 
-		dx = (prev_vertex->m_p.x - vertex.m_c.x) * CArea::m_units;
-		dy = (prev_vertex->m_p.y - vertex.m_c.y) * CArea::m_units;
+		dx = (prev_vertex->m_p.x - vertex.m_c.x) * CAreaSettings::current().units;
+		dy = (prev_vertex->m_p.y - vertex.m_c.y) * CAreaSettings::current().units;
 
 		ang1=atan2(dy,dx);
 		if (ang1<0) ang1+=2.0*PI;
-		dx = (vertex.m_p.x - vertex.m_c.x) * CArea::m_units;
-		dy = (vertex.m_p.y - vertex.m_c.y) * CArea::m_units;
+		dx = (vertex.m_p.x - vertex.m_c.x) * CAreaSettings::current().units;
+		dy = (vertex.m_p.y - vertex.m_c.y) * CAreaSettings::current().units;
 		ang2=atan2(dy,dx);
 		if (ang2<0) ang2+=2.0*PI;
 
@@ -73,7 +73,7 @@ static void AddVertex(const CVertex& vertex, const CVertex* prev_vertex)
 
 		//what is the delta phi to get an accuracy of aber
 		double radius = sqrt(dx*dx + dy*dy);
-		dphi=2*acos((radius-CArea::m_accuracy)/radius);
+		dphi=2*acos((radius-CAreaSettings::current().accuracy)/radius);
 
 		//set the number of segments
 		if (phit > 0)
@@ -81,24 +81,24 @@ static void AddVertex(const CVertex& vertex, const CVertex* prev_vertex)
 		else
 			Segments=(int)ceil(-phit/dphi);
 
-        if (Segments < CArea::m_min_arc_points)
-            Segments = CArea::m_min_arc_points;
-        // if (Segments > CArea::m_max_arc_points)
-        //     Segments=CArea::m_max_arc_points;
+        if (Segments < CAreaSettings::current().min_arc_points)
+            Segments = CAreaSettings::current().min_arc_points;
+        // if (Segments > CAreaSettings::current().max_arc_points)
+        //     Segments=CAreaSettings::current().max_arc_points;
 
 		dphi=phit/(Segments);
 
-		double px = prev_vertex->m_p.x * CArea::m_units;
-		double py = prev_vertex->m_p.y * CArea::m_units;
+		double px = prev_vertex->m_p.x * CAreaSettings::current().units;
+		double py = prev_vertex->m_p.y * CAreaSettings::current().units;
 
 		for (i=1; i<=Segments; i++)
 		{
-			dx = px - vertex.m_c.x * CArea::m_units;
-			dy = py - vertex.m_c.y * CArea::m_units;
+			dx = px - vertex.m_c.x * CAreaSettings::current().units;
+			dy = py - vertex.m_c.y * CAreaSettings::current().units;
 			phi=atan2(dy,dx);
 
-			double nx = vertex.m_c.x * CArea::m_units + radius * cos(phi-dphi);
-			double ny = vertex.m_c.y * CArea::m_units + radius * sin(phi-dphi);
+			double nx = vertex.m_c.x * CAreaSettings::current().units + radius * cos(phi-dphi);
+			double ny = vertex.m_c.y * CAreaSettings::current().units + radius * sin(phi-dphi);
 
 			AddPoint(DoubleAreaPoint(nx, ny));
 
@@ -127,19 +127,19 @@ static void MakeLoop(const DoubleAreaPoint &pt0, const DoubleAreaPoint &pt1, con
 	CVertex v1(arc_dir, p1 + right1 * radius, p1);
 	CVertex v2(0, p2 + right1 * radius, Point(0, 0));
 
-	double save_units = CArea::m_units;
-	CArea::m_units = 1.0;
+	double save_units = CAreaSettings::current().units;
+	CAreaSettings::current().units = 1.0;
 
 	AddVertex(v1, &v0);
 	AddVertex(v2, &v1);
 
-	CArea::m_units = save_units;
+	CAreaSettings::current().units = save_units;
 }
 
 static void OffsetWithLoops(const TPolyPolygon &pp, TPolyPolygon &pp_new, double inwards_value)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 
 	bool inwards = (inwards_value > 0);
 	bool reverse = false;
@@ -237,8 +237,8 @@ static void MakeObround(const Point &pt0, const CVertex &vt1, double radius)
 	CVertex v3(-vt1.m_type, pt0 + right0 * -radius, vt1.m_c);
 	CVertex v4(1, pt0 + right0 * radius, pt0);
 
-	double save_units = CArea::m_units;
-	CArea::m_units = 1.0;
+	double save_units = CAreaSettings::current().units;
+	CAreaSettings::current().units = 1.0;
 
 	AddVertex(v0, NULL);
 	AddVertex(v1, &v0);
@@ -246,13 +246,13 @@ static void MakeObround(const Point &pt0, const CVertex &vt1, double radius)
 	AddVertex(v3, &v2);
 	AddVertex(v4, &v3);
 
-	CArea::m_units = save_units;
+	CAreaSettings::current().units = save_units;
 }
 
 static void OffsetSpansWithObrounds(const CArea& area, TPolyPolygon &pp_new, double radius)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 
 
 	for(std::list<CCurve>::const_iterator It = area.m_curves.begin(); It != area.m_curves.end(); It++)
@@ -345,14 +345,14 @@ static void MakePolyPoly( const CArea& area, TPolyPolygon &pp, bool reverse = tr
 
 static void SetFromResult( CCurve& curve, TPolygon& p, bool reverse = true, bool is_closed = true )
 {
-    if(CArea::m_clipper_clean_distance >= Point::tolerance)
-        CleanPolygon(p,CArea::m_clipper_clean_distance);
+    if(CAreaSettings::current().clipper_clean_distance >= CAreaSettings::current().tolerance)
+        CleanPolygon(p,CAreaSettings::current().clipper_clean_distance);
 
     for(unsigned int j = 0; j < p.size(); j++)
     {
         const IntPoint &pt = p[j];
         DoubleAreaPoint dp(pt);
-        CVertex vertex(0, Point(dp.X / CArea::m_units, dp.Y / CArea::m_units), Point(0.0, 0.0));
+        CVertex vertex(0, Point(dp.X / CAreaSettings::current().units, dp.Y / CAreaSettings::current().units), Point(0.0, 0.0));
         if(reverse)curve.m_vertices.push_front(vertex);
         else curve.m_vertices.push_back(vertex);
     }
@@ -362,7 +362,7 @@ static void SetFromResult( CCurve& curve, TPolygon& p, bool reverse = true, bool
         else curve.m_vertices.push_back(curve.m_vertices.front());
     }
 
-    if(CArea::m_fit_arcs)curve.FitArcs();
+    if(CAreaSettings::current().fit_arcs)curve.FitArcs();
 }
 
 static void SetFromResult( CArea& area, TPolyPolygon& pp, bool reverse=true, bool is_closed=true, bool clear=true)
@@ -384,7 +384,7 @@ static void SetFromResult( CArea& area, TPolyPolygon& pp, bool reverse=true, boo
 void CArea::Subtract(const CArea& a2)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 	TPolyPolygon pp1, pp2;
 	MakePolyPoly(*this, pp1);
 	MakePolyPoly(a2, pp2);
@@ -398,7 +398,7 @@ void CArea::Subtract(const CArea& a2)
 void CArea::Intersect(const CArea& a2)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 	TPolyPolygon pp1, pp2;
 	MakePolyPoly(*this, pp1);
 	MakePolyPoly(a2, pp2);
@@ -412,7 +412,7 @@ void CArea::Intersect(const CArea& a2)
 void CArea::Union(const CArea& a2)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 	TPolyPolygon pp1, pp2;
 	MakePolyPoly(*this, pp1);
 	MakePolyPoly(a2, pp2);
@@ -427,7 +427,7 @@ void CArea::Union(const CArea& a2)
 CArea CArea::UniteCurves(std::list<CCurve> &curves)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 
 	TPolyPolygon pp;
 
@@ -450,7 +450,7 @@ CArea CArea::UniteCurves(std::list<CCurve> &curves)
 void CArea::Xor(const CArea& a2)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
 	TPolyPolygon pp1, pp2;
 	MakePolyPoly(*this, pp1);
 	MakePolyPoly(a2, pp2);
@@ -465,7 +465,7 @@ void CArea::Offset(double inwards_value)
 {
 	TPolyPolygon pp, pp2;
 	MakePolyPoly(*this, pp, false);
-	OffsetWithLoops(pp, pp2, inwards_value * m_units);
+	OffsetWithLoops(pp, pp2, inwards_value * CAreaSettings::current().units);
 	SetFromResult(*this, pp2, false);
 	this->Reorder();
 }
@@ -496,7 +496,7 @@ void CArea::Clip(ClipType op, const CArea *a,
                  PolyFillType clipFillType)
 {
 	Clipper c;
-    c.StrictlySimple(CArea::m_clipper_simple);
+    c.StrictlySimple(CAreaSettings::current().clipper_simple);
     PopulateClipper(c,ptSubject);
     if(a) a->PopulateClipper(c,ptClip);
     PolyTree tree;
@@ -515,19 +515,19 @@ void CArea::OffsetWithClipper(double offset,
                               double miterLimit/*  = 5.0 */,
                               double roundPrecision/*  = 0.0 */)
 {
-    offset *= m_units*m_clipper_scale;
+    offset *= CAreaSettings::current().units*CAreaSettings::current().clipper_scale;
     if(roundPrecision == 0.0) {
         // Clipper roundPrecision definition: https://goo.gl/4odfQh
-		double dphi=acos(1.0-m_accuracy*m_clipper_scale/fabs(offset));
+		double dphi=acos(1.0-CAreaSettings::current().accuracy*CAreaSettings::current().clipper_scale/fabs(offset));
         int Segments=(int)ceil(PI/dphi);
-        if (Segments < 2*CArea::m_min_arc_points)
-            Segments = 2*CArea::m_min_arc_points;
-        // if (Segments > CArea::m_max_arc_points)
-        //     Segments=CArea::m_max_arc_points;
+        if (Segments < 2*CAreaSettings::current().min_arc_points)
+            Segments = 2*CAreaSettings::current().min_arc_points;
+        // if (Segments > CAreaSettings::current().max_arc_points)
+        //     Segments=CAreaSettings::current().max_arc_points;
         dphi = PI/Segments;
         roundPrecision = (1.0-cos(dphi))*fabs(offset);
     }else
-        roundPrecision *= m_clipper_scale;
+        roundPrecision *= CAreaSettings::current().clipper_scale;
 
     ClipperOffset clipper(miterLimit,roundPrecision);
 	TPolyPolygon pp, pp2;
@@ -543,7 +543,7 @@ void CArea::OffsetWithClipper(double offset,
 void CArea::Thicken(double value)
 {
 	TPolyPolygon pp;
-	OffsetSpansWithObrounds(*this, pp, value * m_units);
+	OffsetSpansWithObrounds(*this, pp, value * CAreaSettings::current().units);
 	SetFromResult(*this, pp, false);
 	this->Reorder();
 }
@@ -564,7 +564,7 @@ void UnFitArcs(CCurve &curve)
 	for(std::list<DoubleAreaPoint>::iterator It = pts_for_AddVertex.begin(); It != pts_for_AddVertex.end(); It++)
 	{
 		DoubleAreaPoint &pt = *It;
-		CVertex vertex(0, Point(pt.X / CArea::m_units, pt.Y / CArea::m_units), Point(0.0, 0.0));
+		CVertex vertex(0, Point(pt.X / CAreaSettings::current().units, pt.Y / CAreaSettings::current().units), Point(0.0, 0.0));
 		curve.m_vertices.push_back(vertex);
 	}
 }
@@ -5,6 +5,7 @@
 // implements CArea::MakeOnePocketCurve
 
 #include "Area.h"
+#include "AreaSettings.h"
 
 #include <map>
 #include <set>
@@ -128,7 +129,7 @@ void GetCurveItem::GetCurve(CCurve& output)
 			for(std::multimap<double, CurveTree*>::iterator It2 = ordered_inners.begin(); It2 != ordered_inners.end(); It2++)
 			{
 				CurveTree& inner = *(It2->second);
-				if(inner.point_on_parent.dist(back().m_p) > 0.01/CArea::m_units)
+				if(inner.point_on_parent.dist(back().m_p) > 0.01/CAreaSettings::current().units)
 				{
 					output.m_vertices.insert(this->EndIt, CVertex(vertex.m_type, inner.point_on_parent, vertex.m_c));
 				}
@@ -314,8 +315,8 @@ void CurveTree::MakeOffsets2()
 		}
 	}
 
-	CArea::m_processing_done += CArea::m_MakeOffsets_increment;
-	if(CArea::m_processing_done > CArea::m_after_MakeOffsets_length)CArea::m_processing_done = CArea::m_after_MakeOffsets_length;
+	CAreaSettings::current().processing_done += CAreaSettings::current().MakeOffsets_increment;
+	if(CAreaSettings::current().processing_done > CAreaSettings::current().after_MakeOffsets_length)CAreaSettings::current().processing_done = CAreaSettings::current().after_MakeOffsets_length;
 
 	std::list<CArea> separate_areas;
 	smaller.Split(separate_areas);
@@ -494,7 +495,7 @@ void CArea::MakeOnePocketCurve(std::list<CCurve> &curve_list, const CAreaPocketP
 	pocket_params = &params;
 	if(m_curves.size() == 0)
 	{
-		CArea::m_processing_done += CArea::m_single_area_processing_length;
+		CAreaSettings::current().processing_done += CAreaSettings::current().single_area_processing_length;
 		return;
 	}
 	CurveTree top_level(m_curves.front());
@@ -516,17 +517,17 @@ void CArea::MakeOnePocketCurve(std::list<CCurve> &curve_list, const CAreaPocketP
 
 	MarkOverlappingOffsetIslands(offset_islands);
 
-	CArea::m_processing_done += CArea::m_single_area_processing_length * 0.1;
+	CAreaSettings::current().processing_done += CAreaSettings::current().single_area_processing_length * 0.1;
 
-	double MakeOffsets_processing_length = CArea::m_single_area_processing_length * 0.8;
-	CArea::m_after_MakeOffsets_length = CArea::m_processing_done + MakeOffsets_processing_length;
+	double MakeOffsets_processing_length = CAreaSettings::current().single_area_processing_length * 0.8;
+	CAreaSettings::current().after_MakeOffsets_length = CAreaSettings::current().processing_done + MakeOffsets_processing_length;
 	double guess_num_offsets = sqrt(GetArea(true)) * 0.5 / params.stepover;
-	CArea::m_MakeOffsets_increment = MakeOffsets_processing_length / guess_num_offsets;
+	CAreaSettings::current().MakeOffsets_increment = MakeOffsets_processing_length / guess_num_offsets;
 
 	top_level.MakeOffsets();
 	if(CArea::m_please_abort)
 	    return;
-	CArea::m_processing_done = CArea::m_after_MakeOffsets_length;
+	CAreaSettings::current().processing_done = CAreaSettings::current().after_MakeOffsets_length;
 
 	curve_list.emplace_back();
 	CCurve& output = curve_list.back();
@@ -557,7 +558,7 @@ void CArea::MakeOnePocketCurve(std::list<CCurve> &curve_list, const CAreaPocketP
 		delete curve_tree;
 	}
 
-	CArea::m_processing_done += CArea::m_single_area_processing_length * 0.1;
+	CAreaSettings::current().processing_done += CAreaSettings::current().single_area_processing_length * 0.1;
 #endif
 }
 
@@ -0,0 +1,37 @@
+// AreaSettings.h
+// This program is released under the BSD license. See the file COPYING for details.
+
+#ifndef AREA_SETTINGS_HEADER
+#define AREA_SETTINGS_HEADER
+
+// The settings and the progress of libarea. They are per thread, so that areas can be processed
+// concurrently with different settings, see CAreaConfig in Mod/Path/App/Area.h.
+// Thread local data can't be exported from a DLL, so only libarea itself includes this header.
+// Other modules use the get_ and set_ functions of CArea.
+struct CAreaSettings
+{
+	double accuracy = 0.01;
+	double units = 1.0; // 1.0 for mm, 25.4 for inches. All points are multiplied by this before going to the engine
+	bool clipper_simple = false;
+	double clipper_clean_distance = 0.0;
+	bool fit_arcs = true;
+	int min_arc_points = 4;
+	int max_arc_points = 100;
+	double processing_done = 0.0; // 0.0 to 100.0, set inside MakeOnePocketCurve
+	double single_area_processing_length = 0.0;
+	double after_MakeOffsets_length = 0.0;
+	double MakeOffsets_increment = 0.0;
+	double split_processing_length = 0.0;
+	bool set_processing_length_in_split = false;
+	double clipper_scale = 10000.0;
+	double tolerance = 0.001; // points closer than this are equal
+
+	// the settings of the calling thread
+	static CAreaSettings& current()
+	{
+		static thread_local CAreaSettings settings;
+		return settings;
+	}
+};
+
+#endif
@@ -6,16 +6,17 @@
 #include "Circle.h"
 #include "Arc.h"
 #include "Area.h"
+#include "AreaSettings.h"
 #include "kurve/geometry.h"
 
 const Point operator*(const double &d, const Point &p){ return p * d;}
-double Point::tolerance = 0.001;
 
 //static const double PI = 3.1415926535897932; duplicated in kurve/geometry.h
 
 //This function is moved from header here to solve windows DLL not export
 //static variable problem
 bool Point::operator==(const Point& p)const{
+    double tolerance = CAreaSettings::current().tolerance;
     return fabs(x-p.x)<tolerance && fabs(y-p.y)<tolerance;
 }
 
@@ -96,7 +97,7 @@ bool CCurve::CheckForArc(const CVertex& prev_vt, std::list<const CVertex*>& migh
     // is not exactly what's documented at https://goo.gl/4odfQh. Test shows the
     // maximum arc distance deviate at about 2.2*ArcTolerance units. The maximum
     // deviance seems to always occur at the end of arc.
-	double accuracy = CArea::m_accuracy * 2.3 / CArea::m_units;
+	double accuracy = CAreaSettings::current().accuracy * 2.3 / CAreaSettings::current().units;
 	for(std::list<const CVertex*>::iterator It = might_be_an_arc.begin(); It != might_be_an_arc.end(); It++)
 	{
 		const CVertex* vt = *It;
@@ -289,7 +290,7 @@ void CCurve::UnFitArcs()
 		const CVertex& vertex = *It2;
 		if(vertex.m_type == 0 || prev_vertex == NULL)
 		{
-			new_pts.push_back(vertex.m_p * CArea::m_units);
+			new_pts.push_back(vertex.m_p * CAreaSettings::current().units);
 		}
 		else
 		{
@@ -300,13 +301,13 @@ void CCurve::UnFitArcs()
 				int i;
 				double ang1,ang2,phit;
 
-				dx = (prev_vertex->m_p.x - vertex.m_c.x) * CArea::m_units;
-				dy = (prev_vertex->m_p.y - vertex.m_c.y) * CArea::m_units;
+				dx = (prev_vertex->m_p.x - vertex.m_c.x) * CAreaSettings::current().units;
+				dy = (prev_vertex->m_p.y - vertex.m_c.y) * CAreaSettings::current().units;
 
 				ang1=atan2(dy,dx);
 				if (ang1<0) ang1+=2.0*PI;
-				dx = (vertex.m_p.x - vertex.m_c.x) * CArea::m_units;
-				dy = (vertex.m_p.y - vertex.m_c.y) * CArea::m_units;
+				dx = (vertex.m_p.x - vertex.m_c.x) * CAreaSettings::current().units;
+				dy = (vertex.m_p.y - vertex.m_c.y) * CAreaSettings::current().units;
 				ang2=atan2(dy,dx);
 				if (ang2<0) ang2+=2.0*PI;
 
@@ -327,7 +328,7 @@ void CCurve::UnFitArcs()
 
 				//what is the delta phi to get an accuracy of aber
 				double radius = sqrt(dx*dx + dy*dy);
-				dphi=2*acos((radius-CArea::m_accuracy)/radius);
+				dphi=2*acos((radius-CAreaSettings::current().accuracy)/radius);
 
 				//set the number of segments
 				if (phit > 0)
@@ -342,17 +343,17 @@ void CCurve::UnFitArcs()
 
 				dphi=phit/(Segments);
 
-				double px = prev_vertex->m_p.x * CArea::m_units;
-				double py = prev_vertex->m_p.y * CArea::m_units;
+				double px = prev_vertex->m_p.x * CAreaSettings::current().units;
+				double py = prev_vertex->m_p.y * CAreaSettings::current().units;
 
 				for (i=1; i<=Segments; i++)
 				{
-					dx = px - vertex.m_c.x * CArea::m_units;
-					dy = py - vertex.m_c.y * CArea::m_units;
+					dx = px - vertex.m_c.x * CAreaSettings::current().units;
+					dy = py - vertex.m_c.y * CAreaSettings::current().units;
 					phi=atan2(dy,dx);
 
-					double nx = vertex.m_c.x * CArea::m_units + radius * cos(phi-dphi);
-					double ny = vertex.m_c.y * CArea::m_units + radius * sin(phi-dphi);
+					double nx = vertex.m_c.x * CAreaSettings::current().units + radius * cos(phi-dphi);
+					double ny = vertex.m_c.y * CAreaSettings::current().units + radius * sin(phi-dphi);
 
 					new_pts.emplace_back(nx, ny);
 
@@ -369,7 +370,7 @@ void CCurve::UnFitArcs()
 	for(std::list<Point>::iterator It = new_pts.begin(); It != new_pts.end(); It++)
 	{
 		Point &pt = *It;
-		CVertex vertex(0, pt / CArea::m_units, Point(0.0, 0.0));
+		CVertex vertex(0, pt / CAreaSettings::current().units, Point(0.0, 0.0));
 		m_vertices.push_back(vertex);
 	}
 }
@@ -656,7 +657,7 @@ void CCurve::RemoveTinySpans() {
 	{
 		const CVertex& vertex = *VIt;
 
-		if(vertex.m_type != 0 || new_curve.m_vertices.back().m_p.dist(vertex.m_p) > Point::tolerance)
+		if(vertex.m_type != 0 || new_curve.m_vertices.back().m_p.dist(vertex.m_p) > CAreaSettings::current().tolerance)
 		{
 			new_curve.m_vertices.push_back(vertex);
 		}
@@ -1043,7 +1044,7 @@ Point Span::NearestPointNotOnSpan(const Point& p)const
 	{
 		double radius = m_p.dist(m_v.m_c);
 		double r = p.dist(m_v.m_c);
-		if(r < Point::tolerance)
+		if(r < CAreaSettings::current().tolerance)
 		    return m_p;
 		Point vc = (m_v.m_c - p);
 		return p + vc * ((r - radius) / r);
@@ -1108,9 +1109,9 @@ Point Span::NearestPointToSpan(const Span& p, double &d)const
 	Point np = p.NearestPoint(m_p);
 	Point best_point = m_p;
 	double dist = np.dist(m_p);
-	if(p.m_start_span)dist -= (CArea::m_accuracy * 2); // give start of curve most priority
+	if(p.m_start_span)dist -= (CAreaSettings::current().accuracy * 2); // give start of curve most priority
 	Point npm = p.NearestPoint(midpoint);
-	double dm = npm.dist(midpoint) - CArea::m_accuracy; // lie about midpoint distance to give midpoints priority
+	double dm = npm.dist(midpoint) - CAreaSettings::current().accuracy; // lie about midpoint distance to give midpoints priority
 	if(dm < dist){dist = dm; best_point = midpoint;}
 	Point np2 = p.NearestPoint(m_v.m_p);
 	double dp2 = np2.dist(m_v.m_p);
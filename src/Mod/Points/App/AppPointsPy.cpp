@@ -36,6 +36,7 @@
 
 #include "Points.h"
 #include "PointsAlgos.h"
+#include "PointsOctree.h"
 #include "PointsPy.h"
 #include "Properties.h"
 #include "Structured.h"
@@ -72,6 +73,38 @@ private:
 
         return std::make_tuple(useColor, checkState, minDistance);
     }
+    /**
+     * If the user set a limit and \a points exceeds it, an octree of \a points
+     * is built in a temporary file and the finest level of detail within the limit
+     * is returned in \a lod. Otherwise false is returned.
+     */
+    bool getLevelOfDetail(const PointKernel& points, PointKernel& lod) const
+    {
+        Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter()
+            .GetGroup("BaseApp")->GetGroup("Preferences")->GetGroup("Mod/Points/Import");
+        unsigned long maxPoints = hGrp->GetUnsigned("MaxPoints", 0);
+        if (maxPoints == 0 || points.size() <= maxPoints)
+            return false;
+
+        Base::FileInfo fi(App::Application::getTempFileName("octree"));
+        try {
+            PointsOctree octree(fi.filePath());
+            KernelSource source(points);
+            octree.build(source);
+            octree.getPoints(octree.getBoundBox(), octree.findLevel(maxPoints), lod);
+        }
+        catch (...) {
+            fi.deleteFile();
+            throw;
+        }
+        fi.deleteFile();
+
+        lod.setTransform(points.getTransform());
+        Base::Console().Warning("Point cloud reduced from %lu to %lu points\n",
+                                static_cast<unsigned long>(points.size()),
+                                static_cast<unsigned long>(lod.size()));
+        return true;
+    }
     Py::Object open(const Py::Tuple& args)
     {
         char* Name;
@@ -174,7 +207,11 @@ private:
                 }
 
                 // delayed adding of the points feature
-                pcFeature->Points.setValue(reader->getPoints());
+                PointKernel lod;
+                if (!reader->isStructured() && getLevelOfDetail(reader->getPoints(), lod))
+                    pcFeature->Points.setValue(lod);
+                else
+                    pcFeature->Points.setValue(reader->getPoints());
                 pcDoc->addObject(pcFeature, file.fileNamePure().c_str());
                 pcDoc->recomputeFeature(pcFeature);
                 pcFeature->purgeTouched();
@@ -284,7 +321,11 @@ private:
             else {
                 Points::Feature* pcFeature = static_cast<Points::Feature*>
                     (pcDoc->addObject("Points::Feature", file.fileNamePure().c_str()));
-                pcFeature->Points.setValue(reader->getPoints());
+                PointKernel lod;
+                if (!reader->isStructured() && getLevelOfDetail(reader->getPoints(), lod))
+                    pcFeature->Points.setValue(lod);
+                else
+                    pcFeature->Points.setValue(reader->getPoints());
                 pcDoc->recomputeFeature(pcFeature);
                 pcFeature->purgeTouched();
             }
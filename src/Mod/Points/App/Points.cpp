@@ -171,13 +171,13 @@ void PointKernel::Save (Base::Writer &writer) const
 
 void PointKernel::SaveDocFile (Base::Writer &writer) const
 {
+    static_assert(sizeof(value_type) == 3 * sizeof(float_type), "value_type is expected to be packed");
+
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)size();
     str << uCt;
     // store the data without transforming it
-    for (std::vector<value_type>::const_iterator it = _Points.begin(); it != _Points.end(); ++it) {
-        str << it->x << it->y << it->z;
-    }
+    str.write(reinterpret_cast<const float_type*>(_Points.data()), 3 * _Points.size());
 }
 
 void PointKernel::Restore(Base::XMLReader &reader)
@@ -203,11 +203,8 @@ void PointKernel::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt = 0;
     str >> uCt;
     _Points.resize(uCt);
-    for (unsigned long i=0; i < uCt; i++) {
-        float x, y, z;
-        str >> x >> y >> z;
-        _Points[i].Set(x,y,z);
-    }
+    // read the coordinates directly into the point array
+    str.read(reinterpret_cast<float_type*>(_Points.data()), 3 * _Points.size());
 }
 
 void PointKernel::save(const char* file) const
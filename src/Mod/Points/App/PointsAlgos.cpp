@@ -25,9 +25,16 @@
 # ifdef FC_OS_LINUX
 #  include <unistd.h>
 # endif
+# include <atomic>
+# include <cstdlib>
+# include <cstring>
+# include <limits>
 # include <memory>
 # include <sstream>
 
+# include <QFile>
+# include <QtConcurrentMap>
+
 # include <boost/lexical_cast.hpp>
 # include <boost/regex.hpp>
 # include <boost/algorithm/string.hpp>
@@ -40,6 +47,7 @@
 #include <Base/FileInfo.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
 
 #include "PointsAlgos.h"
 #include <E57Format.h>
@@ -130,6 +138,7 @@ Reader::~Reader()
 
 void Reader::clear()
 {
+    points.clear();
     intensity.clear();
     colors.clear();
     normals.clear();
@@ -245,79 +254,6 @@ public:
 
 using ConverterPtr = std::shared_ptr<Converter>;
 
-class DataStreambuf : public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data) : _buffer(data) {
-        _beg = 0;
-        _end = data.size();
-        _cur = 0;
-    }
-    ~DataStreambuf() override {
-    }
-
-protected:
-    int_type uflow() override {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    int_type underflow() override {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    int_type pbackfail(int_type ch) override {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur-1]))
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    std::streamsize showmanyc() override {
-        return _end - _cur;
-    }
-    pos_type seekoff(std::streambuf::off_type off,
-        std::ios_base::seekdir way,
-        std::ios_base::openmode =
-            std::ios::in | std::ios::out) override {
-        int p_pos=-1;
-        if (way == std::ios_base::beg)
-            p_pos = _beg;
-        else if (way == std::ios_base::end)
-            p_pos = _end;
-        else if (way == std::ios_base::cur)
-            p_pos = _cur;
-
-        if (p_pos > _end)
-            return traits_type::eof();
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg))
-            return traits_type::eof();
-
-        _cur = p_pos+ off;
-
-        return ((p_pos+off) - _beg);
-    }
-    pos_type seekpos(std::streambuf::pos_type pos,
-        std::ios_base::openmode which =
-        std::ios::in | std::ios::out) override {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-private:
-    DataStreambuf(const DataStreambuf&) = delete;
-    DataStreambuf(DataStreambuf&&) = delete;
-    DataStreambuf& operator=(const DataStreambuf&) = delete;
-    DataStreambuf& operator=(DataStreambuf&&) = delete;
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg, _end, _cur;
-};
-
 //Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int
 lzfDecompress (const void *const in_data,  unsigned int in_len,
@@ -504,6 +440,642 @@ lzfDecompress (const void *const in_data,  unsigned int in_len,
 }
 }
 
+// ----------------------------------------------------------------------------
+
+namespace Points {
+
+/*!
+ * \brief The PointColumns class decodes the per-point fields of a PLY or PCD
+ * file directly into the typed columns of a Reader, i.e. float coordinates,
+ * normals and intensities and colors. Rows can be written concurrently
+ * because the columns are allocated upfront.
+ */
+class PointColumns
+{
+public:
+    enum class Type {
+        Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+    };
+    enum class ColorMode {
+        /// separate red, green, blue and optional alpha fields
+        Channels,
+        /// rgb or rgba field with a packed ARGB value
+        Packed
+    };
+
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    PointColumns(const std::vector<std::string>& fields,
+                 const std::vector<Type>& types,
+                 const std::vector<int>& sizes,
+                 ColorMode mode)
+      : colorMode(mode)
+    {
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            layout.push_back({types[i], offset});
+            offset += static_cast<std::size_t>(sizes[i]);
+        }
+        stride = offset;
+
+        auto find = [&fields](const char* name, const char* alias = nullptr) {
+            auto it = std::find(fields.begin(), fields.end(), name);
+            if (it == fields.end() && alias)
+                it = std::find(fields.begin(), fields.end(), alias);
+            if (it == fields.end())
+                return none;
+            return static_cast<std::size_t>(std::distance(fields.begin(), it));
+        };
+
+        x = find("x");
+        y = find("y");
+        z = find("z");
+        nx = find("normal_x", "nx");
+        ny = find("normal_y", "ny");
+        nz = find("normal_z", "nz");
+        grey = find("intensity");
+        if (colorMode == ColorMode::Channels) {
+            red = find("red");
+            green = find("green");
+            blue = find("blue");
+            alpha = find("alpha");
+        }
+        else {
+            rgba = find("rgb", "rgba");
+        }
+    }
+
+    std::size_t numFields() const
+    {
+        return layout.size();
+    }
+    std::size_t recordSize() const
+    {
+        return stride;
+    }
+    bool hasPoints() const
+    {
+        return x != none && y != none && z != none;
+    }
+    bool hasNormals() const
+    {
+        return hasPoints() && nx != none && ny != none && nz != none;
+    }
+    bool hasIntensities() const
+    {
+        return hasPoints() && grey != none;
+    }
+    bool hasColors() const
+    {
+        if (colorMode == ColorMode::Channels)
+            return hasPoints() && red != none && green != none && blue != none;
+        return hasPoints() && rgba != none;
+    }
+
+    /// Allocates the target columns so that rows can be set from several threads
+    void allocate(std::size_t numPoints,
+                  std::vector<Base::Vector3f>& pts,
+                  std::vector<Base::Vector3f>& nor,
+                  std::vector<float>& grv,
+                  std::vector<App::Color>& col)
+    {
+        pntColumn = nullptr;
+        norColumn = nullptr;
+        grvColumn = nullptr;
+        colColumn = nullptr;
+
+        if (hasPoints()) {
+            pts.resize(numPoints);
+            pntColumn = pts.data();
+        }
+        if (hasNormals()) {
+            nor.resize(numPoints);
+            norColumn = nor.data();
+        }
+        if (hasIntensities()) {
+            grv.resize(numPoints);
+            grvColumn = grv.data();
+        }
+        if (hasColors()) {
+            col.resize(numPoints);
+            colColumn = col.data();
+        }
+    }
+
+    /// Sets the columns of \a row from the field values. \a packed is the raw bit pattern of the rgb(a) field.
+    void setRow(std::size_t row, const double* values, uint32_t packed)
+    {
+        if (pntColumn) {
+            pntColumn[row].Set(static_cast<float>(values[x]),
+                               static_cast<float>(values[y]),
+                               static_cast<float>(values[z]));
+        }
+        if (norColumn) {
+            norColumn[row].Set(static_cast<float>(values[nx]),
+                               static_cast<float>(values[ny]),
+                               static_cast<float>(values[nz]));
+        }
+        if (grvColumn) {
+            grvColumn[row] = static_cast<float>(values[grey]);
+        }
+        if (colColumn) {
+            if (colorMode == ColorMode::Packed) {
+                colColumn[row].setPackedARGB(packed);
+            }
+            else {
+                // without alpha field the alpha value is 1 in the units of the red channel
+                float a = alpha != none ? colorChannel(values, alpha)
+                                        : static_cast<float>(1.0 / colorRange(layout[red].type));
+                colColumn[row].set(colorChannel(values, red),
+                                   colorChannel(values, green),
+                                   colorChannel(values, blue),
+                                   a);
+            }
+        }
+    }
+
+    /// Sets a row parsed from text where the packed color is given as number
+    void setAsciiRow(std::size_t row, const double* values)
+    {
+        uint32_t packed = 0;
+        if (colorMode == ColorMode::Packed && rgba != none) {
+            if (layout[rgba].type == Type::Float32) {
+                float f = static_cast<float>(values[rgba]);
+                std::memcpy(&packed, &f, sizeof(packed));
+            }
+            else {
+                packed = static_cast<uint32_t>(values[rgba]);
+            }
+        }
+        setRow(row, values, packed);
+    }
+
+    /// Decodes \a count records stored row by row starting at \a data into the rows from \a first on
+    void decodeRecords(const char* data, std::size_t first, std::size_t count, bool swapByteOrder)
+    {
+        std::vector<double> values(layout.size());
+        for (std::size_t i = 0; i < count; i++) {
+            const char* record = data + i * stride;
+            for (std::size_t j = 0; j < layout.size(); j++) {
+                values[j] = readValue(record + layout[j].offset, layout[j].type, swapByteOrder);
+            }
+            setRow(first + i, values.data(), readPacked(record, swapByteOrder));
+        }
+    }
+
+    /// Decodes the rows [first, first + count) from field-wise stored values of \a numPoints points
+    void decodeColumns(const char* data, std::size_t numPoints, std::size_t first, std::size_t count)
+    {
+        std::vector<double> values(layout.size());
+        std::vector<std::size_t> sizes(layout.size());
+        for (std::size_t j = 0; j < layout.size(); j++) {
+            std::size_t next = j + 1 < layout.size() ? layout[j + 1].offset : stride;
+            sizes[j] = next - layout[j].offset;
+        }
+
+        for (std::size_t i = first; i < first + count; i++) {
+            uint32_t packed = 0;
+            for (std::size_t j = 0; j < layout.size(); j++) {
+                const char* value = data + layout[j].offset * numPoints + i * sizes[j];
+                values[j] = readValue(value, layout[j].type, false);
+                if (j == rgba)
+                    packed = readRaw<uint32_t>(value, false);
+            }
+            setRow(i, values.data(), packed);
+        }
+    }
+
+private:
+    /// The value of a color channel of an integer type that maps to 1, floating point channels are used as they are
+    static double colorRange(Type type)
+    {
+        switch (type) {
+        case Type::Int8:
+            return std::numeric_limits<int8_t>::max();
+        case Type::UInt8:
+            return std::numeric_limits<uint8_t>::max();
+        case Type::Int16:
+            return std::numeric_limits<int16_t>::max();
+        case Type::UInt16:
+            return std::numeric_limits<uint16_t>::max();
+        case Type::Int32:
+            return std::numeric_limits<int32_t>::max();
+        case Type::UInt32:
+            return std::numeric_limits<uint32_t>::max();
+        case Type::Float32:
+        case Type::Float64:
+            return 1.0;
+        }
+        return 1.0;
+    }
+
+    float colorChannel(const double* values, std::size_t field) const
+    {
+        return static_cast<float>(values[field] / colorRange(layout[field].type));
+    }
+
+    template <typename T>
+    static T readRaw(const char* data, bool swapByteOrder)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        if (swapByteOrder && sizeof(T) > 1)
+            Base::SwapEndian<T>(value);
+        return value;
+    }
+
+    static double readValue(const char* data, Type type, bool swapByteOrder)
+    {
+        switch (type) {
+        case Type::Int8:
+            return readRaw<int8_t>(data, swapByteOrder);
+        case Type::UInt8:
+            return readRaw<uint8_t>(data, swapByteOrder);
+        case Type::Int16:
+            return readRaw<int16_t>(data, swapByteOrder);
+        case Type::UInt16:
+            return readRaw<uint16_t>(data, swapByteOrder);
+        case Type::Int32:
+            return readRaw<int32_t>(data, swapByteOrder);
+        case Type::UInt32:
+            return readRaw<uint32_t>(data, swapByteOrder);
+        case Type::Float32:
+            return readRaw<float>(data, swapByteOrder);
+        case Type::Float64:
+            return readRaw<double>(data, swapByteOrder);
+        }
+        return 0.0;
+    }
+
+    uint32_t readPacked(const char* record, bool swapByteOrder) const
+    {
+        // keep the bit pattern of a float rgb value untouched
+        if (colorMode == ColorMode::Packed && rgba != none)
+            return readRaw<uint32_t>(record + layout[rgba].offset, swapByteOrder);
+        return 0;
+    }
+
+private:
+    struct Field {
+        Type type;
+        std::size_t offset;
+    };
+    std::vector<Field> layout;
+    std::size_t stride = 0;
+    ColorMode colorMode;
+
+    std::size_t x = none, y = none, z = none;
+    std::size_t nx = none, ny = none, nz = none;
+    std::size_t grey = none;
+    std::size_t red = none, green = none, blue = none, alpha = none;
+    std::size_t rgba = none;
+
+    Base::Vector3f* pntColumn = nullptr;
+    Base::Vector3f* norColumn = nullptr;
+    float* grvColumn = nullptr;
+    App::Color* colColumn = nullptr;
+};
+
+/*!
+ * \brief The BlockReader class gives access to the data section of a file
+ * block by block. If possible the file is memory-mapped, otherwise the blocks
+ * are read into a buffer of fixed size. This way the memory needed to read in
+ * a file doesn't depend on its size.
+ */
+class BlockReader
+{
+public:
+    /// The data section starts at the current position of \a inp
+    BlockReader(const std::string& filename, std::istream& inp)
+      : inp(inp)
+    {
+        std::streamoff start = inp.tellg();
+        file.setFileName(QString::fromUtf8(filename.c_str()));
+        if (start >= 0 && file.open(QIODevice::ReadOnly)) {
+            qint64 size = file.size() - start;
+            if (size > 0 && static_cast<quint64>(size) <= std::numeric_limits<std::size_t>::max())
+                mapped = file.map(start, size);
+            if (mapped)
+                length = static_cast<std::size_t>(size);
+            else
+                file.close();
+        }
+    }
+    ~BlockReader()
+    {
+        if (mapped)
+            file.unmap(mapped);
+    }
+
+    /// Returns the next block of at most \a size bytes. Its first \a keep bytes
+    /// repeat the not yet consumed end of the previous block.
+    std::size_t next(std::size_t keep, std::size_t size, const char*& data)
+    {
+        if (mapped) {
+            pos -= keep;
+            std::size_t len = std::min(size, length - pos);
+            data = reinterpret_cast<const char*>(mapped) + pos;
+            pos += len;
+            return len;
+        }
+
+        if (buffer.size() < size)
+            buffer.resize(size);
+        if (keep > 0)
+            std::memmove(buffer.data(), buffer.data() + used - keep, keep);
+        inp.read(buffer.data() + keep, static_cast<std::streamsize>(size - keep));
+        used = keep + static_cast<std::size_t>(inp.gcount());
+        data = buffer.data();
+        return used;
+    }
+
+    bool atEnd() const
+    {
+        if (mapped)
+            return pos == length;
+        return !inp.good();
+    }
+
+private:
+    std::istream& inp;
+    QFile file;
+    uchar* mapped = nullptr;
+    std::size_t length = 0;
+    std::size_t pos = 0;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+};
+
+} // namespace Points
+
+namespace {
+
+// blocks of this size are processed one after another
+const std::size_t blockSize = 64 * 1024 * 1024;
+// a block is split into parts of about this size that are processed in parallel
+const std::size_t partSize = 256 * 1024;
+
+struct TextPart {
+    const char* begin;
+    const char* end;
+    std::size_t numLines;
+    std::size_t firstRow;
+};
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* nextLine(const char* ptr, const char* end)
+{
+    const char* nl = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+    return nl ? nl + 1 : end;
+}
+
+bool isDataLine(const char* ptr, const char* end)
+{
+    for (; ptr != end; ++ptr) {
+        if (!isBlank(*ptr) && *ptr != '\n')
+            return true;
+    }
+    return false;
+}
+
+bool parseNumber(const char*& ptr, const char* end, double& value)
+{
+    while (ptr != end && isBlank(*ptr))
+        ++ptr;
+    const char* token = ptr;
+    while (ptr != end && !isBlank(*ptr) && *ptr != '\n')
+        ++ptr;
+
+    // strtod needs a null-terminated string and the block isn't
+    char buf[64];
+    std::size_t len = ptr - token;
+    if (len == 0 || len >= sizeof(buf))
+        return false;
+    std::memcpy(buf, token, len);
+    buf[len] = '\0';
+
+    char* last = nullptr;
+    value = std::strtod(buf, &last);
+    return last == buf + len;
+}
+
+/// Splits [begin, end) into parts that start at line boundaries
+std::vector<TextPart> splitLines(const char* begin, const char* end)
+{
+    std::vector<TextPart> parts;
+    std::size_t num = std::max<std::size_t>(1, (end - begin) / partSize);
+    std::size_t step = (end - begin) / num;
+    const char* ptr = begin;
+    while (ptr != end) {
+        const char* stop = end;
+        if (static_cast<std::size_t>(end - ptr) > step + step / 2)
+            stop = nextLine(ptr + step, end);
+        parts.push_back({ptr, stop, 0, 0});
+        ptr = stop;
+    }
+    return parts;
+}
+
+/*!
+ * Reads \a numPoints rows of whitespace separated numbers from the text
+ * section at the current position of \a inp. The first \a skip data lines
+ * are ignored. Each block is split at line boundaries and the parts are
+ * parsed in parallel.
+ */
+void readTextRows(const std::string& filename, std::istream& inp,
+                  std::size_t skip, std::size_t numPoints,
+                  Points::PointColumns& data)
+{
+    Points::BlockReader reader(filename, inp);
+    std::size_t numFields = data.numFields();
+    std::size_t row = 0;
+    std::size_t keep = 0;
+
+    while (row < numPoints) {
+        const char* block = nullptr;
+        std::size_t len = reader.next(keep, blockSize, block);
+        if (len == 0)
+            break;
+
+        const char* end = block + len;
+        if (!reader.atEnd()) {
+            // only handle complete lines
+            const char* last = end;
+            while (last != block && *(last - 1) != '\n')
+                --last;
+            if (last == block)
+                throw Base::BadFormatError("Line too long");
+            end = last;
+        }
+        keep = (block + len) - end;
+
+        const char* ptr = block;
+        while (skip > 0 && ptr != end) {
+            const char* next = nextLine(ptr, end);
+            if (isDataLine(ptr, next))
+                skip--;
+            ptr = next;
+        }
+
+        std::vector<TextPart> parts = splitLines(ptr, end);
+        QtConcurrent::blockingMap(parts, [](TextPart& part) {
+            for (const char* it = part.begin; it != part.end; ) {
+                const char* next = nextLine(it, part.end);
+                if (isDataLine(it, next))
+                    part.numLines++;
+                it = next;
+            }
+        });
+
+        for (auto& part : parts) {
+            part.firstRow = row;
+            row += part.numLines;
+        }
+
+        std::atomic<bool> failed(false);
+        QtConcurrent::blockingMap(parts, [&](const TextPart& part) {
+            std::vector<double> values(numFields, 0.0);
+            std::size_t index = part.firstRow;
+            for (const char* it = part.begin; it != part.end && index < numPoints; ) {
+                const char* next = nextLine(it, part.end);
+                if (isDataLine(it, next)) {
+                    const char* tok = it;
+                    std::fill(values.begin(), values.end(), 0.0);
+                    for (std::size_t col = 0; col < numFields; col++) {
+                        double value = 0.0;
+                        if (!isDataLine(tok, next))
+                            break;
+                        if (!parseNumber(tok, next, value)) {
+                            failed = true;
+                            return;
+                        }
+                        values[col] = value;
+                    }
+                    data.setAsciiRow(index++, values.data());
+                }
+                it = next;
+            }
+        });
+
+        if (failed)
+            throw Base::BadFormatError("Invalid number in point data");
+        if (reader.atEnd() && keep == 0)
+            break;
+    }
+}
+
+/*!
+ * Reads \a numPoints records stored row by row from the binary section at the
+ * current position of \a inp. Each block is decoded in parallel.
+ */
+void readBinaryRows(const std::string& filename, std::istream& inp,
+                    bool swapByteOrder, std::size_t numPoints,
+                    Points::PointColumns& data)
+{
+    std::size_t stride = data.recordSize();
+    if (stride == 0 || numPoints == 0)
+        return;
+
+    std::streamoff ulSize = 0;
+    std::streamoff ulCurr = 0;
+    std::streambuf* buf = inp.rdbuf();
+    if (buf) {
+        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
+        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
+        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
+        if (ulCurr + static_cast<std::streamoff>(stride * numPoints) > ulSize)
+            throw Base::BadFormatError("File expects too many elements");
+    }
+
+    using Range = std::pair<std::size_t, std::size_t>;
+    Points::BlockReader reader(filename, inp);
+    std::size_t recordsPerBlock = std::max<std::size_t>(1, blockSize / stride);
+    std::size_t recordsPerPart = std::max<std::size_t>(1, partSize / stride);
+    std::size_t row = 0;
+
+    while (row < numPoints) {
+        const char* block = nullptr;
+        std::size_t count = std::min(recordsPerBlock, numPoints - row);
+        std::size_t len = reader.next(0, count * stride, block);
+        if (len < count * stride)
+            throw Base::BadFormatError("Unexpected end of file");
+
+        std::vector<Range> parts;
+        for (std::size_t i = 0; i < count; i += recordsPerPart)
+            parts.emplace_back(i, std::min(recordsPerPart, count - i));
+
+        QtConcurrent::blockingMap(parts, [&](const Range& part) {
+            data.decodeRecords(block + part.first * stride, row + part.first,
+                               part.second, swapByteOrder);
+        });
+
+        row += count;
+    }
+}
+
+Points::PointColumns::Type plyType(const std::string& t)
+{
+    using Type = Points::PointColumns::Type;
+    if (t == "char" || t == "int8")
+        return Type::Int8;
+    if (t == "uchar" || t == "uint8")
+        return Type::UInt8;
+    if (t == "short" || t == "int16")
+        return Type::Int16;
+    if (t == "ushort" || t == "uint16")
+        return Type::UInt16;
+    if (t == "int" || t == "int32")
+        return Type::Int32;
+    if (t == "uint" || t == "uint32")
+        return Type::UInt32;
+    if (t == "float" || t == "float32")
+        return Type::Float32;
+    if (t == "double" || t == "float64")
+        return Type::Float64;
+    throw Base::BadFormatError("Unexpected type");
+}
+
+Points::PointColumns::Type pcdType(const std::string& type, int size)
+{
+    using Type = Points::PointColumns::Type;
+    char t = type.empty() ? '\0' : type[0];
+    switch (size) {
+    case 1:
+        if (t == 'I')
+            return Type::Int8;
+        if (t == 'U')
+            return Type::UInt8;
+        break;
+    case 2:
+        if (t == 'I')
+            return Type::Int16;
+        if (t == 'U')
+            return Type::UInt16;
+        break;
+    case 4:
+        if (t == 'I')
+            return Type::Int32;
+        if (t == 'U')
+            return Type::UInt32;
+        if (t == 'F')
+            return Type::Float32;
+        break;
+    case 8:
+        if (t == 'F')
+            return Type::Float64;
+        break;
+    default:
+        break;
+    }
+    throw Base::BadFormatError("Unexpected type");
+}
+
+}
+
 PlyReader::PlyReader()
 {
 }
@@ -528,139 +1100,23 @@ void PlyReader::read(const std::string& filename)
     std::size_t offset = 0;
     std::size_t numPoints = readHeader(inp, format, offset, fields, types, sizes);
 
-    Eigen::MatrixXd data(numPoints, fields.size());
+    std::vector<PointColumns::Type> columnTypes;
+    for (const auto& it : types)
+        columnTypes.push_back(plyType(it));
+
+    PointColumns data(fields, columnTypes, sizes, PointColumns::ColorMode::Channels);
+    if (!data.hasPoints())
+        return;
+
+    data.allocate(numPoints, points.getBasicPoints(), normals, intensity, colors);
     if (format == "ascii") {
-        readAscii(inp, offset, data);
+        readAscii(filename, inp, offset, numPoints, data);
     }
     else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
+        readBinary(false, filename, inp, offset, numPoints, data);
     }
     else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t red = max_size, green = max_size, blue = max_size, alpha = max_size;
-    it = std::find(fields.begin(), fields.end(), "red");
-    if (it != fields.end())
-        red = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "green");
-    if (it != fields.end())
-        green = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "blue");
-    if (it != fields.end())
-        blue = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "alpha");
-    if (it != fields.end())
-        alpha = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (red != max_size && green != max_size && blue != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
-
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.emplace_back(data(i,normal_x),data(i,normal_y),data(i,normal_z));
-        }
-    }
-
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
-    }
-
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.emplace_back(static_cast<float>(r)/255.0f,
-                                    static_cast<float>(g)/255.0f,
-                                    static_cast<float>(b)/255.0f,
-                                    static_cast<float>(a)/255.0f);
-            }
-        }
-        else if (types[red] == "float") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.emplace_back(r, g, b, a);
-            }
-        }
+        readBinary(true, filename, inp, offset, numPoints, data);
     }
 }
 
@@ -832,119 +1288,26 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
+void PlyReader::readAscii(const std::string& filename,
+                          std::istream& inp,
+                          std::size_t offset,
+                          std::size_t numPoints,
+                          PointColumns& data)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    readTextRows(filename, inp, offset, numPoints, data);
 }
 
-void PlyReader::readBinary(bool swapByteOrder,
+void PlyReader::readBinary(bool bigEndian,
+                           const std::string& filename,
                            std::istream& inp,
                            std::size_t offset,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        std::string t = types[j];
-        switch (sizes[j]) {
-        case 1:
-            if (t == "char" || t == "int8")
-                converters.push_back(convert_int8);
-            else if (t == "uchar" || t == "uint8")
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == "short" || t == "int16")
-                converters.push_back(convert_int16);
-            else if (t == "ushort" || t == "uint16")
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == "int" || t == "int32")
-                converters.push_back(convert_int32);
-            else if (t == "uint" || t == "uint32")
-                converters.push_back(convert_uint32);
-            else if (t == "float" || t == "float32")
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == "double" || t == "float64")
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (std::size_t i=0; i<numPoints; i++) {
-        for (std::size_t j=0; j<numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
+                           std::size_t numPoints,
+                           PointColumns& data)
+{
+    // skip the elements stored before the vertices
+    inp.seekg(static_cast<std::streamoff>(offset), std::ios::cur);
+    bool swapByteOrder = bigEndian != (Base::SwapOrder() == HIGH_ENDIAN);
+    readBinaryRows(filename, inp, swapByteOrder, numPoints, data);
 }
 
 // ----------------------------------------------------------------------------
@@ -972,139 +1335,23 @@ void PcdReader::read(const std::string& filename)
     std::vector<int> sizes;
     std::size_t numPoints = readHeader(inp, format, fields, types, sizes);
 
-    Eigen::MatrixXd data(numPoints, fields.size());
+    std::vector<PointColumns::Type> columnTypes;
+    for (std::size_t i = 0; i < types.size(); i++)
+        columnTypes.push_back(pcdType(types[i], sizes[i]));
+
+    PointColumns data(fields, columnTypes, sizes, PointColumns::ColorMode::Packed);
+    if (!data.hasPoints())
+        return;
+
+    data.allocate(numPoints, points.getBasicPoints(), normals, intensity, colors);
     if (format == "ascii") {
-        readAscii(inp, data);
+        readAscii(filename, inp, numPoints, data);
     }
     else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
+        readBinary(filename, inp, numPoints, data);
     }
     else if (format == "binary_compressed") {
-        unsigned int c, u;
-        Base::InputStream str(inp);
-        str >> c >> u;
-
-        std::vector<char> compressed(c);
-        inp.read(&compressed[0], c);
-        std::vector<char> uncompressed(u);
-        if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(nullptr);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
-        }
-        else {
-            throw Base::BadFormatError("Failed to decompress binary data");
-        }
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t rgba = max_size;
-    it = std::find(fields.begin(), fields.end(), "rgb");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "rgba");
-    if (it != fields.end())
-        rgba = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
-
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.emplace_back(data(i,normal_x),data(i,normal_y),data(i,normal_z));
-        }
-    }
-
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
-    }
-
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i,rgba));
-                App::Color col;
-                col.setPackedARGB(packed);
-                colors.emplace_back(col);
-            }
-        }
-        else if (types[rgba] == "F") {
-            static_assert(sizeof(float) == sizeof(uint32_t), "float and uint32_t have different sizes");
-            for (std::size_t i=0; i<numPoints; i++) {
-                float f = static_cast<float>(data(i,rgba));
-                uint32_t packed;
-                std::memcpy(&packed, &f, sizeof(packed));
-                App::Color col;
-                col.setPackedARGB(packed);
-                colors.emplace_back(col);
-            }
-        }
+        readCompressed(inp, numPoints, data);
     }
 }
 
@@ -1180,124 +1427,55 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
+void PcdReader::readAscii(const std::string& filename,
+                          std::istream& inp,
+                          std::size_t numPoints,
+                          PointColumns& data)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    readTextRows(filename, inp, 0, numPoints, data);
 }
 
-void PcdReader::readBinary(bool transpose,
+void PcdReader::readBinary(const std::string& filename,
                            std::istream& inp,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-        case 1:
-            if (t == 'I')
-                converters.push_back(convert_int8);
-            else if (t == 'U')
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == 'I')
-                converters.push_back(convert_int16);
-            else if (t == 'U')
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == 'I')
-                converters.push_back(convert_int32);
-            else if (t == 'U')
-                converters.push_back(convert_uint32);
-            else if (t == 'F')
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == 'F')
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
+                           std::size_t numPoints,
+                           PointColumns& data)
+{
+    readBinaryRows(filename, inp, false, numPoints, data);
+}
 
+void PcdReader::readCompressed(std::istream& inp,
+                               std::size_t numPoints,
+                               PointColumns& data)
+{
+    unsigned int c, u;
     Base::InputStream str(inp);
-    if (transpose) {
-        for (std::size_t j=0; j<numFields; j++) {
-            for (std::size_t i=0; i<numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-    else {
-        for (std::size_t i=0; i<numPoints; i++) {
-            for (std::size_t j=0; j<numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
+    str >> c >> u;
+
+    if (static_cast<std::size_t>(u) < data.recordSize() * numPoints)
+        throw Base::BadFormatError("File expects too many elements");
+
+    std::vector<char> compressed(c);
+    inp.read(compressed.data(), c);
+    std::vector<char> uncompressed(u);
+    if (lzfDecompress(compressed.data(), c, uncompressed.data(), u) != u)
+        throw Base::BadFormatError("Failed to decompress binary data");
+    compressed.clear();
+    compressed.shrink_to_fit();
+
+    // the values are stored field by field
+    using Range = std::pair<std::size_t, std::size_t>;
+    std::size_t recordsPerPart = std::max<std::size_t>(1, partSize / std::max<std::size_t>(1, data.recordSize()));
+    std::vector<Range> parts;
+    for (std::size_t i = 0; i < numPoints; i += recordsPerPart)
+        parts.emplace_back(i, std::min(recordsPerPart, numPoints - i));
+
+    const char* columns = uncompressed.data();
+    QtConcurrent::blockingMap(parts, [&](const Range& part) {
+        data.decodeColumns(columns, numPoints, part.first, part.second);
+    });
 }
 
+
 // ----------------------------------------------------------------------------
 
 namespace {
@@ -45,7 +45,9 @@ public:
     static void LoadAscii(PointKernel&, const char *FileName);
 };
 
-class Reader
+class PointColumns;
+
+class PointsExport Reader
 {
 public:
     Reader();
@@ -81,7 +83,7 @@ public:
     void read(const std::string& filename) override;
 };
 
-class PlyReader : public Reader
+class PointsExport PlyReader : public Reader
 {
 public:
     PlyReader();
@@ -92,14 +94,13 @@ private:
     std::size_t readHeader(std::istream&, std::string& format, std::size_t& offset,
         std::vector<std::string>& fields, std::vector<std::string>& types,
         std::vector<int>& sizes);
-    void readAscii(std::istream&, std::size_t offset, Eigen::MatrixXd& data);
-    void readBinary(bool swapByteOrder, std::istream&, std::size_t offset,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+    void readAscii(const std::string& filename, std::istream&, std::size_t offset,
+        std::size_t numPoints, PointColumns& data);
+    void readBinary(bool bigEndian, const std::string& filename, std::istream&,
+        std::size_t offset, std::size_t numPoints, PointColumns& data);
 };
 
-class PcdReader : public Reader
+class PointsExport PcdReader : public Reader
 {
 public:
     PcdReader();
@@ -109,11 +110,11 @@ public:
 private:
     std::size_t readHeader(std::istream&, std::string& format, std::vector<std::string>& fields,
         std::vector<std::string>& types, std::vector<int>& sizes);
-    void readAscii(std::istream&, Eigen::MatrixXd& data);
-    void readBinary(bool transpose, std::istream&,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+    void readAscii(const std::string& filename, std::istream&,
+        std::size_t numPoints, PointColumns& data);
+    void readBinary(const std::string& filename, std::istream&,
+        std::size_t numPoints, PointColumns& data);
+    void readCompressed(std::istream&, std::size_t numPoints, PointColumns& data);
 };
 
 class E57Reader : public Reader
@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <limits>
+# include <numeric>
+# include <QtConcurrentMap>
+#endif
+
+#include <Base/Exception.h>
+
+#include "Points.h"
+#include "PointsKDTree.h"
+
+
+using namespace Points;
+
+namespace {
+
+constexpr uint32_t LeafSize = 16;
+constexpr std::size_t QueriesPerPart = 4096;
+
+inline double coord(const Base::Vector3d& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+}
+
+KDTree::KDTree(const std::vector<Base::Vector3d>& pts)
+{
+    build(pts);
+}
+
+KDTree::KDTree(const PointKernel& kernel)
+{
+    std::vector<Base::Vector3d> pts;
+    pts.reserve(kernel.size());
+    for (const auto& it : kernel) {
+        pts.push_back(it);
+    }
+    build(pts);
+}
+
+void KDTree::clear()
+{
+    points.clear();
+    indices.clear();
+    nodes.clear();
+}
+
+void KDTree::build(const std::vector<Base::Vector3d>& pts)
+{
+    clear();
+    if (pts.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw Base::ValueError("Too many points for k-d tree");
+    }
+    if (pts.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> order(pts.size());
+    std::iota(order.begin(), order.end(), 0);
+    nodes.reserve(2 * pts.size() / LeafSize + 1);
+    buildNode(pts, order, 0, static_cast<uint32_t>(pts.size()));
+
+    points.reserve(pts.size());
+    for (auto index : order) {
+        points.push_back(pts[index]);
+    }
+    indices.swap(order);
+}
+
+int32_t KDTree::buildNode(const std::vector<Base::Vector3d>& pts, std::vector<uint32_t>& order,
+                          uint32_t begin, uint32_t end)
+{
+    int32_t index = static_cast<int32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes[index].begin = begin;
+    nodes[index].end = end;
+    if (end - begin <= LeafSize) {
+        return index;
+    }
+
+    // split along the axis of the largest extent at the median
+    Base::Vector3d minPt = pts[order[begin]];
+    Base::Vector3d maxPt = minPt;
+    for (uint32_t i = begin + 1; i < end; i++) {
+        const Base::Vector3d& p = pts[order[i]];
+        minPt.x = std::min(minPt.x, p.x);
+        minPt.y = std::min(minPt.y, p.y);
+        minPt.z = std::min(minPt.z, p.z);
+        maxPt.x = std::max(maxPt.x, p.x);
+        maxPt.y = std::max(maxPt.y, p.y);
+        maxPt.z = std::max(maxPt.z, p.z);
+    }
+    Base::Vector3d size = maxPt - minPt;
+    int axis = 0;
+    if (size.y > size.x && size.y >= size.z) {
+        axis = 1;
+    }
+    else if (size.z > size.x && size.z > size.y) {
+        axis = 2;
+    }
+
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                     [&pts, axis](uint32_t a, uint32_t b) {
+        return coord(pts[a], axis) < coord(pts[b], axis);
+    });
+
+    double split = coord(pts[order[mid]], axis);
+    buildNode(pts, order, begin, mid);
+    int32_t right = buildNode(pts, order, mid, end);
+    nodes[index].split = split;
+    nodes[index].axis = axis;
+    nodes[index].right = right;
+    return index;
+}
+
+void KDTree::search(const Base::Vector3d& pnt, std::size_t k, double maxDist2,
+                    std::vector<Candidate>& heap) const
+{
+    heap.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    auto less = [](const Candidate& a, const Candidate& b) {
+        return a.first < b.first;
+    };
+    auto bound = [&]() {
+        if (k > 0 && heap.size() == k) {
+            return std::min(maxDist2, heap.front().first);
+        }
+        return maxDist2;
+    };
+
+    // a depth-first traversal only keeps the far children along one path
+    struct Entry
+    {
+        int32_t node;
+        double dist2;
+    };
+    Entry stack[64];
+    int top = 0;
+    stack[top++] = {0, 0.0};
+
+    while (top > 0) {
+        Entry entry = stack[--top];
+        if (entry.dist2 > bound()) {
+            continue;
+        }
+
+        int32_t index = entry.node;
+        while (nodes[index].right >= 0) {
+            const Node& node = nodes[index];
+            double diff = coord(pnt, node.axis) - node.split;
+            int32_t nearChild = index + 1;
+            int32_t farChild = node.right;
+            if (diff >= 0.0) {
+                std::swap(nearChild, farChild);
+            }
+            if (diff * diff <= bound()) {
+                stack[top++] = {farChild, diff * diff};
+            }
+            index = nearChild;
+        }
+
+        const Node& leaf = nodes[index];
+        for (uint32_t i = leaf.begin; i < leaf.end; i++) {
+            double dist2 = Base::DistanceP2(pnt, points[i]);
+            if (dist2 > bound()) {
+                continue;
+            }
+            if (k > 0 && heap.size() == k) {
+                std::pop_heap(heap.begin(), heap.end(), less);
+                heap.pop_back();
+            }
+            heap.emplace_back(dist2, indices[i]);
+            std::push_heap(heap.begin(), heap.end(), less);
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), less);
+}
+
+void KDTree::findKNearest(const Base::Vector3d& pnt, std::size_t k,
+                          std::vector<uint32_t>& result) const
+{
+    result.clear();
+    if (k == 0) {
+        return;
+    }
+
+    std::vector<Candidate> heap;
+    heap.reserve(k + 1);
+    search(pnt, k, std::numeric_limits<double>::max(), heap);
+    for (const auto& it : heap) {
+        result.push_back(it.second);
+    }
+}
+
+void KDTree::findInRadius(const Base::Vector3d& pnt, double radius,
+                          std::vector<uint32_t>& result, std::size_t maxNN) const
+{
+    result.clear();
+    std::vector<Candidate> heap;
+    search(pnt, maxNN, radius * radius, heap);
+    for (const auto& it : heap) {
+        result.push_back(it.second);
+    }
+}
+
+template <typename Query>
+KDTree::Neighbours KDTree::batch(std::size_t numQueries, std::size_t k, double maxDist2,
+                                 Query&& query) const
+{
+    struct Part
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::vector<uint32_t> counts;
+        std::vector<uint32_t> found;
+    };
+
+    std::vector<Part> parts;
+    for (std::size_t i = 0; i < numQueries; i += QueriesPerPart) {
+        parts.push_back({i, std::min(i + QueriesPerPart, numQueries), {}, {}});
+    }
+
+    QtConcurrent::blockingMap(parts, [&](Part& part) {
+        std::vector<Candidate> heap;
+        part.counts.reserve(part.end - part.begin);
+        if (k > 0) {
+            heap.reserve(k + 1);
+            part.found.reserve((part.end - part.begin) * k);
+        }
+        for (std::size_t i = part.begin; i < part.end; i++) {
+            search(query(i).first, k, maxDist2, heap);
+            part.counts.push_back(static_cast<uint32_t>(heap.size()));
+            for (const auto& it : heap) {
+                part.found.push_back(it.second);
+            }
+        }
+    });
+
+    Neighbours result;
+    result.offsets.resize(numQueries + 1, 0);
+    for (const auto& part : parts) {
+        for (std::size_t i = part.begin; i < part.end; i++) {
+            result.offsets[query(i).second + 1] = part.counts[i - part.begin];
+        }
+    }
+    std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+    result.indices.resize(result.offsets.back());
+
+    QtConcurrent::blockingMap(parts, [&](const Part& part) {
+        auto src = part.found.begin();
+        for (std::size_t i = part.begin; i < part.end; i++) {
+            uint32_t count = part.counts[i - part.begin];
+            std::copy(src, src + count, result.indices.begin() + result.offsets[query(i).second]);
+            src += count;
+        }
+    });
+
+    return result;
+}
+
+KDTree::Neighbours KDTree::findKNearest(std::size_t k) const
+{
+    if (k == 0) {
+        Neighbours result;
+        result.offsets.resize(points.size() + 1, 0);
+        return result;
+    }
+
+    // walk through the points in bucket order so that consecutive queries visit the same nodes
+    return batch(points.size(), k, std::numeric_limits<double>::max(), [this](std::size_t i) {
+        return std::make_pair(points[i], static_cast<std::size_t>(indices[i]));
+    });
+}
+
+KDTree::Neighbours KDTree::findKNearest(const std::vector<Base::Vector3d>& queries,
+                                        std::size_t k) const
+{
+    if (k == 0) {
+        Neighbours result;
+        result.offsets.resize(queries.size() + 1, 0);
+        return result;
+    }
+
+    return batch(queries.size(), k, std::numeric_limits<double>::max(), [&queries](std::size_t i) {
+        return std::make_pair(queries[i], i);
+    });
+}
+
+KDTree::Neighbours KDTree::findInRadius(double radius, std::size_t maxNN) const
+{
+    return batch(points.size(), maxNN, radius * radius, [this](std::size_t i) {
+        return std::make_pair(points[i], static_cast<std::size_t>(indices[i]));
+    });
+}
+
+KDTree::Neighbours KDTree::findInRadius(const std::vector<Base::Vector3d>& queries, double radius,
+                                        std::size_t maxNN) const
+{
+    return batch(queries.size(), maxNN, radius * radius, [&queries](std::size_t i) {
+        return std::make_pair(queries[i], i);
+    });
+}
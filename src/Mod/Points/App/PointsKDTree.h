@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#ifndef POINTS_POINTSKDTREE_H
+#define POINTS_POINTSKDTREE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <Base/Vector3D.h>
+#include <Mod/Points/PointsGlobal.h>
+
+
+namespace Points
+{
+class PointKernel;
+
+/**
+ * The KDTree class is a static k-d tree for nearest neighbour searches in
+ * point clouds. The points are reordered into leaf buckets so that each
+ * bucket lies contiguously in memory, and the nodes are stored in depth-first
+ * order in a flat array.
+ *
+ * Besides single queries it provides batch queries that are distributed over
+ * all cores. Their results are indices into the point array passed to
+ * build(), so the tree can handle up to 2^32 points.
+ */
+class PointsExport KDTree
+{
+public:
+    /**
+     * The Neighbours class holds the result of a batch query in compressed
+     * row format. The neighbours of query \a i are sorted by distance.
+     */
+    struct PointsExport Neighbours
+    {
+        /// neighbours of query i are indices[offsets[i]] up to indices[offsets[i+1]]
+        std::vector<std::size_t> offsets;
+        std::vector<uint32_t> indices;
+
+        std::size_t size() const
+        {
+            return offsets.empty() ? 0 : offsets.size() - 1;
+        }
+        std::size_t count(std::size_t i) const
+        {
+            return offsets[i + 1] - offsets[i];
+        }
+        const uint32_t* begin(std::size_t i) const
+        {
+            return indices.data() + offsets[i];
+        }
+        const uint32_t* end(std::size_t i) const
+        {
+            return indices.data() + offsets[i + 1];
+        }
+    };
+
+    KDTree() = default;
+    explicit KDTree(const std::vector<Base::Vector3d>& pts);
+    explicit KDTree(const PointKernel& kernel);
+
+    /// Builds the tree for the given points
+    void build(const std::vector<Base::Vector3d>& pts);
+    void clear();
+    std::size_t size() const
+    {
+        return points.size();
+    }
+
+    /** @name Single queries */
+    //@{
+    /// Finds the \a k nearest neighbours of \a pnt, sorted by distance
+    void findKNearest(const Base::Vector3d& pnt, std::size_t k,
+                      std::vector<uint32_t>& indices) const;
+    /** Finds all points within \a radius of \a pnt, sorted by distance. If \a maxNN
+     * is not zero, only the \a maxNN nearest of them are returned.
+     */
+    void findInRadius(const Base::Vector3d& pnt, double radius,
+                      std::vector<uint32_t>& indices, std::size_t maxNN = 0) const;
+    //@}
+
+    /** @name Batch queries
+     * The queries are run in parallel. If no query points are passed the points
+     * of the tree themselves are used, and each point is part of its own neighbourhood.
+     */
+    //@{
+    Neighbours findKNearest(std::size_t k) const;
+    Neighbours findKNearest(const std::vector<Base::Vector3d>& queries, std::size_t k) const;
+    Neighbours findInRadius(double radius, std::size_t maxNN = 0) const;
+    Neighbours findInRadius(const std::vector<Base::Vector3d>& queries, double radius,
+                            std::size_t maxNN = 0) const;
+    //@}
+
+private:
+    struct Node
+    {
+        double split = 0.0;
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        /// the left child directly follows its parent, leaves have no right child
+        int32_t right = -1;
+        int32_t axis = 0;
+    };
+    using Candidate = std::pair<double, uint32_t>;
+
+    int32_t buildNode(const std::vector<Base::Vector3d>& pts, std::vector<uint32_t>& order,
+                      uint32_t begin, uint32_t end);
+    void search(const Base::Vector3d& pnt, std::size_t k, double maxDist2,
+                std::vector<Candidate>& heap) const;
+    template <typename Query>
+    Neighbours batch(std::size_t numQueries, std::size_t k, double maxDist2,
+                     Query&& query) const;
+
+private:
+    /// points in leaf bucket order
+    std::vector<Base::Vector3d> points;
+    /// original index of each point
+    std::vector<uint32_t> indices;
+    std::vector<Node> nodes;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_POINTSKDTREE_H
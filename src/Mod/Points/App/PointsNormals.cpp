@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <numeric>
+# include <queue>
+# include <QtConcurrentMap>
+#endif
+
+#include <Eigen/Eigenvalues>
+
+#include <Base/Exception.h>
+
+#include "PointsNormals.h"
+
+
+using namespace Points;
+
+NormalEstimation::NormalEstimation(const std::vector<Base::Vector3d>& pts)
+  : points(pts)
+{
+}
+
+void NormalEstimation::perform(std::vector<Base::Vector3d>& normals, std::vector<double>* curvature) const
+{
+    if (kSearch == 0 && searchRadius <= 0.0) {
+        throw Base::ValueError("Neither the number of neighbours nor the search radius is set");
+    }
+
+    KDTree tree(points);
+    KDTree::Neighbours neighbours = searchRadius > 0.0
+        ? tree.findInRadius(searchRadius, kSearch)
+        : tree.findKNearest(kSearch);
+
+    normals.assign(points.size(), Base::Vector3d());
+    if (curvature) {
+        curvature->assign(points.size(), 0.0);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> parts;
+    const std::size_t pointsPerPart = 4096;
+    for (std::size_t i = 0; i < points.size(); i += pointsPerPart) {
+        parts.emplace_back(i, std::min(i + pointsPerPart, points.size()));
+    }
+
+    QtConcurrent::blockingMap(parts, [&](const std::pair<std::size_t, std::size_t>& part) {
+        for (std::size_t i = part.first; i < part.second; i++) {
+            std::size_t count = neighbours.count(i);
+            if (count < 3) {
+                continue;
+            }
+
+            // the covariance is computed relative to the query point for numerical stability
+            const Base::Vector3d& base = points[i];
+            Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+            Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+            for (auto it = neighbours.begin(i); it != neighbours.end(i); ++it) {
+                Base::Vector3d d = points[*it] - base;
+                Eigen::Vector3d v(d.x, d.y, d.z);
+                sum += v;
+                cov += v * v.transpose();
+            }
+            Eigen::Vector3d mean = sum / double(count);
+            cov = cov / double(count) - mean * mean.transpose();
+
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig;
+            eig.computeDirect(cov);
+            Eigen::Vector3d n = eig.eigenvectors().col(0);
+            Base::Vector3d normal(n.x(), n.y(), n.z());
+
+            if (orientation == Orientation::ViewPoint && normal.Dot(viewPoint - base) < 0.0) {
+                normal = -normal;
+            }
+            normals[i] = normal;
+
+            if (curvature) {
+                double trace = eig.eigenvalues().sum();
+                (*curvature)[i] = trace > 0.0 ? eig.eigenvalues()(0) / trace : 0.0;
+            }
+        }
+    });
+
+    if (orientation == Orientation::Propagate) {
+        propagate(neighbours, normals);
+    }
+}
+
+void NormalEstimation::propagate(const KDTree::Neighbours& neighbours,
+                                 std::vector<Base::Vector3d>& normals) const
+{
+    std::size_t numPoints = points.size();
+
+    // the k-NN relation isn't symmetric, so the graph gets the edges in both directions
+    std::vector<std::size_t> offsets(numPoints + 1, 0);
+    for (std::size_t i = 0; i < numPoints; i++) {
+        for (auto it = neighbours.begin(i); it != neighbours.end(i); ++it) {
+            if (*it != i) {
+                offsets[i + 1]++;
+                offsets[*it + 1]++;
+            }
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<uint32_t> edges(offsets.back());
+    std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < numPoints; i++) {
+        for (auto it = neighbours.begin(i); it != neighbours.end(i); ++it) {
+            if (*it != i) {
+                edges[fill[i]++] = *it;
+                edges[fill[*it]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    // each connected component is seeded with its highest point whose normal points upwards
+    std::vector<uint32_t> seeds(numPoints);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::sort(seeds.begin(), seeds.end(), [this](uint32_t a, uint32_t b) {
+        return points[a].z > points[b].z;
+    });
+
+    using Edge = std::pair<double, std::pair<uint32_t, uint32_t>>;
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> queue;
+    std::vector<bool> visited(numPoints, false);
+    auto visit = [&](uint32_t index) {
+        visited[index] = true;
+        const Base::Vector3d& normal = normals[index];
+        for (std::size_t j = offsets[index]; j < offsets[index + 1]; j++) {
+            uint32_t next = edges[j];
+            if (!visited[next]) {
+                double weight = 1.0 - std::fabs(normal.Dot(normals[next]));
+                queue.push(std::make_pair(weight, std::make_pair(index, next)));
+            }
+        }
+    };
+
+    for (auto seed : seeds) {
+        if (visited[seed]) {
+            continue;
+        }
+        if (normals[seed].z < 0.0) {
+            normals[seed] = -normals[seed];
+        }
+        visit(seed);
+
+        // Prim's algorithm
+        while (!queue.empty()) {
+            auto edge = queue.top().second;
+            queue.pop();
+            if (visited[edge.second]) {
+                continue;
+            }
+            if (normals[edge.first].Dot(normals[edge.second]) < 0.0) {
+                normals[edge.second] = -normals[edge.second];
+            }
+            visit(edge.second);
+        }
+    }
+}
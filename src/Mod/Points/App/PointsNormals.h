@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+
+#ifndef POINTS_POINTSNORMALS_H
+#define POINTS_POINTSNORMALS_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+#include "PointsKDTree.h"
+
+
+namespace Points
+{
+
+/**
+ * The NormalEstimation class estimates the normals of a point cloud by a
+ * principal component analysis of the neighbourhood of each point. The
+ * normal is the eigenvector of the smallest eigenvalue of the covariance
+ * matrix. The neighbourhoods are determined in parallel with a KDTree.
+ *
+ * The sign of a normal is arbitrary after the estimation. It's either
+ * flipped towards a view point or propagated along a minimum spanning tree
+ * of the neighbourhood graph, where the edge weights favour neighbours with
+ * nearly parallel normals (Hoppe et al., 1992).
+ */
+class PointsExport NormalEstimation
+{
+public:
+    enum class Orientation
+    {
+        None,
+        ViewPoint,
+        Propagate
+    };
+
+    explicit NormalEstimation(const std::vector<Base::Vector3d>& pts);
+
+    /// Sets the number of nearest neighbours used for the estimation
+    void setKSearch(std::size_t k)
+    {
+        kSearch = k;
+    }
+    /** Sets the radius of the neighbourhood. If the number of neighbours is
+     * set too, the nearest of them inside the radius are used.
+     */
+    void setSearchRadius(double radius)
+    {
+        searchRadius = radius;
+    }
+    void setOrientation(Orientation mode)
+    {
+        orientation = mode;
+    }
+    /// Sets the view point the normals are flipped to with Orientation::ViewPoint
+    void setViewPoint(const Base::Vector3d& pnt)
+    {
+        viewPoint = pnt;
+    }
+
+    /** Computes a normal for each point. Points with fewer than three
+     * neighbours get a null vector. If \a curvature is given it receives the
+     * surface variation of each point.
+     */
+    void perform(std::vector<Base::Vector3d>& normals, std::vector<double>* curvature = nullptr) const;
+
+private:
+    void propagate(const KDTree::Neighbours& graph, std::vector<Base::Vector3d>& normals) const;
+
+private:
+    const std::vector<Base::Vector3d>& points;
+    std::size_t kSearch = 0;
+    double searchRadius = 0.0;
+    Orientation orientation = Orientation::ViewPoint;
+    Base::Vector3d viewPoint;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_POINTSNORMALS_H
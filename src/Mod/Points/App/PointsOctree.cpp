@@ -0,0 +1,506 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <cstring>
+# include <limits>
+#endif
+
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+
+#include "PointsOctree.h"
+
+
+using namespace Points;
+
+namespace {
+const char octreeMagic[8] = {'F', 'C', 'P', 'O', 'C', 'T', 'R', 'E'};
+const uint32_t octreeVersion = 1;
+// magic, version, grid depth, number of points, table offset, bounding box
+const std::streamoff headerSize = 8 + 4 + 4 + 8 + 8 + 6 * 8;
+const std::streamoff pointSize = 3 * sizeof(float);
+
+// spreads consecutive point indices so that every n-th hash selects a uniform sample
+inline uint64_t sampleHash(uint64_t index)
+{
+    return (index * 0x9E3779B97F4A7C15ULL) >> 17;
+}
+}
+
+KernelSource::KernelSource(const PointKernel& kernel, std::size_t chunkSize)
+  : kernel(kernel)
+  , chunkSize(std::max<std::size_t>(1, chunkSize))
+{
+}
+
+void KernelSource::rewind()
+{
+    pos = 0;
+}
+
+bool KernelSource::next(std::vector<Base::Vector3f>& chunk)
+{
+    const std::vector<Base::Vector3f>& pts = kernel.getBasicPoints();
+    if (pos >= pts.size())
+        return false;
+
+    std::size_t end = std::min(pos + chunkSize, pts.size());
+    chunk.assign(pts.begin() + pos, pts.begin() + end);
+    pos = end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PointsOctree::Node::isLeaf() const
+{
+    return std::all_of(children, children + 8, [](int32_t child) {
+        return child < 0;
+    });
+}
+
+PointsOctree::PointsOctree(const std::string& filename)
+  : filename(filename)
+{
+}
+
+PointsOctree::~PointsOctree()
+{
+}
+
+void PointsOctree::setMaxPointsPerNode(uint32_t num)
+{
+    maxPointsPerNode = std::max<uint32_t>(1, num);
+}
+
+void PointsOctree::setCacheSize(std::size_t num)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cacheSize = num;
+    evictCache();
+}
+
+uint64_t PointsOctree::size() const
+{
+    return numPoints;
+}
+
+int PointsOctree::countLevels() const
+{
+    uint32_t depth = 0;
+    for (const auto& it : nodes)
+        depth = std::max(depth, it.depth);
+    return nodes.empty() ? 0 : static_cast<int>(depth) + 1;
+}
+
+uint64_t PointsOctree::countPoints(int level) const
+{
+    uint64_t num = 0;
+    for (const auto& it : nodes) {
+        if (level >= 0 && it.depth > static_cast<uint32_t>(level))
+            continue;
+        if (it.isLeaf() || (level >= 0 && it.depth == static_cast<uint32_t>(level)))
+            num += it.count;
+    }
+    return num;
+}
+
+int PointsOctree::findLevel(uint64_t maxPoints) const
+{
+    for (int level = countLevels() - 1; level > 0; level--) {
+        if (countPoints(level) <= maxPoints)
+            return level;
+    }
+    return 0;
+}
+
+Base::BoundBox3d PointsOctree::getBoundBox() const
+{
+    return boundBox;
+}
+
+void PointsOctree::build(PointsSource& source)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        input.reset();
+        cache.clear();
+        lru.clear();
+        cached = 0;
+    }
+    nodes.clear();
+
+    scan(source);
+
+    // count the points per cell of the finest grid
+    uint32_t res = 1u << gridDepth;
+    std::vector<std::vector<uint64_t>> counts(gridDepth + 1);
+    counts[gridDepth].resize(static_cast<std::size_t>(res) * res * res, 0);
+
+    double len = boundBox.LengthX();
+    auto cell = [&](double v, double min) {
+        int i = static_cast<int>((v - min) / len * res);
+        return static_cast<uint32_t>(std::clamp<int>(i, 0, static_cast<int>(res) - 1));
+    };
+
+    std::vector<Base::Vector3f> chunk;
+    source.rewind();
+    while (source.next(chunk)) {
+        for (const auto& p : chunk) {
+            uint32_t ix = cell(p.x, boundBox.MinX);
+            uint32_t iy = cell(p.y, boundBox.MinY);
+            uint32_t iz = cell(p.z, boundBox.MinZ);
+            counts[gridDepth][(static_cast<std::size_t>(iz) * res + iy) * res + ix]++;
+        }
+    }
+
+    // sum up the counts for the coarser levels
+    for (uint32_t d = gridDepth; d > 0; d--) {
+        uint32_t n = 1u << (d - 1);
+        counts[d - 1].resize(static_cast<std::size_t>(n) * n * n, 0);
+        for (uint32_t iz = 0; iz < 2 * n; iz++) {
+            for (uint32_t iy = 0; iy < 2 * n; iy++) {
+                for (uint32_t ix = 0; ix < 2 * n; ix++) {
+                    uint64_t c = counts[d][(static_cast<std::size_t>(iz) * 2 * n + iy) * 2 * n + ix];
+                    counts[d - 1][(static_cast<std::size_t>(iz / 2) * n + iy / 2) * n + ix / 2] += c;
+                }
+            }
+        }
+    }
+
+    createNodes(counts);
+
+    // every n-th point of the subtree becomes a sample of an inner node
+    std::vector<uint64_t> ratios(nodes.size(), 1);
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        if (!nodes[i].isLeaf())
+            ratios[i] = std::max<uint64_t>(1, (nodes[i].total + maxPointsPerNode - 1) / maxPointsPerNode);
+    }
+
+    distribute(source, ratios);
+    open();
+}
+
+void PointsOctree::scan(PointsSource& source)
+{
+    Base::BoundBox3d bbox;
+    numPoints = 0;
+
+    std::vector<Base::Vector3f> chunk;
+    source.rewind();
+    while (source.next(chunk)) {
+        for (const auto& p : chunk)
+            bbox.Add(Base::Vector3d(p.x, p.y, p.z));
+        numPoints += chunk.size();
+    }
+
+    if (numPoints == 0)
+        throw Base::ValueError("Cannot build octree of empty point cloud");
+
+    // the octree cells are cubes
+    Base::Vector3d center = bbox.GetCenter();
+    double half = 0.5 * std::max({bbox.LengthX(), bbox.LengthY(), bbox.LengthZ()});
+    half = std::max(half * 1.001, 1.0e-6);
+    boundBox = Base::BoundBox3d(center.x - half, center.y - half, center.z - half,
+                                center.x + half, center.y + half, center.z + half);
+}
+
+void PointsOctree::createNodes(const std::vector<std::vector<uint64_t>>& counts)
+{
+    createNode(counts, 0, 0, 0, 0);
+
+    // reserve the file region of each node
+    uint64_t offset = 0;
+    for (auto& it : nodes) {
+        it.offset = offset;
+        offset += it.capacity;
+    }
+}
+
+int32_t PointsOctree::createNode(const std::vector<std::vector<uint64_t>>& counts,
+                                 uint32_t depth, uint32_t ix, uint32_t iy, uint32_t iz)
+{
+    uint32_t n = 1u << depth;
+    uint64_t total = counts[depth][(static_cast<std::size_t>(iz) * n + iy) * n + ix];
+    if (total == 0)
+        return -1;
+
+    double len = boundBox.LengthX() / n;
+    Node node;
+    node.depth = depth;
+    node.total = total;
+    node.box = Base::BoundBox3d(boundBox.MinX + ix * len, boundBox.MinY + iy * len, boundBox.MinZ + iz * len,
+                                boundBox.MinX + (ix + 1) * len, boundBox.MinY + (iy + 1) * len, boundBox.MinZ + (iz + 1) * len);
+
+    bool leaf = total <= maxPointsPerNode || depth == gridDepth;
+    if (leaf) {
+        node.capacity = static_cast<uint32_t>(std::min<uint64_t>(total, std::numeric_limits<uint32_t>::max()));
+    }
+    else {
+        // leave room for the statistical variation of the sample size
+        node.capacity = static_cast<uint32_t>(std::min<uint64_t>(total, 2 * static_cast<uint64_t>(maxPointsPerNode)));
+    }
+
+    int32_t index = static_cast<int32_t>(nodes.size());
+    nodes.push_back(node);
+
+    if (!leaf) {
+        for (int o = 0; o < 8; o++) {
+            int32_t child = createNode(counts, depth + 1,
+                                       2 * ix + (o & 1),
+                                       2 * iy + ((o >> 1) & 1),
+                                       2 * iz + ((o >> 2) & 1));
+            nodes[index].children[o] = child;
+        }
+    }
+
+    return index;
+}
+
+void PointsOctree::distribute(PointsSource& source, const std::vector<uint64_t>& ratios)
+{
+    Base::FileInfo fi(filename);
+    Base::ofstream out(fi, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw Base::FileException("Cannot create octree file", fi);
+
+    // the header is written at the end when the table offset is known
+    std::vector<char> header(headerSize, 0);
+    out.write(header.data(), headerSize);
+
+    // keep the write buffers of all nodes below 64 MB
+    std::size_t flushSize = std::max<std::size_t>(256, (64 * 1024 * 1024 / pointSize) / nodes.size());
+    std::vector<std::vector<Base::Vector3f>> buffers(nodes.size());
+    for (auto& it : nodes)
+        it.count = 0;
+
+    Base::OutputStream str(out);
+    auto flush = [&](std::size_t index) {
+        std::vector<Base::Vector3f>& buf = buffers[index];
+        if (buf.empty())
+            return;
+        const Node& node = nodes[index];
+        uint64_t written = node.count - buf.size();
+        out.seekp(headerSize + static_cast<std::streamoff>(node.offset + written) * pointSize);
+        str.write(reinterpret_cast<const float*>(buf.data()), 3 * buf.size());
+        buf.clear();
+    };
+
+    uint32_t res = 1u << gridDepth;
+    double len = boundBox.LengthX();
+    auto cell = [&](double v, double min) {
+        int i = static_cast<int>((v - min) / len * res);
+        return static_cast<uint32_t>(std::clamp<int>(i, 0, static_cast<int>(res) - 1));
+    };
+
+    uint64_t index = 0;
+    std::vector<Base::Vector3f> chunk;
+    source.rewind();
+    while (source.next(chunk)) {
+        for (const auto& p : chunk) {
+            uint32_t ix = cell(p.x, boundBox.MinX);
+            uint32_t iy = cell(p.y, boundBox.MinY);
+            uint32_t iz = cell(p.z, boundBox.MinZ);
+            uint64_t hash = sampleHash(index++);
+
+            int32_t current = 0;
+            while (current >= 0) {
+                Node& node = nodes[current];
+                bool leaf = node.isLeaf();
+                if (node.count < node.capacity && (leaf || hash % ratios[current] == 0)) {
+                    buffers[current].push_back(p);
+                    node.count++;
+                    if (buffers[current].size() >= flushSize)
+                        flush(current);
+                }
+                if (leaf)
+                    break;
+
+                uint32_t shift = gridDepth - node.depth - 1;
+                int octant = ((ix >> shift) & 1) | (((iy >> shift) & 1) << 1) | (((iz >> shift) & 1) << 2);
+                current = node.children[octant];
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); i++)
+        flush(i);
+
+    out.seekp(0, std::ios::end);
+    uint64_t tableOffset = static_cast<uint64_t>(out.tellp());
+    writeTable(str);
+
+    out.seekp(0);
+    out.write(octreeMagic, sizeof(octreeMagic));
+    str << octreeVersion << gridDepth << numPoints << tableOffset;
+    str << boundBox.MinX << boundBox.MinY << boundBox.MinZ
+        << boundBox.MaxX << boundBox.MaxY << boundBox.MaxZ;
+
+    if (!out)
+        throw Base::FileException("Failed to write octree file", fi);
+}
+
+void PointsOctree::writeTable(Base::OutputStream& str) const
+{
+    str << static_cast<uint32_t>(nodes.size());
+    for (const auto& it : nodes) {
+        str << it.box.MinX << it.box.MinY << it.box.MinZ
+            << it.box.MaxX << it.box.MaxY << it.box.MaxZ;
+        str.write(it.children, 8);
+        str << it.depth << it.offset << it.capacity << it.count << it.total;
+    }
+}
+
+void PointsOctree::readTable(Base::InputStream& str)
+{
+    uint32_t num = 0;
+    str >> num;
+    nodes.resize(num);
+    for (auto& it : nodes) {
+        str >> it.box.MinX >> it.box.MinY >> it.box.MinZ
+            >> it.box.MaxX >> it.box.MaxY >> it.box.MaxZ;
+        str.read(it.children, 8);
+        str >> it.depth >> it.offset >> it.capacity >> it.count >> it.total;
+    }
+}
+
+void PointsOctree::open()
+{
+    Base::FileInfo fi(filename);
+    std::unique_ptr<std::istream> inp(new Base::ifstream(fi, std::ios::in | std::ios::binary));
+
+    char magic[sizeof(octreeMagic)];
+    inp->read(magic, sizeof(magic));
+    if (!*inp || std::memcmp(magic, octreeMagic, sizeof(magic)) != 0)
+        throw Base::BadFormatError("Not an octree file");
+
+    Base::InputStream str(*inp);
+    uint32_t version = 0;
+    uint64_t tableOffset = 0;
+    str >> version >> gridDepth >> numPoints >> tableOffset;
+    if (version != octreeVersion)
+        throw Base::BadFormatError("Unsupported octree file version");
+    str >> boundBox.MinX >> boundBox.MinY >> boundBox.MinZ
+        >> boundBox.MaxX >> boundBox.MaxY >> boundBox.MaxZ;
+
+    inp->seekg(static_cast<std::streamoff>(tableOffset));
+    readTable(str);
+    if (!*inp)
+        throw Base::BadFormatError("Failed to read octree node table");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    input = std::move(inp);
+    cache.clear();
+    lru.clear();
+    cached = 0;
+}
+
+std::shared_ptr<const std::vector<Base::Vector3f>> PointsOctree::loadNode(std::size_t index) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(index);
+    if (it != cache.end()) {
+        lru.splice(lru.begin(), lru, it->second.lru);
+        return it->second.points;
+    }
+
+    if (!input)
+        throw Base::RuntimeError("Octree file is not open");
+
+    const Node& node = nodes.at(index);
+    auto points = std::make_shared<std::vector<Base::Vector3f>>(node.count);
+    input->clear();
+    input->seekg(headerSize + static_cast<std::streamoff>(node.offset) * pointSize);
+    Base::InputStream str(*input);
+    str.read(reinterpret_cast<float*>(points->data()), 3 * points->size());
+    if (!*input)
+        throw Base::FileException("Failed to read octree node", Base::FileInfo(filename));
+
+    lru.push_front(index);
+    cache[index] = CacheEntry{points, lru.begin()};
+    cached += points->size();
+    evictCache();
+    return points;
+}
+
+void PointsOctree::evictCache() const
+{
+    // the most recently used node always stays
+    while (cached > cacheSize && lru.size() > 1) {
+        std::size_t index = lru.back();
+        lru.pop_back();
+        auto it = cache.find(index);
+        cached -= it->second.points->size();
+        cache.erase(it);
+    }
+}
+
+void PointsOctree::getPoints(const Base::BoundBox3d& region, int level,
+                             std::vector<Base::Vector3f>& points) const
+{
+    if (nodes.empty())
+        return;
+
+    std::vector<std::size_t> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        std::size_t index = stack.back();
+        stack.pop_back();
+
+        const Node& node = nodes[index];
+        if (!region.Intersect(node.box))
+            continue;
+
+        bool leaf = node.isLeaf();
+        if (leaf || (level >= 0 && node.depth == static_cast<uint32_t>(level))) {
+            auto data = loadNode(index);
+            if (region.IsInBox(node.box)) {
+                points.insert(points.end(), data->begin(), data->end());
+            }
+            else {
+                for (const auto& p : *data) {
+                    if (region.IsInBox(Base::Vector3d(p.x, p.y, p.z)))
+                        points.push_back(p);
+                }
+            }
+            continue;
+        }
+
+        for (int32_t child : node.children) {
+            if (child >= 0)
+                stack.push_back(static_cast<std::size_t>(child));
+        }
+    }
+}
+
+void PointsOctree::getPoints(const Base::BoundBox3d& region, int level, PointKernel& kernel) const
+{
+    std::vector<Base::Vector3f> points;
+    getPoints(region, level, points);
+    kernel.swap(points);
+}
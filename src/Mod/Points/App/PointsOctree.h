@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+/****************************************************************************
+ *   Copyright (c) 2023 FreeCAD Project Association                         *
+ *                                                                          *
+ *   This file is part of FreeCAD.                                          *
+ *                                                                          *
+ *   FreeCAD is free software: you can redistribute it and/or modify it     *
+ *   under the terms of the GNU Lesser General Public License as            *
+ *   published by the Free Software Foundation, either version 2.1 of the   *
+ *   License, or (at your option) any later version.                        *
+ *                                                                          *
+ *   FreeCAD is distributed in the hope that it will be useful, but         *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU       *
+ *   Lesser General Public License for more details.                        *
+ *                                                                          *
+ *   You should have received a copy of the GNU Lesser General Public       *
+ *   License along with FreeCAD. If not, see                                *
+ *   <https://www.gnu.org/licenses/>.                                       *
+ *                                                                          *
+ ***************************************************************************/
+
+#ifndef POINTS_POINTSOCTREE_H
+#define POINTS_POINTSOCTREE_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Base/BoundBox.h>
+#include <Base/Stream.h>
+
+#include "Points.h"
+
+
+namespace Points
+{
+
+/**
+ * The PointsSource class provides a point cloud chunk by chunk, so that it
+ * never needs to be kept in memory as a whole.
+ */
+class PointsExport PointsSource
+{
+public:
+    PointsSource() = default;
+    virtual ~PointsSource() = default;
+    /// Restarts with the first point
+    virtual void rewind() = 0;
+    /// Fills \a chunk with the next points. Returns false if there are no more points.
+    virtual bool next(std::vector<Base::Vector3f>& chunk) = 0;
+
+private:
+    PointsSource(const PointsSource&) = delete;
+    PointsSource& operator=(const PointsSource&) = delete;
+};
+
+/**
+ * The KernelSource class provides the points of a point kernel chunk by chunk.
+ */
+class PointsExport KernelSource : public PointsSource
+{
+public:
+    explicit KernelSource(const PointKernel&, std::size_t chunkSize = 1 << 20);
+    void rewind() override;
+    bool next(std::vector<Base::Vector3f>& chunk) override;
+
+private:
+    const PointKernel& kernel;
+    std::size_t chunkSize;
+    std::size_t pos = 0;
+};
+
+/**
+ * The PointsOctree class is a disk-backed octree for point clouds that don't
+ * fit into memory. The points of each node are stored contiguously in a file
+ * and only loaded on demand into a cache of bounded size.
+ *
+ * All points are stored in the leaves. Each inner node additionally keeps a
+ * spatially uniform sample of the points of its subtree that serves as level
+ * of detail (LOD). Level \a n consists of the samples of all nodes at depth
+ * \a n and the leaves above.
+ */
+class PointsExport PointsOctree
+{
+public:
+    struct Node
+    {
+        Base::BoundBox3d box;
+        int32_t children[8];
+        uint32_t depth = 0;
+        /// position of the first point in the file, in points
+        uint64_t offset = 0;
+        /// number of reserved point slots
+        uint32_t capacity = 0;
+        /// number of stored points
+        uint32_t count = 0;
+        /// number of points in the subtree
+        uint64_t total = 0;
+
+        Node()
+        {
+            std::fill(children, children + 8, -1);
+        }
+        bool isLeaf() const;
+    };
+
+    /// The octree is stored in the file \a filename
+    explicit PointsOctree(const std::string& filename);
+    ~PointsOctree();
+
+    /** @name Settings */
+    //@{
+    /// Sets the maximum number of points in a leaf and the sample size of inner nodes
+    void setMaxPointsPerNode(uint32_t num);
+    /// Sets the maximum number of points kept in memory by the node cache
+    void setCacheSize(std::size_t num);
+    //@}
+
+    /** @name Construction */
+    //@{
+    /// Builds the octree from \a source and writes it to the file. The source is read three times.
+    void build(PointsSource& source);
+    /// Reads the node table of an octree file written by build()
+    void open();
+    //@}
+
+    /** @name Access */
+    //@{
+    /// Returns the number of points of the cloud
+    uint64_t size() const;
+    /// Returns the number of levels of detail
+    int countLevels() const;
+    /// Returns the number of points of the level of detail \a level without loading them
+    uint64_t countPoints(int level) const;
+    /** Returns the finest level of detail with at most \a maxPoints points.
+     * If even the coarsest level exceeds the limit 0 is returned.
+     */
+    int findLevel(uint64_t maxPoints) const;
+    Base::BoundBox3d getBoundBox() const;
+    const std::vector<Node>& getNodes() const
+    {
+        return nodes;
+    }
+    /// Returns the points of a node. If needed they are loaded from the file.
+    std::shared_ptr<const std::vector<Base::Vector3f>> loadNode(std::size_t index) const;
+    /** Collects the points of the level of detail \a level inside \a region.
+     * A negative level or a level above countLevels() gives all points.
+     */
+    void getPoints(const Base::BoundBox3d& region, int level, std::vector<Base::Vector3f>& points) const;
+    /// Same as above but fills a point kernel
+    void getPoints(const Base::BoundBox3d& region, int level, PointKernel& kernel) const;
+    //@}
+
+private:
+    void scan(PointsSource& source);
+    void createNodes(const std::vector<std::vector<uint64_t>>& counts);
+    int32_t createNode(const std::vector<std::vector<uint64_t>>& counts,
+                       uint32_t depth, uint32_t ix, uint32_t iy, uint32_t iz);
+    void distribute(PointsSource& source, const std::vector<uint64_t>& ratios);
+    void writeTable(Base::OutputStream& str) const;
+    void readTable(Base::InputStream& str);
+    void evictCache() const;
+
+private:
+    std::string filename;
+    uint32_t maxPointsPerNode = 65536;
+    std::size_t cacheSize = 16 * 1024 * 1024;
+
+    Base::BoundBox3d boundBox;
+    uint64_t numPoints = 0;
+    uint32_t gridDepth = 7;
+    std::vector<Node> nodes;
+
+    // node cache
+    using NodePoints = std::shared_ptr<const std::vector<Base::Vector3f>>;
+    struct CacheEntry
+    {
+        NodePoints points;
+        std::list<std::size_t>::iterator lru;
+    };
+    mutable std::mutex mutex;
+    mutable std::unique_ptr<std::istream> input;
+    mutable std::map<std::size_t, CacheEntry> cache;
+    mutable std::list<std::size_t> lru;
+    mutable std::size_t cached = 0;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_POINTSOCTREE_H
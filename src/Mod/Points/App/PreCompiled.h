@@ -39,9 +39,14 @@
 
 // STL
 # include <algorithm>
+# include <atomic>
 # include <cmath>
+# include <cstring>
 # include <iostream>
+# include <limits>
 # include <memory>
+# include <numeric>
+# include <queue>
 # include <set>
 # include <sstream>
 # include <vector>
@@ -53,6 +58,7 @@
 # include <boost/math/special_functions/fpclassify.hpp>
 
 // Qt
+# include <QFile>
 # include <QtConcurrentMap>
 
 #endif //_PreComp_
@@ -156,9 +156,7 @@ void PropertyGreyValueList::SaveDocFile (Base::Writer &writer) const
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    for (std::vector<float>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << *it;
-    }
+    str.write(_lValueList.data(), _lValueList.size());
 }
 
 void PropertyGreyValueList::RestoreDocFile(Base::Reader &reader)
@@ -167,10 +165,11 @@ void PropertyGreyValueList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<float> values(uCt);
-    for (std::vector<float>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> *it;
-    }
-    setValues(values);
+    str.read(values.data(), values.size());
+
+    aboutToSetValue();
+    _lValueList.swap(values);
+    hasSetValue();
 }
 
 App::Property *PropertyGreyValueList::Copy() const
@@ -327,12 +326,12 @@ void PropertyNormalList::Restore(Base::XMLReader &reader)
 
 void PropertyNormalList::SaveDocFile (Base::Writer &writer) const
 {
+    static_assert(sizeof(Base::Vector3f) == 3 * sizeof(float), "Base::Vector3f is expected to be packed");
+
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    for (std::vector<Base::Vector3f>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->x << it->y << it->z;
-    }
+    str.write(reinterpret_cast<const float*>(_lValueList.data()), 3 * _lValueList.size());
 }
 
 void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
@@ -341,10 +340,11 @@ void PropertyNormalList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<Base::Vector3f> values(uCt);
-    for (std::vector<Base::Vector3f>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> it->x >> it->y >> it->z;
-    }
-    setValues(values);
+    str.read(reinterpret_cast<float*>(values.data()), 3 * values.size());
+
+    aboutToSetValue();
+    _lValueList.swap(values);
+    hasSetValue();
 }
 
 App::Property *PropertyNormalList::Copy() const
@@ -593,15 +593,12 @@ void PropertyCurvatureList::Restore(Base::XMLReader &reader)
 
 void PropertyCurvatureList::SaveDocFile (Base::Writer &writer) const
 {
+    static_assert(sizeof(CurvatureInfo) == 8 * sizeof(float), "CurvatureInfo is expected to be packed");
+
     Base::OutputStream str(writer.Stream());
     uint32_t uCt = (uint32_t)getSize();
     str << uCt;
-    if (uCt > 0)
-    for (std::vector<CurvatureInfo>::const_iterator it = _lValueList.begin(); it != _lValueList.end(); ++it) {
-        str << it->fMaxCurvature << it->fMinCurvature;
-        str << it->cMaxCurvDir.x << it->cMaxCurvDir.y << it->cMaxCurvDir.z;
-        str << it->cMinCurvDir.x << it->cMinCurvDir.y << it->cMinCurvDir.z;
-    }
+    str.write(reinterpret_cast<const float*>(_lValueList.data()), 8 * _lValueList.size());
 }
 
 void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
@@ -610,13 +607,11 @@ void PropertyCurvatureList::RestoreDocFile(Base::Reader &reader)
     uint32_t uCt=0;
     str >> uCt;
     std::vector<CurvatureInfo> values(uCt);
-    for (std::vector<CurvatureInfo>::iterator it = values.begin(); it != values.end(); ++it) {
-        str >> it->fMaxCurvature >> it->fMinCurvature;
-        str >> it->cMaxCurvDir.x >> it->cMaxCurvDir.y >> it->cMaxCurvDir.z;
-        str >> it->cMinCurvDir.x >> it->cMinCurvDir.y >> it->cMinCurvDir.z;
-    }
+    str.read(reinterpret_cast<float*>(values.data()), 8 * values.size());
 
-    setValues(values);
+    aboutToSetValue();
+    _lValueList.swap(values);
+    hasSetValue();
 }
 
 App::Property *PropertyCurvatureList::Copy() const
@@ -122,11 +122,14 @@ public:
         add_keyword_method("filterVoxelGrid",&Module::filterVoxelGrid,
             "filterVoxelGrid(dim)."
         );
+#endif
         add_keyword_method("normalEstimation",&Module::normalEstimation,
-            "normalEstimation(Points,[KSearch=0, SearchRadius=0]) -> Normals\n"
+            "normalEstimation(Points,[KSearch=0, SearchRadius=0, Propagate=False]) -> Normals\n"
             "KSearch is an int and used to search the k-nearest neighbours in\n"
             "the k-d tree. Alternatively, SearchRadius (a float) can be used\n"
             "as spatial distance to determine the neighbours of a point\n"
+            "If Propagate is True the normals are oriented consistently over\n"
+            "the neighbourhood graph, otherwise towards the origin\n"
             "Example:\n"
             "\n"
             "import ReverseEngineering as Reen\n"
@@ -140,7 +143,6 @@ public:
             "f.ViewObject.Proxy=0\n"
             "f.ViewObject.DisplayMode=1\n"
         );
-#endif
 #if defined(HAVE_PCL_SEGMENTATION)
         add_keyword_method("regionGrowingSegmentation",&Module::regionGrowingSegmentation,
             "regionGrowingSegmentation()."
@@ -638,26 +640,33 @@ Mesh.show(m)
         return Py::asObject(new Points::PointsPy(points_sample));
     }
 #endif
-#if defined(HAVE_PCL_FILTERS)
     Py::Object normalEstimation(const Py::Tuple& args, const Py::Dict& kwds)
     {
         PyObject *pts;
         int ksearch=0;
         double searchRadius=0;
+        PyObject *propagate = Py_False;
 
-        static char* kwds_normals[] = {"Points", "KSearch", "SearchRadius", NULL};
-        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|id", kwds_normals,
+        static char* kwds_normals[] = {"Points", "KSearch", "SearchRadius", "Propagate", NULL};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|idO!", kwds_normals,
                                         &(Points::PointsPy::Type), &pts,
-                                        &ksearch, &searchRadius))
+                                        &ksearch, &searchRadius,
+                                        &PyBool_Type, &propagate))
             throw Py::Exception();
 
         Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
 
         std::vector<Base::Vector3d> normals;
-        NormalEstimation estimate(*points);
-        estimate.setKSearch(ksearch);
-        estimate.setSearchRadius(searchRadius);
-        estimate.perform(normals);
+        try {
+            NormalEstimation estimate(*points);
+            estimate.setKSearch(ksearch);
+            estimate.setSearchRadius(searchRadius);
+            estimate.setPropagateOrientation(Base::asBoolean(propagate));
+            estimate.perform(normals);
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
 
         Py::List list;
         for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
@@ -666,7 +675,6 @@ Mesh.show(m)
 
         return list;
     }
-#endif
 #if defined(HAVE_PCL_SEGMENTATION)
     Py::Object regionGrowingSegmentation(const Py::Tuple& args, const Py::Dict& kwds)
     {
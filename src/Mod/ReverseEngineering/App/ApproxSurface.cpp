@@ -22,16 +22,15 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
-# include <QFuture>
-# include <QFutureWatcher>
 # include <QtConcurrentMap>
 
 # include <Geom_BSplineSurface.hxx>
-# include <math_Gauss.hxx>
-# include <math_Householder.hxx>
 # include <Precision.hxx>
 #endif
 
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseQR>
+
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
 #include <Mod/Mesh/App/Core/Approximation.h>
@@ -40,7 +39,96 @@
 
 
 using namespace Reen;
-namespace bp = boost::placeholders;
+
+namespace {
+using SparseMatrix = Eigen::SparseMatrix<double>;
+using PointMatrix = Eigen::Matrix<double, Eigen::Dynamic, 3>;
+
+/**
+ * Builds the coefficient matrix of the overdetermined LGS. For each parameter pair
+ * only uOrder*vOrder basis functions are non-zero, so the rows are evaluated in
+ * parallel and stored as sparse matrix.
+ */
+SparseMatrix BasisMatrix(BSplineBasis& uSpline, BSplineBasis& vSpline,
+                         unsigned uOrder, unsigned vOrder,
+                         unsigned uCtrlpoints, unsigned vCtrlpoints,
+                         const TColgp_Array1OfPnt2d& uvParams)
+{
+    int numRows = uvParams.Length();
+    int nonZeros = static_cast<int>(uOrder * vOrder);
+    std::vector<Eigen::Triplet<double> > triplets(static_cast<std::size_t>(numRows) * nonZeros);
+
+    const int rowsPerPart = 1024;
+    std::vector<std::pair<int, int> > parts;
+    for (int i=0; i<numRows; i+=rowsPerPart)
+        parts.emplace_back(i, std::min(i+rowsPerPart, numRows));
+
+    QtConcurrent::blockingMap(parts, [&](const std::pair<int, int>& part) {
+        TColStd_Array1OfReal basisU(0, uOrder-1);
+        TColStd_Array1OfReal basisV(0, vOrder-1);
+        for (int i=part.first; i<part.second; i++) {
+            const gp_Pnt2d& uvValue = uvParams(uvParams.Lower() + i);
+            double fU = uvValue.X();
+            double fV = uvValue.Y();
+
+            // The non-zero basis functions of a span are N(span-p),...,N(span)
+            int firstU = uSpline.FindSpan(fU) - static_cast<int>(uOrder) + 1;
+            int firstV = vSpline.FindSpan(fV) - static_cast<int>(vOrder) + 1;
+            uSpline.AllBasisFunctions(fU, basisU);
+            vSpline.AllBasisFunctions(fV, basisV);
+
+            Eigen::Triplet<double>* it = triplets.data() + static_cast<std::size_t>(i) * nonZeros;
+            for (unsigned j=0; j<uOrder; j++) {
+                for (unsigned k=0; k<vOrder; k++) {
+                    int col = (firstU+j) * vCtrlpoints + firstV+k;
+                    *it++ = Eigen::Triplet<double>(i, col, basisU(j) * basisV(k));
+                }
+            }
+        }
+    });
+
+    SparseMatrix M(numRows, uCtrlpoints * vCtrlpoints);
+    M.setFromTriplets(triplets.begin(), triplets.end());
+    return M;
+}
+
+/**
+ * Builds a matrix of smoothing functionals. The integrals of the products of basis
+ * functions vanish unless their supports overlap, so the control point (k,l) is only
+ * coupled with the control points (i,j) where |i-k| < uOrder and |j-l| < vOrder.
+ */
+template <typename Integral>
+SparseMatrix SmoothMatrix(unsigned uOrder, unsigned vOrder,
+                          unsigned uCtrlpoints, unsigned vCtrlpoints,
+                          Base::SequencerLauncher& seq, Integral&& integral)
+{
+    unsigned ulDim = uCtrlpoints * vCtrlpoints;
+    std::vector<Eigen::Triplet<double> > triplets;
+    triplets.reserve(static_cast<std::size_t>(ulDim) * (2*uOrder-1) * (2*vOrder-1));
+
+    for (unsigned k=0; k<uCtrlpoints; k++) {
+        unsigned iBegin = k+1 > uOrder ? k+1-uOrder : 0;
+        unsigned iEnd = std::min(k+uOrder, uCtrlpoints);
+        for (unsigned l=0; l<vCtrlpoints; l++) {
+            unsigned jBegin = l+1 > vOrder ? l+1-vOrder : 0;
+            unsigned jEnd = std::min(l+vOrder, vCtrlpoints);
+            unsigned m = k * vCtrlpoints + l;
+            for (unsigned i=iBegin; i<iEnd; i++) {
+                for (unsigned j=jBegin; j<jEnd; j++) {
+                    double value = integral(i, j, k, l);
+                    if (value != 0.0)
+                        triplets.emplace_back(m, i * vCtrlpoints + j, value);
+                }
+            }
+            seq.next();
+        }
+    }
+
+    SparseMatrix S(ulDim, ulDim);
+    S.setFromTriplets(triplets.begin(), triplets.end());
+    return S;
+}
+}
 
 // SplineBasisfunction
 
@@ -768,14 +856,10 @@ BSplineParameterCorrection::BSplineParameterCorrection(unsigned usUOrder, unsign
   : ParameterCorrection(usUOrder, usVOrder, usUCtrlpoints, usVCtrlpoints)
   , _clUSpline(usUCtrlpoints+usUOrder)
   , _clVSpline(usVCtrlpoints+usVOrder)
-  , _clSmoothMatrix(0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clFirstMatrix (0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clSecondMatrix(0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
-  , _clThirdMatrix (0,usUCtrlpoints*usVCtrlpoints-1,
-                    0,usUCtrlpoints*usVCtrlpoints-1)
+  , _clSmoothMatrix(usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clFirstMatrix (usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clSecondMatrix(usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
+  , _clThirdMatrix (usUCtrlpoints*usVCtrlpoints, usUCtrlpoints*usVCtrlpoints)
 {
     Init();
 }
@@ -785,10 +869,10 @@ void BSplineParameterCorrection::Init()
     // Initializations
     _pvcUVParam       = nullptr;
     _pvcPoints        = nullptr;
-    _clFirstMatrix.Init(0.0);
-    _clSecondMatrix.Init(0.0);
-    _clThirdMatrix.Init(0.0);
-    _clSmoothMatrix.Init(0.0);
+    _clFirstMatrix.setZero();
+    _clSecondMatrix.setZero();
+    _clThirdMatrix.setZero();
+    _clSmoothMatrix.setZero();
 
     /* Calculate the knot vectors */
     unsigned usUMax = _usUCtrlpoints-_usUOrder+1;
@@ -933,70 +1017,31 @@ bool BSplineParameterCorrection::SolveWithoutSmoothing()
 {
     unsigned ulSize = _pvcPoints->Length();
     unsigned ulDim  = _usUCtrlpoints*_usVCtrlpoints;
-    math_Matrix M  (0, ulSize-1, 0, ulDim-1);
-    math_Matrix Xx (0, ulDim-1, 0, 0);
-    math_Matrix Xy (0, ulDim-1, 0, 0);
-    math_Matrix Xz (0, ulDim-1, 0, 0);
-    math_Vector bx (0, ulSize-1);
-    math_Vector by (0, ulSize-1);
-    math_Vector bz (0, ulSize-1);
 
     // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i=0; i<ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        unsigned ulIdx=0;
-
-        // Pre-calculation of the values of the base functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j,fU);
-        }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k=0; k<_usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k,fV);
-        }
-
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = 0.0;
-                    ulIdx++;
-                }
-            }
-            else {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = valueU * basisV[k];
-                    ulIdx++;
-                }
-            }
-        }
-    }
+    SparseMatrix M = BasisMatrix(_clUSpline, _clVSpline, _usUOrder, _usVOrder,
+                                 _usUCtrlpoints, _usVCtrlpoints, *_pvcUVParam);
 
     // Determine the right side
-    for (int ii=_pvcPoints->Lower(); ii<=_pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X(); by(ii) = pnt.Y(); bz(ii) = pnt.Z();
+    PointMatrix b(ulSize, 3);
+    for (unsigned i=0; i<ulSize; i++) {
+        const gp_Pnt& pnt = (*_pvcPoints)(_pvcPoints->Lower() + i);
+        b(i,0) = pnt.X(); b(i,1) = pnt.Y(); b(i,2) = pnt.Z();
     }
 
-    // Solve the over-determined LGS with Householder-Transformation
-    math_Householder hhX(M,bx);
-    math_Householder hhY(M,by);
-    math_Householder hhZ(M,bz);
-
-    if (!(hhX.IsDone() && hhY.IsDone() && hhZ.IsDone()))
+    // Solve the over-determined LGS with a sparse QR decomposition
+    Eigen::SparseQR<SparseMatrix, Eigen::COLAMDOrdering<int> > qr(M);
+    if (qr.info() != Eigen::Success || qr.rank() < static_cast<Eigen::Index>(ulDim))
         // LGS could not be solved
         return false;
-    Xx = hhX.AllValues();
-    Xy = hhY.AllValues();
-    Xz = hhZ.AllValues();
+    PointMatrix X = qr.solve(b);
+    if (qr.info() != Eigen::Success)
+        return false;
 
     unsigned ulIdx=0;
     for (unsigned j=0;j<_usUCtrlpoints;j++) {
         for (unsigned k=0;k<_usVCtrlpoints;k++) {
-            _vCtrlPntsOfSurf(j,k) = gp_Pnt(Xx(ulIdx,0),Xy(ulIdx,0),Xz(ulIdx,0));
+            _vCtrlPntsOfSurf(j,k) = gp_Pnt(X(ulIdx,0),X(ulIdx,1),X(ulIdx,2));
             ulIdx++;
         }
     }
@@ -1004,142 +1049,40 @@ bool BSplineParameterCorrection::SolveWithoutSmoothing()
     return true;
 }
 
-namespace Reen {
-class ScalarProduct
-{
-public:
-    explicit ScalarProduct(const math_Matrix& mat) : mat(mat)
-    {
-    }
-    std::vector<double> multiply(int col) const
-    {
-        math_Vector vec = mat.Col(col);
-        std::vector<double> out(mat.ColNumber());
-        for (int n=mat.LowerCol(); n<=mat.UpperCol(); n++) {
-            out[n] = vec * mat.Col(n);
-        }
-        return out;
-    }
-
-private:
-    const math_Matrix& mat;
-};
-}
-
 bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
 {
     unsigned ulSize = _pvcPoints->Length();
-    unsigned ulDim  = _usUCtrlpoints*_usVCtrlpoints;
-    math_Matrix M  (0, ulSize-1, 0, ulDim-1);
-    math_Vector Xx (0, ulDim-1);
-    math_Vector Xy (0, ulDim-1);
-    math_Vector Xz (0, ulDim-1);
-    math_Vector bx (0, ulSize-1);
-    math_Vector by (0, ulSize-1);
-    math_Vector bz (0, ulSize-1);
-    math_Vector Mbx(0, ulDim-1);
-    math_Vector Mby(0, ulDim-1);
-    math_Vector Mbz(0, ulDim-1);
 
     // Determining the coefficient matrix of the overdetermined LGS
-    for (unsigned i=0; i<ulSize; i++) {
-        const gp_Pnt2d& uvValue = (*_pvcUVParam)(i);
-        double fU = uvValue.X();
-        double fV = uvValue.Y();
-        int ulIdx=0;
-
-        // Pre-calculation of the values of the basis functions
-        std::vector<double> basisU(_usUCtrlpoints);
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            basisU[j] = _clUSpline.BasisFunction(j,fU);
-        }
-        std::vector<double> basisV(_usVCtrlpoints);
-        for (unsigned k=0; k<_usVCtrlpoints; k++) {
-            basisV[k] = _clVSpline.BasisFunction(k,fV);
-        }
-
-        for (unsigned j=0; j<_usUCtrlpoints; j++) {
-            double valueU = basisU[j];
-            if (valueU == 0.0) {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = 0.0;
-                    ulIdx++;
-                }
-            }
-            else {
-                for (unsigned k=0; k<_usVCtrlpoints; k++) {
-                    M(i,ulIdx) = valueU * basisV[k];
-                    ulIdx++;
-                }
-            }
-        }
-    }
+    SparseMatrix M = BasisMatrix(_clUSpline, _clVSpline, _usUOrder, _usVOrder,
+                                 _usUCtrlpoints, _usVCtrlpoints, *_pvcUVParam);
 
     // The product of its transform and itself results in the quadratic
-    // system matrix (slowly)
-#if 0
-    math_Matrix MTM = M.TMultiply(M);
-#elif 0
-    math_Matrix MTM(0, ulDim-1, 0, ulDim-1);
-    for (unsigned m=0; m<ulDim; m++) {
-        math_Vector Mm = M.Col(m);
-        for (unsigned n=m; n<ulDim; n++) {
-            MTM(m,n) = MTM(n,m) = Mm * M.Col(n);
-        }
-    }
-#else // multi-threaded
-    std::vector<int> columns(ulDim);
-    std::generate(columns.begin(), columns.end(), Base::iotaGen<int>(0));
-    ScalarProduct scalar(M);
-    QFuture< std::vector<double> > future = QtConcurrent::mapped
-        (columns, boost::bind(&ScalarProduct::multiply, &scalar, bp::_1));
-    QFutureWatcher< std::vector<double> > watcher;
-    watcher.setFuture(future);
-    watcher.waitForFinished();
-
-    math_Matrix MTM(0, ulDim-1, 0, ulDim-1);
-    int rowIndex=0;
-    for (QFuture< std::vector<double> >::const_iterator it = future.begin(); it != future.end(); ++it) {
-        int colIndex=0;
-        for (std::vector<double>::const_iterator jt = it->begin(); jt != it->end(); ++jt, colIndex++)
-            MTM(rowIndex, colIndex) = *jt;
-        rowIndex++;
-    }
-#endif
+    // system matrix, which is banded for B-spline bases like the smoothing terms
+    SparseMatrix MT = M.transpose();
+    SparseMatrix MTM = MT * M;
+    MTM += fWeight * _clSmoothMatrix;
 
     // Determine the right side
-    for (int ii=_pvcPoints->Lower(); ii<=_pvcPoints->Upper(); ii++) {
-        const gp_Pnt& pnt = (*_pvcPoints)(ii);
-        bx(ii) = pnt.X(); by(ii) = pnt.Y(); bz(ii) = pnt.Z();
-    }
-    for (unsigned i=0; i<ulDim; i++) {
-        math_Vector Mi = M.Col(i);
-        Mbx(i) = Mi * bx;
-        Mby(i) = Mi * by;
-        Mbz(i) = Mi * bz;
+    PointMatrix b(ulSize, 3);
+    for (unsigned i=0; i<ulSize; i++) {
+        const gp_Pnt& pnt = (*_pvcPoints)(_pvcPoints->Lower() + i);
+        b(i,0) = pnt.X(); b(i,1) = pnt.Y(); b(i,2) = pnt.Z();
     }
+    PointMatrix Mb = MT * b;
 
-    // Solve the LGS with the LU decomposition
-    math_Gauss mgGaussX(MTM+fWeight*_clSmoothMatrix);
-    math_Gauss mgGaussY(MTM+fWeight*_clSmoothMatrix);
-    math_Gauss mgGaussZ(MTM+fWeight*_clSmoothMatrix);
-
-    mgGaussX.Solve(Mbx,Xx);
-    if (!mgGaussX.IsDone())
-        return false;
-
-    mgGaussY.Solve(Mby,Xy);
-    if (!mgGaussY.IsDone())
+    // Solve the LGS with a sparse Cholesky decomposition
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt(MTM);
+    if (ldlt.info() != Eigen::Success)
         return false;
-
-    mgGaussZ.Solve(Mbz,Xz);
-    if (!mgGaussZ.IsDone())
+    PointMatrix X = ldlt.solve(Mb);
+    if (ldlt.info() != Eigen::Success)
         return false;
 
     unsigned ulIdx=0;
     for (unsigned j=0;j<_usUCtrlpoints;j++) {
         for (unsigned k=0;k<_usVCtrlpoints;k++) {
-            _vCtrlPntsOfSurf(j,k) = gp_Pnt(Xx(ulIdx),Xy(ulIdx),Xz(ulIdx));
+            _vCtrlPntsOfSurf(j,k) = gp_Pnt(X(ulIdx,0),X(ulIdx,1),X(ulIdx,2));
             ulIdx++;
         }
     }
@@ -1150,7 +1093,7 @@ bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
 void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc, double fFirst, double fSecond, double fThird)
 {
     if (bRecalc) {
-        Base::SequencerLauncher seq("Initializing...", 3 * _usUCtrlpoints * _usUCtrlpoints * _usVCtrlpoints * _usVCtrlpoints);
+        Base::SequencerLauncher seq("Initializing...", 3 * _usUCtrlpoints * _usVCtrlpoints);
         CalcFirstSmoothMatrix(seq);
         CalcSecondSmoothMatrix(seq);
         CalcThirdSmoothMatrix(seq);
@@ -1163,82 +1106,49 @@ void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc, double fFirst,
 
 void BSplineParameterCorrection::CalcFirstSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clFirstMatrix(m,n) =   _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                            _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1);
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    _clFirstMatrix = SmoothMatrix(_usUOrder, _usVOrder, _usUCtrlpoints, _usVCtrlpoints, seq,
+                                  [this](unsigned i, unsigned j, unsigned k, unsigned l) {
+        return _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1);
+    });
 }
 
 void BSplineParameterCorrection::CalcSecondSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clSecondMatrix(m,n) =  _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                          2*_clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
-                                            _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                            _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2);
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    _clSecondMatrix = SmoothMatrix(_usUOrder, _usVOrder, _usUCtrlpoints, _usVCtrlpoints, seq,
+                                   [this](unsigned i, unsigned j, unsigned k, unsigned l) {
+        return   _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
+                 _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
+               2*_clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
+                 _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
+                 _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
+                 _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2);
+    });
 }
 
 void BSplineParameterCorrection::CalcThirdSmoothMatrix(Base::SequencerLauncher& seq)
 {
-    unsigned m=0;
-    for (unsigned k=0; k<_usUCtrlpoints; k++) {
-        for (unsigned l=0; l<_usVCtrlpoints; l++) {
-            unsigned n=0;
-
-            for (unsigned i=0; i<_usUCtrlpoints; i++) {
-                for (unsigned j=0; j<_usVCtrlpoints; j++) {
-                    _clThirdMatrix(m,n) = _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,3) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,1) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,2) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,3) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,0) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,2) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,1) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,0) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,3) +
-                                          _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
-                                          _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,3) ;
-                    seq.next();
-                    n++;
-                }
-            }
-            m++;
-        }
-    }
+    _clThirdMatrix = SmoothMatrix(_usUOrder, _usVOrder, _usUCtrlpoints, _usVCtrlpoints, seq,
+                                  [this](unsigned i, unsigned j, unsigned k, unsigned l) {
+        return _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,3) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,0) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,3,1) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,0,2) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,3) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,0) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,1,1) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,2,2) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,2) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,1) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,2) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,1) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,2,0) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,1,3) +
+               _clUSpline.GetIntegralOfProductOfBSplines(i,k,0,0) *
+               _clVSpline.GetIntegralOfProductOfBSplines(j,l,3,3);
+    });
 }
 
 void BSplineParameterCorrection::EnableSmoothing(bool bSmooth, double fSmoothInfl)
@@ -1257,32 +1167,32 @@ void BSplineParameterCorrection::EnableSmoothing(bool bSmooth, double fSmoothInf
     ParameterCorrection::EnableSmoothing(bSmooth, fSmoothInfl);
 }
 
-const math_Matrix& BSplineParameterCorrection::GetFirstSmoothMatrix() const
+const Eigen::SparseMatrix<double>& BSplineParameterCorrection::GetFirstSmoothMatrix() const
 {
     return _clFirstMatrix;
 }
 
-const math_Matrix& BSplineParameterCorrection::GetSecondSmoothMatrix() const
+const Eigen::SparseMatrix<double>& BSplineParameterCorrection::GetSecondSmoothMatrix() const
 {
     return _clSecondMatrix;
 }
 
-const math_Matrix& BSplineParameterCorrection::GetThirdSmoothMatrix() const
+const Eigen::SparseMatrix<double>& BSplineParameterCorrection::GetThirdSmoothMatrix() const
 {
     return _clThirdMatrix;
 }
 
-void BSplineParameterCorrection::SetFirstSmoothMatrix(const math_Matrix& rclMat)
+void BSplineParameterCorrection::SetFirstSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat)
 {
     _clFirstMatrix = rclMat;
 }
 
-void BSplineParameterCorrection::SetSecondSmoothMatrix(const math_Matrix& rclMat)
+void BSplineParameterCorrection::SetSecondSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat)
 {
     _clSecondMatrix = rclMat;
 }
 
-void BSplineParameterCorrection::SetThirdSmoothMatrix(const math_Matrix& rclMat)
+void BSplineParameterCorrection::SetThirdSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat)
 {
     _clThirdMatrix = rclMat;
 }
@@ -31,6 +31,8 @@
 #include <Geom_BSplineSurface.hxx>
 #include <math_Matrix.hxx>
 
+#include <Eigen/SparseCore>
+
 #include <Base/Vector3D.h>
 #include <Mod/ReverseEngineering/ReverseEngineeringGlobal.h>
 
@@ -389,13 +391,13 @@ protected:
     void DoParameterCorrection(int iIter) override;
 
     /**
-     * Solve an overdetermined LGS with the help of the Householder-Tansformation
+     * Solve an overdetermined LGS with the help of a sparse QR decomposition
      */
     bool SolveWithoutSmoothing() override;
 
     /**
-     * Solve a regular system of equations by LU decomposition. Depending on the weighting,
-     * smoothing terms are included
+     * Solve a regular system of equations by a sparse Cholesky decomposition. Depending on
+     * the weighting, smoothing terms are included
      */
     bool SolveWithSmoothing(double fWeight) override;
 
@@ -413,32 +415,32 @@ public:
     /**
      * Returns the first matrix of smoothing terms, if calculated
      */
-    virtual const math_Matrix& GetFirstSmoothMatrix() const;
+    virtual const Eigen::SparseMatrix<double>& GetFirstSmoothMatrix() const;
 
     /**
      * Returns the second matrix of smoothing terms, if calculated
      */
-    virtual const math_Matrix& GetSecondSmoothMatrix() const;
+    virtual const Eigen::SparseMatrix<double>& GetSecondSmoothMatrix() const;
 
     /**
      * Returns the third matrix of smoothing terms, if calculated
      */
-    virtual const math_Matrix& GetThirdSmoothMatrix() const;
+    virtual const Eigen::SparseMatrix<double>& GetThirdSmoothMatrix() const;
 
     /**
      * Sets the first matrix of the smoothing terms
      */
-    virtual void SetFirstSmoothMatrix(const math_Matrix& rclMat);
+    virtual void SetFirstSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat);
 
     /**
      * Sets the second matrix of smoothing terms
      */
-    virtual void SetSecondSmoothMatrix(const math_Matrix& rclMat);
+    virtual void SetSecondSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat);
 
     /**
      * Sets the third matrix of smoothing terms
      */
-    virtual void SetThirdSmoothMatrix(const math_Matrix& rclMat);
+    virtual void SetThirdSmoothMatrix(const Eigen::SparseMatrix<double>& rclMat);
 
     /**
      * Use smoothing-terms
@@ -478,10 +480,10 @@ protected:
 protected:
     BSplineBasis           _clUSpline;        //! B-spline basic function in the u-direction
     BSplineBasis           _clVSpline;        //! B-spline basic function in the v-direction
-    math_Matrix            _clSmoothMatrix;   //! Matrix of smoothing functionals
-    math_Matrix            _clFirstMatrix;    //! Matrix of the 1st smoothing functionals
-    math_Matrix            _clSecondMatrix;   //! Matrix of the 2nd smoothing functionals
-    math_Matrix            _clThirdMatrix;    //! Matrix of the 3rd smoothing functionals
+    Eigen::SparseMatrix<double> _clSmoothMatrix;   //! Matrix of smoothing functionals
+    Eigen::SparseMatrix<double> _clFirstMatrix;    //! Matrix of the 1st smoothing functionals
+    Eigen::SparseMatrix<double> _clSecondMatrix;   //! Matrix of the 2nd smoothing functionals
+    Eigen::SparseMatrix<double> _clThirdMatrix;    //! Matrix of the 3rd smoothing functionals
 };
 
 } // namespace Reen
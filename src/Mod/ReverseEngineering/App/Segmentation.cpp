@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsNormals.h>
 
 #include "Segmentation.h"
 
@@ -159,53 +160,30 @@ void Segmentation::perform(int ksearch)
 
 // ----------------------------------------------------------------------------
 
-#if defined (HAVE_PCL_FILTERS)
 NormalEstimation::NormalEstimation(const Points::PointKernel& pts)
   : myPoints(pts)
   , kSearch(0)
   , searchRadius(0)
+  , propagate(false)
 {
 }
 
 void NormalEstimation::perform(std::vector<Base::Vector3d>& normals)
 {
     // Copy the points
-    pcl::PointCloud<PointXYZ>::Ptr cloud (new pcl::PointCloud<PointXYZ>);
-    cloud->reserve(myPoints.size());
+    std::vector<Base::Vector3d> points;
+    points.reserve(myPoints.size());
     for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        cloud->push_back(pcl::PointXYZ(it->x, it->y, it->z));
+        points.push_back(*it);
     }
 
-    cloud->width = int (cloud->points.size ());
-    cloud->height = 1;
-
-#if 0
-    // Build a passthrough filter to remove spurious NaNs
-    pcl::PointCloud<PointXYZ>::Ptr cloud_filtered (new pcl::PointCloud<PointXYZ>);
-    pcl::PassThrough<PointXYZ> pass;
-    pass.setInputCloud (cloud);
-    pass.setFilterFieldName ("z");
-    pass.setFilterLimits (0, 1.5);
-    pass.filter (*cloud_filtered);
-#endif
-
     // Estimate point normals
-    pcl::PointCloud<pcl::Normal>::Ptr cloud_normals (new pcl::PointCloud<pcl::Normal>);
-    pcl::search::KdTree<PointXYZ>::Ptr tree (new pcl::search::KdTree<PointXYZ> ());
-    pcl::NormalEstimation<PointXYZ, pcl::Normal> ne;
-    ne.setSearchMethod (tree);
-    //ne.setInputCloud (cloud_filtered);
-    ne.setInputCloud (cloud);
+    Points::NormalEstimation ne(points);
     if (kSearch > 0)
         ne.setKSearch (kSearch);
     if (searchRadius > 0)
-        ne.setRadiusSearch (searchRadius);
-    ne.compute (*cloud_normals);
-
-    normals.reserve(cloud_normals->size());
-    for (pcl::PointCloud<pcl::Normal>::const_iterator it = cloud_normals->begin(); it != cloud_normals->end(); ++it) {
-        normals.push_back(Base::Vector3d(it->normal_x, it->normal_y, it->normal_z));
-    }
+        ne.setSearchRadius (searchRadius);
+    if (propagate)
+        ne.setOrientation (Points::NormalEstimation::Orientation::Propagate);
+    ne.perform (normals);
 }
-
-#endif // HAVE_PCL_FILTERS
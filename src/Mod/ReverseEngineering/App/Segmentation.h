@@ -67,6 +67,15 @@ public:
         searchRadius = radius;
     }
 
+    /** \brief Set whether the orientation of the normals is propagated over the
+      * neighbourhood graph instead of flipping them towards the origin.
+      */
+    inline void
+    setPropagateOrientation (bool on)
+    {
+        propagate = on;
+    }
+
     /** \brief Perform the normal estimation.
       * \param[out] the estimated normals
       */
@@ -76,6 +85,7 @@ private:
     const Points::PointKernel& myPoints;
     int kSearch;
     double searchRadius;
+    bool propagate;
 };
 
 } // namespace Reen
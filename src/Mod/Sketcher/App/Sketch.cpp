@@ -69,7 +69,9 @@ TYPESYSTEM_SOURCE(Sketcher::Sketch, Base::Persistence)
 
 Sketch::Sketch()
   : SolveTime(0)
+  , DiagnoseTime(0)
   , RecalculateInitialSolutionWhileMovingPoint(false)
+  , DragTimeBudget(0)
   , resolveAfterGeometryUpdated(false)
   , GCSsys(), ConstraintsCounter(0)
   , isInitMove(false), isFine(true), moveStep(0)
@@ -248,6 +250,9 @@ int Sketch::setUpSketch(const std::vector<Part::Geometry *> &GeoList,
     clearTemporaryConstraints();
     GCSsys.declareUnknowns(Parameters);
     GCSsys.declareDrivenParams(DrivenParameters);
+
+    Base::TimeInfo diagnose_time;
+
     GCSsys.initSolution(defaultSolverRedundant);
 
     // Post-analysis
@@ -309,9 +314,11 @@ int Sketch::setUpSketch(const std::vector<Part::Geometry *> &GeoList,
 
     calculateDependentParametersElements();
 
-    if (debugMode==GCS::Minimal || debugMode==GCS::IterationLevel) {
-        Base::TimeInfo end_time;
+    Base::TimeInfo end_time;
+
+    DiagnoseTime = Base::TimeInfo::diffTimeF(diagnose_time,end_time);
 
+    if (debugMode==GCS::Minimal || debugMode==GCS::IterationLevel) {
         Base::Console().Log("Sketcher::setUpSketch()-T:%s\n",Base::TimeInfo::diffTime(start_time,end_time).c_str());
     }
 
@@ -3590,10 +3597,13 @@ Base::Vector3d Sketch::calculateNormalAtPoint(int geoIdCurve, double px, double
     return Base::Vector3d(tx,ty,0.0);
 }
 
-bool Sketch::updateGeometry()
+bool Sketch::updateGeometry(const std::vector<bool> &geoMask)
 {
     int i=0;
     for (std::vector<GeoDef>::const_iterator it=Geoms.begin(); it != Geoms.end(); ++it, i++) {
+        if (!geoMask.empty() && !geoMask[i])
+            continue;
+
         try {
             if (it->type == Point) {
                 GeomPoint *point = static_cast<GeomPoint*>(it->geo);
@@ -4340,6 +4350,64 @@ int Sketch::initBSplinePieceMove(int geoId, PointPos pos, const Base::Vector3d&
 }
 
 int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative)
+{
+    int ret = setMoveTarget(geoId, pos, toPoint, relative);
+    if (ret != 0)
+        return ret;
+
+    return solve();
+}
+
+int Sketch::dragPoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative)
+{
+    int ret = setMoveTarget(geoId, pos, toPoint, relative);
+    if (ret != 0)
+        return ret;
+
+    // OCCT reliant geometry needs the second solve of the regular solver
+    if (DragTimeBudget <= 0 || !isInitMove || resolveAfterGeometryUpdated)
+        return solve();
+
+    Base::TimeInfo start_time;
+
+    if (GCSsys.solveInteractive(DragTimeBudget) == GCS::Success) {
+        // only the geometry of the dragged components may have changed
+        std::vector<double *> params;
+        GCSsys.getInteractiveParams(params);
+
+        std::vector<bool> geoMask(Geoms.size(), false);
+        for (auto param : params) {
+            auto element = param2geoelement.find(param);
+            if (element == param2geoelement.end()) {
+                geoMask.clear(); // not mapped, update all the geometry
+                break;
+            }
+            geoMask[std::get<0>(element->second)] = true;
+        }
+
+        GCSsys.applySolution();
+        if (updateGeometry(geoMask)) {
+            updateNonDrivingConstraints();
+
+            Base::TimeInfo end_time;
+
+            if(debugMode==GCS::Minimal || debugMode==GCS::IterationLevel){
+                Base::Console().Log("Sketcher::dragPoint()-T:%s\n",Base::TimeInfo::diffTime(start_time,end_time).c_str());
+            }
+
+            SolveTime = Base::TimeInfo::diffTimeF(start_time,end_time);
+
+            return GCS::Success;
+        }
+
+        GCSsys.undoSolution();
+    }
+
+    // fall back to the regular solver
+    return solve();
+}
+
+int Sketch::setMoveTarget(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative)
 {
     geoId = checkGeoId(geoId);
 
@@ -4454,7 +4522,7 @@ int Sketch::movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool rela
         }
     }
 
-    return solve();
+    return 0;
 }
 
 int Sketch::setDatum(int /*constrId*/, double /*value*/)
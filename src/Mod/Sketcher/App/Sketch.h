@@ -110,6 +110,9 @@ public:
     inline const std::vector<int> &getPartiallyRedundant() const { return PartiallyRedundant; }
 
     inline float getSolveTime() const { return SolveTime; }
+    inline float getDiagnoseTime() const { return DiagnoseTime; }
+    /// total number of iterations run by the solver algorithms of this sketch
+    inline long getSolverIterations() const { return GCSsys.getIterationCount(); }
 
     inline bool hasMalformedConstraints() const { return !MalformedConstraints.empty(); }
     inline const std::vector<int> &getMalformedConstraints() const { return MalformedConstraints; }
@@ -151,6 +154,24 @@ public:
       */
     int movePoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative=false);
 
+    /** move this point (or curve) to a new location and solve in low latency mode.
+      * Meant for the intermediate positions of an interactive drag: only the dragged part of the
+      * sketch is solved, starting from the previous position, until the drag time budget is
+      * spent. If the low latency solver fails, or is disabled, it solves as movePoint does.
+      * The final position of a drag should be set with movePoint for a full accuracy solution.
+      */
+    int dragPoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative=false);
+
+    /**
+     * Time budget in seconds of the solver in dragPoint. Zero or a negative budget disables the
+     * low latency mode.
+     */
+    double getDragTimeBudget() const
+        {return DragTimeBudget;}
+
+    void setDragTimeBudget(double dragTimeBudget)
+        {DragTimeBudget = dragTimeBudget;}
+
     /**
      * Sets whether the initial solution should be recalculated while dragging after a certain distance from the previous drag point
      * for smoother dragging operation.
@@ -423,7 +444,9 @@ public:
 
 protected:
     float SolveTime;
+    float DiagnoseTime; // initialisation and diagnosis of the solver in the last setUpSketch
     bool RecalculateInitialSolutionWhileMovingPoint;
+    double DragTimeBudget;
 
     // regulates a second solve for cases where there result of having update the geometry (e.g. via OCCT)
     // needs to be taken into account by the solver (for example to provide the right value of non-driving constraints)
@@ -529,7 +552,8 @@ protected:
 
 private:
 
-    bool updateGeometry();
+    /// updates the geometry from the solver, only the geometry set in geoMask if it is not empty
+    bool updateGeometry(const std::vector<bool> &geoMask = std::vector<bool>());
     bool updateNonDrivingConstraints();
 
     void calculateDependentParametersElements();
@@ -540,6 +564,9 @@ private:
 
     int internalSolve(std::string & solvername, int level = 0);
 
+    /// sets the position the temporary constraints of a point (or curve) move pull to
+    int setMoveTarget(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative);
+
     /// checks if the index bounds and converts negative indices to positive
     int checkGeoId(int geoId) const;
     GCS::Curve* getGCSCurveByGeoId(int geoId);
@@ -459,11 +459,15 @@ public: /* Solver exposed interface */
     /// enables/disables solver initial solution recalculation when moving point mode (useful for dragging)
     inline void setRecalculateInitialSolutionWhileMovingPoint(bool recalculateInitialSolutionWhileMovingPoint)
         {solvedSketch.setRecalculateInitialSolutionWhileMovingPoint(recalculateInitialSolutionWhileMovingPoint);}
+    /// sets the time budget in seconds of the low latency solver used by moveTemporaryPoint (zero disables it)
+    inline void setDragTimeBudget(double dragTimeBudget)
+        {solvedSketch.setDragTimeBudget(dragTimeBudget);}
     /// Forwards a request for a temporary initMove to the solver using the current sketch state as a reference (enables dragging)
     inline int initTemporaryMove(int geoId, PointPos pos, bool fine=true);
     /// Forwards a request for a temporary initBSplinePieceMove to the solver using the current sketch state as a reference (enables dragging)
     inline int initTemporaryBSplinePieceMove(int geoId, PointPos pos, const Base::Vector3d& firstPoint, bool fine=true);
     /** Forwards a request for point or curve temporary movement to the solver using the current state as a reference (enables dragging).
+     *  The solver runs in low latency mode if a drag time budget is set, so the final position should be set with movePoint().
      *  NOTE: A temporary move operation must always be preceded by a initTemporaryMove() operation.
      */
     inline int moveTemporaryPoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative=false);
@@ -718,7 +722,7 @@ inline int SketchObject::initTemporaryBSplinePieceMove(int geoId, PointPos pos,
 
 inline int SketchObject::moveTemporaryPoint(int geoId, PointPos pos, Base::Vector3d toPoint, bool relative/*=false*/)
 {
-    return solvedSketch.movePoint(geoId, pos, toPoint, relative);
+    return solvedSketch.dragPoint(geoId, pos, toPoint, relative);
 }
 
 template <  typename GeometryT,
@@ -30,6 +30,8 @@
 #include "SketchPy.h"
 #include "SketchPy.cpp"
 #include "ConstraintPy.h"
+#include "SketchObject.h"
+#include "SketchObjectPy.h"
 
 
 using namespace Sketcher;
@@ -136,6 +138,52 @@ PyObject* SketchPy::addConstraint(PyObject *args)
     }
 }
 
+PyObject* SketchPy::setUpSketch(PyObject *args)
+{
+    PyObject *pcObj;
+    if (PyArg_ParseTuple(args, "O!", &(SketchObjectPy::Type), &pcObj)) {
+        SketchObject* obj = static_cast<SketchObjectPy*>(pcObj)->getSketchObjectPtr();
+        int dofs = getSketchPtr()->setUpSketch(obj->getCompleteGeometry(), obj->Constraints.getValues(),
+                                               obj->getExternalGeometryCount());
+        return Py::new_reference_to(Py::Long(dofs));
+    }
+
+    PyErr_Clear();
+    PyObject *pcCons;
+    int extGeoCount=0;
+    if (!PyArg_ParseTuple(args, "OO|i", &pcObj, &pcCons, &extGeoCount))
+        return nullptr;
+
+    std::vector<Part::Geometry *> geoList;
+    Py::Sequence geos(pcObj);
+    for (Py::Sequence::iterator it = geos.begin(); it != geos.end(); ++it) {
+        if (!PyObject_TypeCheck((*it).ptr(), &(Part::GeometryPy::Type))) {
+            std::string error = std::string("type must be 'Geometry', not ");
+            error += (*it).ptr()->ob_type->tp_name;
+            throw Py::TypeError(error);
+        }
+        geoList.push_back(static_cast<Part::GeometryPy*>((*it).ptr())->getGeometryPtr());
+    }
+
+    std::vector<Constraint *> conList;
+    Py::Sequence cons(pcCons);
+    for (Py::Sequence::iterator it = cons.begin(); it != cons.end(); ++it) {
+        if (!PyObject_TypeCheck((*it).ptr(), &(ConstraintPy::Type))) {
+            std::string error = std::string("type must be 'Constraint', not ");
+            error += (*it).ptr()->ob_type->tp_name;
+            throw Py::TypeError(error);
+        }
+        conList.push_back(static_cast<ConstraintPy*>((*it).ptr())->getConstraintPtr());
+    }
+
+    if (extGeoCount < 0 || extGeoCount > int(geoList.size())) {
+        PyErr_SetString(PyExc_ValueError, "invalid external geometry count");
+        return nullptr;
+    }
+
+    return Py::new_reference_to(Py::Long(getSketchPtr()->setUpSketch(geoList, conList, extGeoCount)));
+}
+
 PyObject* SketchPy::clear(PyObject *args)
 {
     if (!PyArg_ParseTuple(args, ""))
@@ -158,6 +206,29 @@ PyObject* SketchPy::movePoint(PyObject *args)
     return Py::new_reference_to(Py::Long(getSketchPtr()->movePoint(index1,static_cast<Sketcher::PointPos>(index2),*toPoint,(relative>0))));
 }
 
+PyObject* SketchPy::dragPoint(PyObject *args)
+{
+    int index1,index2;
+    PyObject *pcObj;
+    int relative=0;
+    if (!PyArg_ParseTuple(args, "iiO!|i", &index1,&index2,&(Base::VectorPy::Type),&pcObj,&relative))
+        return nullptr;
+    Base::Vector3d* toPoint = static_cast<Base::VectorPy*>(pcObj)->getVectorPtr();
+
+    return Py::new_reference_to(Py::Long(getSketchPtr()->dragPoint(index1,static_cast<Sketcher::PointPos>(index2),*toPoint,(relative>0))));
+}
+
+PyObject* SketchPy::initMove(PyObject *args)
+{
+    int index1,index2;
+    PyObject *fine = Py_True;
+    if (!PyArg_ParseTuple(args, "ii|O!", &index1,&index2,&PyBool_Type,&fine))
+        return nullptr;
+
+    return Py::new_reference_to(Py::Long(getSketchPtr()->initMove(index1,static_cast<Sketcher::PointPos>(index2),
+                                                                  PyObject_IsTrue(fine) ? true : false)));
+}
+
 // +++ attributes implementer ++++++++++++++++++++++++++++++++++++++++++++++++
 
 Py::Long SketchPy::getConstraint() const
@@ -198,6 +269,31 @@ Py::Object SketchPy::getShape() const
     return Py::asObject(new TopoShapePy(new TopoShape(getSketchPtr()->toShape())));
 }
 
+Py::Float SketchPy::getSolveTime() const
+{
+    return Py::Float(getSketchPtr()->getSolveTime());
+}
+
+Py::Float SketchPy::getDiagnoseTime() const
+{
+    return Py::Float(getSketchPtr()->getDiagnoseTime());
+}
+
+Py::Float SketchPy::getDragTimeBudget() const
+{
+    return Py::Float(getSketchPtr()->getDragTimeBudget());
+}
+
+void SketchPy::setDragTimeBudget(Py::Float arg)
+{
+    getSketchPtr()->setDragTimeBudget(static_cast<double>(arg));
+}
+
+Py::Long SketchPy::getSolverIterations() const
+{
+    return Py::Long(getSketchPtr()->getSolverIterations());
+}
+
 
 // +++ custom attributes implementer ++++++++++++++++++++++++++++++++++++++++
 
@@ -86,6 +86,16 @@ double Constraint::grad(double * /*param*/)
     return 0.0;
 }
 
+void Constraint::derivatives(VEC_D &derivs)
+{
+    // grad() already sums up all occurrences of a parameter, so only its first position gets it
+    derivs.assign(pvec.size(), 0.);
+    for (std::size_t i = 0; i < pvec.size(); i++) {
+        if (std::find(pvec.begin(), pvec.begin() + i, pvec[i]) == pvec.begin() + i)
+            derivs[i] = grad(pvec[i]);
+    }
+}
+
 double Constraint::maxStep(MAP_pD_D & /*dir*/, double lim)
 {
     return lim;
@@ -138,6 +148,13 @@ double ConstraintEqual::grad(double *param)
     return scale * deriv;
 }
 
+void ConstraintEqual::derivatives(VEC_D &derivs)
+{
+    derivs.resize(2);
+    derivs[0] = scale;
+    derivs[1] = -scale;
+}
+
 
 // --------------------------------------------------------
 // Weighted Linear Combination
@@ -639,6 +656,14 @@ double ConstraintDifference::grad(double* param)
     return scale * deriv;
 }
 
+void ConstraintDifference::derivatives(VEC_D &derivs)
+{
+    derivs.resize(3);
+    derivs[0] = -scale;
+    derivs[1] = scale;
+    derivs[2] = -scale;
+}
+
 
 // --------------------------------------------------------
 // P2PDistance
@@ -694,6 +719,19 @@ double ConstraintP2PDistance::grad(double* param)
     return scale * deriv;
 }
 
+void ConstraintP2PDistance::derivatives(VEC_D &derivs)
+{
+    double dx = (*p1x() - *p2x());
+    double dy = (*p1y() - *p2y());
+    double d = sqrt(dx * dx + dy * dy);
+    derivs.resize(5);
+    derivs[0] = scale * dx / d;
+    derivs[1] = scale * dy / d;
+    derivs[2] = -scale * dx / d;
+    derivs[3] = -scale * dy / d;
+    derivs[4] = -scale;
+}
+
 double ConstraintP2PDistance::maxStep(MAP_pD_D& dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -1009,6 +1047,24 @@ double ConstraintPointOnLine::grad(double* param)
     return scale * deriv;
 }
 
+void ConstraintPointOnLine::derivatives(VEC_D &derivs)
+{
+    double x0 = *p0x(), x1 = *p1x(), x2 = *p2x();
+    double y0 = *p0y(), y1 = *p1y(), y2 = *p2y();
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double d2 = dx * dx + dy * dy;
+    double d = sqrt(d2);
+    double area = -x0 * dy + y0 * dx + x1 * y2 - x2 * y1;
+    derivs.resize(6);
+    derivs[0] = scale * (y1 - y2) / d;
+    derivs[1] = scale * (x2 - x1) / d;
+    derivs[2] = scale * ((y2 - y0) * d + (dx / d) * area) / d2;
+    derivs[3] = scale * ((x0 - x2) * d + (dy / d) * area) / d2;
+    derivs[4] = scale * ((y0 - y1) * d - (dx / d) * area) / d2;
+    derivs[5] = scale * ((x1 - x0) * d - (dy / d) * area) / d2;
+}
+
 
 // --------------------------------------------------------
 // PointOnPerpBisector
@@ -1151,6 +1207,23 @@ double ConstraintParallel::grad(double* param)
     return scale * deriv;
 }
 
+void ConstraintParallel::derivatives(VEC_D &derivs)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    derivs.resize(8);
+    derivs[0] = scale * dy2;
+    derivs[1] = -scale * dx2;
+    derivs[2] = -scale * dy2;
+    derivs[3] = scale * dx2;
+    derivs[4] = -scale * dy1;
+    derivs[5] = scale * dx1;
+    derivs[6] = scale * dy1;
+    derivs[7] = -scale * dx1;
+}
+
 
 // --------------------------------------------------------
 // Perpendicular
@@ -1230,6 +1303,23 @@ double ConstraintPerpendicular::grad(double* param)
     return scale * deriv;
 }
 
+void ConstraintPerpendicular::derivatives(VEC_D &derivs)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    derivs.resize(8);
+    derivs[0] = scale * dx2;
+    derivs[1] = scale * dy2;
+    derivs[2] = -scale * dx2;
+    derivs[3] = -scale * dy2;
+    derivs[4] = scale * dx1;
+    derivs[5] = scale * dy1;
+    derivs[6] = -scale * dx1;
+    derivs[7] = -scale * dy1;
+}
+
 
 // --------------------------------------------------------
 // L2LAngle
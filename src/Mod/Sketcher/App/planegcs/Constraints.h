@@ -135,7 +135,10 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
-        // virtual void grad(MAP_pD_D &deriv);  --> TODO: vectorized grad version
+        // Vectorized version of grad(): derivs[i] receives the partial derivative with respect
+        // to the i-th entry of params(). A parameter that appears several times in params() has
+        // the sum of the entries at its positions as derivative.
+        virtual void derivatives(VEC_D &derivs);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
         // Finds first occurrence of param in pvec. This is useful to test if a constraint depends
         // on the parameter (it may not actually depend on it, e.g. angle-via-point doesn't depend
@@ -157,6 +160,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
     };
 
     // Center of Gravity
@@ -269,6 +273,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
     };
 
     // P2PDistance
@@ -289,6 +294,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
         double maxStep(MAP_pD_D &dir, double lim=1.) override;
     };
 
@@ -358,6 +364,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
     };
 
     // PointOnPerpBisector
@@ -405,6 +412,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
     };
 
     // Perpendicular
@@ -429,6 +437,7 @@ namespace GCS
         void rescale(double coef=1.) override;
         double error() override;
         double grad(double *) override;
+        void derivatives(VEC_D &derivs) override;
     };
 
     // L2LAngle
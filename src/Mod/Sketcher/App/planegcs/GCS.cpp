@@ -51,9 +51,14 @@
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <chrono>
 #include <limits>
+#include <functional>
 #include <future>
+#include <thread>
+#include <unordered_map>
 
 #include "GCS.h"
 #include "qp_eq.h"
@@ -441,6 +446,61 @@ void SolverReportingManager::LogMatrix(const std::string str, MatrixIndexType ma
 
 using Graph = boost::adjacency_list <boost::vecS, boost::vecS, boost::undirectedS>;
 
+// Below this amount of parameters, decoupled components are solved (or diagnosed) one after the
+// other, as starting the threads would take longer than the work itself.
+constexpr std::size_t ConcurrencyMinimalParameters = 256;
+
+// Calls func(i) for every i in [0, size), spreading the calls over the hardware threads. The calls
+// must not depend on each other, and each one only writes to its own part of the results, so the
+// outcome does not depend on which thread runs which index.
+template<typename Func>
+static void parallelFor(int size, Func func)
+{
+    int threads = std::min<int>(size, std::max(1U, std::thread::hardware_concurrency()));
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next++; i < size; i = next++)
+            func(i);
+    };
+
+    std::vector<std::future<void>> futures;
+    for (int t=1; t < threads; t++)
+        futures.push_back(std::async(std::launch::async, worker));
+    worker();
+    for (auto& fut : futures)
+        fut.get();
+}
+
+// Interactive solving alternates pulls towards the temporary constraints (B) and projections
+// back onto the constraints of the sketch (A). Both are simplified Newton steps on the KKT
+// system of the Gauss-Newton step
+//
+//   | JB'JB + mu I   JA'    | | dx      |   | -JB' rB |
+//   | JA             -eps I | | -lambda | = | -rA     |
+//
+// with the right hand side -JB' rB dropped for the projections. mu damps the step in the
+// directions the temporary constraints do not pull (the rest of the sketch moves as little as
+// possible), eps regularises dependent constraints. The matrix is only factorized again once the
+// iterations stop contracting, so most drag steps only cost some residual evaluations and
+// triangular solves.
+constexpr double InteractiveStepDamping = 1e-6;
+constexpr double InteractiveRegularization = 1e-10;
+// ratio of the errors of two iterations above which the factorization is renewed
+constexpr double InteractiveContraction = 0.25;
+// corrections after which a pull that could not be brought back onto the constraints is undone
+constexpr int InteractiveMaxCorrections = 10;
+// error of the constraints of the sketch under which a drag step is accepted
+constexpr double InteractiveMaxError = 1e-16;
+
+struct System::InteractiveComponent
+{
+    int cid = 0;
+    VEC_pD plist; // union of the parameters of both subsystems
+    Eigen::SparseLU<Eigen::SparseMatrix<double>> kkt;
+    bool factorized = false;
+    double stepLength = std::numeric_limits<double>::infinity(); // longest pull still accepted
+};
+
 ///////////////////////////////////////
 // Solver
 ///////////////////////////////////////
@@ -455,12 +515,16 @@ System::System()
   , p2c()
   , subSystems(0)
   , subSystemsAux(0)
+  , isInteractiveInit(false)
   , reference(0)
   , dofs(0)
   , hasUnknowns(false)
   , hasDiagnosis(false)
   , isInit(false)
   , emptyDiagnoseMatrix(true)
+  , iterationCount(0)
+  , diagnosedQRAlgorithm(EigenSparseQR)
+  , diagnosedQRPivotThreshold(0)
   , maxIter(100)
   , maxIterRedundant(100)
   , sketchSizeMultiplier(false)
@@ -483,6 +547,7 @@ System::System()
   , DL_tolgRedundant(1E-80)
   , DL_tolxRedundant(1E-80)
   , DL_tolfRedundant(1E-10)
+  , concurrentSolving(true)
 {
     // currently Eigen only supports multithreading for multiplications
     // There is no appreciable gain from using more threads
@@ -1751,23 +1816,48 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     if (!isInit)
         return Failed;
 
-    bool isReset = false;
-    // return success by default in order to permit coincidence constraints to be applied
-    // even if no other system has to be solved
-    int res = Success;
+    VEC_I cids; // components having something to solve
+    std::size_t paramsNum = 0;
     for (int cid=0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-             resetToReference();
-             isReset = true;
+        if (subSystems[cid] || subSystemsAux[cid]) {
+            cids.push_back(cid);
+            paramsNum += plists[cid].size();
         }
+    }
+
+    if (!cids.empty())
+        resetToReference();
+
+    // Components share neither parameters nor constraints, so they can be solved concurrently.
+    // Each component stores its own result and the worst one is taken afterwards, so the outcome
+    // does not depend on the order the components finish in. Iteration level logging is not
+    // thread-safe, hence it forces sequential solving.
+    VEC_I results(cids.size(), Success);
+    auto solveComponent = [&](int i) {
+        int cid = cids[i];
         if (subSystems[cid] && subSystemsAux[cid])
-             res = std::max(res,
-                            solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving));
+            results[i] = solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving);
         else if (subSystems[cid])
-            res = std::max(res, solve(subSystems[cid], isFine, alg, isRedundantsolving));
-        else if (subSystemsAux[cid])
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
+            results[i] = solve(subSystems[cid], isFine, alg, isRedundantsolving);
+        else
+            results[i] = solve(subSystemsAux[cid], isFine, alg, isRedundantsolving);
+    };
+
+    if (concurrentSolving && debugMode != IterationLevel && cids.size() > 1
+        && paramsNum >= ConcurrencyMinimalParameters) {
+        parallelFor(int(cids.size()), solveComponent);
     }
+    else {
+        for (int i=0; i < int(cids.size()); i++)
+            solveComponent(i);
+    }
+
+    // return success by default in order to permit coincidence constraints to be applied
+    // even if no other system has to be solved
+    int res = Success;
+    for (int result : results)
+        res = std::max(res, result);
+
     if (res == Success) {
         for (std::set<Constraint *>::const_iterator constr=redundant.begin();
              constr != redundant.end(); ++constr){
@@ -1847,7 +1937,8 @@ int System::solve_BFGS(SubSystem *subsys, bool /*isFine*/, bool isRedundantsolvi
     double divergingLim = 1e6*err + 1e12;
     double h_norm;
 
-    for (int iter=1; iter < maxIterNumber; iter++) {
+    int iter=1;
+    for (; iter < maxIterNumber; iter++) {
         h_norm = h.norm();
         if (h_norm <= (isRedundantsolving?convergenceRedundant:convergence) || err <= smallF){
            if(debugMode==IterationLevel) {
@@ -1910,6 +2001,8 @@ int System::solve_BFGS(SubSystem *subsys, bool /*isFine*/, bool isRedundantsolvi
         }
     }
 
+    iterationCount += iter - 1;
+
     subsys->revertParams();
 
     if (err <= smallF)
@@ -1933,9 +2026,13 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd e(csize),
         e_new(csize);// vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);// Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Eigen::SparseMatrix<double> J(csize, xsize);// Jacobi of the subsystem
+    Eigen::SparseMatrix<double> A(xsize, xsize), A_mu(xsize, xsize);
+    Eigen::SparseMatrix<double> I(xsize, xsize);
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt;
+
+    I.setIdentity();
 
     subsys->redirectParams();
 
@@ -1982,14 +2079,14 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
+        subsys->calcJacobi(J);
 
         A = J.transpose()*J;
         g = J.transpose()*e;
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
+        diag_A = A.diagonal();
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -2006,12 +2103,15 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         int k=0;
         while (k < 50) {
             // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+            A_mu = A + mu*I;
 
             //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A*h - g).norm() / g.norm();
+            ldlt.compute(A_mu);
+            if (ldlt.info() == Eigen::Success)
+                h = ldlt.solve(g);
+            else
+                h = Eigen::MatrixXd(A_mu).fullPivLu().solve(g);
+            double rel_error = (A_mu*h - g).norm() / g.norm();
 
             // check if solving works
             if (rel_error < 1e-5) {
@@ -2058,8 +2158,6 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
 
             k++;
         }
@@ -2084,6 +2182,8 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
     if (iter >= maxIterNumber)
         stop = 5;
 
+    iterationCount += iter;
+
     subsys->revertParams();
 
     return (stop == 1) ? Success : Failed;
@@ -2128,8 +2228,9 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    Eigen::SparseMatrix<double> Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > ldlt;
 
     subsys->redirectParams();
 
@@ -2172,16 +2273,23 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
             // get the gauss-newton step
             // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
             // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
+            // the pivoting LU decompositions are only available for dense matrices
             switch (dogLegGaussStep){
                 case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
+                    h_gn = Eigen::MatrixXd(Jx).fullPivLu().solve(-fx);
                     break;
                 case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
+                    h_gn = Jx.adjoint()*Eigen::MatrixXd(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
                     break;
-                case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
+                case LeastNormLdlt: {
+                    Eigen::SparseMatrix<double> JJt = Jx*Jx.adjoint();
+                    ldlt.compute(JJt);
+                    if (ldlt.info() == Eigen::Success)
+                        h_gn = Jx.adjoint()*ldlt.solve(-fx);
+                    else // rank deficient, fall back to the pivoting dense LDLT
+                        h_gn = Jx.adjoint()*Eigen::MatrixXd(JJt).ldlt().solve(-fx);
                     break;
+                }
             }
 
             double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
@@ -2285,6 +2393,8 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         iter++;
     }
 
+    iterationCount += iter;
+
     subsys->revertParams();
 
     if(debugMode==IterationLevel) {
@@ -4486,7 +4596,8 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
 
     double mu = 0;
     lambda.setZero();
-    for (int iter=1; iter < maxIterNumber; iter++) {
+    int iter=1;
+    for (; iter < maxIterNumber; iter++) {
         int status = qp_eq(B, grad, JA, resA, xdir, Y, Z);
         if (status)
             break;
@@ -4583,6 +4694,8 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
             break;
     }
 
+    iterationCount += iter;
+
     int ret;
     if (subsysA->error() <= smallF)
         ret = Success;
@@ -4597,6 +4710,223 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
 
 }
 
+void System::initInteractive()
+{
+    interactiveComponents.clear();
+    for (int cid=0; cid < int(subSystemsAux.size()); cid++) {
+        if (!subSystemsAux[cid])
+            continue;
+
+        auto ic = std::make_unique<InteractiveComponent>();
+        ic->cid = cid;
+
+        VEC_pD plistA, plistB;
+        if (subSystems[cid])
+            subSystems[cid]->getParamList(plistA);
+        subSystemsAux[cid]->getParamList(plistB);
+        std::sort(plistA.begin(), plistA.end());
+        std::sort(plistB.begin(), plistB.end());
+        std::set_union(plistA.begin(), plistA.end(), plistB.begin(), plistB.end(),
+                       std::back_inserter(ic->plist));
+
+        interactiveComponents.push_back(std::move(ic));
+    }
+    isInteractiveInit = true;
+}
+
+int System::solveInteractive(double timeBudget, bool isRedundantsolving)
+{
+    if (!isInit)
+        return Failed;
+
+    auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(timeBudget));
+
+    if (!isInteractiveInit)
+        initInteractive();
+
+    // nothing is being dragged, let the regular solver handle it
+    if (interactiveComponents.empty())
+        return Failed;
+
+    int res = Success;
+    for (auto& ic : interactiveComponents)
+        res = std::max(res, solveInteractive(*ic, deadline, isRedundantsolving));
+
+    return res;
+}
+
+int System::solveInteractive(InteractiveComponent& ic,
+                             std::chrono::steady_clock::time_point deadline,
+                             bool isRedundantsolving)
+{
+    SubSystem* subsysA = subSystems[ic.cid];
+    SubSystem* subsysB = subSystemsAux[ic.cid];
+
+    int xsize = int(ic.plist.size());
+    int csizeA = subsysA ? subsysA->cSize() : 0;
+    if (xsize == 0)
+        return Success;
+
+    // Unlike solve(), the parameters are not reset to the reference: the last applied solution
+    // is the starting point, so that consecutive drag steps only have to cover the mouse motion.
+    if (subsysA)
+        subsysA->redirectParams();
+    subsysB->redirectParams();
+
+    Eigen::VectorXd x(xsize), xAccepted, grad(xsize), resA(csizeA), rhs(xsize + csizeA), dx;
+    subsysB->getParams(ic.plist, x);
+    if (subsysA)
+        subsysA->getParams(ic.plist, x);
+
+    auto setParams = [&]() {
+        subsysB->setParams(ic.plist, x);
+        if (subsysA)
+            subsysA->setParams(ic.plist, x);
+    };
+    setParams(); // just to ensure that A and B are synchronized
+
+    double tolx = isRedundantsolving ? convergenceRedundant : convergence;
+    int maxIterNumber = (isRedundantsolving?
+        (sketchSizeMultiplierRedundant?maxIterRedundant * xsize:maxIterRedundant):
+        (sketchSizeMultiplier?maxIter * xsize:maxIter));
+    int iter = 0;
+
+    auto factorize = [&]() {
+        Eigen::SparseMatrix<double> JA, JB;
+        if (subsysA)
+            subsysA->calcJacobi(ic.plist, JA);
+        subsysB->calcJacobi(ic.plist, JB);
+
+        Eigen::SparseMatrix<double> H = JB.transpose() * JB;
+        std::vector<Eigen::Triplet<double>> triplets;
+        triplets.reserve(H.nonZeros() + 2 * JA.nonZeros() + xsize + csizeA);
+        for (int k=0; k < H.outerSize(); ++k)
+            for (Eigen::SparseMatrix<double>::InnerIterator it(H, k); it; ++it)
+                triplets.emplace_back(it.row(), it.col(), it.value());
+        for (int j=0; j < xsize; j++)
+            triplets.emplace_back(j, j, InteractiveStepDamping);
+        for (int k=0; k < JA.outerSize(); ++k) {
+            for (Eigen::SparseMatrix<double>::InnerIterator it(JA, k); it; ++it) {
+                triplets.emplace_back(xsize + it.row(), it.col(), it.value());
+                triplets.emplace_back(it.col(), xsize + it.row(), it.value());
+            }
+        }
+        for (int i=0; i < csizeA; i++)
+            triplets.emplace_back(xsize + i, xsize + i, -InteractiveRegularization);
+
+        Eigen::SparseMatrix<double> K(xsize + csizeA, xsize + csizeA);
+        K.setFromTriplets(triplets.begin(), triplets.end());
+        ic.kkt.compute(K);
+        ic.factorized = (ic.kkt.info() == Eigen::Success);
+        return ic.factorized;
+    };
+
+    // Brings x back onto the constraints of the sketch with minimal norm corrections. The
+    // iterations with an old factorization converge linearly at best, so it is renewed as soon
+    // as they stop contracting. If a fresh one does not help either, the projection fails.
+    auto project = [&]() {
+        double err = subsysA ? subsysA->error() : 0.;
+        bool fresh = false;
+        for (int i=0; err > InteractiveMaxError; i++) {
+            if (i >= InteractiveMaxCorrections)
+                return false;
+            if (!ic.factorized) {
+                if (!factorize())
+                    return false;
+                fresh = true;
+            }
+
+            subsysA->calcResidual(resA);
+            rhs.head(xsize).setZero();
+            rhs.tail(csizeA) = -resA;
+            x += ic.kkt.solve(rhs).head(xsize);
+            setParams();
+            iter++;
+
+            double err1 = subsysA->error();
+            if (err1 != err1) // NaN
+                return false;
+            if (err1 > InteractiveContraction * err) {
+                if (fresh && err1 >= err)
+                    return false;
+                if (!fresh)
+                    ic.factorized = false;
+            }
+            fresh = false;
+            err = err1;
+        }
+        return true;
+    };
+
+    int ret = Failed;
+    if (project()) {
+        ret = Success;
+        xAccepted = x;
+
+        // Pull towards the temporary constraints, each pull being projected back onto the
+        // constraints of the sketch. A pull whose projection fails is retried shorter, and the
+        // step length is kept for the next call, as consecutive drag steps look alike.
+        while (iter < maxIterNumber && std::chrono::steady_clock::now() < deadline) {
+            if (!ic.factorized && !factorize())
+                break;
+
+            subsysB->calcGrad(ic.plist, grad);
+            rhs.head(xsize) = -grad;
+            if (subsysA) {
+                subsysA->calcResidual(resA);
+                rhs.tail(csizeA) = -resA;
+            }
+            dx = ic.kkt.solve(rhs).head(xsize);
+            iter++;
+
+            double length = dx.lpNorm<Eigen::Infinity>();
+            if (length <= tolx)
+                break;
+            if (length > ic.stepLength)
+                dx *= ic.stepLength / length;
+
+            x += dx;
+            setParams();
+            if (project()) {
+                xAccepted = x;
+                ic.stepLength *= 2;
+            }
+            else {
+                x = xAccepted;
+                setParams();
+                ic.stepLength = std::min(length, ic.stepLength) / 4;
+                ic.factorized = false;
+                if (ic.stepLength <= tolx)
+                    break;
+            }
+        }
+
+        x = xAccepted;
+        setParams();
+    }
+    else {
+        ic.factorized = false;
+    }
+
+    iterationCount += iter;
+
+    subsysB->revertParams();
+    if (subsysA)
+        subsysA->revertParams();
+
+    return ret;
+}
+
+void System::getInteractiveParams(VEC_pD& params) const
+{
+    params.clear();
+    for (const auto& ic : interactiveComponents) {
+        params.insert(params.end(), plists[ic->cid].begin(), plists[ic->cid].end());
+    }
+}
+
 void System::applySolution()
 {
     for (int cid=0; cid < int(subSystems.size()); cid++) {
@@ -4632,15 +4962,25 @@ void System::makeReducedJacobian(Eigen::MatrixXd &J,
 
     J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
 
+    MAP_pD_I columns;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        columns[pdiagnoselist[j]] = j;
+
     int jacobianconstraintcount=0;
     int allcount=0;
+    VEC_D derivs;
     for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
         (*constr)->revertParams();
         ++allcount;
         if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
             jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
+            // only the parameters of the constraint itself have non-zero derivatives
+            VEC_pD params = (*constr)->params();
+            (*constr)->derivatives(derivs);
+            for (std::size_t k=0; k < params.size(); k++) {
+                MAP_pD_I::const_iterator it = columns.find(params[k]);
+                if (it != columns.end())
+                    J(jacobianconstraintcount-1,it->second) += derivs[k];
             }
 
             // parallel processing: create tag multiplicity map
@@ -4700,6 +5040,8 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     conflictingTags.clear();
     redundantTags.clear();
     partiallyRedundantTags.clear();
+    pDependentParameters.clear();
+    pDependentParametersGroups.clear();
 
     // This QR diagnosis uses a reduced Jacobian matrix to calculate the rank of the system
     // and identify conflicting and redundant constraints.
@@ -4782,145 +5124,260 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     }
 #endif
 
-    if(qrAlgorithm==EigenDenseQR){
-    #ifdef PROFILE_DIAGNOSE
-        Base::TimeInfo DenseQR_start_time;
-    #endif
-        if (J.rows() > 0) {
-            int rank = 0; // rank is not cheap to retrieve from qrJT in DenseQR
-            Eigen::MatrixXd R;
-            Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
-            // Here we give the system the possibility to run the two QR decompositions in parallel,
-            // depending on the load of the system so we are using the default std::launch::async |
-            // std::launch::deferred policy, as nobody better than the system nows if it can run the
-            // task in parallel or is oversubscribed and should deferred it. Care to wait() for the
-            // future before any prospective detection of conflicting/redundant, because the
-            // redundant solve modifies pdiagnoselist and it would NOT be thread-safe. Care to call
-            // the thread with silent=true, unless the present thread does not use Base::Console, or
-            // the launch policy is set to std::launch::deferred policy, as it is not thread-safe to
-            // use them in both at the same time.
-            //
-            // identifyDependentParametersDenseQR(J, jacobianconstraintmap, pdiagnoselist, true)
-            //
-            auto fut = std::async(&System::identifyDependentParametersDenseQR,this,J,jacobianconstraintmap, pdiagnoselist, true);
-
-            makeDenseQRDecomposition( J, jacobianconstraintmap, qrJT, rank, R);
-
-            int paramsNum = qrJT.rows();
-            int constrNum = qrJT.cols();
-
-            // This function is legacy code that was used to obtain partial geometry dependency
-            // information from a SINGLE Dense QR decomposition. I am reluctant to remove it from
-            // here until everything new is well tested.
-            // identifyDependentGeometryParametersInTransposedJacobianDenseQRDecomposition( qrJT,
-            // pdiagnoselist, paramsNum, rank);
-
-            fut.wait(); // wait for the execution of identifyDependentParametersSparseQR to finish
-
-            dofs = paramsNum - rank; // unless overconstraint, which will be overridden below
-
-            // Detecting conflicting or redundant constraints
-            if (constrNum > rank) {// conflicting or redundant constraints
-                int nonredundantconstrNum;
-                identifyConflictingRedundantConstraints(alg,
-                                                        qrJT,
-                                                        jacobianconstraintmap,
-                                                        tagmultiplicity,
-                                                        pdiagnoselist,
-                                                        R,
-                                                        constrNum,
-                                                        rank,
-                                                        nonredundantconstrNum);
-                if (paramsNum == rank && nonredundantconstrNum > rank)// over-constrained
-                    dofs = paramsNum - nonredundantconstrNum;
+    // Block decomposition:
+    //
+    // Constraints not sharing any parameter (decoupled components of the sketch) make the reduced
+    // Jacobian block diagonal up to a permutation of rows and columns. The rank of J is the sum of
+    // the ranks of its blocks, and neither a group of conflicting constraints nor a group of
+    // dependent parameters can span more than one block. So each block is decomposed on its own,
+    // which is considerably cheaper than decomposing J as a whole.
+    //
+    // The result of a block only depends on its values. If the very same block was already
+    // decomposed by the previous diagnosis, which is the case for every component an edit of the
+    // sketch does not touch, its result is reused instead of decomposing it again. The redundant
+    // solving, which decides which of the conflicting constraints are merely redundant, still acts
+    // on the whole system.
+#ifdef PROFILE_DIAGNOSE
+    Base::TimeInfo QR_start_time;
+#endif
+    if (J.rows() > 0) {
+        int constrNum = jacobianconstraintmap.size();
+        int paramsNum = pdiagnoselist.size();
+
+        Graph g;
+        for (int i=0; i < constrNum + paramsNum; i++)
+            boost::add_vertex(g);
+
+        for (int row=0; row < constrNum; row++) {
+            for (int col=0; col < paramsNum; col++) {
+                if (J(row,col) != 0)
+                    boost::add_edge(row, constrNum + col, g);
             }
         }
-    #ifdef PROFILE_DIAGNOSE
-        Base::TimeInfo DenseQR_end_time;
 
-        auto SolveTime = Base::TimeInfo::diffTimeF(DenseQR_start_time,DenseQR_end_time);
+        VEC_I components(boost::num_vertices(g));
+        int componentsSize = boost::connected_components(g, &components[0]);
 
-        Base::Console().Log("\nDenseQR - Lapsed Time: %f seconds\n", SolveTime);
-    #endif
-    }
+        std::vector<VEC_I> blockRows(componentsSize), blockCols(componentsSize);
+        for (int row=0; row < constrNum; row++)
+            blockRows[components[row]].push_back(row);
+        for (int col=0; col < paramsNum; col++)
+            blockCols[components[constrNum + col]].push_back(col);
 
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-    else if(qrAlgorithm==EigenSparseQR){
-    #ifdef PROFILE_DIAGNOSE
-        Base::TimeInfo SparseQR_start_time;
-    #endif
-        if (J.rows() > 0) {
-            int rank = 0;
-            Eigen::MatrixXd R;
-            Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
-            // Here we give the system the possibility to run the two QR decompositions in parallel,
-            // depending on the load of the system so we are using the default std::launch::async |
-            // std::launch::deferred policy, as nobody better than the system nows if it can run the
-            // task in parallel or is oversubscribed and should deferred it. Care to wait() for the
-            // future before any prospective detection of conflicting/redundant, because the
-            // redundant solve modifies pdiagnoselist and it would NOT be thread-safe. Care to call
-            // the thread with silent=true, unless the present thread does not use Base::Console, or
-            // the launch policy is set to std::launch::deferred policy, as it is not thread-safe to
-            // use them in both at the same time.
-            //
-            // identifyDependentParametersSparseQR(J, jacobianconstraintmap, pdiagnoselist, true)
-            //
-            // Debug:
-            // auto fut =
-            // std::async(std::launch::deferred,&System::identifyDependentParametersSparseQR,this,J,jacobianconstraintmap,
-            // pdiagnoselist, false);
-            auto fut = std::async(&System::identifyDependentParametersSparseQR,
-                                  this,
-                                  J,
-                                  jacobianconstraintmap,
-                                  pdiagnoselist,
-                                  /*silent=*/true);
-
-            makeSparseQRDecomposition(
-                J, jacobianconstraintmap, SqrJT, rank, R, /*transposed=*/true, /*silent=*/false);
-
-            int paramsNum = SqrJT.rows();
-            int constrNum = SqrJT.cols();
-
-            fut.wait();// wait for the execution of identifyDependentParametersSparseQR to finish
-
-            dofs = paramsNum - rank;// unless overconstraint, which will be overridden below
-
-            // Detecting conflicting or redundant constraints
-            if (constrNum > rank) {// conflicting or redundant constraints
-
-                int nonredundantconstrNum;
-
-                identifyConflictingRedundantConstraints(alg,
-                                                        SqrJT,
-                                                        jacobianconstraintmap,
-                                                        tagmultiplicity,
-                                                        pdiagnoselist,
-                                                        R,
-                                                        constrNum,
-                                                        rank,
-                                                        nonredundantconstrNum);
-
-                if (paramsNum == rank && nonredundantconstrNum > rank)// over-constrained
-                    dofs = paramsNum - nonredundantconstrNum;
+        auto hashBlock = [](const Eigen::MatrixXd& M) {
+            std::size_t seed = std::hash<Eigen::Index>()(M.rows() * 31 + M.cols());
+            for (Eigen::Index i=0; i < M.size(); i++)
+                seed ^= std::hash<double>()(M.data()[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        };
+
+        // blocks are only interchangeable if they were decomposed the same way
+        if (diagnosedQRAlgorithm != qrAlgorithm || diagnosedQRPivotThreshold != qrpivotThreshold)
+            diagnosedBlocks.clear();
+
+        std::unordered_multimap<std::size_t, const DiagnosedBlock*> previousBlocks;
+        for (const DiagnosedBlock& block : diagnosedBlocks)
+            previousBlocks.emplace(block.hash, &block);
+
+        std::vector<DiagnosedBlock> blocks(componentsSize);
+        VEC_I pendingBlocks; // blocks not found in the previous diagnosis
+        std::size_t pendingParamsNum = 0;
+        int reusedBlocks = 0;
+        for (int cid=0; cid < componentsSize; cid++) {
+            DiagnosedBlock& block = blocks[cid];
+            const VEC_I& rows = blockRows[cid];
+            const VEC_I& cols = blockCols[cid];
+
+            block.J.resize(rows.size(), cols.size());
+            for (std::size_t i=0; i < rows.size(); i++) {
+                for (std::size_t j=0; j < cols.size(); j++)
+                    block.J(i,j) = J(rows[i],cols[j]);
+            }
+            block.hash = hashBlock(block.J);
+
+            const DiagnosedBlock* previous = nullptr;
+            auto range = previousBlocks.equal_range(block.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                const Eigen::MatrixXd& previousJ = it->second->J;
+                if (previousJ.rows() == block.J.rows() && previousJ.cols() == block.J.cols()
+                    && previousJ == block.J) {
+                    previous = it->second;
+                    break;
+                }
+            }
+
+            if (previous) {
+                block.rank = previous->rank;
+                block.conflictGroups = previous->conflictGroups;
+                block.dependentGroups = previous->dependentGroups;
+                reusedBlocks++;
+            }
+            else {
+                pendingBlocks.push_back(cid);
+                pendingParamsNum += cols.size();
             }
         }
 
-        #ifdef PROFILE_DIAGNOSE
-        Base::TimeInfo SparseQR_end_time;
+        // blocks are independent of each other, see System::solve
+        auto diagnosePendingBlock = [&](int i) {
+            diagnoseBlock(blocks[pendingBlocks[i]]);
+        };
+
+        if (concurrentSolving && debugMode != IterationLevel && pendingBlocks.size() > 1
+            && pendingParamsNum >= ConcurrencyMinimalParameters) {
+            parallelFor(int(pendingBlocks.size()), diagnosePendingBlock);
+        }
+        else {
+            for (int i=0; i < int(pendingBlocks.size()); i++)
+                diagnosePendingBlock(i);
+        }
+
+        diagnosedBlocks = std::move(blocks);
+        diagnosedQRAlgorithm = qrAlgorithm;
+        diagnosedQRPivotThreshold = qrpivotThreshold;
+
+        if (debugMode == Minimal || debugMode == IterationLevel) {
+            Base::Console().Log("Sketcher::Diagnose: %d of %d blocks reused\n",
+                                reusedBlocks,
+                                componentsSize);
+        }
+
+        // translate the block local results back to constraints and parameters of the system
+        int rank = 0;
+        std::vector<std::vector<Constraint*>> conflictGroups;
+        for (int cid=0; cid < componentsSize; cid++) {
+            const DiagnosedBlock& block = diagnosedBlocks[cid];
+            rank += block.rank;
+
+            for (const VEC_I& group : block.conflictGroups) {
+                std::vector<Constraint*> constraints;
+                constraints.reserve(group.size());
+                for (int row : group)
+                    constraints.push_back(clist[jacobianconstraintmap.at(blockRows[cid][row])]);
+                conflictGroups.push_back(std::move(constraints));
+            }
+
+            for (const VEC_I& group : block.dependentGroups) {
+                VEC_pD params;
+                params.reserve(group.size());
+                for (int col : group) {
+                    params.push_back(pdiagnoselist[blockCols[cid][col]]);
+                    pDependentParameters.push_back(params.back());
+                }
+                pDependentParametersGroups.push_back(std::move(params));
+            }
+        }
 
-        auto SolveTime = Base::TimeInfo::diffTimeF(SparseQR_start_time,SparseQR_end_time);
+#ifdef _GCS_DEBUG
+        SolverReportingManager::Manager().LogGroupOfParameters("ParameterGroups",
+                                                               pDependentParametersGroups);
+#endif
 
-        Base::Console().Log("\nSparseQR - Lapsed Time: %f seconds\n", SolveTime);
-        #endif
+        dofs = paramsNum - rank; // unless overconstraint, which will be overridden below
+
+        // Detecting conflicting or redundant constraints
+        if (constrNum > rank) {// conflicting or redundant constraints
+            int nonredundantconstrNum;
+            identifyConflictingRedundantConstraints(alg,
+                                                    conflictGroups,
+                                                    tagmultiplicity,
+                                                    pdiagnoselist,
+                                                    constrNum,
+                                                    nonredundantconstrNum);
+            if (paramsNum == rank && nonredundantconstrNum > rank)// over-constrained
+                dofs = paramsNum - nonredundantconstrNum;
+        }
     }
+#ifdef PROFILE_DIAGNOSE
+    Base::TimeInfo QR_end_time;
+
+    auto SolveTime = Base::TimeInfo::diffTimeF(QR_start_time,QR_end_time);
+
+    Base::Console().Log("\n%s - Lapsed Time: %f seconds\n",
+                        qrAlgorithm == EigenSparseQR ? "SparseQR" : "DenseQR",
+                        SolveTime);
 #endif
 
     return dofs;
 }
 
+void System::diagnoseBlock(DiagnosedBlock& block)
+{
+    // Rank, conflicting constraints and dependent parameters of a single block of the reduced
+    // Jacobian, in block local indices (see System::diagnose)
+    const Eigen::MatrixXd& J = block.J;
+    int constrNum = J.rows();
+    int paramsNum = J.cols();
+
+    block.rank = 0;
+    block.conflictGroups.clear();
+    block.dependentGroups.clear();
+
+    // A driving constraint not depending on any diagnosed parameter, or a parameter not taking
+    // part in any driving constraint, is a block on its own. Its rank is zero, and the constraint
+    // (or parameter) is a group by itself, just as a zero column in a QR decomposition would be.
+    if (constrNum == 0 || paramsNum == 0) {
+        for (int row=0; row < constrNum; row++)
+            block.conflictGroups.push_back(VEC_I(1, row));
+        for (int col=0; col < paramsNum; col++)
+            block.dependentGroups.push_back(VEC_I(1, col));
+        return;
+    }
+
+    // Here we give the system the possibility to run the two QR decompositions in parallel,
+    // depending on the load of the system so we are using the default std::launch::async |
+    // std::launch::deferred policy, as nobody better than the system nows if it can run the task
+    // in parallel or is oversubscribed and should deferred it. Care to call the thread with
+    // silent=true, unless the present thread does not use Base::Console, or the launch policy is
+    // set to std::launch::deferred policy, as it is not thread-safe to use them in both at the
+    // same time.
+    if(qrAlgorithm==EigenDenseQR){
+        Eigen::MatrixXd R;
+        Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
+
+        auto fut = std::async(&System::identifyDependentParametersDenseQR,
+                              this,
+                              std::cref(J),
+                              /*silent=*/true);
+
+        makeDenseQRDecomposition(J, qrJT, block.rank, R);
+
+        // This function is legacy code that was used to obtain partial geometry dependency
+        // information from a SINGLE Dense QR decomposition. I am reluctant to remove it from
+        // here until everything new is well tested.
+        // identifyDependentGeometryParametersInTransposedJacobianDenseQRDecomposition( qrJT,
+        // pdiagnoselist, paramsNum, rank);
+
+        block.dependentGroups = fut.get();
+
+        if (constrNum > block.rank)
+            block.conflictGroups = identifyConflictGroups(qrJT, R, constrNum, block.rank);
+    }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+    else if(qrAlgorithm==EigenSparseQR){
+        Eigen::MatrixXd R;
+        Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
+
+        // Debug:
+        // auto fut =
+        // std::async(std::launch::deferred,&System::identifyDependentParametersSparseQR,this,
+        // std::cref(J), false);
+        auto fut = std::async(&System::identifyDependentParametersSparseQR,
+                              this,
+                              std::cref(J),
+                              /*silent=*/true);
+
+        makeSparseQRDecomposition(J, SqrJT, block.rank, R, /*transposed=*/true, /*silent=*/false);
+
+        block.dependentGroups = fut.get();
+
+        if (constrNum > block.rank)
+            block.conflictGroups = identifyConflictGroups(SqrJT, R, constrNum, block.rank);
+    }
+#endif
+}
+
 void System::makeDenseQRDecomposition(  const Eigen::MatrixXd &J,
-                                        const std::map<int,int> &jacobianconstraintmap,
                                         Eigen::FullPivHouseholderQR<Eigen::MatrixXd>& qrJT,
                                         int &rank, Eigen::MatrixXd & R, bool transposeJ, bool silent)
 {
@@ -4944,9 +5401,9 @@ void System::makeDenseQRDecomposition(  const Eigen::MatrixXd &J,
     if (J.rows() > 0) {
         Eigen::MatrixXd JG;
         if(transposeJ)
-            JG = J.topRows(jacobianconstraintmap.size()).transpose();
+            JG = J.transpose();
         else
-            JG = J.topRows(jacobianconstraintmap.size());
+            JG = J;
 
         if (JG.rows() > 0 && JG.cols() > 0) {
 
@@ -4992,7 +5449,7 @@ void System::makeDenseQRDecomposition(  const Eigen::MatrixXd &J,
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
 void System::makeSparseQRDecomposition(
-    const Eigen::MatrixXd& J, const std::map<int, int>& jacobianconstraintmap,
+    const Eigen::MatrixXd& J,
     Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>>& SqrJT, int& rank,
     Eigen::MatrixXd& R, bool transposeJ, bool silent)
 {
@@ -5024,9 +5481,9 @@ void System::makeSparseQRDecomposition(
     if (SJ.rows() > 0) {
         Eigen::SparseMatrix<double> SJG;
         if (transposeJ)
-            SJG = SJ.topRows(jacobianconstraintmap.size()).transpose();
+            SJG = SJ.transpose();
         else
-            SJG = SJ.topRows(jacobianconstraintmap.size());
+            SJG = SJ;
 
         if (SJG.rows() > 0 && SJG.cols() > 0) {
             SqrJT.compute(SJG);
@@ -5076,26 +5533,22 @@ void System::makeSparseQRDecomposition(
 }
 #endif// EIGEN_SPARSEQR_COMPATIBLE
 
-void System::identifyDependentParametersDenseQR( const Eigen::MatrixXd &J,
-                                                  const std::map<int,int> &jacobianconstraintmap,
-                                                  const GCS::VEC_pD &pdiagnoselist,
-                                                  bool silent)
+std::vector<VEC_I> System::identifyDependentParametersDenseQR(const Eigen::MatrixXd &J,
+                                                              bool silent)
 {
     Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJ;
     Eigen::MatrixXd Rparams;
 
     int rank;
 
-    makeDenseQRDecomposition( J, jacobianconstraintmap, qrJ, rank, Rparams, false, true);
+    makeDenseQRDecomposition( J, qrJ, rank, Rparams, false, true);
 
-    identifyDependentParameters(qrJ, Rparams, rank, pdiagnoselist, silent);
+    return identifyDependentParameters(qrJ, Rparams, rank, silent);
 }
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
-void System::identifyDependentParametersSparseQR( const Eigen::MatrixXd &J,
-                                                  const std::map<int,int> &jacobianconstraintmap,
-                                                  const GCS::VEC_pD &pdiagnoselist,
-                                                  bool silent)
+std::vector<VEC_I> System::identifyDependentParametersSparseQR(const Eigen::MatrixXd &J,
+                                                               bool silent)
 {
     Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJ;
     Eigen::MatrixXd Rparams;
@@ -5103,23 +5556,21 @@ void System::identifyDependentParametersSparseQR( const Eigen::MatrixXd &J,
     int nontransprank;
 
     makeSparseQRDecomposition(J,
-                              jacobianconstraintmap,
                               SqrJ,
                               nontransprank,
                               Rparams,
                               false,
                               true);// do not transpose allow to diagnose parameters
 
-    identifyDependentParameters(SqrJ, Rparams, nontransprank, pdiagnoselist, silent);
+    return identifyDependentParameters(SqrJ, Rparams, nontransprank, silent);
 }
 #endif
 
 template <typename T>
-void System::identifyDependentParameters(   T & qrJ,
-                                            Eigen::MatrixXd &Rparams,
-                                            int rank,
-                                            const GCS::VEC_pD &pdiagnoselist,
-                                            bool silent)
+std::vector<VEC_I> System::identifyDependentParameters(T & qrJ,
+                                                       Eigen::MatrixXd &Rparams,
+                                                       int rank,
+                                                       bool silent)
 {
     (void)silent;// silent is only used in debug code, but it is important as Base::Console is not
                  // thread-safe. Removes warning in non Debug mode.
@@ -5134,32 +5585,30 @@ void System::identifyDependentParameters(   T & qrJ,
         SolverReportingManager::Manager().LogMatrix("Rparams_nonzeros_over_pilot", Rparams);
 #endif
 
-    pDependentParametersGroups.resize(qrJ.cols()-rank);
+    // groups of dependent parameters, as columns of J
+    std::vector<VEC_I> dependentGroups(qrJ.cols()-rank);
     for (int j=rank; j < qrJ.cols(); j++) {
         for (int row=0; row < rank; row++) {
             if (fabs(Rparams(row,j)) > 1e-10) {
                 int origCol = qrJ.colsPermutation().indices()[row];
 
-                pDependentParametersGroups[j-rank].push_back(pdiagnoselist[origCol]);
-                pDependentParameters.push_back(pdiagnoselist[origCol]);
+                dependentGroups[j-rank].push_back(origCol);
             }
         }
         int origCol = qrJ.colsPermutation().indices()[j];
 
-        pDependentParametersGroups[j-rank].push_back(pdiagnoselist[origCol]);
-        pDependentParameters.push_back(pdiagnoselist[origCol]);
+        dependentGroups[j-rank].push_back(origCol);
     }
 
 #ifdef _GCS_DEBUG
     if (!silent) {
         SolverReportingManager::Manager().LogMatrix("PermMatrix",
                                                     (Eigen::MatrixXd)qrJ.colsPermutation());
-
-        SolverReportingManager::Manager().LogGroupOfParameters("ParameterGroups",
-                                                               pDependentParametersGroups);
     }
 
 #endif
+
+    return dependentGroups;
 }
 
 void System::identifyDependentGeometryParametersInTransposedJacobianDenseQRDecomposition(
@@ -5264,27 +5713,34 @@ void System::eliminateNonZerosOverPivotInUpperTriangularMatrix( Eigen::MatrixXd
 }
 
 template <typename T>
-void System::identifyConflictingRedundantConstraints(
-    Algorithm alg, const T& qrJT, const std::map<int, int>& jacobianconstraintmap,
-    const std::map<int, int>& tagmultiplicity, GCS::VEC_pD& pdiagnoselist, Eigen::MatrixXd& R,
-    int constrNum, int rank, int& nonredundantconstrNum)
+std::vector<VEC_I> System::identifyConflictGroups(const T& qrJT, Eigen::MatrixXd& R,
+                                                  int constrNum, int rank)
 {
     eliminateNonZerosOverPivotInUpperTriangularMatrix(R, rank);
 
-    std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
+    // groups of conflicting or redundant constraints, as rows of J (columns of JT)
+    std::vector<VEC_I> conflictGroups(constrNum-rank);
     for (int j=rank; j < constrNum; j++) {
         for (int row=0; row < rank; row++) {
             if (fabs(R(row,j)) > 1e-10) {
                 int origCol = qrJT.colsPermutation().indices()[row];
 
-                conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+                conflictGroups[j-rank].push_back(origCol);
             }
         }
         int origCol = qrJT.colsPermutation().indices()[j];
 
-        conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+        conflictGroups[j-rank].push_back(origCol);
     }
 
+    return conflictGroups;
+}
+
+void System::identifyConflictingRedundantConstraints(
+    Algorithm alg, std::vector<std::vector<Constraint*>>& conflictGroups,
+    const std::map<int, int>& tagmultiplicity, GCS::VEC_pD& pdiagnoselist,
+    int constrNum, int& nonredundantconstrNum)
+{
     // Augment the information regarding the group of constraints that are conflicting or redundant.
     if (debugMode == IterationLevel) {
         SolverReportingManager::Manager().LogGroupOfConstraints(
@@ -5494,6 +5950,8 @@ void System::identifyConflictingRedundantConstraints(
 void System::clearSubSystems()
 {
     isInit = false;
+    interactiveComponents.clear();
+    isInteractiveInit = false;
     free(subSystems);
     free(subSystemsAux);
     subSystems.clear();
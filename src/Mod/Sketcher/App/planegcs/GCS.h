@@ -23,6 +23,10 @@
 #ifndef PLANEGCS_GCS_H
 #define PLANEGCS_GCS_H
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+
 #include <Eigen/QR>
 
 #include "SubSystem.h"
@@ -120,6 +124,16 @@ namespace GCS
         std::vector<SubSystem *> subSystems, subSystemsAux;
         void clearSubSystems();
 
+        // Factorization and parameters of a component having temporary constraints, kept
+        // across the calls to solveInteractive() of a drag (see GCS.cpp).
+        struct InteractiveComponent;
+        std::vector<std::unique_ptr<InteractiveComponent>> interactiveComponents;
+        bool isInteractiveInit; // if interactiveComponents are up to date with the subsystems
+        void initInteractive();
+        int solveInteractive(InteractiveComponent& ic,
+                             std::chrono::steady_clock::time_point deadline,
+                             bool isRedundantsolving);
+
         VEC_D reference;
         void setReference();     // copies the current parameter values to reference
         void resetToReference(); // reverts all parameter values to the stored reference
@@ -139,6 +153,28 @@ namespace GCS
 
         bool emptyDiagnoseMatrix; // false only if there is at least one driving constraint.
 
+        // total number of solver iterations run since construction, shared by concurrent solves
+        std::atomic<long> iterationCount;
+
+        // QR diagnosis of one decoupled block of the reduced Jacobian. Results are stored in
+        // block local indices (rows are constraints, columns are parameters), so that they only
+        // depend on the values of the block and can be reused whenever the same block shows up
+        // again in a later diagnosis, even if the system was rebuilt in between.
+        struct DiagnosedBlock
+        {
+            Eigen::MatrixXd J;
+            std::size_t hash = 0;
+            int rank = 0;
+            std::vector<VEC_I> conflictGroups;
+            std::vector<VEC_I> dependentGroups;
+        };
+        // blocks of the last diagnosis, kept across clear() for the untouched components
+        std::vector<DiagnosedBlock> diagnosedBlocks;
+        QRAlgorithm diagnosedQRAlgorithm;
+        double diagnosedQRPivotThreshold;
+
+        void diagnoseBlock(DiagnosedBlock& block);
+
         int solve_BFGS(SubSystem *subsys, bool isFine=true, bool isRedundantsolving=false);
         int solve_LM(SubSystem *subsys, bool isRedundantsolving=false);
         int solve_DL(SubSystem *subsys, bool isRedundantsolving=false);
@@ -147,14 +183,13 @@ namespace GCS
                                  GCS::VEC_pD& pdiagnoselist, std::map<int, int>& tagmultiplicity);
 
         void makeDenseQRDecomposition(const Eigen::MatrixXd& J,
-                                      const std::map<int, int>& jacobianconstraintmap,
                                       Eigen::FullPivHouseholderQR<Eigen::MatrixXd>& qrJT, int& rank,
                                       Eigen::MatrixXd& R, bool transposeJ = true,
                                       bool silent = false);
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
         void makeSparseQRDecomposition(
-            const Eigen::MatrixXd& J, const std::map<int, int>& jacobianconstraintmap,
+            const Eigen::MatrixXd& J,
             Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>>& SqrJT,
             int& rank, Eigen::MatrixXd& R, bool transposeJ = true, bool silent = false);
 #endif
@@ -166,28 +201,27 @@ namespace GCS
             const GCS::VEC_pD& pdiagnoselist, int paramsNum, int rank);
 
         template<typename T>
+        std::vector<VEC_I> identifyConflictGroups(const T& qrJT, Eigen::MatrixXd& R,
+                                                  int constrNum, int rank);
+
         void identifyConflictingRedundantConstraints(
-            Algorithm alg, const T& qrJT, const std::map<int, int>& jacobianconstraintmap,
+            Algorithm alg, std::vector<std::vector<Constraint*>>& conflictGroups,
             const std::map<int, int>& tagmultiplicity, GCS::VEC_pD& pdiagnoselist,
-            Eigen::MatrixXd& R, int constrNum, int rank, int& nonredundantconstrNum);
+            int constrNum, int& nonredundantconstrNum);
 
         void eliminateNonZerosOverPivotInUpperTriangularMatrix(Eigen::MatrixXd& R, int rank);
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
-        void identifyDependentParametersSparseQR(const Eigen::MatrixXd& J,
-                                                 const std::map<int, int>& jacobianconstraintmap,
-                                                 const GCS::VEC_pD& pdiagnoselist,
-                                                 bool silent = true);
+        std::vector<VEC_I> identifyDependentParametersSparseQR(const Eigen::MatrixXd& J,
+                                                               bool silent = true);
 #endif
 
-        void identifyDependentParametersDenseQR(const Eigen::MatrixXd& J,
-                                                const std::map<int, int>& jacobianconstraintmap,
-                                                const GCS::VEC_pD& pdiagnoselist,
-                                                bool silent = true);
+        std::vector<VEC_I> identifyDependentParametersDenseQR(const Eigen::MatrixXd& J,
+                                                              bool silent = true);
 
         template<typename T>
-        void identifyDependentParameters(T& qrJ, Eigen::MatrixXd& Rparams, int rank,
-                                         const GCS::VEC_pD& pdiagnoselist, bool silent = true);
+        std::vector<VEC_I> identifyDependentParameters(T& qrJ, Eigen::MatrixXd& Rparams, int rank,
+                                                       bool silent = true);
 
         #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
         void extractSubsystem(SubSystem *subsys, bool isRedundantsolving);
@@ -216,6 +250,7 @@ namespace GCS
         double DL_tolgRedundant;
         double DL_tolxRedundant;
         double DL_tolfRedundant;
+        bool concurrentSolving; // solve and diagnose decoupled components on several threads
 
     public:
         System();
@@ -392,6 +427,15 @@ namespace GCS
         int solve(SubSystem* subsysA, SubSystem* subsysB, bool isFine = true,
                   bool isRedundantsolving = false);
 
+        // Low latency solving for dragging: only the components having temporary constraints
+        // are solved, starting from the last solution instead of the reference, reusing the
+        // factorization of the previous calls and stopping after timeBudget seconds. Returns
+        // Success if the (non temporary) constraints are satisfied, even if the temporary ones
+        // have not fully converged yet.
+        int solveInteractive(double timeBudget, bool isRedundantsolving = false);
+        // the parameters that solveInteractive() may change
+        void getInteractiveParams(VEC_pD& params) const;
+
         void applySolution();
         void undoSolution();
         // FIXME: looks like XconvergenceFine is not the solver precision, at least in DogLeg
@@ -409,6 +453,10 @@ namespace GCS
         {
             return hasDiagnosis ? dofs : -1;
         }
+        long getIterationCount() const
+        {
+            return iterationCount;
+        }
         void getConflicting(VEC_I& conflictingOut) const
         {
             conflictingOut = hasDiagnosis ? conflictingTags : VEC_I(0);
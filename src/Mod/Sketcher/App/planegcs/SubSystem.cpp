@@ -110,17 +110,27 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
 
     c2p.clear();
     p2c.clear();
+    stencils.clear();
+    stencils.reserve(csize);
     for (std::vector<Constraint *>::iterator constr=clist.begin();
          constr != clist.end(); ++constr) {
         (*constr)->revertParams(); // ensure that the constraint points to the original parameters
         VEC_pD constr_params_orig = (*constr)->params();
         SET_pD constr_params;
+        std::vector<int> stencil;
+        stencil.reserve(constr_params_orig.size());
         for (VEC_pD::const_iterator p=constr_params_orig.begin();
              p != constr_params_orig.end(); ++p) {
             MAP_pD_pD::const_iterator pmapfind = pmap.find(*p);
-            if (pmapfind != pmap.end())
+            if (pmapfind != pmap.end()) {
                 constr_params.insert(pmapfind->second);
+                stencil.push_back(static_cast<int>(pmapfind->second - pvals.data()));
+            }
+            else {
+                stencil.push_back(-1);
+            }
         }
+        stencils.push_back(stencil);
         for (SET_pD::const_iterator p=constr_params.begin();
              p != constr_params.end(); ++p) {
 //            jacobi.set(*constr, *p, 0.);
@@ -261,15 +271,39 @@ void SubSystem::calcJacobi()
 }
 */
 
-void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
+void SubSystem::getColumns(VEC_pD &params, std::vector<int> &columns)
 {
-    jacobi.setZero(csize, params.size());
+    columns.assign(psize, -1);
+    if (&params == &plist) {
+        for (int j=0; j < psize; j++)
+            columns[j] = j;
+        return;
+    }
+
     for (int j=0; j < int(params.size()); j++) {
         MAP_pD_pD::const_iterator
           pmapfind = pmap.find(params[j]);
         if (pmapfind != pmap.end())
-            for (int i=0; i < csize; i++)
-                jacobi(i,j) = clist[i]->grad(pmapfind->second);
+            columns[pmapfind->second - pvals.data()] = j;
+    }
+}
+
+// Each constraint only depends on the few parameters of its stencil, so the
+// Jacobian is assembled constraint by constraint from the vectorized derivatives
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
+{
+    std::vector<int> columns;
+    getColumns(params, columns);
+
+    jacobi.setZero(csize, params.size());
+    VEC_D derivs;
+    for (int i=0; i < csize; i++) {
+        clist[i]->derivatives(derivs);
+        const std::vector<int> &stencil = stencils[i];
+        for (std::size_t k=0; k < stencil.size(); k++) {
+            if (stencil[k] >= 0 && columns[stencil[k]] >= 0)
+                jacobi(i,columns[stencil[k]]) += derivs[k];
+        }
     }
 }
 
@@ -278,20 +312,48 @@ void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
     calcJacobi(plist, jacobi);
 }
 
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi)
+{
+    std::vector<int> columns;
+    getColumns(params, columns);
+
+    std::vector<Eigen::Triplet<double> > triplets;
+    VEC_D derivs;
+    for (int i=0; i < csize; i++) {
+        clist[i]->derivatives(derivs);
+        const std::vector<int> &stencil = stencils[i];
+        for (std::size_t k=0; k < stencil.size(); k++) {
+            if (stencil[k] >= 0 && columns[stencil[k]] >= 0)
+                triplets.emplace_back(i, columns[stencil[k]], derivs[k]);
+        }
+    }
+
+    // duplicated parameters of a constraint are summed up
+    jacobi.resize(csize, params.size());
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    calcJacobi(plist, jacobi);
+}
+
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
 
+    std::vector<int> columns;
+    getColumns(params, columns);
+
     grad.setZero();
-    for (int j=0; j < int(params.size()); j++) {
-        MAP_pD_pD::const_iterator
-          pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end()) {
-            // assert(p2c.find(pmapfind->second) != p2c.end());
-            std::vector<Constraint *> constrs=p2c[pmapfind->second];
-            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
-                 constr != constrs.end(); ++constr)
-                grad[j] += (*constr)->error() * (*constr)->grad(pmapfind->second);
+    VEC_D derivs;
+    for (int i=0; i < csize; i++) {
+        double err = clist[i]->error();
+        clist[i]->derivatives(derivs);
+        const std::vector<int> &stencil = stencils[i];
+        for (std::size_t k=0; k < stencil.size(); k++) {
+            if (stencil[k] >= 0 && columns[stencil[k]] >= 0)
+                grad[columns[stencil[k]]] += err * derivs[k];
         }
     }
 }
@@ -27,6 +27,7 @@
 #undef max
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 
 #include "Constraints.h"
 
@@ -45,7 +46,9 @@ namespace GCS
 //        JacobianMatrix jacobi;  // jacobi matrix of the residuals
         std::map<Constraint *,VEC_pD > c2p; // constraint to parameter adjacency list
         std::map<double *,std::vector<Constraint *> > p2c; // parameter to constraint adjacency list
+        std::vector<std::vector<int> > stencils; // per constraint the index in pvals of each of its parameters or -1
         void initialize(VEC_pD &params, MAP_pD_pD &reductionmap); // called by the constructors
+        void getColumns(VEC_pD &params, std::vector<int> &columns); // maps pvals to the positions in params
     public:
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params);
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params,
@@ -73,6 +76,8 @@ namespace GCS
         void calcResidual(Eigen::VectorXd &r, double &err);
         void calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi);
         void calcJacobi(Eigen::MatrixXd &jacobi);
+        void calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi);
+        void calcJacobi(Eigen::SparseMatrix<double> &jacobi);
         void calcGrad(VEC_pD &params, Eigen::VectorXd &grad);
         void calcGrad(Eigen::VectorXd &grad);
 
@@ -163,6 +163,16 @@ void ViewProviderSketch::ParameterObserver::updateRecalculateInitialSolutionWhil
     Client.viewProviderParameters.recalculateInitialSolutionWhileDragging = hGrp2->GetBool("RecalculateInitialSolutionWhileDragging",true);
 }
 
+void ViewProviderSketch::ParameterObserver::updateDragSolverTimeBudget(const std::string & string, App::Property * property)
+{
+    (void) property;
+    (void) string;
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Mod/Sketcher");
+
+    Client.viewProviderParameters.dragSolverTimeBudget = hGrp->GetInt("DragSolverTimeBudget",8);
+}
+
 void ViewProviderSketch::ParameterObserver::subscribeToParameters()
 {
     try {
@@ -227,6 +237,8 @@ void ViewProviderSketch::ParameterObserver::initParameters()
             {[this](const std::string & string, App::Property * property){ updateAutoRecompute(string, property);}, nullptr }},
         {"RecalculateInitialSolutionWhileDragging",
             {[this](const std::string & string, App::Property * property){ updateRecalculateInitialSolutionWhileDragging(string, property);}, nullptr }},
+        {"DragSolverTimeBudget",
+            {[this](const std::string & string, App::Property * property){ updateDragSolverTimeBudget(string, property);}, nullptr }},
         {"GridSizePixelThreshold",
             {[this](const std::string & string, [[maybe_unused]] App::Property * property){ auto v = getSketcherGeneralParameter(string, 15); Client.setGridSizePixelThreshold(v); }, nullptr }},
         {"GridNumberSubdivision",
@@ -2911,6 +2923,9 @@ bool ViewProviderSketch::setEdit(int ModNum)
     // Enable solver initial solution update while dragging.
     getSketchObject()->setRecalculateInitialSolutionWhileMovingPoint(viewProviderParameters.recalculateInitialSolutionWhileDragging);
 
+    // Solve the intermediate positions of a drag in low latency mode, the final one is fully solved.
+    getSketchObject()->setDragTimeBudget(viewProviderParameters.dragSolverTimeBudget / 1000.0);
+
     // intercept del key press from main app
     listener = new ShortcutListener(this);
 
@@ -184,6 +184,8 @@ private:
 
         void updateRecalculateInitialSolutionWhileDragging(const std::string & string, App::Property * property);
 
+        void updateDragSolverTimeBudget(const std::string & string, App::Property * property);
+
     private:
         ViewProviderSketch &Client;
         std::map<std::string, std::tuple<std::function<void(const std::string & string, App::Property *)>, App::Property * >> parameterMap;
@@ -387,6 +389,7 @@ private:
         bool handleEscapeButton = false;
         bool autoRecompute = false;
         bool recalculateInitialSolutionWhileDragging = false;
+        int dragSolverTimeBudget = 8; // milliseconds, 0 disables the low latency drag solver
 
         bool isShownVirtualSpace = false; // indicates whether the present virtual space view is the Real Space or the Virtual Space (virtual space 1 or 2)
         bool buttonPress = false;
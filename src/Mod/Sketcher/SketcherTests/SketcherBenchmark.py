@@ -0,0 +1,275 @@
+# SPDX-License-Identifier: LGPL-2.1-or-later
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2023 FreeCAD Project Association                        *
+# *                                                                         *
+# *   This file is part of FreeCAD.                                         *
+# *                                                                         *
+# *   FreeCAD is free software: you can redistribute it and/or modify it    *
+# *   under the terms of the GNU Lesser General Public License as           *
+# *   published by the Free Software Foundation, either version 2.1 of the  *
+# *   License, or (at your option) any later version.                       *
+# *                                                                         *
+# *   FreeCAD is distributed in the hope that it will be useful, but        *
+# *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+# *   Lesser General Public License for more details.                       *
+# *                                                                         *
+# *   You should have received a copy of the GNU Lesser General Public      *
+# *   License along with FreeCAD. If not, see                               *
+# *   <https://www.gnu.org/licenses/>.                                      *
+# *                                                                         *
+# ***************************************************************************
+
+""" Headless benchmark of the sketcher solver.
+
+Sets up, solves, diagnoses and drags a corpus of sketches with Sketcher.Sketch and
+writes the per phase timings and solver iteration counts as JSON, so that solver
+changes can be compared against a stored baseline.
+
+The corpus consists of synthetic sketches (grids of rectangles, chains of B-splines
+with many poles and grids of heavily redundant rectangles) and, optionally, every
+sketch found in the given FCStd documents.
+
+Usage with the command line version of FreeCAD:
+
+    FreeCADCmd -c "from SketcherTests import SketcherBenchmark; \
+SketcherBenchmark.main(['--output', 'bench.json', 'parts.FCStd'])"
+
+Pass '--quick' for a reduced corpus that runs in a few seconds.
+"""
+
+import argparse
+import json
+import statistics
+import sys
+import time
+
+import FreeCAD
+import Part
+import Sketcher
+
+App = FreeCAD
+
+START = 1
+END = 2
+
+
+def _rectangle(geos, cons, x, y, w, h, fixed=True, redundant=False):
+    """Append a rectangle to the geometry and constraint lists."""
+    i = len(geos)
+    geos.append(Part.LineSegment(App.Vector(x, y + h, 0), App.Vector(x + w, y + h, 0)))
+    geos.append(Part.LineSegment(App.Vector(x + w, y + h, 0), App.Vector(x + w, y, 0)))
+    geos.append(Part.LineSegment(App.Vector(x + w, y, 0), App.Vector(x, y, 0)))
+    geos.append(Part.LineSegment(App.Vector(x, y, 0), App.Vector(x, y + h, 0)))
+    for k in range(4):
+        cons.append(Sketcher.Constraint("Coincident", i + k, END, i + (k + 1) % 4, START))
+    cons.append(Sketcher.Constraint("Horizontal", i + 0))
+    cons.append(Sketcher.Constraint("Horizontal", i + 2))
+    cons.append(Sketcher.Constraint("Vertical", i + 1))
+    cons.append(Sketcher.Constraint("Vertical", i + 3))
+    cons.append(Sketcher.Constraint("Distance", i + 0, w))
+    cons.append(Sketcher.Constraint("Distance", i + 1, h))
+    if fixed:
+        cons.append(Sketcher.Constraint("DistanceX", i + 2, END, x))
+        cons.append(Sketcher.Constraint("DistanceY", i + 2, END, y))
+    if redundant:
+        cons.append(Sketcher.Constraint("Parallel", i + 0, i + 2))
+        cons.append(Sketcher.Constraint("Parallel", i + 1, i + 3))
+        cons.append(Sketcher.Constraint("Perpendicular", i + 0, i + 1))
+        cons.append(Sketcher.Constraint("Distance", i + 2, w))
+    return i
+
+
+def rectangle_grid(n, redundant=False):
+    """n x n rectangles, all fixed but the first one, which is dragged."""
+    geos, cons = [], []
+    for r in range(n):
+        for c in range(n):
+            _rectangle(geos, cons, 15.0 * c, 15.0 * r, 10.0, 8.0 + (r + c) % 3,
+                       fixed=(r, c) != (0, 0), redundant=redundant)
+    return geos, cons, (0, START)
+
+
+def bspline_chain(count, poles):
+    """count B-splines of the given number of poles joined end to start."""
+    geos, cons = [], []
+    for i in range(count):
+        pts = [App.Vector(100.0 * i + 100.0 * k / (poles - 1), 20.0 * ((k % 2) - 0.5), 0)
+               for k in range(poles)]
+        curve = Part.BSplineCurve()
+        curve.buildFromPoles(pts, False, 3)
+        geos.append(curve)
+        if i > 0:
+            cons.append(Sketcher.Constraint("Coincident", i - 1, END, i, START))
+    cons.append(Sketcher.Constraint("DistanceX", 0, START, 0.0))
+    cons.append(Sketcher.Constraint("DistanceY", 0, START, -10.0))
+    return geos, cons, (count - 1, END)
+
+
+def synthetic_corpus(quick):
+    """(name, generator) pairs of the synthetic sketches."""
+    sizes = (2, 5) if quick else (2, 5, 10, 20)
+    corpus = [("rectangle_grid_%dx%d" % (n, n), (lambda n=n: rectangle_grid(n))) for n in sizes]
+    corpus += [("redundant_grid_%dx%d" % (n, n), (lambda n=n: rectangle_grid(n, True)))
+               for n in sizes]
+    chains = ((2, 16), (4, 64)) if quick else ((2, 16), (4, 64), (8, 256))
+    corpus += [("bspline_chain_%dx%d" % (c, p), (lambda c=c, p=p: bspline_chain(c, p)))
+               for c, p in chains]
+    return corpus
+
+
+def _summary(samples):
+    return {
+        "min": min(samples),
+        "mean": statistics.mean(samples),
+        "max": max(samples),
+    }
+
+
+def run_case(name, setup, drag, repeat, steps, drag_budget=0):
+    """Time the phases of one sketch.
+
+    setup is called with a fresh Sketcher.Sketch and sets it up; drag is the
+    (GeoId, PointPos) of the point dragged in the drag phase, or None. With a positive
+    drag_budget the drag is repeated with the low latency solver of dragPoint.
+    """
+    result = {"name": name}
+    setup_wall, diagnose, solve_wall, solve, solve_iter = [], [], [], [], []
+    for _ in range(repeat):
+        sketch = Sketcher.Sketch()
+        start = time.perf_counter()
+        dofs = setup(sketch)
+        setup_wall.append(time.perf_counter() - start)
+        diagnose.append(sketch.DiagnoseTime)
+
+        iterations = sketch.SolverIterations
+        start = time.perf_counter()
+        status = sketch.solve()
+        solve_wall.append(time.perf_counter() - start)
+        solve.append(sketch.SolveTime)
+        solve_iter.append(sketch.SolverIterations - iterations)
+
+    result.update({
+        "geometries": len(sketch.Geometries),
+        "dofs": dofs,
+        "conflicts": len(sketch.Conflicts),
+        "redundancies": len(sketch.Redundancies),
+        "solve_status": status,
+        "setup": {"wall": _summary(setup_wall), "diagnose": _summary(diagnose)},
+        "solve": {"wall": _summary(solve_wall), "solver": _summary(solve),
+                  "iterations": _summary(solve_iter)},
+    })
+
+    if drag is None or sketch.Conflicts:
+        return result
+
+    drag_result = _drag(sketch, drag, steps, 0)
+    if drag_result:
+        result["drag"] = drag_result
+
+    if drag_budget > 0:
+        sketch = Sketcher.Sketch()
+        setup(sketch)
+        sketch.solve()
+        drag_result = _drag(sketch, drag, steps, drag_budget)
+        if drag_result:
+            result["drag_low_latency"] = drag_result
+    return result
+
+
+def _drag(sketch, drag, steps, budget):
+    """Drag a point in steps, in low latency mode if budget is positive, and release it."""
+    geoid, pos = drag
+    start = time.perf_counter()
+    if sketch.initMove(geoid, pos) < 0:
+        return None
+    init_move = time.perf_counter() - start
+
+    sketch.DragTimeBudget = budget
+    move = sketch.dragPoint if budget > 0 else sketch.movePoint
+    step_wall, step_iter, failed = [], [], 0
+    for k in range(steps):
+        offset = App.Vector(0.5 * (k + 1), 0.25 * (k + 1), 0)
+        iterations = sketch.SolverIterations
+        start = time.perf_counter()
+        if move(geoid, pos, offset, True) != 0:
+            failed += 1
+        step_wall.append(time.perf_counter() - start)
+        step_iter.append(sketch.SolverIterations - iterations)
+
+    # the final position is always solved with full accuracy
+    start = time.perf_counter()
+    if sketch.movePoint(geoid, pos, App.Vector(0.5 * steps, 0.25 * steps, 0), True) != 0:
+        failed += 1
+    release = time.perf_counter() - start
+
+    return {
+        "time_budget": budget,
+        "init_move": init_move,
+        "steps": steps,
+        "failed_steps": failed,
+        "step_wall": _summary(step_wall),
+        "step_iterations": _summary(step_iter),
+        "release": release,
+        "total_wall": init_move + sum(step_wall) + release,
+    }
+
+
+def document_corpus(path):
+    """(name, sketch object) pairs of every sketch in the document."""
+    doc = App.openDocument(path)
+    sketches = [obj for obj in doc.Objects if obj.isDerivedFrom("Sketcher::SketchObject")]
+    return doc, [("%s:%s" % (doc.Name, obj.Name), obj) for obj in sketches]
+
+
+def run(documents=(), quick=False, repeat=3, steps=20, drag_budget=0.008):
+    """Run the corpus and return the results as a dictionary."""
+    cases = []
+    for name, generator in synthetic_corpus(quick):
+        geos, cons, drag = generator()
+        cases.append(run_case(name, lambda s: s.setUpSketch(geos, cons), drag, repeat, steps,
+                              drag_budget))
+
+    for path in documents:
+        doc, sketches = document_corpus(path)
+        try:
+            for name, obj in sketches:
+                drag = (0, START) if obj.GeometryCount > 0 else None
+                cases.append(run_case(name, lambda s, obj=obj: s.setUpSketch(obj),
+                                      drag, repeat, steps, drag_budget))
+        finally:
+            App.closeDocument(doc.Name)
+
+    return {
+        "version": ".".join(App.Version()[0:3]),
+        "repeat": repeat,
+        "drag_budget": drag_budget,
+        "cases": cases,
+    }
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Benchmark the sketcher solver")
+    parser.add_argument("documents", nargs="*", help="FCStd files whose sketches are added to the corpus")
+    parser.add_argument("--output", "-o", help="JSON file to write, default is standard output")
+    parser.add_argument("--repeat", type=int, default=3, help="repetitions of set up and solve")
+    parser.add_argument("--steps", type=int, default=20, help="number of drag steps")
+    parser.add_argument("--drag-budget", type=float, default=0.008,
+                        help="time budget in seconds of the low latency drag, 0 skips it")
+    parser.add_argument("--quick", action="store_true", help="run a reduced synthetic corpus")
+    args = parser.parse_args(argv)
+
+    results = run(args.documents, args.quick, max(1, args.repeat), max(1, args.steps),
+                  args.drag_budget)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    else:
+        json.dump(results, sys.stdout, indent=2)
+        sys.stdout.write("\n")
+    return results
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
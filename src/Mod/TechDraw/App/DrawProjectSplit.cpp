@@ -24,8 +24,12 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <cmath>
+# include <iterator>
 # include <limits>
+# include <numeric>
 # include <sstream>
+# include <QtConcurrentMap>
 #include <Bnd_Box.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepAdaptor_Curve.hxx>
@@ -34,10 +38,12 @@
 #include <BRepBndLib.hxx>
 #include <BRepBuilderAPI_Copy.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepLProp_CurveTool.hxx>
 #include <Geom_Curve.hxx>
 #include <GeomLib_Tool.hxx>
 #include <gp_Ax2.hxx>
+#include <gp_Circ.hxx>
 #include <gp_Pnt.hxx>
 #include <TopExp.hxx>
 #include <TopExp_Explorer.hxx>
@@ -141,76 +147,224 @@ std::vector<TopoDS_Edge> DrawProjectSplit::getEdges(TechDraw::GeometryObject* ge
 
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = origEdges.begin();
-    int iOuter = 0;
-    for (; itOuter != origEdges.end(); ++itOuter, iOuter++) {
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::AddOptimal(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
-            continue;
+    std::vector<splitPoint> sorted = findSplitPoints(faceEdges);
+    std::vector<TopoDS_Edge> newEdges = splitEdges(faceEdges, sorted);
+
+    if (!newEdges.empty()) {
+        newEdges = removeDuplicateEdges(newEdges);
+    }
+    return newEdges;
+}
+
+
+namespace {
+
+//edge data needed to find the split points, computed once per edge
+struct SplitEdgeInfo
+{
+    Bnd_Box box;
+    bool skip = true;           //zero length edge or void box
+    GeomAbs_CurveType type = GeomAbs_OtherCurve;
+    gp_Pnt start;               //ends of a line
+    gp_Pnt end;
+    gp_Circ circle;
+};
+
+//the cheap analytic distance of a point to lines and circles is used to reject points
+//that are obviously not on the edge before asking OCC
+bool mayBeOnEdge(const SplitEdgeInfo& info, const gp_Pnt& pt)
+{
+    const double margin = 100.0 * Precision::Confusion();
+    if (info.type == GeomAbs_Line) {
+        gp_Vec seg(info.start, info.end);
+        gp_Vec toPoint(info.start, pt);
+        double len2 = seg.SquareMagnitude();
+        double t = len2 > 0.0 ? std::min(1.0, std::max(0.0, toPoint.Dot(seg) / len2)) : 0.0;
+        return pt.Distance(info.start.Translated(t * seg)) < margin;
+    }
+    if (info.type == GeomAbs_Circle) {
+        gp_Vec toPoint(info.circle.Location(), pt);
+        double height = toPoint.Dot(gp_Vec(info.circle.Axis().Direction()));
+        double radial = std::sqrt(std::max(0.0, toPoint.SquareMagnitude() - height * height));
+        double delta = radial - info.circle.Radius();
+        return std::sqrt(height * height + delta * delta) < margin;
+    }
+    return true;
+}
+
+//uniform grid over the xy extent of the edge boxes, for finding the boxes that contain a point
+class SplitEdgeGrid
+{
+public:
+    explicit SplitEdgeGrid(const std::vector<SplitEdgeInfo>& infos)
+    {
+        Bnd_Box all;
+        for (auto& info : infos) {
+            if (!info.skip) {
+                all.Add(info.box);
+            }
         }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            continue;  //skip zero length edges. shouldn't happen ;)
+        if (all.IsVoid()) {
+            return;
         }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = faceEdges.begin();
-        for (; itInner != faceEdges.end(); ++itInner, iInner++) {
-            if (iInner == iOuter) {
+        double zMin, zMax;
+        all.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        size = std::max(1, std::min(1024, (int)std::ceil(std::sqrt((double)infos.size()))));
+        cellX = std::max((xMax - xMin) / size, Precision::Confusion());
+        cellY = std::max((yMax - yMin) / size, Precision::Confusion());
+        cells.resize(size * size);
+        for (int i = 0; i < (int)infos.size(); i++) {
+            if (infos[i].skip) {
                 continue;
             }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::AddOptimal(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
+            double bxMin, byMin, bzMin, bxMax, byMax, bzMax;
+            infos[i].box.Get(bxMin, byMin, bzMin, bxMax, byMax, bzMax);
+            int ix0 = cellIndex(bxMin, xMin, cellX), ix1 = cellIndex(bxMax, xMin, cellX);
+            int iy0 = cellIndex(byMin, yMin, cellY), iy1 = cellIndex(byMax, yMin, cellY);
+            if ((ix1 - ix0 + 1) * (iy1 - iy0 + 1) > std::max(16, size * size / 4)) {
+                large.push_back(i);     //long diagonal edges would fill most of the grid
                 continue;
             }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
+            for (int ix = ix0; ix <= ix1; ix++) {
+                for (int iy = iy0; iy <= iy1; iy++) {
+                    cells[ix * size + iy].push_back(i);
+                }
             }
+        }
+    }
+
+    //indexes of the edges whose box may contain pt, ascending
+    void candidates(const gp_Pnt& pt, std::vector<int>& result) const
+    {
+        result.clear();
+        if (cells.empty() || pt.X() < xMin || pt.X() > xMax || pt.Y() < yMin || pt.Y() > yMax) {
+            return;
+        }
+        const std::vector<int>& cell = cells[cellIndex(pt.X(), xMin, cellX) * size
+                                             + cellIndex(pt.Y(), yMin, cellY)];
+        result.reserve(cell.size() + large.size());
+        std::merge(cell.begin(), cell.end(), large.begin(), large.end(), std::back_inserter(result));
+    }
+
+private:
+    int cellIndex(double value, double min, double cell) const
+    {
+        return std::max(0, std::min(size - 1, (int)((value - min) / cell)));
+    }
 
-            double param = -1;
-            if (isOnEdge((*itInner), v1, param, false)) {
-                gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                splitPoint s1;
-                s1.i = iInner;
-                s1.v = Base::Vector3d(pnt1.X(), pnt1.Y(), pnt1.Z());
-                s1.param = param;
-                splits.push_back(s1);
+    double xMin = 0.0, yMin = 0.0, xMax = 0.0, yMax = 0.0;
+    double cellX = 1.0, cellY = 1.0;
+    int size = 0;
+    std::vector<std::vector<int>> cells;
+    std::vector<int> large;
+};
+
+} //anonymous namespace
+
+//HLR does not split edges where a vertex of another edge touches them.
+//find the points where edges have to be split, sorted and without duplicates
+std::vector<splitPoint> DrawProjectSplit::findSplitPoints(const std::vector<TopoDS_Edge>& edges)
+{
+    std::vector<SplitEdgeInfo> infos(edges.size());
+    std::vector<int> indexes(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        indexes[i] = (int)i;
+    }
+    QtConcurrent::blockingMap(indexes, [&edges, &infos](int i) {
+        SplitEdgeInfo& info = infos[i];
+        BRepBndLib::AddOptimal(edges[i], info.box);
+        info.box.SetGap(0.1);
+        info.skip = info.box.IsVoid() || DrawUtil::isZeroEdge(edges[i]);
+        if (info.skip) {
+            return;
+        }
+        BRepAdaptor_Curve adapt(edges[i]);
+        info.type = adapt.GetType();
+        if (info.type == GeomAbs_Line) {
+            info.start = adapt.Value(adapt.FirstParameter());
+            info.end = adapt.Value(adapt.LastParameter());
+        }
+        else if (info.type == GeomAbs_Circle) {
+            info.circle = adapt.Circle();
+        }
+    });
+
+    SplitEdgeGrid grid(infos);
+
+    //the splits of every outer edge, in the order of the nested loops this replaces
+    std::vector<std::vector<splitPoint>> edgeSplits(edges.size());
+    //the workers must not write to the console, failures are reported afterwards
+    std::vector<int> failures(edges.size(), 0);
+    QtConcurrent::blockingMap(indexes, [&edges, &infos, &grid, &edgeSplits, &failures](int iOuter) {
+        const SplitEdgeInfo& outer = infos[iOuter];
+        if (outer.skip) {
+            return;
+        }
+        TopoDS_Vertex ends[2] = {TopExp::FirstVertex(edges[iOuter]), TopExp::LastVertex(edges[iOuter])};
+        gp_Pnt points[2] = {BRep_Tool::Pnt(ends[0]), BRep_Tool::Pnt(ends[1])};
+        //candidates that may contain either end
+        std::vector<int> candidates, candidates2, inners;
+        grid.candidates(points[0], candidates);
+        grid.candidates(points[1], candidates2);
+        std::set_union(candidates.begin(), candidates.end(), candidates2.begin(), candidates2.end(),
+                       std::back_inserter(inners));
+        for (int iInner : inners) {
+            const SplitEdgeInfo& inner = infos[iInner];
+            if (iInner == iOuter || inner.skip || outer.box.IsOut(inner.box)) {
+                continue;
             }
-            if (isOnEdge((*itInner), v2, param, false)) {
-                gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                splitPoint s2;
-                s2.i = iInner;
-                s2.v = Base::Vector3d(pnt2.X(), pnt2.Y(), pnt2.Z());
-                s2.param = param;
-                splits.push_back(s2);
+            for (int k = 0; k < 2; k++) {
+                if (inner.box.IsOut(points[k]) || !mayBeOnEdge(inner, points[k])) {
+                    continue;
+                }
+                double param = -1;
+                double dist = 0.0;
+                bool onEdge = checkOnEdge(edges[iInner], ends[k], param, false, dist);
+                if (dist < 0.0) {
+                    failures[iOuter]++;
+                }
+                if (onEdge) {
+                    splitPoint split;
+                    split.i = iInner;
+                    split.v = Base::Vector3d(points[k].X(), points[k].Y(), points[k].Z());
+                    split.param = param;
+                    edgeSplits[iOuter].push_back(split);
+                }
             }
-        } //inner loop
-    }   //outer loop
+        }
+    });
+
+    int failed = std::accumulate(failures.begin(), failures.end(), 0);
+    if (failed > 0) {
+        Base::Console().Error("DPS::findSplitPoints - distance to edge failed %d times\n", failed);
+    }
 
+    std::vector<splitPoint> splits;
+    for (auto& s : edgeSplits) {
+        splits.insert(splits.end(), s.begin(), s.end());
+    }
     std::vector<splitPoint> sorted = sortSplits(splits, true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
     sorted.erase(last, sorted.end());                         //remove dupls
-    std::vector<TopoDS_Edge> newEdges = splitEdges(faceEdges, sorted);
-
-    if (!newEdges.empty()) {
-        newEdges = removeDuplicateEdges(newEdges);
-    }
-    return newEdges;
+    return sorted;
 }
 
-
 //this routine is the big time consumer.  gets called many times (and is slow?))
 //note param gets modified here
 bool DrawProjectSplit::isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, bool allowEnds)
+{
+    double dist = 0.0;
+    bool result = checkOnEdge(e, v, param, allowEnds, dist);
+    if (dist < 0.0) {
+        Base::Console().Error("DPS::isOnEdge - simpleMinDist failed: %.3f\n", dist);
+    }
+    return result;
+}
+
+//isOnEdge without console output, safe to call from worker threads.
+//dist is set to the distance between v and e, or to -1 if it could not be found
+bool DrawProjectSplit::checkOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, bool allowEnds,
+                                   double& dist)
 {
     bool result = false;
     bool outOfBox = false;
@@ -227,9 +381,9 @@ bool DrawProjectSplit::isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, b
         }
     }
     if (!outOfBox) {
-            double dist = DrawUtil::simpleMinDist(v, e);
+            BRepExtrema_DistShapeShape extss(v, e);
+            dist = (extss.IsDone() && extss.NbSolution() != 0) ? extss.Value() : -1.0;
             if (dist < 0.0) {
-                Base::Console().Error("DPS::isOnEdge - simpleMinDist failed: %.3f\n", dist);
                 result = false;
             } else if (dist < Precision::Confusion()) {
                 const gp_Pnt pt = BRep_Tool::Pnt(v);                         //have to duplicate method 3 to get param
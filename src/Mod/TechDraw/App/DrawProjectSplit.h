@@ -102,6 +102,7 @@ public:
     static TechDraw::GeometryObjectPtr  buildGeometryObject(TopoDS_Shape shape, const gp_Ax2& viewAxis);
 
     static bool isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, bool allowEnds = false);
+    static std::vector<splitPoint> findSplitPoints(const std::vector<TopoDS_Edge>& edges);
     static std::vector<TopoDS_Edge> splitEdges(std::vector<TopoDS_Edge> orig, std::vector<splitPoint> splits);
     static std::vector<TopoDS_Edge> split1Edge(TopoDS_Edge e, std::vector<splitPoint> splitPoints);
 
@@ -135,6 +136,8 @@ public:
 
 protected:
     static std::vector<TopoDS_Edge> getEdges(TechDraw::GeometryObject* geometryObject);
+    static bool checkOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, bool allowEnds,
+                            double& dist);
 
 
 private:
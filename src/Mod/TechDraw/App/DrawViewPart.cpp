@@ -50,6 +50,7 @@
 #include <gp_Dir.hxx>
 #include <gp_Pln.hxx>
 #include <gp_Pnt.hxx>
+#include <iomanip>
 #include <sstream>
 #endif
 
@@ -59,6 +60,7 @@
 #include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Parameter.h>
+#include <Mod/Part/App/Tools.h>
 
 #include "Cosmetic.h"
 #include "DrawGeomHatch.h"
@@ -74,7 +76,9 @@
 #include "DrawViewSection.h"
 #include "EdgeWalker.h"
 #include "Geometry.h"
+#include "GeometryCache.h"
 #include "GeometryObject.h"
+#include "Preferences.h"
 #include "ShapeExtractor.h"
 
 
@@ -90,8 +94,8 @@ using DU = DrawUtil;
 PROPERTY_SOURCE_WITH_EXTENSIONS(TechDraw::DrawViewPart, TechDraw::DrawView)
 
 DrawViewPart::DrawViewPart(void)
-    : geometryObject(nullptr), m_tempGeometryObject(nullptr), m_waitingForFaces(false),
-      m_waitingForHlr(false)
+    : geometryObject(nullptr), m_tempGeometryObject(nullptr), m_geometryScale(1.0),
+      m_tempGeometryScale(1.0), m_waitingForFaces(false), m_waitingForHlr(false)
 {
     static const char* group = "Projection";
     static const char* sgroup = "HLR Parameters";
@@ -309,9 +313,13 @@ void DrawViewPart::partExec(TopoDS_Shape& shape)
 
     //we need to keep using the old geometryObject until the new one is fully populated
     m_tempGeometryObject = makeGeometryForShape(shape);
-    if (CoarseView.getValue()) {
-        onHlrFinished();//poly algo does not run in separate thread, so we need to invoke
-                        //the post hlr processing manually
+    if (!m_tempGeometryObject) {
+        //nothing the geometry depends on has changed
+        return;
+    }
+    if (!waitingForHlr()) {
+        onHlrFinished();//poly algo and cached projections do not run in separate thread, so
+                        //we need to invoke the post hlr processing manually
     }
 }
 
@@ -332,10 +340,120 @@ GeometryObjectPtr DrawViewPart::makeGeometryForShape(TopoDS_Shape& shape)
     m_saveCentroid = DU::toVector3d(gCentroid);
     m_saveShape = centerScaleRotate(this, localShape, m_saveCentroid);
 
+    //the shapes are only written to hash their content if they are not the shapes the
+    //current geometry was made from
+    std::vector<TopoDS_Shape> sources = geometryCacheSources(shape);
+    bool sameSources = geometryObject && !m_geometryKey.empty()
+        && GeometryCache::isSame(sources, m_geometrySources);
+    std::string contentKey = sameSources ? m_geometryContentKey : geometryContentKey(sources);
+    std::string key = geometryCacheKey(contentKey);
+    if (sameSources && key == m_geometryKey && DU::fpCompare(getScale(), m_geometryScale)
+        && !geometryPropertyTouched()) {
+        return nullptr;
+    }
+    m_tempGeometryKey = key;
+    m_tempGeometryContentKey = contentKey;
+    m_tempGeometryScale = getScale();
+    m_tempGeometrySources.clear();
+    if (!key.empty()) {
+        m_tempGeometrySources = sources;
+    }
+
+    //an orthographic projection only needs to be scaled if just the scale has changed
+    GeometryCache::Projection cached;
+    if (!key.empty() && GeometryCache::findProjection(key, cached)) {
+        GeometryObjectPtr go = createGeometryObject();
+        go->setHLRCompounds(GeometryCache::scaled(cached.compounds, getScale() / cached.scale));
+        return go;
+    }
+
     GeometryObjectPtr go = buildGeometryObject(localShape, getProjectionCS());
     return go;
 }
 
+//the shapes the projection of this view is made from, shape and the 2d shapes of the sources
+std::vector<TopoDS_Shape> DrawViewPart::geometryCacheSources(const TopoDS_Shape& shape) const
+{
+    std::vector<TopoDS_Shape> sources = getSourceShape2d();
+    sources.insert(sources.begin(), shape);
+    return sources;
+}
+
+//the hashes and lengths of the BRep text of the sources, empty if the cache is not used
+std::string DrawViewPart::geometryContentKey(const std::vector<TopoDS_Shape>& sources) const
+{
+    if (Preferences::geometryCacheSize() <= 0 || sources.empty() || sources.front().IsNull()) {
+        return std::string();
+    }
+
+    std::string key;
+    for (auto& shape : sources) {
+        key += Part::Tools::contentKey(shape) + " ";
+    }
+    return key;
+}
+
+//the key of the projection of the sources with the given content key in the GeometryCache.
+//The scale is not part of the key of orthographic projections as their HLR output can be
+//scaled instead.
+std::string DrawViewPart::geometryCacheKey(const std::string& contentKey) const
+{
+    if (contentKey.empty()) {
+        return std::string();
+    }
+
+    gp_Ax2 viewAxis = getProjectionCS();
+    std::stringstream key;
+    key << std::setprecision(12) << contentKey;
+    key << viewAxis.Location().X() << " " << viewAxis.Location().Y() << " "
+        << viewAxis.Location().Z() << " " << viewAxis.Direction().X() << " "
+        << viewAxis.Direction().Y() << " " << viewAxis.Direction().Z() << " "
+        << viewAxis.XDirection().X() << " " << viewAxis.XDirection().Y() << " "
+        << viewAxis.XDirection().Z() << " " << Rotation.getValue() << " " << IsoCount.getValue()
+        << " " << CoarseView.getValue() << " " << Perspective.getValue();
+    if (Perspective.getValue()) {
+        key << " " << Focus.getValue() << " " << getScale();
+    }
+    return key.str();
+}
+
+//the key of the faces of geometryObject in the GeometryCache. It includes the face finding
+//settings and tolerances, so the faces are found again if one of them changes.
+std::string DrawViewPart::faceCacheKey()
+{
+    std::stringstream key;
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication()
+                                             .GetUserParameter()
+                                             .GetGroup("BaseApp")
+                                             ->GetGroup("Preferences")
+                                             ->GetGroup("Mod/TechDraw/debug");
+    key << m_geometryKey << " " << SmoothVisible.getValue() << " " << SeamVisible.getValue()
+        << " " << newFaceFinder() << " " << hGrp->GetBool("allowCrazyEdge", false) << " "
+        << EWTOLERANCE << " " << FUZZYADJUST;
+    return key.str();
+}
+
+//true if a property used after HLR to complete the geometry has changed
+bool DrawViewPart::geometryPropertyTouched() const
+{
+    return SmoothVisible.isTouched() || SeamVisible.isTouched() || IsoVisible.isTouched()
+        || HardHidden.isTouched() || SmoothHidden.isTouched() || SeamHidden.isTouched()
+        || IsoHidden.isTouched() || CosmeticVertexes.isTouched() || CosmeticEdges.isTouched()
+        || CenterLines.isTouched();
+}
+
+//make a geometry object with the HLR parameters of this view
+TechDraw::GeometryObjectPtr DrawViewPart::createGeometryObject()
+{
+    TechDraw::GeometryObjectPtr go(
+        std::make_shared<TechDraw::GeometryObject>(getNameInDocument(), this));
+    go->setIsoCount(IsoCount.getValue());
+    go->isPerspective(Perspective.getValue());
+    go->setFocus(Focus.getValue());
+    go->usePolygonHLR(CoarseView.getValue());
+    return go;
+}
+
 //Modify a shape by centering, scaling and rotating and return the centered (but not rotated) shape
 TopoDS_Shape DrawViewPart::centerScaleRotate(DrawViewPart* dvp, TopoDS_Shape& inOutShape,
                                              Base::Vector3d centroid)
@@ -362,12 +480,7 @@ TechDraw::GeometryObjectPtr DrawViewPart::buildGeometryObject(TopoDS_Shape& shap
 //    Base::Console().Message("DVP::buildGeometryObject() - %s\n", getNameInDocument());
     showProgressMessage(getNameInDocument(), "is finding hidden lines");
 
-    TechDraw::GeometryObjectPtr go(
-        std::make_shared<TechDraw::GeometryObject>(getNameInDocument(), this));
-    go->setIsoCount(IsoCount.getValue());
-    go->isPerspective(Perspective.getValue());
-    go->setFocus(Focus.getValue());
-    go->usePolygonHLR(CoarseView.getValue());
+    TechDraw::GeometryObjectPtr go = createGeometryObject();
 
     if (CoarseView.getValue()) {
         //the polygon approximation HLR process runs quickly, so doesn't need to be in a
@@ -410,10 +523,22 @@ void DrawViewPart::onHlrFinished(void)
     if (m_tempGeometryObject) {
         geometryObject = m_tempGeometryObject;//replace with new
         m_tempGeometryObject = nullptr;       //superfluous?
+        m_geometryKey = m_tempGeometryKey;
+        m_geometryContentKey = m_tempGeometryContentKey;
+        m_geometryScale = m_tempGeometryScale;
+        m_geometrySources = m_tempGeometrySources;
+        m_tempGeometryKey.clear();
+        m_tempGeometryContentKey.clear();
+        m_tempGeometrySources.clear();
+        if (!m_geometryKey.empty()) {
+            GeometryCache::addProjection(m_geometryKey,
+                                         {geometryObject->getHLRCompounds(), m_geometryScale});
+        }
     }
     if (!geometryObject) {
         throw Base::RuntimeError("DrawViewPart has lost its geometry");
     }
+    GeometryObjectPtr go = geometryObject;
 
     //the last hlr related task is to make a bbox of the results
     bbox = geometryObject->calcBoundingBox();
@@ -423,10 +548,21 @@ void DrawViewPart::onHlrFinished(void)
     showProgressMessage(getNameInDocument(), "has finished finding hidden lines");
 
     postHlrTasks();//application level tasks that depend on HLR/GO being complete
+    if (geometryObject != go) {
+        //a second pass in postHlrTasks has already replaced the geometry
+        return;
+    }
 
     //start face finding in a separate thread.  We don't find faces when using the polygon
     //HLR method.
-    if (handleFaces() && !CoarseView.getValue()) {
+    GeometryCache::Faces cachedFaces;
+    if (handleFaces() && !CoarseView.getValue() && !m_geometryKey.empty()
+        && GeometryCache::findFaces(faceCacheKey(), cachedFaces)) {
+        addFacesFromWires(
+            GeometryCache::scaled(cachedFaces.wires, m_geometryScale / cachedFaces.scale));
+        postFaceExtractionTasks();
+    }
+    else if (handleFaces() && !CoarseView.getValue()) {
         try {
             //note that &m_faceWatcher in the third parameter is not strictly required, but using the
             //4 parameter signature instead of the 3 parameter signature prevents clazy warning:
@@ -516,6 +652,7 @@ void DrawViewPart::extractFaces()
     }
 
     showProgressMessage(getNameInDocument(), "is extracting faces");
+    m_faceWires.clear();
 
     const std::vector<TechDraw::BaseGeomPtr>& goEdges =
         geometryObject->getVisibleFaceEdges(SmoothVisible.getValue(), SeamVisible.getValue());
@@ -584,6 +721,7 @@ void DrawViewPart::extractFaces()
                 f->wires.push_back(new TechDraw::Wire(wire));
                 if (geometryObject) {
                     geometryObject->addFaceGeom(f);
+                    m_faceWires.push_back(wire);
                 }
             }
         }
@@ -607,65 +745,7 @@ void DrawViewPart::extractFaces()
 
         //HLR algo does not provide all edge intersections for edge endpoints.
         //need to split long edges touched by Vertex of another edge
-        std::vector<splitPoint> splits;
-        std::vector<TopoDS_Edge>::iterator itOuter = nonZero.begin();
-        int iOuter = 0;
-        for (; itOuter != nonZero.end(); ++itOuter, iOuter++) {//*** itOuter != nonZero.end() - 1
-            TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-            TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-            Bnd_Box sOuter;
-            BRepBndLib::AddOptimal(*itOuter, sOuter);
-            sOuter.SetGap(0.1);
-            if (sOuter.IsVoid()) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge(*itOuter)) {
-                continue;                   //skip zero length edges. shouldn't happen ;)
-            }
-            int iInner = 0;
-            std::vector<TopoDS_Edge>::iterator itInner = nonZero.begin();//***sb itOuter + 1;
-            for (; itInner != nonZero.end(); ++itInner, iInner++) {
-                if (iInner == iOuter) {
-                    continue;
-                }
-                if (DrawUtil::isZeroEdge((*itInner))) {
-                    continue;//skip zero length edges. shouldn't happen ;)
-                }
-
-                Bnd_Box sInner;
-                BRepBndLib::AddOptimal(*itInner, sInner);
-                sInner.SetGap(0.1);
-                if (sInner.IsVoid()) {
-                    continue;
-                }
-                if (sOuter.IsOut(sInner)) {//bboxes of edges don't intersect, don't bother
-                    continue;
-                }
-
-                double param = -1;
-                if (DrawProjectSplit::isOnEdge((*itInner), v1, param, false)) {
-                    gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                    splitPoint s1;
-                    s1.i = iInner;
-                    s1.v = Base::Vector3d(pnt1.X(), pnt1.Y(), pnt1.Z());
-                    s1.param = param;
-                    splits.push_back(s1);
-                }
-                if (DrawProjectSplit::isOnEdge((*itInner), v2, param, false)) {
-                    gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                    splitPoint s2;
-                    s2.i = iInner;
-                    s2.v = Base::Vector3d(pnt2.X(), pnt2.Y(), pnt2.Z());
-                    s2.param = param;
-                    splits.push_back(s2);
-                }
-            }//inner loop
-        }    //outer loop
-
-        std::vector<splitPoint> sorted = DrawProjectSplit::sortSplits(splits, true);
-        auto last = std::unique(sorted.begin(), sorted.end(),
-                                DrawProjectSplit::splitEqual);//duplicates to back
-        sorted.erase(last, sorted.end());                     //remove dupl splits
+        std::vector<splitPoint> sorted = DrawProjectSplit::findSplitPoints(nonZero);
         std::vector<TopoDS_Edge> newEdges = DrawProjectSplit::splitEdges(nonZero, sorted);
 
         if (newEdges.empty()) {
@@ -696,12 +776,27 @@ void DrawViewPart::extractFaces()
                 f->wires.push_back(w);
                 if (geometryObject) {
                     geometryObject->addFaceGeom(f);
+                    m_faceWires.push_back(wire);
                 }
             }
         }
     }
 }
 
+//! make faces from wires found by an earlier extractFaces
+void DrawViewPart::addFacesFromWires(const std::vector<TopoDS_Wire>& wires)
+{
+    if (!geometryObject) {
+        return;
+    }
+    geometryObject->clearFaceGeom();
+    for (auto& wire : wires) {
+        TechDraw::FacePtr f(std::make_shared<TechDraw::Face>());
+        f->wires.push_back(new TechDraw::Wire(wire));
+        geometryObject->addFaceGeom(f);
+    }
+}
+
 //continue processing after extractFaces thread completes
 void DrawViewPart::onFacesFinished(void)
 {
@@ -710,6 +805,10 @@ void DrawViewPart::onFacesFinished(void)
     QObject::disconnect(connectFaceWatcher);
     showProgressMessage(getNameInDocument(), "has finished extracting faces");
 
+    if (!m_geometryKey.empty() && !m_faceWires.empty()) {
+        GeometryCache::addFaces(faceCacheKey(), {m_faceWires, m_geometryScale});
+    }
+
     // Now we can recompute Dimensions and do other tasks possibly depending on Face extraction
     postFaceExtractionTasks();
 
@@ -250,6 +250,14 @@ protected:
     virtual void addShapes2d(void);
 
     void extractFaces();
+    void addFacesFromWires(const std::vector<TopoDS_Wire>& wires);
+
+    TechDraw::GeometryObjectPtr createGeometryObject();
+    std::vector<TopoDS_Shape> geometryCacheSources(const TopoDS_Shape& shape) const;
+    std::string geometryContentKey(const std::vector<TopoDS_Shape>& sources) const;
+    std::string geometryCacheKey(const std::string& contentKey) const;
+    std::string faceCacheKey();
+    bool geometryPropertyTouched() const;
 
     Base::Vector3d shapeCentroid;
     void getRunControl();
@@ -274,6 +282,18 @@ protected:
 
     std::vector<TechDraw::VertexPtr> m_referenceVerts;
 
+    //keys in the GeometryCache and source shapes (see geometryCacheSources) of geometryObject
+    //and m_tempGeometryObject, empty if they are not cached
+    std::string m_geometryKey;
+    std::string m_geometryContentKey;
+    double m_geometryScale;
+    std::vector<TopoDS_Shape> m_geometrySources;
+    std::string m_tempGeometryKey;
+    std::string m_tempGeometryContentKey;
+    double m_tempGeometryScale;
+    std::vector<TopoDS_Shape> m_tempGeometrySources;
+    std::vector<TopoDS_Wire> m_faceWires;//the wires of the faces made by extractFaces
+
 private:
     bool nowUnsetting;
     bool m_waitingForFaces;
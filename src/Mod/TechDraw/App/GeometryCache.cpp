@@ -0,0 +1,192 @@
+/***************************************************************************
+ *   Copyright (c) 2023 WandererFan <wandererfan@gmail.com>                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <list>
+# include <mutex>
+# include <unordered_map>
+#include <TopoDS.hxx>
+#include <TopoDS_Iterator.hxx>
+#endif
+
+#include "DrawUtil.h"
+#include "GeometryCache.h"
+#include "Preferences.h"
+
+
+using namespace TechDraw;
+
+namespace {
+
+//least recently used entries are dropped first
+template<typename T>
+class LRUCache
+{
+public:
+    bool find(const std::string& key, T& result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            return false;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        result = it->second->second;
+        return true;
+    }
+
+    void add(const std::string& key, const T& value, size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+        if (capacity > 0) {
+            m_entries.emplace_front(key, value);
+            m_index[key] = m_entries.begin();
+        }
+        while (m_entries.size() > capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+private:
+    using Entries = std::list<std::pair<std::string, T>>;
+    std::mutex m_mutex;
+    Entries m_entries;
+    std::unordered_map<std::string, typename Entries::iterator> m_index;
+};
+
+LRUCache<GeometryCache::Projection>& projections()
+{
+    static LRUCache<GeometryCache::Projection> cache;
+    return cache;
+}
+
+LRUCache<GeometryCache::Faces>& faces()
+{
+    static LRUCache<GeometryCache::Faces> cache;
+    return cache;
+}
+
+size_t capacity()
+{
+    return static_cast<size_t>(std::max(0, Preferences::geometryCacheSize()));
+}
+
+bool isSameShape(const TopoDS_Shape& shape1, const TopoDS_Shape& shape2)
+{
+    if (shape1.IsEqual(shape2)) {
+        return true;
+    }
+    if (shape1.IsNull() || shape2.IsNull() || shape1.ShapeType() != TopAbs_COMPOUND
+        || shape2.ShapeType() != TopAbs_COMPOUND || shape1.Orientation() != shape2.Orientation()
+        || !shape1.Location().IsEqual(shape2.Location())) {
+        return false;
+    }
+    TopoDS_Iterator it1(shape1, false, false);
+    TopoDS_Iterator it2(shape2, false, false);
+    for (; it1.More() && it2.More(); it1.Next(), it2.Next()) {
+        if (!isSameShape(it1.Value(), it2.Value())) {
+            return false;
+        }
+    }
+    return !it1.More() && !it2.More();
+}
+
+}// namespace
+
+bool GeometryCache::isSame(const std::vector<TopoDS_Shape>& shapes1,
+                           const std::vector<TopoDS_Shape>& shapes2)
+{
+    if (shapes1.size() != shapes2.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < shapes1.size(); i++) {
+        if (!isSameShape(shapes1[i], shapes2[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GeometryCache::findProjection(const std::string& key, Projection& result)
+{
+    return projections().find(key, result);
+}
+
+void GeometryCache::addProjection(const std::string& key, const Projection& projection)
+{
+    projections().add(key, projection, capacity());
+}
+
+bool GeometryCache::findFaces(const std::string& key, Faces& result)
+{
+    return faces().find(key, result);
+}
+
+void GeometryCache::addFaces(const std::string& key, const Faces& faceWires)
+{
+    faces().add(key, faceWires, capacity());
+}
+
+HLRCompounds GeometryCache::scaled(const HLRCompounds& compounds, double factor)
+{
+    if (DrawUtil::fpCompare(factor, 1.0)) {
+        return compounds;
+    }
+    auto scale = [factor](const TopoDS_Shape& shape) {
+        return shape.IsNull() ? shape : TechDraw::scaleShape(shape, factor);
+    };
+    HLRCompounds result;
+    result.visHard = scale(compounds.visHard);
+    result.visOutline = scale(compounds.visOutline);
+    result.visSmooth = scale(compounds.visSmooth);
+    result.visSeam = scale(compounds.visSeam);
+    result.visIso = scale(compounds.visIso);
+    result.hidHard = scale(compounds.hidHard);
+    result.hidOutline = scale(compounds.hidOutline);
+    result.hidSmooth = scale(compounds.hidSmooth);
+    result.hidSeam = scale(compounds.hidSeam);
+    result.hidIso = scale(compounds.hidIso);
+    return result;
+}
+
+std::vector<TopoDS_Wire> GeometryCache::scaled(const std::vector<TopoDS_Wire>& wires,
+                                               double factor)
+{
+    if (DrawUtil::fpCompare(factor, 1.0)) {
+        return wires;
+    }
+    std::vector<TopoDS_Wire> result;
+    result.reserve(wires.size());
+    for (auto& wire : wires) {
+        result.push_back(TopoDS::Wire(TechDraw::scaleShape(wire, factor)));
+    }
+    return result;
+}
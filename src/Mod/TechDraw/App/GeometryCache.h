@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (c) 2023 WandererFan <wandererfan@gmail.com>                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TECHDRAW_GEOMETRYCACHE_H
+#define TECHDRAW_GEOMETRYCACHE_H
+
+#include <string>
+#include <vector>
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Wire.hxx>
+
+#include <Mod/TechDraw/TechDrawGlobal.h>
+
+#include "GeometryObject.h"
+
+
+namespace TechDraw
+{
+
+//! Keeps the hidden line removal and face finding results of recently projected views,
+//! so that a view whose shape and projection did not change is not projected again.
+//! The entries are looked up by a key made by the view from the hashes and lengths of
+//! the BRep text of its shapes (see Part::Tools::contentKey) and its projection parameters.
+//! The cache is shared by all documents and may be used from any thread.
+class TechDrawExport GeometryCache
+{
+public:
+    //! the HLR output of a view made at the given scale
+    struct Projection
+    {
+        HLRCompounds compounds;
+        double scale;
+    };
+
+    //! the wires of the faces of a view made at the given scale
+    struct Faces
+    {
+        std::vector<TopoDS_Wire> wires;
+        double scale;
+    };
+
+    //! true if the shapes share their TShapes, locations and orientations, so that their
+    //! content is known to be the same without writing them. Compounds are compared by
+    //! their children, as a view puts the shapes of its sources in a new compound.
+    static bool isSame(const std::vector<TopoDS_Shape>& shapes1,
+                       const std::vector<TopoDS_Shape>& shapes2);
+
+    static bool findProjection(const std::string& key, Projection& result);
+    static void addProjection(const std::string& key, const Projection& projection);
+    static bool findFaces(const std::string& key, Faces& result);
+    static void addFaces(const std::string& key, const Faces& faces);
+
+    //! scale cached output about the origin
+    static HLRCompounds scaled(const HLRCompounds& compounds, double factor);
+    static std::vector<TopoDS_Wire> scaled(const std::vector<TopoDS_Wire>& wires, double factor);
+};
+
+}// namespace TechDraw
+
+#endif// TECHDRAW_GEOMETRYCACHE_H
@@ -23,6 +23,8 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+#include <QtConcurrentMap>
+
 #include <BRepAlgo_NormalProjection.hxx>
 #include <BRepBndLib.hxx>
 #include <BRepBuilderAPI_Copy.hxx>
@@ -46,8 +48,10 @@
 #include <TopExp.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <TopoDS_Iterator.hxx>
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Vertex.hxx>
 #include <gp_Ax1.hxx>
@@ -61,6 +65,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <exception>
 
 #include <Base/Console.h>
 #include <Mod/Part/App/PartFeature.h>
@@ -141,18 +146,130 @@ void GeometryObject::clear()
     edgeGeom.clear();
 }
 
-void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& viewAxis)
+namespace {
+
+void addHLRPieces(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& pieces)
 {
-//    Base::Console().Message("GO::projectShape()\n");
-    clear();
+    if (shape.IsNull()) {
+        return;
+    }
+    if (shape.ShapeType() != TopAbs_COMPOUND) {
+        pieces.push_back(shape);
+        return;
+    }
+    for (TopoDS_Iterator it(shape); it.More(); it.Next()) {
+        addHLRPieces(it.Value(), pieces);
+    }
+}
 
+//split a shape into groups of pieces (solids, shells, ...) whose extents in the view plane
+//do not overlap, so that no group can hide an edge of another group and each group can be
+//projected on its own. Returns the shape itself if it can not be split.
+std::vector<TopoDS_Shape> partitionForHLR(const TopoDS_Shape& shape, const gp_Ax2& viewAxis)
+{
+    std::vector<TopoDS_Shape> pieces;
+    addHLRPieces(shape, pieces);
+    if (pieces.size() < 2) {
+        return {shape};
+    }
+
+    //the extents of the pieces in view coordinates, from the exact geometry as a mesh
+    //may lie inside of the surfaces
+    gp_Trsf toView;
+    toView.SetTransformation(gp_Ax3(viewAxis));
+    struct Extent {
+        double xMin, yMin, xMax, yMax;
+        size_t piece;
+    };
+    std::vector<Extent> extents;
+    std::vector<size_t> noExtent;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        Bnd_Box box;
+        BRepBndLib::Add(pieces[i], box, false);
+        if (box.IsVoid()) {
+            noExtent.push_back(i);
+            continue;
+        }
+        box = box.Transformed(toView);
+        box.Enlarge(Precision::Confusion());
+        double zMin, zMax;
+        Extent extent;
+        box.Get(extent.xMin, extent.yMin, zMin, extent.xMax, extent.yMax, zMax);
+        extent.piece = i;
+        extents.push_back(extent);
+    }
+
+    //union the pieces with overlapping extents, sweeping in x
+    std::vector<size_t> parent(pieces.size());
+    for (size_t i = 0; i < parent.size(); i++) {
+        parent[i] = i;
+    }
+    auto root = [&parent](size_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+    auto join = [&](size_t a, size_t b) {
+        a = root(a);
+        b = root(b);
+        if (a != b) {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    };
+    std::sort(extents.begin(), extents.end(), [](const Extent& a, const Extent& b) {
+        return a.xMin < b.xMin;
+    });
+    for (size_t i = 0; i < extents.size(); i++) {
+        for (size_t j = i + 1; j < extents.size() && extents[j].xMin <= extents[i].xMax; j++) {
+            if (extents[j].yMin <= extents[i].yMax && extents[i].yMin <= extents[j].yMax) {
+                join(extents[i].piece, extents[j].piece);
+            }
+        }
+    }
+    for (auto i : noExtent) {
+        join(i, 0);
+    }
+
+    std::vector<size_t> group(pieces.size(), pieces.size());
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        size_t r = root(i);
+        if (group[r] == pieces.size()) {
+            group[r] = groups.size();
+            groups.emplace_back();
+        }
+        groups[group[r]].push_back(i);
+    }
+    if (groups.size() < 2) {
+        return {shape};
+    }
+
+    std::vector<TopoDS_Shape> parts;
+    BRep_Builder builder;
+    for (auto& members : groups) {
+        TopoDS_Compound comp;
+        builder.MakeCompound(comp);
+        for (auto i : members) {
+            builder.Add(comp, pieces[i]);
+        }
+        parts.push_back(comp);
+    }
+    return parts;
+}
+
+//!project a shape with the exact hidden line remover
+void hideLines(const TopoDS_Shape& shape, const gp_Ax2& viewAxis, int isoCount, bool isPersp,
+               double focus, HLRCompounds& result)
+{
     Handle(HLRBRep_Algo) brep_hlr;
     try {
         brep_hlr = new HLRBRep_Algo();
         //        brep_hlr->Debug(true);
-        brep_hlr->Add(inShape, m_isoCount);
-        if (m_isPersp) {
-            double fLength = std::max(Precision::Confusion(), m_focus);
+        brep_hlr->Add(shape, isoCount);
+        if (isPersp) {
+            double fLength = std::max(Precision::Confusion(), focus);
             HLRAlgo_Projector projector(viewAxis, fLength);
             brep_hlr->Projector(projector);
         }
@@ -176,65 +293,65 @@ void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& vie
         HLRBRep_HLRToShape hlrToShape(brep_hlr);
 
         if (!hlrToShape.VCompound().IsNull()) {
-            visHard = hlrToShape.VCompound();
-            BRepLib::BuildCurves3d(visHard);
-            visHard = invertGeometry(visHard);
-            //            BRepTools::Write(visHard, "GOvisHard.brep");            //debug
+            result.visHard = hlrToShape.VCompound();
+            BRepLib::BuildCurves3d(result.visHard);
+            result.visHard = GeometryObject::invertGeometry(result.visHard);
+            //            BRepTools::Write(result.visHard, "GOvisHard.brep");            //debug
         }
 
         if (!hlrToShape.Rg1LineVCompound().IsNull()) {
-            visSmooth = hlrToShape.Rg1LineVCompound();
-            BRepLib::BuildCurves3d(visSmooth);
-            visSmooth = invertGeometry(visSmooth);
+            result.visSmooth = hlrToShape.Rg1LineVCompound();
+            BRepLib::BuildCurves3d(result.visSmooth);
+            result.visSmooth = GeometryObject::invertGeometry(result.visSmooth);
         }
 
         if (!hlrToShape.RgNLineVCompound().IsNull()) {
-            visSeam = hlrToShape.RgNLineVCompound();
-            BRepLib::BuildCurves3d(visSeam);
-            visSeam = invertGeometry(visSeam);
+            result.visSeam = hlrToShape.RgNLineVCompound();
+            BRepLib::BuildCurves3d(result.visSeam);
+            result.visSeam = GeometryObject::invertGeometry(result.visSeam);
         }
 
         if (!hlrToShape.OutLineVCompound().IsNull()) {
             //            BRepTools::Write(hlrToShape.OutLineVCompound(), "GOOutLineVCompound.brep");            //debug
-            visOutline = hlrToShape.OutLineVCompound();
-            BRepLib::BuildCurves3d(visOutline);
-            visOutline = invertGeometry(visOutline);
+            result.visOutline = hlrToShape.OutLineVCompound();
+            BRepLib::BuildCurves3d(result.visOutline);
+            result.visOutline = GeometryObject::invertGeometry(result.visOutline);
         }
 
         if (!hlrToShape.IsoLineVCompound().IsNull()) {
-            visIso = hlrToShape.IsoLineVCompound();
-            BRepLib::BuildCurves3d(visIso);
-            visIso = invertGeometry(visIso);
+            result.visIso = hlrToShape.IsoLineVCompound();
+            BRepLib::BuildCurves3d(result.visIso);
+            result.visIso = GeometryObject::invertGeometry(result.visIso);
         }
 
         if (!hlrToShape.HCompound().IsNull()) {
-            hidHard = hlrToShape.HCompound();
-            BRepLib::BuildCurves3d(hidHard);
-            hidHard = invertGeometry(hidHard);
+            result.hidHard = hlrToShape.HCompound();
+            BRepLib::BuildCurves3d(result.hidHard);
+            result.hidHard = GeometryObject::invertGeometry(result.hidHard);
         }
 
         if (!hlrToShape.Rg1LineHCompound().IsNull()) {
-            hidSmooth = hlrToShape.Rg1LineHCompound();
-            BRepLib::BuildCurves3d(hidSmooth);
-            hidSmooth = invertGeometry(hidSmooth);
+            result.hidSmooth = hlrToShape.Rg1LineHCompound();
+            BRepLib::BuildCurves3d(result.hidSmooth);
+            result.hidSmooth = GeometryObject::invertGeometry(result.hidSmooth);
         }
 
         if (!hlrToShape.RgNLineHCompound().IsNull()) {
-            hidSeam = hlrToShape.RgNLineHCompound();
-            BRepLib::BuildCurves3d(hidSeam);
-            hidSeam = invertGeometry(hidSeam);
+            result.hidSeam = hlrToShape.RgNLineHCompound();
+            BRepLib::BuildCurves3d(result.hidSeam);
+            result.hidSeam = GeometryObject::invertGeometry(result.hidSeam);
         }
 
         if (!hlrToShape.OutLineHCompound().IsNull()) {
-            hidOutline = hlrToShape.OutLineHCompound();
-            BRepLib::BuildCurves3d(hidOutline);
-            hidOutline = invertGeometry(hidOutline);
+            result.hidOutline = hlrToShape.OutLineHCompound();
+            BRepLib::BuildCurves3d(result.hidOutline);
+            result.hidOutline = GeometryObject::invertGeometry(result.hidOutline);
         }
 
         if (!hlrToShape.IsoLineHCompound().IsNull()) {
-            hidIso = hlrToShape.IsoLineHCompound();
-            BRepLib::BuildCurves3d(hidIso);
-            hidIso = invertGeometry(hidIso);
+            result.hidIso = hlrToShape.IsoLineHCompound();
+            BRepLib::BuildCurves3d(result.hidIso);
+            result.hidIso = GeometryObject::invertGeometry(result.hidIso);
         }
     }
     catch (const Standard_Failure&) {
@@ -245,10 +362,163 @@ void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& vie
         throw Base::RuntimeError(
             "GeometryObject::projectShape - unknown error occurred while extracting edges");
     }
+}
+
+//!project a shape with the polygon hidden line remover, the faces of shape must be meshed
+void hideLinesWithPolygonAlgo(const TopoDS_Shape& shape, const gp_Ax2& viewAxis, bool isPersp,
+                              double focus, HLRCompounds& result)
+{
+    Handle(HLRBRep_PolyAlgo) brep_hlrPoly;
+
+    try {
+        brep_hlrPoly = new HLRBRep_PolyAlgo();
+        brep_hlrPoly->Load(shape);
+
+        if (isPersp) {
+            double fLength = std::max(Precision::Confusion(), focus);
+            HLRAlgo_Projector projector(viewAxis, fLength);
+            brep_hlrPoly->Projector(projector);
+        }
+        else {// non perspective
+            HLRAlgo_Projector projector(viewAxis);
+            brep_hlrPoly->Projector(projector);
+        }
+        brep_hlrPoly->Update();
+    }
+    catch (const Standard_Failure& e) {
+        Base::Console().Error(
+            "GO::projectShapeWithPolygonAlgo - OCC error - %s - while projecting shape\n",
+            e.GetMessageString());
+        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - OCC error");
+    }
+    catch (...) {
+        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - unknown error");
+    }
+
+    try {
+        HLRBRep_PolyHLRToShape polyhlrToShape;
+        polyhlrToShape.Update(brep_hlrPoly);
+
+        result.visHard = polyhlrToShape.VCompound();
+        BRepLib::BuildCurves3d(result.visHard);
+        result.visHard = GeometryObject::invertGeometry(result.visHard);
+        //        BRepTools::Write(result.visHard, "GOvisHardi.brep");            //debug
+
+        result.visSmooth = polyhlrToShape.Rg1LineVCompound();
+        BRepLib::BuildCurves3d(result.visSmooth);
+        result.visSmooth = GeometryObject::invertGeometry(result.visSmooth);
+
+        result.visSeam = polyhlrToShape.RgNLineVCompound();
+        BRepLib::BuildCurves3d(result.visSeam);
+        result.visSeam = GeometryObject::invertGeometry(result.visSeam);
+
+        result.visOutline = polyhlrToShape.OutLineVCompound();
+        BRepLib::BuildCurves3d(result.visOutline);
+        result.visOutline = GeometryObject::invertGeometry(result.visOutline);
+
+        result.hidHard = polyhlrToShape.HCompound();
+        BRepLib::BuildCurves3d(result.hidHard);
+        result.hidHard = GeometryObject::invertGeometry(result.hidHard);
+        //        BRepTools::Write(result.hidHard, "GOhidHardi.brep");            //debug
+
+        result.hidSmooth = polyhlrToShape.Rg1LineHCompound();
+        BRepLib::BuildCurves3d(result.hidSmooth);
+        result.hidSmooth = GeometryObject::invertGeometry(result.hidSmooth);
+
+        result.hidSeam = polyhlrToShape.RgNLineHCompound();
+        BRepLib::BuildCurves3d(result.hidSeam);
+        result.hidSeam = GeometryObject::invertGeometry(result.hidSeam);
+
+        result.hidOutline = polyhlrToShape.OutLineHCompound();
+        BRepLib::BuildCurves3d(result.hidOutline);
+        result.hidOutline = GeometryObject::invertGeometry(result.hidOutline);
+    }
+    catch (const Standard_Failure& e) {
+        Base::Console().Error(
+            "GO::projectShapeWithPolygonAlgo - OCC error - %s - while extracting edges\n",
+            e.GetMessageString());
+        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - OCC error occurred "
+                                 "while extracting edges");
+    }
+    catch (...) {
+        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - unknown error "
+                                 "occurred while extracting edges");
+    }
+}
+
+}// namespace
 
+void GeometryObject::projectShape(const TopoDS_Shape& inShape, const gp_Ax2& viewAxis)
+{
+//    Base::Console().Message("GO::projectShape()\n");
+    clear();
+
+    //parts of the shape that can not hide each other are projected concurrently
+    std::vector<TopoDS_Shape> parts;
+    if (m_isPersp) {
+        parts.push_back(inShape);
+    }
+    else {
+        parts = partitionForHLR(inShape, viewAxis);
+    }
+
+    std::vector<HLRCompounds> results(parts.size());
+    int isoCount = m_isoCount;
+    bool isPersp = m_isPersp;
+    double focus = m_focus;
+    auto hide = [&](HLRCompounds& result) {
+        try {
+            hideLines(parts[&result - results.data()], viewAxis, isoCount, isPersp, focus, result);
+        }
+        catch (...) {
+            result.error = std::current_exception();
+        }
+    };
+    if (results.size() == 1) {
+        hide(results.front());
+    }
+    else {
+        QtConcurrent::blockingMap(results, hide);
+    }
+
+    mergeHLRCompounds(results);
     makeTDGeometry();
 }
 
+void GeometryObject::setHLRCompounds(const HLRCompounds& compounds)
+{
+    clear();
+
+    visHard = compounds.visHard;
+    visOutline = compounds.visOutline;
+    visSmooth = compounds.visSmooth;
+    visSeam = compounds.visSeam;
+    visIso = compounds.visIso;
+    hidHard = compounds.hidHard;
+    hidOutline = compounds.hidOutline;
+    hidSmooth = compounds.hidSmooth;
+    hidSeam = compounds.hidSeam;
+    hidIso = compounds.hidIso;
+
+    makeTDGeometry();
+}
+
+HLRCompounds GeometryObject::getHLRCompounds() const
+{
+    HLRCompounds compounds;
+    compounds.visHard = visHard;
+    compounds.visOutline = visOutline;
+    compounds.visSmooth = visSmooth;
+    compounds.visSeam = visSeam;
+    compounds.visIso = visIso;
+    compounds.hidHard = hidHard;
+    compounds.hidOutline = hidOutline;
+    compounds.hidSmooth = hidSmooth;
+    compounds.hidSeam = hidSeam;
+    compounds.hidIso = hidIso;
+    return compounds;
+}
+
 //convert the hlr output into TD Geometry
 void GeometryObject::makeTDGeometry()
 {
@@ -326,8 +596,7 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input, cons
         inCopy = BuilderCopy.Shape();
     }
 
-    Handle(HLRBRep_PolyAlgo) brep_hlrPoly;
-
+    //the parts may share faces, so the mesh is made before they are projected concurrently
     try {
         TopExp_Explorer faces(inCopy, TopAbs_FACE);
         for (int i = 1; faces.More(); faces.Next(), i++) {
@@ -336,19 +605,6 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input, cons
                 BRepMesh_IncrementalMesh(f, 0.10);//Poly Algo requires a mesh!
             }
         }
-        brep_hlrPoly = new HLRBRep_PolyAlgo();
-        brep_hlrPoly->Load(inCopy);
-
-        if (m_isPersp) {
-            double fLength = std::max(Precision::Confusion(), m_focus);
-            HLRAlgo_Projector projector(viewAxis, fLength);
-            brep_hlrPoly->Projector(projector);
-        }
-        else {// non perspective
-            HLRAlgo_Projector projector(viewAxis);
-            brep_hlrPoly->Projector(projector);
-        }
-        brep_hlrPoly->Update();
     }
     catch (const Standard_Failure& e) {
         Base::Console().Error(
@@ -356,63 +612,78 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input, cons
             e.GetMessageString());
         throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - OCC error");
     }
-    catch (...) {
-        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - unknown error");
-    }
-
-    try {
-        HLRBRep_PolyHLRToShape polyhlrToShape;
-        polyhlrToShape.Update(brep_hlrPoly);
-
-        visHard = polyhlrToShape.VCompound();
-        BRepLib::BuildCurves3d(visHard);
-        visHard = invertGeometry(visHard);
-        //        BRepTools::Write(visHard, "GOvisHardi.brep");            //debug
-
-        visSmooth = polyhlrToShape.Rg1LineVCompound();
-        BRepLib::BuildCurves3d(visSmooth);
-        visSmooth = invertGeometry(visSmooth);
 
-        visSeam = polyhlrToShape.RgNLineVCompound();
-        BRepLib::BuildCurves3d(visSeam);
-        visSeam = invertGeometry(visSeam);
-
-        visOutline = polyhlrToShape.OutLineVCompound();
-        BRepLib::BuildCurves3d(visOutline);
-        visOutline = invertGeometry(visOutline);
-
-        hidHard = polyhlrToShape.HCompound();
-        BRepLib::BuildCurves3d(hidHard);
-        hidHard = invertGeometry(hidHard);
-        //        BRepTools::Write(hidHard, "GOhidHardi.brep");            //debug
-
-        hidSmooth = polyhlrToShape.Rg1LineHCompound();
-        BRepLib::BuildCurves3d(hidSmooth);
-        hidSmooth = invertGeometry(hidSmooth);
-
-        hidSeam = polyhlrToShape.RgNLineHCompound();
-        BRepLib::BuildCurves3d(hidSeam);
-        hidSeam = invertGeometry(hidSeam);
-
-        hidOutline = polyhlrToShape.OutLineHCompound();
-        BRepLib::BuildCurves3d(hidOutline);
-        hidOutline = invertGeometry(hidOutline);
+    std::vector<TopoDS_Shape> parts;
+    if (m_isPersp) {
+        parts.push_back(inCopy);
     }
-    catch (const Standard_Failure& e) {
-        Base::Console().Error(
-            "GO::projectShapeWithPolygonAlgo - OCC error - %s - while extracting edges\n",
-            e.GetMessageString());
-        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - OCC error occurred "
-                                 "while extracting edges");
+    else {
+        parts = partitionForHLR(inCopy, viewAxis);
     }
-    catch (...) {
-        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo - unknown error "
-                                 "occurred while extracting edges");
+
+    std::vector<HLRCompounds> results(parts.size());
+    bool isPersp = m_isPersp;
+    double focus = m_focus;
+    auto hide = [&](HLRCompounds& result) {
+        try {
+            hideLinesWithPolygonAlgo(parts[&result - results.data()], viewAxis, isPersp, focus,
+                                     result);
+        }
+        catch (...) {
+            result.error = std::current_exception();
+        }
+    };
+    if (results.size() == 1) {
+        hide(results.front());
+    }
+    else {
+        QtConcurrent::blockingMap(results, hide);
     }
 
+    mergeHLRCompounds(results);
     makeTDGeometry();
 }
 
+//merge the HLR output of the parts of a shape, the first error of a part is rethrown
+void GeometryObject::mergeHLRCompounds(const std::vector<HLRCompounds>& results)
+{
+    for (auto& result : results) {
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+    }
+
+    auto merge = [&results](TopoDS_Shape HLRCompounds::*member) {
+        std::vector<TopoDS_Shape> shapes;
+        for (auto& result : results) {
+            if (!(result.*member).IsNull()) {
+                shapes.push_back(result.*member);
+            }
+        }
+        if (shapes.size() < 2) {
+            return shapes.empty() ? TopoDS_Shape() : shapes.front();
+        }
+        BRep_Builder builder;
+        TopoDS_Compound comp;
+        builder.MakeCompound(comp);
+        for (auto& shape : shapes) {
+            builder.Add(comp, shape);
+        }
+        return TopoDS_Shape(comp);
+    };
+
+    visHard = merge(&HLRCompounds::visHard);
+    visOutline = merge(&HLRCompounds::visOutline);
+    visSmooth = merge(&HLRCompounds::visSmooth);
+    visSeam = merge(&HLRCompounds::visSeam);
+    visIso = merge(&HLRCompounds::visIso);
+    hidHard = merge(&HLRCompounds::hidHard);
+    hidOutline = merge(&HLRCompounds::hidOutline);
+    hidSmooth = merge(&HLRCompounds::hidSmooth);
+    hidSeam = merge(&HLRCompounds::hidSeam);
+    hidIso = merge(&HLRCompounds::hidIso);
+}
+
 //project the edges in shape onto XY.mirrored plane of CS.  mimics the projection
 //of the main hlr routine. Only the visible hard edges are returned, so this method
 //is only suitable for simple shapes that have no hidden edges, like faces or wires.
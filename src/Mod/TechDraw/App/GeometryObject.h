@@ -25,6 +25,7 @@
 
 #include <Mod/TechDraw/TechDrawGlobal.h>
 
+#include <exception>
 #include <memory>
 #include <string>
 #include <vector>
@@ -95,6 +96,14 @@ gp_Ax2 TechDrawExport getViewAxis(const Base::Vector3d origin, const Base::Vecto
 gp_Ax2 TechDrawExport legacyViewAxis1(const Base::Vector3d origin, const Base::Vector3d& direction,
                                       const bool flip = true);
 
+//! the HLR output of a shape, one compound per class of edges
+struct HLRCompounds
+{
+    TopoDS_Shape visHard, visOutline, visSmooth, visSeam, visIso;
+    TopoDS_Shape hidHard, hidOutline, hidSmooth, hidSeam, hidIso;
+    std::exception_ptr error;
+};
+
 class TechDrawExport GeometryObject
 {
 public:
@@ -117,6 +126,9 @@ public:
 
     void projectShape(const TopoDS_Shape& input, const gp_Ax2& viewAxis);
     void projectShapeWithPolygonAlgo(const TopoDS_Shape& input, const gp_Ax2& viewAxis);
+    //! make the geometry from the HLR output of an earlier projection
+    void setHLRCompounds(const HLRCompounds& compounds);
+    HLRCompounds getHLRCompounds() const;
     static TopoDS_Shape projectSimpleShape(const TopoDS_Shape& shape, const gp_Ax2& CS);
     static TopoDS_Shape simpleProjection(const TopoDS_Shape& shape, const gp_Ax2& projCS);
     static TopoDS_Shape projectFace(const TopoDS_Shape& face, const gp_Ax2& CS);
@@ -175,6 +187,7 @@ protected:
     TopoDS_Shape hidSmooth;
     TopoDS_Shape hidSeam;
     TopoDS_Shape hidIso;
+    void mergeHLRCompounds(const std::vector<HLRCompounds>& results);
 
     void addGeomFromCompound(TopoDS_Shape edgeCompound, edgeClass category, bool visible);
     TechDraw::DrawViewDetail* isParentDetail();
@@ -36,12 +36,16 @@
 #include <cstdio>
 #include <chrono>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <list>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // boost
@@ -59,6 +63,7 @@
 #include <QLocale>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QXmlQuery>
 #include <QXmlResultItems>
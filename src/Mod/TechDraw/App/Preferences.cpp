@@ -459,6 +459,18 @@ bool Preferences::reportProgress()
     return report;
 }
 
+//! the number of view projections kept in the geometry cache, 0 disables the cache
+int Preferences::geometryCacheSize()
+{
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication()
+                                             .GetUserParameter()
+                                             .GetGroup("BaseApp")
+                                             ->GetGroup("Preferences")
+                                             ->GetGroup("Mod/TechDraw/General");
+    int size = hGrp->GetInt("GeometryCacheSize", 16);
+    return size;
+}
+
 bool Preferences::lightOnDark()
 {
     Base::Reference<ParameterGrp> hGrp = App::GetApplication()
@@ -86,6 +86,7 @@ public:
     static double GapASME();
 
     static bool reportProgress();
+    static int geometryCacheSize();
 
     static bool lightOnDark();
     static void lightOnDark(bool state);
@@ -50,5 +50,46 @@ class DrawViewPartTest(unittest.TestCase):
         self.assertEqual(len(edges), 4, "DrawViewPart has wrong number of edges")
         self.assertTrue("Up-to-date" in view.State, "DrawViewPart is not Up-to-date")
 
+    def testGeometryCache(self):
+        """Tests that views of unchanged shapes reuse the cached projection and
+        that a changed shape is projected again"""
+        print("testing the geometry cache of DrawViewPart")
+        box = FreeCAD.ActiveDocument.Box
+        box.Length = 13.7
+        view1 = FreeCAD.ActiveDocument.addObject("TechDraw::DrawViewPart", "View1")
+        self.page.addView(view1)
+        view1.Source = [box]
+        FreeCAD.ActiveDocument.recompute()
+        self.waitForThreads()
+        lengths = self.edgeLengths(view1)
+        self.assertEqual(len(lengths), 4, "DrawViewPart has wrong number of edges")
+
+        # a cached projection is used at once, without waiting for the HLR thread
+        view2 = FreeCAD.ActiveDocument.addObject("TechDraw::DrawViewPart", "View2")
+        self.page.addView(view2)
+        view2.Source = [box]
+        FreeCAD.ActiveDocument.recompute()
+        self.assertEqual(self.edgeLengths(view2), lengths,
+                         "DrawViewPart did not reuse the cached projection")
+
+        box.Length = 21.3
+        FreeCAD.ActiveDocument.recompute()
+        self.waitForThreads()
+        self.assertNotEqual(self.edgeLengths(view1), lengths,
+                            "DrawViewPart used the projection of a changed shape")
+
+    def waitForThreads(self):
+        loop = QtCore.QEventLoop()
+
+        timer = QtCore.QTimer()
+        timer.setSingleShot(True)
+        timer.timeout.connect(loop.quit)
+
+        timer.start(2000)   #2 second delay
+        loop.exec_()
+
+    def edgeLengths(self, view):
+        return sorted(round(edge.Length, 6) for edge in view.getVisibleEdges())
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include <sstream>
+#include <vector>
+#include <Base/Stream.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+TEST(Stream, TestBlockMatchesSingleValues)
+{
+    std::vector<float> values{1.0F, -2.5F, 3.25F, 1.0e10F};
+
+    std::stringstream single;
+    Base::OutputStream out1(single);
+    for (float value : values) {
+        out1 << value;
+    }
+
+    std::stringstream block;
+    Base::OutputStream out2(block);
+    out2.write(values.data(), values.size());
+
+    EXPECT_EQ(single.str(), block.str());
+}
+
+TEST(Stream, TestBlockRoundTrip)
+{
+    std::vector<uint32_t> values(10000);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<uint32_t>(i * 2654435761U);
+    }
+
+    for (auto order : {Base::Stream::LittleEndian, Base::Stream::BigEndian}) {
+        std::stringstream str;
+        Base::OutputStream out(str);
+        out.setByteOrder(order);
+        out.write(values.data(), values.size());
+
+        std::vector<uint32_t> result(values.size());
+        Base::InputStream inp(str);
+        inp.setByteOrder(order);
+        inp.read(result.data(), result.size());
+
+        EXPECT_EQ(values, result);
+    }
+}
+
+TEST(Stream, TestBlockSwapsByteOrder)
+{
+    std::vector<int32_t> values{0x01020304, 0x05060708};
+
+    std::stringstream str;
+    Base::OutputStream out(str);
+    out.setByteOrder(Base::Stream::BigEndian);
+    out.write(values.data(), values.size());
+
+    Base::InputStream inp(str);
+    inp.setByteOrder(Base::Stream::BigEndian);
+    int32_t first = 0;
+    int32_t second = 0;
+    inp >> first >> second;
+
+    EXPECT_EQ(first, values[0]);
+    EXPECT_EQ(second, values[1]);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <Mod/Points/App/PointsKDTree.h>
+#include <Mod/Points/App/PointsNormals.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+class KDTreeTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> coord(-1.0, 1.0);
+        for (int i = 0; i < 500; i++) {
+            points.emplace_back(coord(rng), coord(rng), coord(rng));
+        }
+        for (int i = 0; i < 50; i++) {
+            queries.emplace_back(coord(rng), coord(rng), coord(rng));
+        }
+    }
+
+    // the indices of all points sorted by their distance to pnt
+    std::vector<uint32_t> bruteForce(const Base::Vector3d& pnt) const
+    {
+        std::vector<uint32_t> order(points.size());
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return Base::DistanceP2(pnt, points[a]) < Base::DistanceP2(pnt, points[b]);
+        });
+        return order;
+    }
+
+    std::size_t countInRadius(const Base::Vector3d& pnt, double radius) const
+    {
+        return std::count_if(points.begin(), points.end(), [&](const Base::Vector3d& p) {
+            return Base::DistanceP2(pnt, p) <= radius * radius;
+        });
+    }
+
+    std::vector<Base::Vector3d> points;
+    std::vector<Base::Vector3d> queries;
+};
+
+TEST_F(KDTreeTest, KNearestMatchesBruteForce)
+{
+    Points::KDTree tree(points);
+    const std::size_t k = 7;
+    std::vector<uint32_t> found;
+    for (const auto& pnt : queries) {
+        std::vector<uint32_t> expected = bruteForce(pnt);
+        expected.resize(k);
+        tree.findKNearest(pnt, k, found);
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST_F(KDTreeTest, BatchKNearestMatchesBruteForce)
+{
+    Points::KDTree tree(points);
+    const std::size_t k = 5;
+
+    Points::KDTree::Neighbours external = tree.findKNearest(queries, k);
+    ASSERT_EQ(external.size(), queries.size());
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        std::vector<uint32_t> expected = bruteForce(queries[i]);
+        expected.resize(k);
+        EXPECT_EQ(std::vector<uint32_t>(external.begin(i), external.end(i)), expected);
+    }
+
+    // each point is the nearest neighbour of itself
+    Points::KDTree::Neighbours self = tree.findKNearest(k);
+    ASSERT_EQ(self.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        std::vector<uint32_t> expected = bruteForce(points[i]);
+        expected.resize(k);
+        EXPECT_EQ(std::vector<uint32_t>(self.begin(i), self.end(i)), expected);
+        EXPECT_EQ(self.begin(i)[0], i);
+    }
+}
+
+TEST_F(KDTreeTest, RadiusMatchesBruteForce)
+{
+    Points::KDTree tree(points);
+    const double radius = 0.3;
+    std::vector<uint32_t> found;
+    for (const auto& pnt : queries) {
+        std::vector<uint32_t> expected = bruteForce(pnt);
+        expected.resize(countInRadius(pnt, radius));
+        tree.findInRadius(pnt, radius, found);
+        EXPECT_EQ(found, expected);
+
+        // only the nearest ones inside the radius
+        expected.resize(std::min<std::size_t>(expected.size(), 3));
+        tree.findInRadius(pnt, radius, found, 3);
+        EXPECT_EQ(found, expected);
+    }
+
+    Points::KDTree::Neighbours batch = tree.findInRadius(queries, radius);
+    ASSERT_EQ(batch.size(), queries.size());
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        EXPECT_EQ(batch.count(i), countInRadius(queries[i], radius));
+    }
+
+    Points::KDTree::Neighbours self = tree.findInRadius(radius);
+    ASSERT_EQ(self.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(self.count(i), countInRadius(points[i], radius));
+    }
+}
+
+TEST_F(KDTreeTest, EmptyTree)
+{
+    Points::KDTree tree;
+    std::vector<uint32_t> found;
+    tree.findKNearest(Base::Vector3d(), 3, found);
+    EXPECT_TRUE(found.empty());
+    EXPECT_EQ(tree.findKNearest(queries, 3).indices.size(), 0U);
+}
+
+TEST(NormalEstimation, SphereNormalsAreRadial)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> coord;
+    std::vector<Base::Vector3d> points;
+    for (int i = 0; i < 2000; i++) {
+        Base::Vector3d pnt(coord(rng), coord(rng), coord(rng));
+        pnt.Normalize();
+        points.push_back(pnt * 2.0);
+    }
+
+    std::vector<Base::Vector3d> normals;
+    std::vector<double> curvature;
+    Points::NormalEstimation estimation(points);
+    estimation.setKSearch(12);
+
+    // flipped towards the centre
+    estimation.setOrientation(Points::NormalEstimation::Orientation::ViewPoint);
+    estimation.setViewPoint(Base::Vector3d());
+    estimation.perform(normals, &curvature);
+    ASSERT_EQ(normals.size(), points.size());
+    ASSERT_EQ(curvature.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_LT(normals[i].Dot(points[i]) / 2.0, -0.95);
+        EXPECT_GE(curvature[i], 0.0);
+        EXPECT_LT(curvature[i], 0.05);
+    }
+
+    // propagated along the surface all normals point to the same side
+    estimation.setOrientation(Points::NormalEstimation::Orientation::Propagate);
+    estimation.perform(normals);
+    double side = normals[0].Dot(points[0]) > 0.0 ? 1.0 : -1.0;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        EXPECT_GT(side * normals[i].Dot(points[i]) / 2.0, 0.95);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,279 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <Base/Swap.h>
+#include <Mod/Points/App/PointsAlgos.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+class PointsReaderTest: public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        if (!path.empty()) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    // opens a file named after the running test in the temp directory
+    std::ofstream create(const char* extension)
+    {
+        path = std::filesystem::temp_directory_path()
+            / (std::string("PointsReaderTest_")
+               + ::testing::UnitTest::GetInstance()->current_test_info()->name() + extension);
+        return std::ofstream(path, std::ios::out | std::ios::binary);
+    }
+
+    template<typename T>
+    static void write(std::ostream& out, T value, bool bigEndian)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (bigEndian != (Base::SwapOrder() == HIGH_ENDIAN)) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        out.write(bytes, sizeof(T));
+    }
+
+    // the two points of every test file
+    static constexpr float xyz[2][3] = {{1.0F, 2.0F, 3.0F}, {-4.5F, 5.25F, 6.0F}};
+    static constexpr float nxyz[2][3] = {{0.0F, 0.0F, 1.0F}, {0.0F, 1.0F, 0.0F}};
+    // the colors of the points as fractions of the channel range
+    static constexpr float rgb[2][3] = {{1.0F, 0.0F, 0.2F}, {0.0F, 1.0F, 0.6F}};
+
+    void checkPoints(const Points::Reader& reader) const
+    {
+        const Points::PointKernel& points = reader.getPoints();
+        ASSERT_EQ(points.size(), 2U);
+        for (int i = 0; i < 2; i++) {
+            Base::Vector3d pnt = points.getPoint(i);
+            EXPECT_FLOAT_EQ(pnt.x, xyz[i][0]);
+            EXPECT_FLOAT_EQ(pnt.y, xyz[i][1]);
+            EXPECT_FLOAT_EQ(pnt.z, xyz[i][2]);
+        }
+    }
+
+    void checkNormals(const Points::Reader& reader) const
+    {
+        ASSERT_TRUE(reader.hasNormals());
+        const std::vector<Base::Vector3f>& normals = reader.getNormals();
+        ASSERT_EQ(normals.size(), 2U);
+        for (int i = 0; i < 2; i++) {
+            EXPECT_FLOAT_EQ(normals[i].x, nxyz[i][0]);
+            EXPECT_FLOAT_EQ(normals[i].y, nxyz[i][1]);
+            EXPECT_FLOAT_EQ(normals[i].z, nxyz[i][2]);
+        }
+    }
+
+    void checkColors(const Points::Reader& reader) const
+    {
+        ASSERT_TRUE(reader.hasColors());
+        const std::vector<App::Color>& colors = reader.getColors();
+        ASSERT_EQ(colors.size(), 2U);
+        for (int i = 0; i < 2; i++) {
+            EXPECT_NEAR(colors[i].r, rgb[i][0], 1e-6);
+            EXPECT_NEAR(colors[i].g, rgb[i][1], 1e-6);
+            EXPECT_NEAR(colors[i].b, rgb[i][2], 1e-6);
+        }
+    }
+
+    std::filesystem::path path;
+};
+
+TEST_F(PointsReaderTest, plyAscii)
+{
+    {
+        std::ofstream out = create(".ply");
+        out << "ply\nformat ascii 1.0\nelement vertex 2\n"
+               "property float x\nproperty float y\nproperty float z\n"
+               "property float nx\nproperty float ny\nproperty float nz\n"
+               "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+               "end_header\n"
+               "1 2 3 0 0 1 255 0 51\n"
+               "-4.5 5.25 6 0 1 0 0 255 153\n";
+    }
+    Points::PlyReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    checkNormals(reader);
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, plyAsciiPointsOnly)
+{
+    {
+        std::ofstream out = create(".ply");
+        out << "ply\nformat ascii 1.0\nelement vertex 2\n"
+               "property float x\nproperty float y\nproperty float z\n"
+               "end_header\n"
+               "1 2 3\n"
+               "-4.5 5.25 6\n";
+    }
+    Points::PlyReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    EXPECT_FALSE(reader.hasNormals());
+    EXPECT_FALSE(reader.hasColors());
+}
+
+TEST_F(PointsReaderTest, plyBinaryLittleEndian)
+{
+    {
+        std::ofstream out = create(".ply");
+        out << "ply\nformat binary_little_endian 1.0\nelement vertex 2\n"
+               "property float x\nproperty float y\nproperty float z\n"
+               "property float nx\nproperty float ny\nproperty float nz\n"
+               "property ushort red\nproperty ushort green\nproperty ushort blue\n"
+               "end_header\n";
+        for (int i = 0; i < 2; i++) {
+            for (float value : xyz[i]) {
+                write(out, value, false);
+            }
+            for (float value : nxyz[i]) {
+                write(out, value, false);
+            }
+            for (float value : rgb[i]) {
+                write(out, static_cast<uint16_t>(value * 65535.0F + 0.5F), false);
+            }
+        }
+    }
+    Points::PlyReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    checkNormals(reader);
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, plyBinaryBigEndian)
+{
+    {
+        std::ofstream out = create(".ply");
+        out << "ply\nformat binary_big_endian 1.0\nelement vertex 2\n"
+               "property double x\nproperty double y\nproperty double z\n"
+               "property float red\nproperty float green\nproperty float blue\n"
+               "end_header\n";
+        for (int i = 0; i < 2; i++) {
+            for (float value : xyz[i]) {
+                write(out, static_cast<double>(value), true);
+            }
+            for (float value : rgb[i]) {
+                write(out, value, true);
+            }
+        }
+    }
+    Points::PlyReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    EXPECT_FALSE(reader.hasNormals());
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, plyBinaryBigEndianNormals)
+{
+    {
+        std::ofstream out = create(".ply");
+        out << "ply\nformat binary_big_endian 1.0\nelement vertex 2\n"
+               "property float x\nproperty float y\nproperty float z\n"
+               "property float nx\nproperty float ny\nproperty float nz\n"
+               "property int red\nproperty int green\nproperty int blue\n"
+               "end_header\n";
+        for (int i = 0; i < 2; i++) {
+            for (float value : xyz[i]) {
+                write(out, value, true);
+            }
+            for (float value : nxyz[i]) {
+                write(out, value, true);
+            }
+            for (float value : rgb[i]) {
+                write(out, static_cast<int32_t>(value * 2147483647.0 + 0.5), true);
+            }
+        }
+    }
+    Points::PlyReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    checkNormals(reader);
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, pcdAscii)
+{
+    {
+        std::ofstream out = create(".pcd");
+        out << "VERSION .7\nFIELDS x y z normal_x normal_y normal_z rgb\n"
+               "SIZE 4 4 4 4 4 4 4\nTYPE F F F F F F U\nCOUNT 1 1 1 1 1 1 1\n"
+               "WIDTH 2\nHEIGHT 1\nPOINTS 2\nDATA ascii\n"
+               "1 2 3 0 0 1 16711731\n"      // 0xff0033
+               "-4.5 5.25 6 0 1 0 65433\n";  // 0x00ff99
+    }
+    Points::PcdReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    checkNormals(reader);
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, pcdAsciiPointsOnly)
+{
+    {
+        std::ofstream out = create(".pcd");
+        out << "VERSION .7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n"
+               "WIDTH 2\nHEIGHT 1\nPOINTS 2\nDATA ascii\n"
+               "1 2 3\n"
+               "-4.5 5.25 6\n";
+    }
+    Points::PcdReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    EXPECT_FALSE(reader.hasNormals());
+    EXPECT_FALSE(reader.hasColors());
+}
+
+TEST_F(PointsReaderTest, pcdBinary)
+{
+    const uint32_t packed[2] = {0xff0033, 0x00ff99};
+    {
+        std::ofstream out = create(".pcd");
+        out << "VERSION .7\nFIELDS x y z normal_x normal_y normal_z rgb\n"
+               "SIZE 4 4 4 4 4 4 4\nTYPE F F F F F F U\nCOUNT 1 1 1 1 1 1 1\n"
+               "WIDTH 2\nHEIGHT 1\nPOINTS 2\nDATA binary\n";
+        for (int i = 0; i < 2; i++) {
+            for (float value : xyz[i]) {
+                write(out, value, false);
+            }
+            for (float value : nxyz[i]) {
+                write(out, value, false);
+            }
+            write(out, packed[i], false);
+        }
+    }
+    Points::PcdReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    checkNormals(reader);
+    checkColors(reader);
+}
+
+TEST_F(PointsReaderTest, pcdBinaryPointsOnly)
+{
+    {
+        std::ofstream out = create(".pcd");
+        out << "VERSION .7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n"
+               "WIDTH 2\nHEIGHT 1\nPOINTS 2\nDATA binary\n";
+        for (int i = 0; i < 2; i++) {
+            for (float value : xyz[i]) {
+                write(out, value, false);
+            }
+        }
+    }
+    Points::PcdReader reader;
+    reader.read(path.string());
+    checkPoints(reader);
+    EXPECT_FALSE(reader.hasNormals());
+    EXPECT_FALSE(reader.hasColors());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <Base/Exception.h>
+#include <Mod/Points/App/PointsOctree.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+class PointsOctreeTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path = std::filesystem::temp_directory_path()
+            / (std::string("PointsOctreeTest_")
+               + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".oct");
+
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> dist(-10.0F, 10.0F);
+        std::vector<Base::Vector3f> pts(20000);
+        for (auto& p : pts) {
+            p.Set(dist(gen), dist(gen), dist(gen));
+        }
+        kernel.swap(pts);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    void build(Points::PointsOctree& octree) const
+    {
+        octree.setMaxPointsPerNode(500);
+        Points::KernelSource source(kernel, 3000);
+        octree.build(source);
+    }
+
+    static bool less(const Base::Vector3f& a, const Base::Vector3f& b)
+    {
+        return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+    }
+
+    static void sort(std::vector<Base::Vector3f>& pts)
+    {
+        std::sort(pts.begin(), pts.end(), less);
+    }
+
+    std::vector<Base::Vector3f> inside(const Base::BoundBox3d& region) const
+    {
+        std::vector<Base::Vector3f> pts;
+        for (const auto& p : kernel.getBasicPoints()) {
+            if (region.IsInBox(Base::Vector3d(p.x, p.y, p.z))) {
+                pts.push_back(p);
+            }
+        }
+        return pts;
+    }
+
+    std::filesystem::path path;
+    Points::PointKernel kernel;
+};
+
+TEST_F(PointsOctreeTest, allPoints)
+{
+    Points::PointsOctree octree(path.string());
+    build(octree);
+    EXPECT_EQ(octree.size(), kernel.size());
+    EXPECT_GT(octree.countLevels(), 1);
+    EXPECT_EQ(octree.countPoints(-1), kernel.size());
+    EXPECT_EQ(octree.countPoints(octree.countLevels() - 1), kernel.size());
+
+    std::vector<Base::Vector3f> pts;
+    octree.getPoints(octree.getBoundBox(), -1, pts);
+    std::vector<Base::Vector3f> expected = kernel.getBasicPoints();
+    sort(pts);
+    sort(expected);
+    EXPECT_EQ(pts, expected);
+}
+
+TEST_F(PointsOctreeTest, region)
+{
+    Points::PointsOctree octree(path.string());
+    build(octree);
+
+    Base::BoundBox3d region(-2.0, -3.0, 1.0, 4.0, 5.0, 9.0);
+    std::vector<Base::Vector3f> pts;
+    octree.getPoints(region, -1, pts);
+    std::vector<Base::Vector3f> expected = inside(region);
+    sort(pts);
+    sort(expected);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(pts, expected);
+}
+
+TEST_F(PointsOctreeTest, levelOfDetail)
+{
+    Points::PointsOctree octree(path.string());
+    build(octree);
+
+    std::vector<Base::Vector3f> all = kernel.getBasicPoints();
+    sort(all);
+
+    uint64_t last = 0;
+    for (int level = 0; level < octree.countLevels(); level++) {
+        std::vector<Base::Vector3f> pts;
+        octree.getPoints(octree.getBoundBox(), level, pts);
+        EXPECT_EQ(pts.size(), octree.countPoints(level));
+        EXPECT_GE(pts.size(), last);
+        last = pts.size();
+
+        // a level of detail is a subset of the cloud
+        sort(pts);
+        EXPECT_TRUE(std::includes(all.begin(), all.end(), pts.begin(), pts.end(), less));
+    }
+
+    std::vector<Base::Vector3f> coarse;
+    octree.getPoints(octree.getBoundBox(), 0, coarse);
+    EXPECT_LT(coarse.size(), kernel.size());
+}
+
+TEST_F(PointsOctreeTest, findLevel)
+{
+    Points::PointsOctree octree(path.string());
+    build(octree);
+
+    EXPECT_EQ(octree.findLevel(kernel.size()), octree.countLevels() - 1);
+    int level = octree.findLevel(5000);
+    EXPECT_LE(octree.countPoints(level), 5000U);
+    if (level + 1 < octree.countLevels()) {
+        EXPECT_GT(octree.countPoints(level + 1), 5000U);
+    }
+    EXPECT_EQ(octree.findLevel(1), 0);
+}
+
+TEST_F(PointsOctreeTest, reopen)
+{
+    Base::BoundBox3d region(-5.0, -5.0, -5.0, 0.0, 0.0, 0.0);
+    std::vector<Base::Vector3f> expected;
+    {
+        Points::PointsOctree octree(path.string());
+        build(octree);
+        octree.getPoints(region, 1, expected);
+    }
+
+    Points::PointsOctree octree(path.string());
+    octree.open();
+    EXPECT_EQ(octree.size(), kernel.size());
+
+    Points::PointKernel pts;
+    octree.getPoints(region, 1, pts);
+    EXPECT_EQ(pts.getBasicPoints(), expected);
+}
+
+TEST_F(PointsOctreeTest, smallCache)
+{
+    Points::PointsOctree octree(path.string());
+    build(octree);
+    octree.setCacheSize(1);
+
+    std::vector<Base::Vector3f> pts;
+    octree.getPoints(octree.getBoundBox(), -1, pts);
+    EXPECT_EQ(pts.size(), kernel.size());
+}
+
+TEST_F(PointsOctreeTest, emptyCloud)
+{
+    Points::PointKernel empty;
+    Points::KernelSource source(empty);
+    Points::PointsOctree octree(path.string());
+    EXPECT_THROW(octree.build(source), Base::ValueError);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include <cmath>
+#include <GeomAPI_ProjectPointOnSurf.hxx>
+#include <Mod/ReverseEngineering/App/ApproxSurface.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+namespace
+{
+double height(double x, double y)
+{
+    return 0.1 * std::sin(2.0 * x) * std::cos(y) + 0.05 * x * y;
+}
+}  // namespace
+
+TEST(ApproxSurface, FitWithSmoothing)
+{
+    const int num = 25;
+    TColgp_Array1OfPnt points(0, num * num - 1);
+    int index = 0;
+    for (int i = 0; i < num; i++) {
+        for (int j = 0; j < num; j++) {
+            double x = -1.0 + 2.0 * i / (num - 1);
+            double y = -1.0 + 2.0 * j / (num - 1);
+            points(index++) = gp_Pnt(x, y, height(x, y));
+        }
+    }
+
+    const unsigned order = 4;
+    const unsigned poles = 8;
+    Reen::BSplineParameterCorrection pc(order, order, poles, poles);
+    pc.EnableSmoothing(true, 0.1, 1.0, 0.0, 0.0);
+    Handle(Geom_BSplineSurface) surface = pc.CreateSurface(points, 5, true, 1.0);
+    ASSERT_FALSE(surface.IsNull());
+    EXPECT_EQ(surface->NbUPoles(), static_cast<int>(poles));
+    EXPECT_EQ(surface->NbVPoles(), static_cast<int>(poles));
+
+    // the smoothing terms only couple control points with overlapping support
+    const Eigen::SparseMatrix<double>& first = pc.GetFirstSmoothMatrix();
+    ASSERT_EQ(first.rows(), static_cast<Eigen::Index>(poles * poles));
+    ASSERT_EQ(first.cols(), static_cast<Eigen::Index>(poles * poles));
+    EXPECT_GT(first.nonZeros(), 0);
+    EXPECT_LE(first.nonZeros(), static_cast<Eigen::Index>(poles * poles * (2 * order - 1) * (2 * order - 1)));
+    Eigen::SparseMatrix<double> transposed = first.transpose();
+    EXPECT_NEAR((first - transposed).norm(), 0.0, 1e-9 * first.norm());
+
+    // the surface approximates the interior points closely
+    for (int i = points.Lower(); i <= points.Upper(); i++) {
+        const gp_Pnt& pnt = points(i);
+        if (std::abs(pnt.X()) > 0.8 || std::abs(pnt.Y()) > 0.8) {
+            continue;
+        }
+        GeomAPI_ProjectPointOnSurf proj(pnt, surface);
+        ASSERT_GT(proj.NbPoints(), 0);
+        EXPECT_LT(proj.LowerDistance(), 0.01);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)